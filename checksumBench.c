@@ -0,0 +1,56 @@
+/**
+ * @file checksumBench.c
+ * @brief 프레임 테일 체크섬 커널별 처리량 측정 (GB/s)
+ *
+ * 사용법:
+ *   ./checksumBench [total_mbytes]
+ */
+#include "netModule/core/checksum.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double nowSec(void)
+{
+    struct timespec stTs;
+    clock_gettime(CLOCK_MONOTONIC, &stTs);
+    return (double)stTs.tv_sec + (double)stTs.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+    long lTotalBytes = ((argc > 1) ? atol(argv[1]) : 256) * 1024L * 1024L;
+    static const size_t aulSizes[] = { 16, 64, 256, 1024, 4096, 16384, 65536 };
+    const CHECKSUM_KERNEL* pstKernels;
+    int iKernelCnt = checksumGetKernels(&pstKernels);
+
+    unsigned char* puchData = malloc(65536);
+    for (int i = 0; i < 65536; i++)
+        puchData[i] = (unsigned char)rand();
+
+    printf("%-14s", "kernel");
+    for (size_t j = 0; j < sizeof(aulSizes) / sizeof(aulSizes[0]); j++)
+        printf(" %8zuB", aulSizes[j]);
+    printf("   (GB/s)\n");
+
+    volatile uint32_t uiSink = 0;
+    for (int i = 0; i < iKernelCnt; i++) {
+        printf("%-14s", pstKernels[i].pchName);
+        if (!pstKernels[i].iSupported) {
+            printf(" (not supported on this CPU)\n");
+            continue;
+        }
+        for (size_t j = 0; j < sizeof(aulSizes) / sizeof(aulSizes[0]); j++) {
+            long lIter = lTotalBytes / (long)aulSizes[j];
+            double dStart = nowSec();
+            for (long k = 0; k < lIter; k++)
+                uiSink ^= pstKernels[i].pfnCalc(puchData, aulSizes[j]);
+            double dElapsed = nowSec() - dStart;
+            printf(" %9.2f", (double)lIter * aulSizes[j] / dElapsed / 1e9);
+        }
+        printf("\n");
+    }
+
+    free(puchData);
+    return (int)(uiSink & 0);
+}
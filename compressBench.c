@@ -0,0 +1,114 @@
+/**
+ * @file compressBench.c
+ * @brief 페이로드 압축 비율 / 처리량 측정 (MB/s, memcpy 기준선 포함)
+ *
+ * 사용법:
+ *   ./compressBench [payload_bytes] [total_mbytes]
+ */
+#include "netModule/core/compress.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double nowSec(void)
+{
+    struct timespec stTs;
+    clock_gettime(CLOCK_MONOTONIC, &stTs);
+    return (double)stTs.tv_sec + (double)stTs.tv_nsec / 1e9;
+}
+
+/* 로그/텍스트 형태: 단어 사전에서 골라 이어 붙임 */
+static void fillText(unsigned char* puchData, size_t ulSize)
+{
+    static const char* apchWord[] = { "session ", "frame ", "keepalive ", "ok ", "error ",
+        "submodule ", "timeout ", "retry ", "0x1f ", "connected\n" };
+    size_t ulPos = 0;
+    while (ulPos < ulSize) {
+        const char* pchWord = apchWord[rand() % 10];
+        size_t ulLen = strlen(pchWord);
+        if (ulLen > ulSize - ulPos)
+            ulLen = ulSize - ulPos;
+        memcpy(puchData + ulPos, pchWord, ulLen);
+        ulPos += ulLen;
+    }
+}
+
+/* 구조체 배열 형태: 고정 필드 + 천천히 변하는 카운터 */
+static void fillStruct(unsigned char* puchData, size_t ulSize)
+{
+    struct { uint32_t uiId; uint16_t unType; uint16_t unFlags; uint32_t uiCount; float fValue; } stRec;
+    for (size_t ulPos = 0, i = 0; ulPos < ulSize; ulPos += sizeof(stRec), i++) {
+        stRec.uiId      = (uint32_t)i;
+        stRec.unType    = (uint16_t)(i % 4);
+        stRec.unFlags   = 0x0100;
+        stRec.uiCount   = (uint32_t)(i * 3);
+        stRec.fValue    = (float)(i % 16) * 0.5f;
+        memcpy(puchData + ulPos, &stRec, ulSize - ulPos < sizeof(stRec) ? ulSize - ulPos : sizeof(stRec));
+    }
+}
+
+static void fillRandom(unsigned char* puchData, size_t ulSize)
+{
+    for (size_t i = 0; i < ulSize; i++)
+        puchData[i] = (unsigned char)rand();
+}
+
+int main(int argc, char *argv[])
+{
+    size_t ulSize = (argc > 1) ? (size_t)atol(argv[1]) : 4096;
+    long lTotalBytes = ((argc > 2) ? atol(argv[2]) : 256) * 1024L * 1024L;
+    long lIter = lTotalBytes / (long)(ulSize ? ulSize : 1);
+    static const struct { const char* pchName; void (*pfnFill)(unsigned char*, size_t); } astSet[] = {
+        { "text",   fillText   },
+        { "struct", fillStruct },
+        { "random", fillRandom },
+    };
+
+    unsigned char* puchSrc  = malloc(ulSize);
+    unsigned char* puchComp = malloc(compressBound(ulSize));
+    unsigned char* puchOut  = malloc(ulSize);
+    if (!ulSize || !puchSrc || !puchComp || !puchOut)
+        return 1;
+
+    printf("payload %zu bytes, %ld iterations\n", ulSize, lIter);
+    printf("%-8s %8s %12s %12s %12s\n", "data", "ratio", "memcpy", "compress", "decompress");
+
+    volatile size_t ulSink = 0;
+    for (size_t j = 0; j < sizeof(astSet) / sizeof(astSet[0]); j++) {
+        astSet[j].pfnFill(puchSrc, ulSize);
+
+        double dStart = nowSec();
+        for (long k = 0; k < lIter; k++) {
+            memcpy(puchOut, puchSrc, ulSize);
+            ulSink += puchOut[k % ulSize];
+        }
+        double dCopy = nowSec() - dStart;
+
+        size_t ulComp = 0;
+        dStart = nowSec();
+        for (long k = 0; k < lIter; k++)
+            ulComp = compressLz4(puchSrc, ulSize, puchComp, compressBound(ulSize));
+        double dComp = nowSec() - dStart;
+
+        long lRaw = 0;
+        dStart = nowSec();
+        for (long k = 0; k < lIter; k++)
+            lRaw = decompressLz4(puchComp, ulComp, puchOut, ulSize);
+        double dDecomp = nowSec() - dStart;
+
+        if (lRaw != (long)ulSize || memcmp(puchSrc, puchOut, ulSize) != 0) {
+            fprintf(stderr, "%s: round-trip mismatch\n", astSet[j].pchName);
+            return 1;
+        }
+        double dMb = (double)lIter * (double)ulSize / 1e6;
+        printf("%-8s %8.2f %12.0f %12.0f %12.0f\n", astSet[j].pchName, (double)ulSize / (double)ulComp,
+            dMb / dCopy, dMb / dComp, dMb / dDecomp);
+    }
+
+    free(puchSrc);
+    free(puchComp);
+    free(puchOut);
+    return (int)(ulSink & 0);
+}
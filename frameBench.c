@@ -0,0 +1,145 @@
+/**
+ * @file frameBench.c
+ * @brief 프레임 인코더 처리량 측정 (frames/sec)
+ *
+ * 사용법:
+ *   ./frameBench [frame_count]
+ *
+ * legacy : 이전 writeFrame() 방식 (malloc → memcpy → bufferevent_write → free)
+ * zcopy  : 현재 writeFrame() 방식 (출력 evbuffer 예약 공간에 직접 인코딩)
+ * batch  : writeFrameBatch() 로 BATCH_SIZE 프레임씩 한 번에 인코딩
+ */
+#include "netModule/core/frame.h"
+#include "netModule/core/icdCommand.h"
+#include <event2/event.h>
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DRAIN_THRESHOLD (64 * 1024)   /* 소켓 송신을 흉내 내어 주기적으로 비운다 */
+#define BATCH_SIZE      16
+
+static double nowSec(void)
+{
+    struct timespec stTs;
+    clock_gettime(CLOCK_MONOTONIC, &stTs);
+    return (double)stTs.tv_sec + (double)stTs.tv_nsec / 1e9;
+}
+
+/* 기존 구현 재현 (비교 기준) */
+static int legacyWriteFrame(struct bufferevent* pstBufferEvent, unsigned short unCmd,
+                       const MSG_ID* pstMsgId, unsigned char uchSubModule,
+                       const void* pvPayload, int iDataLength)
+{
+    FRAME_HEADER stFrameHeader;
+    FRAME_TAIL   stFrameTail;
+    const unsigned char* puchSrc = (const unsigned char*)pvPayload;
+    unsigned char uchCrc = 0;
+
+    for (int i = 0; i < iDataLength; i++)
+        uchCrc ^= puchSrc[i];
+
+    stFrameHeader.unStx             = htons(STX_CONST);
+    stFrameHeader.iDataLength       = htonl(iDataLength);
+    stFrameHeader.stMsgId           = *pstMsgId;
+    stFrameHeader.uchSubModule      = uchSubModule;
+    stFrameHeader.unCmd             = htons(unCmd);
+    stFrameTail.uchCrc              = uchCrc;
+    stFrameTail.unEtx               = htons(ETX_CONST);
+
+    int iTotalSize = sizeof(FRAME_HEADER) + iDataLength + sizeof(FRAME_TAIL);
+    unsigned char* puchPacket = (unsigned char*)malloc(iTotalSize);
+    if (!puchPacket)
+        return -1;
+
+    memcpy(puchPacket, &stFrameHeader, sizeof(FRAME_HEADER));
+    memcpy(puchPacket + sizeof(FRAME_HEADER), pvPayload, iDataLength);
+    memcpy(puchPacket + sizeof(FRAME_HEADER) + iDataLength, &stFrameTail, sizeof(FRAME_TAIL));
+    int iRet = bufferevent_write(pstBufferEvent, puchPacket, iTotalSize);
+    free(puchPacket);
+    return iRet < 0 ? -1 : 1;
+}
+
+typedef int (*WRITE_FN)(struct bufferevent*, unsigned short, const MSG_ID*,
+                        unsigned char, const void*, int);
+
+static double runBench(WRITE_FN pfnWrite, struct bufferevent* pstBufferEvent,
+                       const unsigned char* puchPayload, int iDataLength, long lCount)
+{
+    MSG_ID stMsgId = { 1, 2 };
+    struct evbuffer* pstOut = bufferevent_get_output(pstBufferEvent);
+
+    double dStart = nowSec();
+    for (long i = 0; i < lCount; i++) {
+        pfnWrite(pstBufferEvent, CMD_KEEP_ALIVE, &stMsgId, 0, puchPayload, iDataLength);
+        if (evbuffer_get_length(pstOut) >= DRAIN_THRESHOLD)
+            evbuffer_drain(pstOut, evbuffer_get_length(pstOut));
+    }
+    evbuffer_drain(pstOut, evbuffer_get_length(pstOut));
+    return (double)lCount / (nowSec() - dStart);
+}
+
+static double runBatchBench(struct bufferevent* pstBufferEvent,
+                       const unsigned char* puchPayload, int iDataLength, long lCount)
+{
+    MSG_ID stMsgId = { 1, 2 };
+    FRAME_IOV astFrames[BATCH_SIZE];
+    struct evbuffer* pstOut = bufferevent_get_output(pstBufferEvent);
+
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        astFrames[i].unCmd          = CMD_KEEP_ALIVE;
+        astFrames[i].uchSubModule   = 0;
+        astFrames[i].pvPayload      = puchPayload;
+        astFrames[i].iDataLength    = iDataLength;
+    }
+
+    double dStart = nowSec();
+    for (long i = 0; i < lCount; i += BATCH_SIZE) {
+        writeFrameBatch(pstBufferEvent, &stMsgId, astFrames, BATCH_SIZE);
+        if (evbuffer_get_length(pstOut) >= DRAIN_THRESHOLD)
+            evbuffer_drain(pstOut, evbuffer_get_length(pstOut));
+    }
+    evbuffer_drain(pstOut, evbuffer_get_length(pstOut));
+    return (double)lCount / (nowSec() - dStart);
+}
+
+int main(int argc, char *argv[])
+{
+    long lCount = (argc > 1) ? atol(argv[1]) : 2000000;
+    static const int aiSizes[] = { 1, 16, 64, 256, 1024, 4096, 16384 };
+
+    struct event_base* pstEventBase = event_base_new();
+    /* 소켓 없는 bufferevent: 출력 버퍼에만 쌓이고 실제 송신은 하지 않는다 */
+    struct bufferevent* pstBufferEvent = bufferevent_socket_new(pstEventBase, -1, 0);
+    if (!pstEventBase || !pstBufferEvent) {
+        fprintf(stderr, "[BENCH] libevent init failed\n");
+        return 1;
+    }
+    bufferevent_disable(pstBufferEvent, EV_READ | EV_WRITE);
+    /* socket bufferevent는 출력 버퍼 앞단을 freeze 하므로 벤치에서 직접 비우기 위해 해제 */
+    evbuffer_unfreeze(bufferevent_get_output(pstBufferEvent), 1);
+
+    unsigned char* puchPayload = malloc(16384);
+    for (int i = 0; i < 16384; i++)
+        puchPayload[i] = (unsigned char)(i * 31);
+
+    printf("%8s %14s %14s %8s %14s %8s\n", "payload", "legacy(f/s)", "zcopy(f/s)", "speedup",
+        "batch(f/s)", "speedup");
+    for (size_t i = 0; i < sizeof(aiSizes) / sizeof(aiSizes[0]); i++) {
+        long lRun = aiSizes[i] > 1024 ? lCount / 8 : lCount;
+        double dLegacy = runBench(legacyWriteFrame, pstBufferEvent, puchPayload, aiSizes[i], lRun);
+        double dZcopy  = runBench(writeFrame, pstBufferEvent, puchPayload, aiSizes[i], lRun);
+        double dBatch  = runBatchBench(pstBufferEvent, puchPayload, aiSizes[i], lRun);
+        printf("%8d %14.0f %14.0f %7.2fx %14.0f %7.2fx\n", aiSizes[i], dLegacy, dZcopy,
+            dZcopy / dLegacy, dBatch, dBatch / dLegacy);
+    }
+
+    free(puchPayload);
+    bufferevent_free(pstBufferEvent);
+    event_base_free(pstEventBase);
+    return 0;
+}
@@ -0,0 +1,621 @@
+/**
+ * @file frameGtest.cc
+ * @brief 프레임 인코더/디코더 GoogleTest
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <event2/event.h>
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+
+extern "C" {
+#include "netModule/core/frame.h"
+#include "netModule/core/cmdTable.h"
+#include "netModule/core/checksum.h"
+#include "netModule/core/icdCommand.h"
+#include "netModule/core/trace.h"
+#include "netModule/core/inflight.h"
+#include "netModule/core/compress.h"
+}
+
+class FrameTest : public ::testing::Test {
+protected:
+    evbuffer* pstEvBuffer{};
+    MSG_ID stMsgId{ 0x02, 0x01 };
+    CMD_TABLE stCmdTable;
+    FRAME_CTX stFrameCtx;
+
+    void SetUp() override {
+        pstEvBuffer = evbuffer_new();
+        ASSERT_NE(pstEvBuffer, nullptr);
+        cmdTableInit(&stCmdTable);
+        frameRegisterDefaultCmds(&stCmdTable);
+        frameCtxInit(&stFrameCtx, nullptr, &stCmdTable, nullptr);
+    }
+
+    void TearDown() override {
+        cmdTableFree(&stCmdTable);
+        if (pstEvBuffer)
+            evbuffer_free(pstEvBuffer);
+    }
+
+    std::vector<unsigned char> encode(unsigned short unCmd, const void* pvPayload, int iDataLength) {
+        evbuffer* pstTmp = evbuffer_new();
+        EXPECT_EQ(encodeFrame(pstTmp, unCmd, &stMsgId, 0, pvPayload, iDataLength), 1);
+        std::vector<unsigned char> vecFrame(evbuffer_get_length(pstTmp));
+        evbuffer_remove(pstTmp, vecFrame.data(), vecFrame.size());
+        evbuffer_free(pstTmp);
+        return vecFrame;
+    }
+};
+
+TEST_F(FrameTest, EncodeDecode_RoundTrip) {
+    const char* msg = "hello";
+    ASSERT_EQ(encodeFrame(pstEvBuffer, CMD_KEEP_ALIVE, &stMsgId, 0, msg, strlen(msg)), 1);
+    EXPECT_EQ(evbuffer_get_length(pstEvBuffer),
+              sizeof(FRAME_HEADER) + strlen(msg) + sizeof(FRAME_TAIL));
+
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+    EXPECT_EQ(evbuffer_get_length(pstEvBuffer), 0u);
+}
+
+TEST_F(FrameTest, Encode_LargePayload) {
+    std::vector<unsigned char> vecPayload(64 * 1024);
+    for (size_t i = 0; i < vecPayload.size(); i++)
+        vecPayload[i] = (unsigned char)(i * 7);
+
+    /* 작은 프레임으로 마지막 chain 일부를 채운 뒤 큰 프레임 인코딩 (2 iovec 경로) */
+    ASSERT_EQ(encodeFrame(pstEvBuffer, CMD_IBIT, &stMsgId, 0, "x", 1), 1);
+    ASSERT_EQ(encodeFrame(pstEvBuffer, CMD_IBIT, &stMsgId, 0, vecPayload.data(), (int)vecPayload.size()), 1);
+
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+    EXPECT_EQ(evbuffer_get_length(pstEvBuffer), 0u);
+}
+
+TEST_F(FrameTest, Decode_FrameAcrossChains) {
+    const char* msg = "split-frame";
+    std::vector<unsigned char> vecFrame = encode(CMD_IBIT, msg, strlen(msg));
+
+    for (size_t ulSplit = 1; ulSplit < vecFrame.size(); ulSplit++) {
+        /* reference chain 두 개로 나누어 chain 경계를 강제 */
+        evbuffer_add_reference(pstEvBuffer, vecFrame.data(), ulSplit, nullptr, nullptr);
+        evbuffer_add_reference(pstEvBuffer, vecFrame.data() + ulSplit,
+                               vecFrame.size() - ulSplit, nullptr, nullptr);
+        ASSERT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1) << "split=" << ulSplit;
+        ASSERT_EQ(evbuffer_get_length(pstEvBuffer), 0u);
+    }
+}
+
+TEST_F(FrameTest, Decode_PartialFrameNeedsMore) {
+    const char* msg = "partial";
+    std::vector<unsigned char> vecFrame = encode(CMD_KEEP_ALIVE, msg, strlen(msg));
+
+    evbuffer_add(pstEvBuffer, vecFrame.data(), vecFrame.size() - 1);
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 0);
+    EXPECT_EQ(evbuffer_get_length(pstEvBuffer), vecFrame.size() - 1);
+
+    evbuffer_add(pstEvBuffer, vecFrame.data() + vecFrame.size() - 1, 1);
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+}
+
+TEST_F(FrameTest, Decode_BadCrcIsFatal) {
+    const char* msg = "crc";
+    std::vector<unsigned char> vecFrame = encode(CMD_KEEP_ALIVE, msg, strlen(msg));
+    vecFrame[sizeof(FRAME_HEADER)] ^= 0xFF;
+
+    /* 허용 횟수 0: 기존처럼 첫 오류에 세션 종료 */
+    stFrameCtx.uiErrorBudget = 0;
+    evbuffer_add(pstEvBuffer, vecFrame.data(), vecFrame.size());
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), -1);
+}
+
+TEST_F(FrameTest, Decode_ResyncAfterGarbage) {
+    const char* msg = "sync";
+    std::vector<unsigned char> vecGood = encode(CMD_KEEP_ALIVE, msg, strlen(msg));
+    std::vector<unsigned char> vecBad = vecGood;
+    vecBad[sizeof(FRAME_HEADER)] ^= 0xFF;
+
+    /* 쓰레기 + STX 조각 + 손상 프레임 + 정상 프레임 */
+    static const unsigned char auchJunk[] = { 0x01, 0xAA, 0x02, 0xAA, 0x55, 0x7F };
+    evbuffer_add(pstEvBuffer, auchJunk, sizeof(auchJunk));
+    evbuffer_add(pstEvBuffer, vecBad.data(), vecBad.size());
+    evbuffer_add(pstEvBuffer, vecGood.data(), vecGood.size());
+
+    int iFrames = 0, r;
+    while ((r = responseFrame(pstEvBuffer, &stFrameCtx)) == 1)
+        iFrames++;
+    EXPECT_EQ(r, 0);
+    EXPECT_EQ(evbuffer_get_length(pstEvBuffer), 0u);
+    EXPECT_EQ(stFrameCtx.uiErrorCnt, 0u);       /* 정상 프레임으로 동기 회복 */
+    EXPECT_EQ(stFrameCtx.uiCrcErrCnt, 1u);
+    EXPECT_GE(stFrameCtx.ulDiscardBytes, sizeof(auchJunk) + vecBad.size() - 1);
+    EXPECT_GT(iFrames, 1);
+
+    /* STX 없는 입력은 마지막 0xAA 만 남기고 버린다 */
+    static const unsigned char auchTail[] = { 0x10, 0x20, 0xAA };
+    evbuffer_add(pstEvBuffer, auchTail, sizeof(auchTail));
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 0);
+    EXPECT_EQ(evbuffer_get_length(pstEvBuffer), 1u);
+    evbuffer_add(pstEvBuffer, vecGood.data() + 1, vecGood.size() - 1);
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+    EXPECT_EQ(evbuffer_get_length(pstEvBuffer), 0u);
+}
+
+TEST_F(FrameTest, Decode_ErrorBudgetExceeded) {
+    std::vector<unsigned char> vecBad = encode(CMD_KEEP_ALIVE, "x", 1);
+    vecBad[sizeof(FRAME_HEADER)] ^= 0xFF;
+
+    stFrameCtx.uiErrorBudget = 2;
+    for (int i = 0; i < 3; i++)
+        evbuffer_add(pstEvBuffer, vecBad.data(), vecBad.size());
+
+    int r;
+    while ((r = responseFrame(pstEvBuffer, &stFrameCtx)) == 1)
+        ;
+    EXPECT_EQ(r, -1);
+}
+
+TEST_F(FrameTest, EncodeBatch_DecodesAll) {
+    std::vector<unsigned char> vecBig(2048, 0x11);
+    FRAME_IOV astFrames[] = {
+        { CMD_KEEP_ALIVE, 0, "a", 1 },
+        { CMD_IBIT,       0, vecBig.data(), (int)vecBig.size() },
+        { CMD_REQ_ID,     0, nullptr, 0 },
+    };
+    ASSERT_EQ(encodeFrameBatch(pstEvBuffer, CRC_MODE_XOR8, &stMsgId, astFrames, 3), 3);
+    for (int i = 0; i < 3; i++)
+        EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+    EXPECT_EQ(evbuffer_get_length(pstEvBuffer), 0u);
+
+    /* 잘못된 항목이 있으면 아무것도 기록하지 않는다 */
+    FRAME_IOV stBad = { CMD_IBIT, 0, nullptr, 4 };
+    EXPECT_EQ(encodeFrameBatch(pstEvBuffer, CRC_MODE_XOR8, &stMsgId, &stBad, 1), -1);
+    EXPECT_EQ(evbuffer_get_length(pstEvBuffer), 0u);
+}
+
+static int countHandler(FRAME_CTX*, const FRAME_VIEW* pstFrameView, void* pvUser) {
+    int* piCount = static_cast<int*>(pvUser);
+    (*piCount) += pstFrameView->uchSubModule == 0 ? 1 : 100;
+    return 1;
+}
+
+TEST_F(FrameTest, Dispatch_RegisteredCommand) {
+    constexpr unsigned short kCmd = 0x40;
+    int iCount = 0;
+    ASSERT_EQ(cmdRegister(&stCmdTable, kCmd, 4, countHandler, &iCount), 0);
+
+    ASSERT_EQ(encodeFrame(pstEvBuffer, kCmd, &stMsgId, 0, "abcd", 4), 1);
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+    EXPECT_EQ(iCount, 1);
+
+    /* 기대 크기와 다르면 핸들러를 호출하지 않고 프레임만 소비 */
+    ASSERT_EQ(encodeFrame(pstEvBuffer, kCmd, &stMsgId, 0, "abc", 3), 1);
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+    EXPECT_EQ(iCount, 1);
+    EXPECT_EQ(evbuffer_get_length(pstEvBuffer), 0u);
+}
+
+TEST_F(FrameTest, Dispatch_SubModuleOverride) {
+    constexpr unsigned short kCmd = 0x41;
+    int iCount = 0;
+    ASSERT_EQ(cmdRegister(&stCmdTable, kCmd, CMD_ANY_SIZE, countHandler, &iCount), 0);
+    ASSERT_EQ(cmdRegisterSub(&stCmdTable, kCmd, 7, CMD_ANY_SIZE, countHandler, &iCount), 0);
+
+    ASSERT_EQ(encodeFrame(pstEvBuffer, kCmd, &stMsgId, 7, "x", 1), 1);   /* 2단계 */
+    ASSERT_EQ(encodeFrame(pstEvBuffer, kCmd, &stMsgId, 3, "x", 1), 1);   /* 1단계로 fallback */
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+    EXPECT_EQ(iCount, 100 + 100);   /* 두 프레임 모두 uchSubModule != 0 */
+
+    EXPECT_EQ(cmdLookup(&stCmdTable, kCmd, 7), &stCmdTable.astEntry[kCmd].pstSubTable[7]);
+    EXPECT_EQ(cmdLookup(&stCmdTable, kCmd, 3), &stCmdTable.astEntry[kCmd]);
+    EXPECT_EQ(cmdLookup(&stCmdTable, CMD_TABLE_SIZE, 0), nullptr);
+}
+
+TEST(ChecksumTest, KnownAnswer) {
+    const char* pchCheck = "123456789";
+    EXPECT_EQ(checksumCrc16(pchCheck, 9), 0x29B1);
+    EXPECT_EQ(checksumCrc32c(pchCheck, 9), 0xE3069283u);
+    EXPECT_EQ(checksumXor8("\x01\x02\x04", 3), 0x07);
+}
+
+TEST(ChecksumTest, KernelsAgree) {
+    const CHECKSUM_KERNEL* pstKernels;
+    int iKernelCnt = checksumGetKernels(&pstKernels);
+    std::vector<unsigned char> vecData(4096 + 64);
+    for (size_t i = 0; i < vecData.size(); i++)
+        vecData[i] = (unsigned char)(i * 131 + 7);
+
+    /* 길이/정렬 조합마다 같은 모드의 커널 결과가 모두 같아야 한다 */
+    for (size_t ulOff = 0; ulOff < 8; ulOff++) {
+        for (size_t ulSize = 0; ulSize <= 4096; ulSize += (ulSize < 300 ? 1 : 97)) {
+            const unsigned char* puchData = vecData.data() + ulOff;
+            for (int i = 0; i < iKernelCnt; i++) {
+                if (!pstKernels[i].iSupported)
+                    continue;
+                ASSERT_EQ(pstKernels[i].pfnCalc(puchData, ulSize),
+                          checksumCalc(pstKernels[i].eMode, puchData, ulSize))
+                    << pstKernels[i].pchName << " size=" << ulSize << " off=" << ulOff;
+            }
+        }
+    }
+}
+
+TEST_F(FrameTest, CrcMode_RoundTrip) {
+    std::vector<unsigned char> vecPayload(3000, 0x5A);
+    for (unsigned char uchMode = CRC_MODE_XOR8; uchMode < CRC_MODE_MAX; uchMode++) {
+        stFrameCtx.uchCrcMode = uchMode;
+        ASSERT_EQ(encodeFrameCrc(pstEvBuffer, uchMode, CMD_IBIT, &stMsgId, 0,
+                                 vecPayload.data(), (int)vecPayload.size()), 1);
+        EXPECT_EQ(evbuffer_get_length(pstEvBuffer),
+                  sizeof(FRAME_HEADER) + vecPayload.size() + frameTailSize(uchMode));
+        EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+        EXPECT_EQ(evbuffer_get_length(pstEvBuffer), 0u);
+    }
+}
+
+/* 요청도 세션 체크섬 모드로 나가야 같은 모드의 상대가 받는다 */
+TEST_F(FrameTest, RequestFrame_UsesSessionCrcMode) {
+    int aiSock[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, aiSock), 0);
+    event_base* pstEventBase = event_base_new();
+    bufferevent* pstBufferEvent = bufferevent_socket_new(pstEventBase, aiSock[0], BEV_OPT_CLOSE_ON_FREE);
+    FRAME_CTX stTxCtx;
+    frameCtxInit(&stTxCtx, pstBufferEvent, nullptr, nullptr);
+    for (unsigned char uchMode = CRC_MODE_XOR8; uchMode < CRC_MODE_MAX; uchMode++) {
+        stTxCtx.uchCrcMode = stFrameCtx.uchCrcMode = uchMode;
+        ASSERT_EQ(requestFrame(&stTxCtx, &stMsgId, CMD_IBIT), 1);
+        event_base_loop(pstEventBase, EVLOOP_NONBLOCK);
+        unsigned char auchFrame[64];
+        ssize_t lRead = read(aiSock[1], auchFrame, sizeof(auchFrame));
+        ASSERT_GT(lRead, 0);
+        evbuffer_add(pstEvBuffer, auchFrame, (size_t)lRead);
+        EXPECT_EQ(evbuffer_get_length(pstEvBuffer),
+                  sizeof(FRAME_HEADER) + sizeof(REQ_IBIT) + frameTailSize(uchMode));
+        EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+        EXPECT_EQ(evbuffer_get_length(pstEvBuffer), 0u);
+    }
+    bufferevent_free(pstBufferEvent);
+    close(aiSock[1]);
+    event_base_free(pstEventBase);
+}
+
+static void traceCountVisit(uint32_t, const TRACE_RECORD* pstRecord, void* pvUser) {
+    int* piCount = static_cast<int*>(pvUser);
+    piCount[pstRecord->uchEvent]++;
+}
+
+TEST_F(FrameTest, Trace_RecordsFrameEvents) {
+    int aiBefore[TRACE_EV_MAX] = {}, aiAfter[TRACE_EV_MAX] = {};
+    traceCollect(traceCountVisit, aiBefore);
+
+    static const unsigned char auchJunk[] = { 0x00, 0x01 };
+    evbuffer_add(pstEvBuffer, auchJunk, sizeof(auchJunk));
+    ASSERT_EQ(encodeFrame(pstEvBuffer, CMD_KEEP_ALIVE, &stMsgId, 0, "k", 1), 1);
+    EXPECT_EQ(responseFrame(pstEvBuffer, &stFrameCtx), 1);
+
+    traceCollect(traceCountVisit, aiAfter);
+    if (TRACE_LEVEL >= TRACE_LEVEL_INFO) {
+        EXPECT_EQ(aiAfter[TRACE_EV_RESYNC] - aiBefore[TRACE_EV_RESYNC], 1);
+        EXPECT_EQ(aiAfter[TRACE_EV_RX_FRAME] - aiBefore[TRACE_EV_RX_FRAME], 1);
+        EXPECT_EQ(aiAfter[TRACE_EV_RES_KEEP_ALIVE] - aiBefore[TRACE_EV_RES_KEEP_ALIVE], 1);
+    }
+}
+/* === 요청/응답 상관: 클라이언트 → 서버 → 클라이언트 를 evbuffer 로 연결 === */
+class InflightTest : public ::testing::Test {
+protected:
+    event_base* pstEventBase{};
+    bufferevent* pstClnBev{};
+    bufferevent* pstSvrBev{};
+    CMD_TABLE stCmdTable;
+    FRAME_CTX stClnCtx, stSvrCtx;
+    INFLIGHT_TABLE stInflight;
+
+    static bufferevent* newBev(event_base* pstBase) {
+        bufferevent* pstBev = bufferevent_socket_new(pstBase, -1, 0);
+        bufferevent_disable(pstBev, EV_READ | EV_WRITE);
+        evbuffer_unfreeze(bufferevent_get_output(pstBev), 1);
+        return pstBev;
+    }
+
+    void SetUp() override {
+        pstEventBase = event_base_new();
+        pstClnBev = newBev(pstEventBase);
+        pstSvrBev = newBev(pstEventBase);
+        cmdTableInit(&stCmdTable);
+        frameRegisterDefaultCmds(&stCmdTable);
+        frameCtxInit(&stClnCtx, pstClnBev, &stCmdTable, nullptr);
+        frameCtxInit(&stSvrCtx, pstSvrBev, &stCmdTable, nullptr);
+        ASSERT_EQ(inflightInit(&stInflight, pstEventBase, 64), 0);
+        stClnCtx.pstInflight = &stInflight;
+    }
+
+    void TearDown() override {
+        inflightFree(&stInflight);
+        frameCtxFree(&stClnCtx);
+        frameCtxFree(&stSvrCtx);
+        cmdTableFree(&stCmdTable);
+        bufferevent_free(pstClnBev);
+        bufferevent_free(pstSvrBev);
+        event_base_free(pstEventBase);
+    }
+
+    /* pstFrom 출력 버퍼의 프레임을 모두 pstCtx 로 처리 */
+    static int pump(bufferevent* pstFrom, FRAME_CTX* pstCtx) {
+        evbuffer* pstIn = evbuffer_new();
+        evbuffer_add_buffer(pstIn, bufferevent_get_output(pstFrom));
+        int iFrames = 0;
+        while (responseFrame(pstIn, pstCtx) == 1)
+            iFrames++;
+        EXPECT_EQ(evbuffer_get_length(pstIn), 0u);
+        evbuffer_free(pstIn);
+        return iFrames;
+    }
+};
+
+struct InflightResult {
+    int iDone = 0, iTimeout = 0, iCancelled = 0;
+    unsigned int uiLastSeq = 0;
+};
+
+static void inflightResultCb(int iStatus, const FRAME_VIEW* pstFrameView, void* pvUser) {
+    InflightResult* pstResult = static_cast<InflightResult*>(pvUser);
+    if (iStatus == INFLIGHT_DONE) {
+        pstResult->iDone++;
+        EXPECT_TRUE(pstFrameView->uchFlags & FRAME_FLAG_RESPONSE);
+        EXPECT_GT(pstFrameView->uiSeq, pstResult->uiLastSeq);   /* 서버는 순서대로 응답 */
+        pstResult->uiLastSeq = pstFrameView->uiSeq;
+    } else if (iStatus == INFLIGHT_TIMEOUT) {
+        pstResult->iTimeout++;
+    } else {
+        pstResult->iCancelled++;
+    }
+}
+
+TEST_F(InflightTest, PipelinedRequestsComplete) {
+    InflightResult stResult;
+    REQ_KEEP_ALIVE stReq = { 0x01 };
+    for (int i = 0; i < 50; i++)
+        ASSERT_GT(inflightRequest(&stClnCtx, CMD_KEEP_ALIVE, 0, &stReq, sizeof(stReq),
+                                  1000, inflightResultCb, &stResult), 0);
+    EXPECT_EQ(inflightPending(&stInflight), 50u);
+
+    /* 서버는 chReply 가 꺼져 있어도 상관 ID가 있는 요청에는 응답한다 */
+    EXPECT_EQ(pump(pstClnBev, &stSvrCtx), 50);
+    EXPECT_EQ(pump(pstSvrBev, &stClnCtx), 50);
+    EXPECT_EQ(stResult.iDone, 50);
+    EXPECT_EQ(inflightPending(&stInflight), 0u);
+}
+
+TEST_F(InflightTest, TableFullAndCancel) {
+    InflightResult stResult;
+    for (int i = 0; i < 64; i++)
+        ASSERT_GT(inflightRequest(&stClnCtx, CMD_IBIT, 0, "i", 1, 1000, inflightResultCb, &stResult), 0);
+    EXPECT_EQ(inflightRequest(&stClnCtx, CMD_IBIT, 0, "i", 1, 1000, inflightResultCb, &stResult), -1);
+
+    inflightFree(&stInflight);
+    EXPECT_EQ(stResult.iCancelled, 64);
+}
+
+TEST_F(InflightTest, TimeoutThenLateResponse) {
+    InflightResult stResult;
+    ASSERT_GT(inflightRequest(&stClnCtx, CMD_KEEP_ALIVE, 0, "k", 1, 1, inflightResultCb, &stResult), 0);
+    event_base_loop(pstEventBase, EVLOOP_ONCE);
+    EXPECT_EQ(stResult.iTimeout, 1);
+    EXPECT_EQ(inflightPending(&stInflight), 0u);
+
+    /* 시간 초과 후 도착한 응답은 콜백 없이 버린다 */
+    EXPECT_EQ(pump(pstClnBev, &stSvrCtx), 1);
+    EXPECT_EQ(pump(pstSvrBev, &stClnCtx), 1);
+    EXPECT_EQ(stResult.iDone, 0);
+    EXPECT_EQ(stInflight.ulLateCnt, 1u);
+}
+/* === 조각 송신/재조립 === */
+using FragTest = InflightTest;
+
+struct FragResult {
+    std::vector<unsigned char> vecData;
+    int iCalls = 0;
+    int iLast = 0;
+};
+
+static int fragCollectHandler(FRAME_CTX*, const FRAME_VIEW* pstFrameView, void* pvUser) {
+    FragResult* pstResult = static_cast<FragResult*>(pvUser);
+    pstResult->iCalls++;
+    if (pstFrameView->uchFlags & FRAME_FLAG_FRAG) {
+        EXPECT_EQ(pstFrameView->uiFragOffset, pstResult->vecData.size());
+    }
+    if (pstFrameView->uchFlags & FRAME_FLAG_LAST)
+        pstResult->iLast++;
+    pstResult->vecData.insert(pstResult->vecData.end(), pstFrameView->puchPayload,
+                              pstFrameView->puchPayload + pstFrameView->iDataLength);
+    return 1;
+}
+
+static std::vector<unsigned char> makePattern(size_t ulSize) {
+    std::vector<unsigned char> vec(ulSize);
+    for (size_t i = 0; i < ulSize; i++)
+        vec[i] = (unsigned char)(i * 31 + (i >> 8));
+    return vec;
+}
+
+TEST_F(FragTest, ReassembledForPlainHandler) {
+    constexpr unsigned short kCmd = 0x50;
+    FragResult stResult;
+    ASSERT_EQ(cmdRegister(&stCmdTable, kCmd, CMD_ANY_SIZE, fragCollectHandler, &stResult), 0);
+    std::vector<unsigned char> vecPayload = makePattern(13 * 16 * 1024);
+
+    /* 조각 사이에 제어 프레임을 끼워 보낸다 */
+    FRAME_STREAM stStream;
+    frameStreamBegin(&stClnCtx, &stStream, kCmd, 0);
+    for (size_t ulOff = 0; ulOff < vecPayload.size(); ulOff += 16 * 1024) {
+        ASSERT_EQ(frameStreamWrite(&stClnCtx, &stStream, vecPayload.data() + ulOff, 16 * 1024,
+                                   ulOff + 16 * 1024 >= vecPayload.size()), 1);
+        ASSERT_EQ(writeFrameCtx(&stClnCtx, CMD_KEEP_ALIVE, 0, "k", 1), 1);
+    }
+
+    EXPECT_EQ(pump(pstClnBev, &stSvrCtx), 13 * 2);
+    EXPECT_EQ(stResult.iCalls, 1);
+    EXPECT_EQ(stResult.vecData, vecPayload);
+}
+
+TEST_F(FragTest, StreamHandlerGetsChunks) {
+    constexpr unsigned short kCmd = 0x51;
+    FragResult stResult;
+    ASSERT_EQ(cmdRegisterStream(&stCmdTable, kCmd, fragCollectHandler, &stResult), 0);
+    std::vector<unsigned char> vecPayload = makePattern(100000);
+
+    EXPECT_EQ(writeFrameFragmented(&stClnCtx, kCmd, 0, vecPayload.data(), vecPayload.size(), 8192), 13);
+    EXPECT_EQ(pump(pstClnBev, &stSvrCtx), 13);
+    EXPECT_EQ(stResult.iCalls, 13);
+    EXPECT_EQ(stResult.iLast, 1);
+    EXPECT_EQ(stResult.vecData, vecPayload);
+    EXPECT_EQ(stSvrCtx.puchReasm, nullptr);     /* 스트리밍 경로는 재조립 버퍼를 쓰지 않음 */
+}
+
+TEST_F(FragTest, ReassemblyLimitDropsTransfer) {
+    constexpr unsigned short kCmd = 0x52;
+    FragResult stResult;
+    ASSERT_EQ(cmdRegister(&stCmdTable, kCmd, CMD_ANY_SIZE, fragCollectHandler, &stResult), 0);
+    stSvrCtx.ulReasmLimit = 4096;
+
+    std::vector<unsigned char> vecBig = makePattern(10000);
+    ASSERT_GT(writeFrameFragmented(&stClnCtx, kCmd, 0, vecBig.data(), vecBig.size(), 1000), 0);
+    pump(pstClnBev, &stSvrCtx);
+    EXPECT_EQ(stResult.iCalls, 0);
+
+    /* 상한 이내의 다음 전송은 정상 처리 */
+    std::vector<unsigned char> vecSmall = makePattern(3000);
+    ASSERT_GT(writeFrameFragmented(&stClnCtx, kCmd, 0, vecSmall.data(), vecSmall.size(), 1000), 0);
+    pump(pstClnBev, &stSvrCtx);
+    EXPECT_EQ(stResult.iCalls, 1);
+    EXPECT_EQ(stResult.vecData, vecSmall);
+    frameCtxFree(&stSvrCtx);
+}
+
+static std::vector<unsigned int> s_vecTimeoutOrder;
+
+static void inflightOrderCb(int iStatus, const FRAME_VIEW*, void* pvUser) {
+    if (iStatus == INFLIGHT_TIMEOUT)
+        s_vecTimeoutOrder.push_back((unsigned int)(uintptr_t)pvUser);
+}
+
+/* 마감 시각이 섞여 등록돼도 이른 것부터 만료된다 */
+TEST_F(InflightTest, TimeoutsFireInDeadlineOrder) {
+    static const unsigned int auiTimeoutMs[] = { 50, 10, 40, 20, 70, 30, 60, 80 };
+    s_vecTimeoutOrder.clear();
+    for (unsigned int uiMs : auiTimeoutMs)
+        ASSERT_GT(inflightRequest(&stClnCtx, CMD_KEEP_ALIVE, 0, "k", 1, uiMs,
+                                  inflightOrderCb, (void*)(uintptr_t)uiMs), 0);
+    while (inflightPending(&stInflight) > 0)
+        event_base_loop(pstEventBase, EVLOOP_ONCE);
+    std::vector<unsigned int> vecSorted(std::begin(auiTimeoutMs), std::end(auiTimeoutMs));
+    std::sort(vecSorted.begin(), vecSorted.end());
+    EXPECT_EQ(s_vecTimeoutOrder, vecSorted);
+    EXPECT_EQ(stInflight.ulTimeoutCnt, 8u);
+}
+
+/* === 페이로드 압축 === */
+static std::vector<unsigned char> makeText(size_t ulSize) {
+    static const char* apchWord[] = { "frame ", "session ", "keepalive ", "ok\n" };
+    std::vector<unsigned char> vec;
+    for (size_t i = 0; vec.size() < ulSize; i++) {
+        const char* pchWord = apchWord[(i * 7 + i / 5) % 4];
+        vec.insert(vec.end(), pchWord, pchWord + strlen(pchWord));
+    }
+    vec.resize(ulSize);
+    return vec;
+}
+
+TEST(CompressTest, RoundTripAndCorruptInput) {
+    std::vector<unsigned char> vecSrc = makeText(5000);
+    std::vector<unsigned char> vecComp(compressBound(vecSrc.size()));
+    std::vector<unsigned char> vecOut(vecSrc.size());
+
+    size_t ulComp = compressLz4(vecSrc.data(), vecSrc.size(), vecComp.data(), vecComp.size());
+    ASSERT_GT(ulComp, 0u);
+    EXPECT_LT(ulComp, vecSrc.size() / 2);
+    EXPECT_EQ(decompressLz4(vecComp.data(), ulComp, vecOut.data(), vecOut.size()), (long)vecSrc.size());
+    EXPECT_EQ(vecOut, vecSrc);
+
+    /* 출력 공간 부족 → 0 (압축 이득 없음) */
+    EXPECT_EQ(compressLz4(vecSrc.data(), vecSrc.size(), vecComp.data(), 16), 0u);
+    /* 잘린 입력/작은 출력 버퍼는 경계 밖을 쓰지 않고 실패 */
+    EXPECT_EQ(decompressLz4(vecComp.data(), ulComp, vecOut.data(), vecOut.size() - 1), -1);
+    EXPECT_NE(decompressLz4(vecComp.data(), ulComp / 2, vecOut.data(), vecOut.size()), (long)vecSrc.size());
+    /* 무작위 입력 */
+    std::vector<unsigned char> vecJunk = makePattern(300);
+    long lRet = decompressLz4(vecJunk.data(), vecJunk.size(), vecOut.data(), vecOut.size());
+    EXPECT_LE(lRet, (long)vecOut.size());
+}
+
+using CompressFrameTest = InflightTest;
+
+TEST_F(CompressFrameTest, NegotiatedFramesAreCompressed) {
+    constexpr unsigned short kCmd = 0x53;
+    FragResult stResult;
+    ASSERT_EQ(cmdRegister(&stCmdTable, kCmd, CMD_ANY_SIZE, fragCollectHandler, &stResult), 0);
+    std::vector<unsigned char> vecPayload = makeText(4096);
+
+    /* 협상 전에는 그대로 보낸다 */
+    ASSERT_EQ(writeFrameCtx(&stClnCtx, kCmd, 0, vecPayload.data(), vecPayload.size()), 1);
+    EXPECT_EQ(stClnCtx.ulTxWireBytes, stClnCtx.ulTxRawBytes);
+    pump(pstClnBev, &stSvrCtx);
+
+    ASSERT_GT(frameNegotiate(&stClnCtx, FRAME_CAP_COMPRESS, 1000), 0);
+    EXPECT_EQ(pump(pstClnBev, &stSvrCtx), 1);
+    EXPECT_EQ(pump(pstSvrBev, &stClnCtx), 1);
+    EXPECT_EQ(stSvrCtx.uchActiveCaps, FRAME_CAP_COMPRESS);
+    EXPECT_EQ(stClnCtx.uchActiveCaps, FRAME_CAP_COMPRESS);
+
+    stResult.vecData.clear();
+    ASSERT_EQ(writeFrameCtx(&stClnCtx, kCmd, 0, vecPayload.data(), vecPayload.size()), 1);
+    EXPECT_LT(evbuffer_get_length(bufferevent_get_output(pstClnBev)), vecPayload.size() / 2);
+    EXPECT_EQ(pump(pstClnBev, &stSvrCtx), 1);
+    EXPECT_EQ(stResult.vecData, vecPayload);
+
+    /* 조각 오프셋은 압축 전 기준 */
+    FragResult stStream;
+    ASSERT_EQ(cmdRegisterStream(&stCmdTable, kCmd + 1, fragCollectHandler, &stStream), 0);
+    std::vector<unsigned char> vecLarge = makeText(50000);
+    ASSERT_EQ(writeFrameFragmented(&stClnCtx, kCmd + 1, 0, vecLarge.data(), vecLarge.size(), 8192), 7);
+    EXPECT_EQ(pump(pstClnBev, &stSvrCtx), 7);
+    EXPECT_EQ(stStream.vecData, vecLarge);
+    EXPECT_LT(stClnCtx.ulTxWireBytes, stClnCtx.ulTxRawBytes / 2);
+}
+
+TEST_F(CompressFrameTest, PeerWithoutCapStaysPlain) {
+    stSvrCtx.uchLocalCaps = 0;
+    ASSERT_GT(frameNegotiate(&stClnCtx, FRAME_CAP_COMPRESS, 1000), 0);
+    pump(pstClnBev, &stSvrCtx);
+    pump(pstSvrBev, &stClnCtx);
+    EXPECT_EQ(stClnCtx.uchActiveCaps, 0);
+    EXPECT_EQ(stSvrCtx.uchActiveCaps, 0);
+}
+
+/* 응답하지 않는 쪽은 상대가 모르는 기능을 켜지 않는다 */
+TEST_F(CompressFrameTest, UnansweredNegotiationStaysPlain) {
+    REQ_ID_CAPS stReq = { 0x01, FRAME_CAP_COMPRESS };
+    evbuffer* pstIn = evbuffer_new();
+    ASSERT_EQ(encodeFrame(pstIn, CMD_REQ_ID, &stClnCtx.stMsgId, 0, &stReq, sizeof(stReq)), 1);
+    EXPECT_EQ(responseFrame(pstIn, &stSvrCtx), 1);
+    EXPECT_EQ(evbuffer_get_length(bufferevent_get_output(pstSvrBev)), 0u);
+    EXPECT_EQ(stSvrCtx.uchActiveCaps, 0);
+
+    stSvrCtx.chReply = 1;
+    ASSERT_EQ(encodeFrame(pstIn, CMD_REQ_ID, &stClnCtx.stMsgId, 0, &stReq, sizeof(stReq)), 1);
+    EXPECT_EQ(responseFrame(pstIn, &stSvrCtx), 1);
+    EXPECT_EQ(stSvrCtx.uchActiveCaps, FRAME_CAP_COMPRESS);
+    evbuffer_free(pstIn);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,725 @@
+/**
+ * @file sessionGtest.cc
+ * @brief 세션 레지스트리(연결 리스트/상대 ID 인덱스), 유휴 타이머, 속도 제한, 카운터, 리스너 GoogleTest
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+#include <event2/event.h>
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <arpa/inet.h>
+#include <endian.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+extern "C" {
+#include "netModule/core/frame.h"
+#include "netModule/core/icdCommand.h"
+#include "netModule/protocols/commonSession.h"
+#include "netModule/protocols/netWorker.h"
+#include "netModule/protocols/netListener.h"
+#include "netModule/core/netUtil.h"
+}
+
+class SessionTest : public ::testing::Test {
+protected:
+    event_base* pstEventBase{};
+    CORE_CTX stCoreCtx;
+    std::vector<SESSION_CTX*> vecSession;
+
+    void SetUp() override {
+        pstEventBase = event_base_new();
+        sessionInitCore(&stCoreCtx, pstEventBase);
+    }
+
+    void TearDown() override {
+        for (SESSION_CTX* pstSession : vecSession) {
+            sessionRemove(pstSession);
+            sessionFreeState(pstSession);
+            bufferevent_free(pstSession->pstBufferEvent);
+            sessionRelease(pstSession);
+        }
+        sessionStopTimers(&stCoreCtx);
+        sessionFreeCore(&stCoreCtx);
+        event_base_free(pstEventBase);
+    }
+
+    SESSION_CTX* newSession() {
+        SESSION_CTX* pstSession = sessionAlloc(&stCoreCtx);
+        pstSession->pstBufferEvent = bufferevent_socket_new(pstEventBase, -1, 0);
+        evbuffer_unfreeze(bufferevent_get_output(pstSession->pstBufferEvent), 1);
+        sessionSetupFrame(pstSession);
+        sessionAdd(pstSession, &stCoreCtx);
+        vecSession.push_back(pstSession);
+        return pstSession;
+    }
+
+    /* 상대가 보낸 CMD_REQ_ID 를 세션에 입력 */
+    static void feedReqId(SESSION_CTX* pstSession, unsigned char uchPeerId) {
+        MSG_ID stMsgId = { uchPeerId, 0x01 };
+        REQ_ID stReq = { 0x01 };
+        evbuffer* pstIn = evbuffer_new();
+        ASSERT_EQ(encodeFrame(pstIn, CMD_REQ_ID, &stMsgId, 0, &stReq, sizeof(stReq)), 1);
+        EXPECT_EQ(responseFrame(pstIn, &pstSession->stFrameCtx), 1);
+        evbuffer_free(pstIn);
+    }
+};
+
+TEST_F(SessionTest, RemoveFromAnyPosition) {
+    SESSION_CTX* apstSession[4];
+    for (auto& pstSession : apstSession)
+        pstSession = newSession();
+    EXPECT_EQ(stCoreCtx.iClientCount, 4);
+
+    sessionRemove(apstSession[1]);      /* 중간 */
+    sessionRemove(apstSession[3]);      /* head */
+    sessionRemove(apstSession[3]);      /* 중복 제거는 무시 */
+    EXPECT_EQ(stCoreCtx.iClientCount, 2);
+
+    std::vector<SESSION_CTX*> vecOrder;
+    for (SESSION_CTX* pstIt = stCoreCtx.pstSockCtxHead; pstIt; pstIt = pstIt->pstSockCtxNext)
+        vecOrder.push_back(pstIt);
+    EXPECT_EQ(vecOrder, (std::vector<SESSION_CTX*>{ apstSession[2], apstSession[0] }));
+    EXPECT_EQ(apstSession[0]->pstSockCtxPrev, apstSession[2]);
+}
+
+TEST_F(SessionTest, PeerIdLearnedFromReqId) {
+    SESSION_CTX* pstA = newSession();
+    SESSION_CTX* pstB = newSession();
+    EXPECT_EQ(sessionFindByPeer(&stCoreCtx, 0x10), nullptr);
+
+    feedReqId(pstA, 0x10);
+    feedReqId(pstB, 0x20);
+    EXPECT_EQ(sessionFindByPeer(&stCoreCtx, 0x10), pstA);
+    EXPECT_EQ(sessionFindByPeer(&stCoreCtx, 0x20), pstB);
+
+    /* 같은 ID로 재접속하면 새 세션이 우선, 새 세션이 닫히면 이전 세션으로 돌아감 */
+    SESSION_CTX* pstC = newSession();
+    feedReqId(pstC, 0x10);
+    EXPECT_EQ(sessionFindByPeer(&stCoreCtx, 0x10), pstC);
+    sessionRemove(pstC);
+    EXPECT_EQ(sessionFindByPeer(&stCoreCtx, 0x10), pstA);
+
+    /* ID 변경 시 이전 버킷에서 빠진다 */
+    feedReqId(pstB, 0x30);
+    EXPECT_EQ(sessionFindByPeer(&stCoreCtx, 0x20), nullptr);
+    EXPECT_EQ(sessionFindByPeer(&stCoreCtx, 0x30), pstB);
+}
+
+TEST_F(SessionTest, PoolReusesReleasedSessions) {
+    SLAB_POOL* pstPool = &stCoreCtx.stSessionPool;
+    ASSERT_EQ(sessionPoolReserve(&stCoreCtx, 4), 0);
+    EXPECT_EQ(pstPool->ulCapacity, 4u);
+
+    std::vector<SESSION_CTX*> vecLocal;
+    for (int i = 0; i < 4; i++) {
+        SESSION_CTX* pstSession = sessionAlloc(&stCoreCtx);
+        ASSERT_NE(pstSession, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(pstSession) % SLAB_CACHE_LINE, 0u);
+        EXPECT_EQ(pstSession->pstCoreCtx, &stCoreCtx);
+        vecLocal.push_back(pstSession);
+    }
+    EXPECT_EQ(pstPool->ulHitCnt, 4u);
+    EXPECT_EQ(pstPool->ulMissCnt, 0u);
+
+    /* 미리 확보한 수를 넘으면 슬랩 확장 (miss) */
+    SESSION_CTX* pstExtra = sessionAlloc(&stCoreCtx);
+    ASSERT_NE(pstExtra, nullptr);
+    EXPECT_EQ(pstPool->ulMissCnt, 1u);
+    EXPECT_EQ(pstPool->ulCapacity, 4u + SLAB_OBJS_DEFAULT);
+
+    /* 반납한 객체는 0으로 초기화돼 다시 나간다 */
+    vecLocal[2]->chPeerKnown = 1;
+    sessionRelease(vecLocal[2]);
+    SESSION_CTX* pstReused = sessionAlloc(&stCoreCtx);
+    EXPECT_EQ(pstReused, vecLocal[2]);
+    EXPECT_EQ(pstReused->chPeerKnown, 0);
+    EXPECT_EQ(pstPool->ulInUse, 5u);
+
+    for (SESSION_CTX* pstSession : vecLocal)
+        sessionRelease(pstSession);
+    sessionRelease(pstExtra);
+    EXPECT_EQ(pstPool->ulInUse, 0u);
+}
+
+/* === 브로드캐스트: 한 번 인코딩한 버퍼를 세션들이 공유 === */
+TEST_F(SessionTest, BroadcastSharesOneEncodedFrame) {
+    SESSION_CTX* apstSession[3];
+    for (auto& pstSession : apstSession)
+        pstSession = newSession();
+    apstSession[2]->stFrameCtx.uchCrcMode = CRC_MODE_CRC16;
+    feedReqId(apstSession[1], 0x20);
+
+    std::vector<unsigned char> vecPayload(4096);
+    for (size_t i = 0; i < vecPayload.size(); i++)
+        vecPayload[i] = (unsigned char)(i * 7);
+    MSG_ID stMsgId = { 0x01, 0xFF };
+    FRAME_IOV stFrame = { CMD_IBIT, 3, vecPayload.data(), (int)vecPayload.size(), 0, 0, 0, 0 };
+    ASSERT_EQ(sessionBroadcast(&stCoreCtx, &stMsgId, &stFrame, nullptr, nullptr), 3);
+
+    /* 같은 체크섬 모드의 세션은 같은 메모리를 참조 */
+    evbuffer* apstOut[3];
+    evbuffer_iovec astVec[3];
+    for (int i = 0; i < 3; i++) {
+        apstOut[i] = bufferevent_get_output(apstSession[i]->pstBufferEvent);
+        ASSERT_EQ(evbuffer_peek(apstOut[i], -1, nullptr, &astVec[i], 1), 1);
+    }
+    EXPECT_EQ(astVec[0].iov_base, astVec[1].iov_base);
+    EXPECT_NE(astVec[0].iov_base, astVec[2].iov_base);
+
+    /* 바이트는 일반 인코딩과 같다 */
+    evbuffer* pstExpect = evbuffer_new();
+    ASSERT_EQ(encodeFrameBatch(pstExpect, CRC_MODE_XOR8, &stMsgId, &stFrame, 1), 1);
+    ASSERT_EQ(evbuffer_get_length(apstOut[0]), evbuffer_get_length(pstExpect));
+    EXPECT_EQ(memcmp(evbuffer_pullup(apstOut[0], -1), evbuffer_pullup(pstExpect, -1),
+                     evbuffer_get_length(pstExpect)), 0);
+    evbuffer_free(pstExpect);
+
+    /* 상대 ID 필터, 작은 프레임은 복사 */
+    for (evbuffer* pstOut : apstOut)
+        evbuffer_drain(pstOut, evbuffer_get_length(pstOut));
+    unsigned char uchPeer = 0x20;
+    stFrame.iDataLength = 16;
+    EXPECT_EQ(sessionBroadcast(&stCoreCtx, &stMsgId, &stFrame, sessionFilterPeer, &uchPeer), 1);
+    EXPECT_EQ(evbuffer_get_length(apstOut[0]), 0u);
+    EXPECT_GT(evbuffer_get_length(apstOut[1]), 16u);
+    EXPECT_EQ(evbuffer_get_length(apstOut[2]), 0u);
+}
+
+/* === 허브: 목적지 ID 로 등록된 세션에 프레임 전달 === */
+TEST_F(SessionTest, HubForwardsFramesByDestinationId) {
+    ASSERT_EQ(sessionEnableHub(&stCoreCtx, 0x01, nullptr), 0);
+    SESSION_CTX* pstA = newSession();
+    SESSION_CTX* pstB = newSession();
+    SESSION_CTX* pstC = newSession();
+    feedReqId(pstA, 0x10);
+    feedReqId(pstB, 0x20);
+    feedReqId(pstC, 0x30);
+    pstC->stFrameCtx.uchCrcMode = CRC_MODE_CRC16;
+
+    /* 같은 허브에 합친 다른 코어 (같은 event_base) */
+    CORE_CTX stUdsCore;
+    sessionInitCore(&stUdsCore, pstEventBase);
+    ASSERT_EQ(sessionEnableHub(&stUdsCore, 0x01, &stCoreCtx), 0);
+    SESSION_CTX* pstD = sessionAlloc(&stUdsCore);
+    pstD->pstBufferEvent = bufferevent_socket_new(pstEventBase, -1, 0);
+    evbuffer_unfreeze(bufferevent_get_output(pstD->pstBufferEvent), 1);
+    sessionSetupFrame(pstD);
+    sessionAdd(pstD, &stUdsCore);
+    feedReqId(pstD, 0x40);
+
+    evbuffer* pstOutA = bufferevent_get_output(pstA->pstBufferEvent);
+    auto sendFromA = [&](unsigned char uchDstId, unsigned char uchCrcMode, evbuffer* pstExpect) {
+        MSG_ID stMsgId = { 0x10, uchDstId };
+        REQ_IBIT stReq = { 0x01 };
+        FRAME_IOV stFrame = { CMD_IBIT, 2, &stReq, sizeof(stReq), 9, 0, 0, 0 };
+        evbuffer* pstIn = evbuffer_new();
+        ASSERT_EQ(encodeFrameBatch(pstIn, CRC_MODE_XOR8, &stMsgId, &stFrame, 1), 1);
+        if (pstExpect) {
+            ASSERT_EQ(encodeFrameBatch(pstExpect, uchCrcMode, &stMsgId, &stFrame, 1), 1);
+        }
+        EXPECT_EQ(responseFrame(pstIn, &pstA->stFrameCtx), 1);
+        EXPECT_EQ(evbuffer_get_length(pstIn), 0u);
+        evbuffer_free(pstIn);
+    };
+    auto sameBytes = [](evbuffer* pstOut, evbuffer* pstExpect) {
+        size_t ulLen = evbuffer_get_length(pstExpect);
+        bool bSame = evbuffer_get_length(pstOut) == ulLen &&
+            memcmp(evbuffer_pullup(pstOut, -1), evbuffer_pullup(pstExpect, -1), ulLen) == 0;
+        evbuffer_drain(pstOut, evbuffer_get_length(pstOut));
+        evbuffer_drain(pstExpect, ulLen);
+        return bSame;
+    };
+    evbuffer* pstExpect = evbuffer_new();
+
+    /* 같은 체크섬 모드: 바이트 그대로 이동, 보낸 쪽에는 응답하지 않음 */
+    sendFromA(0x20, CRC_MODE_XOR8, pstExpect);
+    EXPECT_TRUE(sameBytes(bufferevent_get_output(pstB->pstBufferEvent), pstExpect));
+    EXPECT_EQ(evbuffer_get_length(pstOutA), 0u);
+
+    /* 다른 체크섬 모드: 대상 모드로 다시 인코딩 */
+    sendFromA(0x30, CRC_MODE_CRC16, pstExpect);
+    EXPECT_TRUE(sameBytes(bufferevent_get_output(pstC->pstBufferEvent), pstExpect));
+
+    /* 합친 코어의 세션 */
+    sendFromA(0x40, CRC_MODE_XOR8, pstExpect);
+    EXPECT_TRUE(sameBytes(bufferevent_get_output(pstD->pstBufferEvent), pstExpect));
+    EXPECT_EQ(pstA->stFrameCtx.ulRoutedCnt, 3u);
+
+    /* 허브 ID, 등록되지 않은 ID: 직접 처리 (상관 ID 요청이므로 응답) */
+    sendFromA(0x01, CRC_MODE_XOR8, nullptr);
+    EXPECT_GT(evbuffer_get_length(pstOutA), 0u);
+    evbuffer_drain(pstOutA, evbuffer_get_length(pstOutA));
+    sendFromA(0x55, CRC_MODE_XOR8, nullptr);
+    EXPECT_GT(evbuffer_get_length(pstOutA), 0u);
+    EXPECT_EQ(pstA->stFrameCtx.ulRoutedCnt, 3u);
+    evbuffer_free(pstExpect);
+
+    sessionRemove(pstD);
+    sessionFreeState(pstD);
+    bufferevent_free(pstD->pstBufferEvent);
+    sessionRelease(pstD);
+    sessionFreeCore(&stUdsCore);
+    EXPECT_EQ(stCoreCtx.pstHubNext, nullptr);
+}
+
+/* === 느린 상대: 출력 버퍼 상한 도달 시 정책 적용, 하한에서 해제 === */
+TEST_F(SessionTest, SlowConsumerPolicies) {
+    std::vector<unsigned char> vecBig(2048, 0x5A);
+    ASSERT_EQ(sessionSetWriteLimit(&stCoreCtx, 1024, 256, SESSION_SLOW_PAUSE_READ, 0), 0);
+    SESSION_CTX* pstSession = newSession();
+    evbuffer* pstOut = bufferevent_get_output(pstSession->pstBufferEvent);
+    bufferevent_enable(pstSession->pstBufferEvent, EV_READ);
+
+    /* 읽기 중지 → 하한까지 빠지면 재개 */
+    ASSERT_EQ(writeFrameCtx(&pstSession->stFrameCtx, CMD_IBIT, 0, vecBig.data(), (int)vecBig.size()), 1);
+    EXPECT_EQ(pstSession->chSlow, 1);
+    EXPECT_FALSE(bufferevent_get_enabled(pstSession->pstBufferEvent) & EV_READ);
+    EXPECT_EQ(stCoreCtx.ulSlowPauseCnt, 1u);
+    evbuffer_drain(pstOut, evbuffer_get_length(pstOut) - 512);
+    EXPECT_EQ(pstSession->chSlow, 1);
+    evbuffer_drain(pstOut, 512);
+    EXPECT_EQ(pstSession->chSlow, 0);
+    EXPECT_TRUE(bufferevent_get_enabled(pstSession->pstBufferEvent) & EV_READ);
+
+    /* 저우선 폐기: 단발 프레임/브로드캐스트는 버리고 상관 ID 응답은 보낸다 */
+    ASSERT_EQ(sessionSetWriteLimit(&stCoreCtx, 1024, 256, SESSION_SLOW_DROP_LOW, 0), 0);
+    ASSERT_EQ(writeFrameCtx(&pstSession->stFrameCtx, CMD_IBIT, 0, vecBig.data(), (int)vecBig.size()), 1);
+    size_t ulQueued = evbuffer_get_length(pstOut);
+    EXPECT_EQ(writeFrameCtx(&pstSession->stFrameCtx, CMD_IBIT, 0, vecBig.data(), 16), 0);
+    MSG_ID stMsgId = { 0x01, 0xFF };
+    FRAME_IOV stFrame = { CMD_IBIT, 0, vecBig.data(), 16, 0, 0, 0, 0 };
+    EXPECT_EQ(sessionBroadcast(&stCoreCtx, &stMsgId, &stFrame, nullptr, nullptr), 0);
+    EXPECT_EQ(evbuffer_get_length(pstOut), ulQueued);
+    stFrame.uiSeq = 3;
+    stFrame.uchFlags = FRAME_FLAG_RESPONSE;
+    EXPECT_EQ(writeFrameIovCtx(&pstSession->stFrameCtx, &stFrame), 1);
+    evbuffer_drain(pstOut, evbuffer_get_length(pstOut));
+    EXPECT_EQ(pstSession->stFrameCtx.chTxShed, 0);
+    EXPECT_EQ(stCoreCtx.ulSlowDropCnt, 2u);
+
+    /* 유예 시간 안에 빠지지 않으면 종료 */
+    ASSERT_EQ(sessionSetWriteLimit(&stCoreCtx, 1024, 256, SESSION_SLOW_DISCONNECT, 200), 0);
+    ASSERT_EQ(writeFrameCtx(&pstSession->stFrameCtx, CMD_IBIT, 0, vecBig.data(), (int)vecBig.size()), 1);
+    timerWheelAdvance(&stCoreCtx.stTimerWheel, 1);
+    EXPECT_EQ(stCoreCtx.iClientCount, 1);
+    timerWheelAdvance(&stCoreCtx.stTimerWheel, 1);
+    EXPECT_EQ(stCoreCtx.ulSlowDisconnectCnt, 1u);
+    EXPECT_EQ(stCoreCtx.iClientCount, 0);
+    vecSession.clear();
+}
+
+/* === 프레임 속도 제한: 토큰이 떨어지면 읽기 중지, 느린 상대 중지와 함께 풀려야 재개 === */
+TEST_F(SessionTest, FrameRateLimitPausesRead) {
+    SESSION_RATE_LIMIT stLimit = {};
+    stLimit.ulReadRate   = 1 << 20;      /* 그룹 가입 확인용 */
+    stLimit.uiFrameRate  = 10;           /* 100ms 틱마다 1 프레임 */
+    stLimit.uiFrameBurst = 2;
+    ASSERT_EQ(sessionSetRateLimit(&stCoreCtx, &stLimit), 0);
+    ASSERT_EQ(sessionSetWriteLimit(&stCoreCtx, 1024, 256, SESSION_SLOW_PAUSE_READ, 0), 0);
+    SESSION_CTX* pstSession = newSession();
+    bufferevent_setcb(pstSession->pstBufferEvent, sessionReadCallback, nullptr, nullptr, pstSession);
+    bufferevent_enable(pstSession->pstBufferEvent, EV_READ);
+    EXPECT_NE(stCoreCtx.pstRateGroup, nullptr);
+
+    /* 요청 5개 입력: 버스트 2개만 처리 */
+    MSG_ID stMsgId = { 0x02, 0x01 };
+    REQ_KEEP_ALIVE stReq = { 0x01 };
+    evbuffer* pstIn = bufferevent_get_input(pstSession->pstBufferEvent);
+    evbuffer_unfreeze(pstIn, 0);
+    ASSERT_EQ(encodeFrame(pstIn, CMD_KEEP_ALIVE, &stMsgId, 0, &stReq, sizeof(stReq)), 1);
+    size_t ulFrameLen = evbuffer_get_length(pstIn);
+    for (int i = 0; i < 4; i++)
+        ASSERT_EQ(encodeFrame(pstIn, CMD_KEEP_ALIVE, &stMsgId, 0, &stReq, sizeof(stReq)), 1);
+    sessionReadCallback(pstSession->pstBufferEvent, pstSession);
+    EXPECT_EQ(evbuffer_get_length(pstIn), 3 * ulFrameLen);
+    EXPECT_EQ(pstSession->uchReadPause, SESSION_PAUSE_RATE);
+    EXPECT_FALSE(bufferevent_get_enabled(pstSession->pstBufferEvent) & EV_READ);
+    EXPECT_EQ(stCoreCtx.ulRateLimitedCnt, 1u);
+
+    /* 한 틱 뒤 재개 → 남은 입력에서 한 프레임 처리 후 다시 중지 */
+    timerWheelAdvance(&stCoreCtx.stTimerWheel, 1);
+    event_base_loop(pstEventBase, EVLOOP_NONBLOCK);
+    EXPECT_EQ(evbuffer_get_length(pstIn), 2 * ulFrameLen);
+    EXPECT_EQ(stCoreCtx.ulRateLimitedCnt, 2u);
+
+    /* 느린 상대로도 멈추면 토큰이 차도 출력이 빠질 때까지 읽지 않는다 */
+    std::vector<unsigned char> vecBig(2048, 0x5A);
+    evbuffer* pstOut = bufferevent_get_output(pstSession->pstBufferEvent);
+    ASSERT_EQ(writeFrameCtx(&pstSession->stFrameCtx, CMD_IBIT, 0, vecBig.data(), (int)vecBig.size()), 1);
+    EXPECT_EQ(pstSession->uchReadPause, SESSION_PAUSE_RATE | SESSION_PAUSE_SLOW);
+    timerWheelAdvance(&stCoreCtx.stTimerWheel, 1);
+    event_base_loop(pstEventBase, EVLOOP_NONBLOCK);
+    EXPECT_EQ(pstSession->uchReadPause, SESSION_PAUSE_SLOW);
+    EXPECT_FALSE(bufferevent_get_enabled(pstSession->pstBufferEvent) & EV_READ);
+    EXPECT_EQ(evbuffer_get_length(pstIn), 2 * ulFrameLen);
+
+    /* 출력이 빠지면 그동안 찬 토큰 하나로 한 프레임 처리 */
+    evbuffer_drain(pstOut, evbuffer_get_length(pstOut));
+    event_base_loop(pstEventBase, EVLOOP_NONBLOCK);
+    EXPECT_EQ(evbuffer_get_length(pstIn), ulFrameLen);
+    EXPECT_EQ(pstSession->uchReadPause, SESSION_PAUSE_RATE);
+    timerWheelAdvance(&stCoreCtx.stTimerWheel, 1);
+    event_base_loop(pstEventBase, EVLOOP_NONBLOCK);
+    EXPECT_TRUE(bufferevent_get_enabled(pstSession->pstBufferEvent) & EV_READ);
+    EXPECT_EQ(evbuffer_get_length(pstIn), 0u);
+
+    /* 해제: 그룹에서 빠지고 읽기 중지 없음 */
+    ASSERT_EQ(sessionSetRateLimit(&stCoreCtx, nullptr), 0);
+    EXPECT_EQ(stCoreCtx.pstRateGroup, nullptr);
+    EXPECT_EQ(pstSession->uchReadPause, 0);
+}
+
+/* === CMD_STATS: 세션/코어 카운터 스냅샷 (종료된 세션은 코어 누계에 남는다) === */
+TEST_F(SessionTest, StatsCommandReturnsSnapshot) {
+    SESSION_CTX* pstGone = newSession();
+    SESSION_CTX* pstSession = newSession();
+    MSG_ID stMsgId = { 0x02, 0x01 };
+    REQ_KEEP_ALIVE stReq = { 0x01 };
+    evbuffer* pstIn = evbuffer_new();
+
+    /* 종료될 세션: 요청 1개 처리 후 레지스트리에서 제거 */
+    ASSERT_EQ(encodeFrame(pstIn, CMD_KEEP_ALIVE, &stMsgId, 0, &stReq, sizeof(stReq)), 1);
+    size_t ulFrameLen = evbuffer_get_length(pstIn);
+    EXPECT_EQ(responseFrame(pstIn, &pstGone->stFrameCtx), 1);
+    sessionRemove(pstGone);
+
+    /* CRC 가 깨진 프레임 하나 + 정상 요청 2개 (상관 ID 없는 단발이므로 응답 없음) */
+    ASSERT_EQ(encodeFrame(pstIn, CMD_KEEP_ALIVE, &stMsgId, 0, &stReq, sizeof(stReq)), 1);
+    unsigned char* puchFrame = evbuffer_pullup(pstIn, -1);
+    puchFrame[ulFrameLen - 3] ^= 0xFF;
+    for (int i = 0; i < 2; i++)
+        ASSERT_EQ(encodeFrame(pstIn, CMD_KEEP_ALIVE, &stMsgId, 0, &stReq, sizeof(stReq)), 1);
+    while (responseFrame(pstIn, &pstSession->stFrameCtx) == 1)
+        ;
+    EXPECT_EQ(pstSession->stFrameCtx.ulRxFrameCnt, 2u);
+    EXPECT_EQ(pstSession->stFrameCtx.ulRxBytes, 2 * ulFrameLen);
+    EXPECT_EQ(pstSession->stFrameCtx.uiCrcErrCnt, 1u);
+
+    SESSION_STATS stCore;
+    EXPECT_EQ(sessionCoreStats(&stCoreCtx, &stCore), 1);
+    EXPECT_EQ(stCore.ulRxFrames, 3u);
+    EXPECT_EQ(stCore.ulCrcErr, 1u);
+
+    /* 상관 ID가 있는 CMD_STATS 요청 → RES_STATS 응답 */
+    evbuffer* pstOut = bufferevent_get_output(pstSession->pstBufferEvent);
+    evbuffer_drain(pstOut, evbuffer_get_length(pstOut));
+    REQ_STATS stStatsReq = { 0x01 };
+    FRAME_IOV stFrame = { CMD_STATS, 0, &stStatsReq, sizeof(stStatsReq), 7, 0, 0, 0 };
+    ASSERT_EQ(encodeFrameBatch(pstIn, CRC_MODE_XOR8, &stMsgId, &stFrame, 1), 1);
+    EXPECT_EQ(responseFrame(pstIn, &pstSession->stFrameCtx), 1);
+
+    size_t ulHeader = sizeof(FRAME_HEADER) + sizeof(FRAME_HEADER_EXT);
+    ASSERT_GE(evbuffer_get_length(pstOut), ulHeader + sizeof(RES_STATS));
+    EXPECT_EQ(pstSession->stFrameCtx.ulTxFrameCnt, 1u);
+    EXPECT_EQ(pstSession->stFrameCtx.ulTxBytes, evbuffer_get_length(pstOut));
+    RES_STATS stRes;
+    evbuffer_drain(pstOut, ulHeader);
+    evbuffer_remove(pstOut, &stRes, sizeof(stRes));
+    EXPECT_EQ(stRes.uchVersion, STATS_VERSION);
+    EXPECT_EQ(ntohl(stRes.uiSessions), 1u);
+    EXPECT_EQ(be64toh(stRes.stSession.ulRxFrames), 3u);
+    EXPECT_EQ(be64toh(stRes.stSession.ulTxFrames), 0u);   /* 응답 직전 시점 */
+    EXPECT_EQ(be64toh(stRes.stSession.ulCrcErr), 1u);
+    EXPECT_EQ(be64toh(stRes.stCore.ulRxFrames), 4u);
+    EXPECT_GE(be64toh(stRes.stCore.ulHandlerMaxNs), 1u);
+
+    evbuffer_free(pstIn);
+    sessionFreeState(pstGone);
+    bufferevent_free(pstGone->pstBufferEvent);
+    sessionRelease(pstGone);
+    vecSession.erase(vecSession.begin());
+}
+
+/* === 타이머 휠: 단 경계를 넘는 타이머도 정확한 틱에 만료 === */
+/* 만료 시점의 휠 틱을 기록 */
+static TIMER_WHEEL* s_pstWheel;
+static void recordExpiry(TIMER_NODE* pstNode, void* pvUser) {
+    (void)pstNode;
+    static_cast<std::vector<uint64_t>*>(pvUser)->push_back(s_pstWheel->ulCurTick);
+}
+
+TEST(TimerWheelTest, ExpiresOnExactTickAcrossLevels) {
+    TIMER_WHEEL stWheel;
+    ASSERT_EQ(timerWheelInit(&stWheel, nullptr, 1), 0);
+
+    const unsigned int auiTimeout[] = { 1, 63, 64, 65, 4095, 4096, 5000, 300000 };
+    TIMER_NODE astNode[8] = {};
+    std::vector<uint64_t> vecTick;
+    s_pstWheel = &stWheel;
+    for (int i = 0; i < 8; i++)
+        timerWheelAdd(&stWheel, &astNode[i], auiTimeout[i], recordExpiry, &vecTick);
+    EXPECT_EQ(stWheel.ulCount, 8u);
+
+    /* 취소와 재예약(이동) */
+    timerWheelCancel(&stWheel, &astNode[3]);
+    timerWheelAdd(&stWheel, &astNode[0], 10, recordExpiry, &vecTick);
+    EXPECT_FALSE(timerPending(&astNode[3]));
+
+    timerWheelAdvance(&stWheel, 300000);
+    EXPECT_EQ(vecTick, (std::vector<uint64_t>{ 10, 63, 64, 4095, 4096, 5000, 300000 }));
+    EXPECT_EQ(stWheel.ulCount, 0u);
+    timerWheelFree(&stWheel);
+}
+
+TEST_F(SessionTest, IdleSessionGetsKeepAliveThenReaped) {
+    ASSERT_EQ(sessionEnableIdleTimer(&stCoreCtx, 300, 1000), 0);
+    SESSION_CTX* pstQuiet = newSession();
+    SESSION_CTX* pstBusy  = newSession();
+    evbuffer* pstQuietOut = bufferevent_get_output(pstQuiet->pstBufferEvent);
+
+    /* 300ms: 둘 다 조용하므로 상관 ID가 있는 KEEP_ALIVE 확인 */
+    timerWheelAdvance(&stCoreCtx.stTimerWheel, 3);
+    EXPECT_EQ(stCoreCtx.ulKeepAliveCnt, 2u);
+    ASSERT_GE(evbuffer_get_length(pstQuietOut), sizeof(FRAME_HEADER) + sizeof(FRAME_HEADER_EXT));
+    FRAME_HEADER stHeader;
+    FRAME_HEADER_EXT stExt;
+    evbuffer_copyout(pstQuietOut, &stHeader, sizeof(stHeader));
+    evbuffer_drain(pstQuietOut, sizeof(stHeader));
+    evbuffer_copyout(pstQuietOut, &stExt, sizeof(stExt));
+    EXPECT_EQ(ntohs(stHeader.unCmd), CMD_KEEP_ALIVE);
+    EXPECT_EQ(ntohl(stExt.uiSeq), SESSION_KEEPALIVE_SEQ);
+    EXPECT_FALSE(stExt.uchFlags & FRAME_FLAG_RESPONSE);
+
+    /* 500ms: 확인 응답 수신 → 유휴 시간 초기화, 응답에는 다시 응답하지 않음 */
+    timerWheelAdvance(&stCoreCtx.stTimerWheel, 2);
+    MSG_ID stMsgId = { 0x02, 0x01 };
+    RES_KEEP_ALIVE stRes = { 0x01 };
+    FRAME_IOV stFrame = { CMD_KEEP_ALIVE, 0, &stRes, sizeof(stRes), SESSION_KEEPALIVE_SEQ,
+                          FRAME_FLAG_RESPONSE, 0, 0 };
+    evbuffer* pstBusyIn = bufferevent_get_input(pstBusy->pstBufferEvent);
+    evbuffer_unfreeze(pstBusyIn, 0);
+    ASSERT_EQ(encodeFrameBatch(pstBusyIn, CRC_MODE_XOR8, &stMsgId, &stFrame, 1), 1);
+    evbuffer* pstBusyOut = bufferevent_get_output(pstBusy->pstBufferEvent);
+    size_t ulBusyOut = evbuffer_get_length(pstBusyOut);
+    sessionReadCallback(pstBusy->pstBufferEvent, pstBusy);
+    EXPECT_EQ(evbuffer_get_length(pstBusyOut), ulBusyOut);
+
+    /* 800ms: 수신 300ms 뒤 다시 확인, 1000ms: 조용한 세션만 종료 */
+    timerWheelAdvance(&stCoreCtx.stTimerWheel, 5);
+    vecSession.erase(vecSession.begin());
+    EXPECT_EQ(stCoreCtx.ulIdleReapCnt, 1u);
+    EXPECT_EQ(stCoreCtx.iClientCount, 1);
+    EXPECT_EQ(stCoreCtx.pstSockCtxHead, pstBusy);
+    EXPECT_EQ(stCoreCtx.ulKeepAliveCnt, 3u);
+
+    /* 1500ms: 수신 1000ms 뒤 종료 */
+    timerWheelAdvance(&stCoreCtx.stTimerWheel, 4);
+    EXPECT_EQ(stCoreCtx.iClientCount, 1);
+    timerWheelAdvance(&stCoreCtx.stTimerWheel, 1);
+    EXPECT_EQ(stCoreCtx.ulIdleReapCnt, 2u);
+    EXPECT_EQ(stCoreCtx.iClientCount, 0);
+    vecSession.clear();
+}
+
+/* === 워커 스레드: 넘겨받은 fd 를 워커 event_base 에서 처리 === */
+static void workerOpenSession(NET_WORKER* pstWorker, evutil_socket_t fd) {
+    SESSION_CTX* pstSession = sessionAlloc(&pstWorker->stCoreCtx);
+    pstSession->pstBufferEvent = bufferevent_socket_new(pstWorker->stCoreCtx.pstEventBase, fd,
+                                                        BEV_OPT_CLOSE_ON_FREE);
+    bufferevent_setcb(pstSession->pstBufferEvent, sessionReadCallback, NULL, sessionEventCallback, pstSession);
+    sessionSetupFrame(pstSession);
+    bufferevent_enable(pstSession->pstBufferEvent, EV_READ | EV_WRITE);
+    sessionAdd(pstSession, &pstWorker->stCoreCtx);
+}
+
+TEST(NetWorkerTest, HandoffServesSessionOnWorker) {
+    event_base* pstEventBase = event_base_new();
+    CORE_CTX stTemplate;
+    sessionInitCore(&stTemplate, pstEventBase);
+
+    NET_WORKER stWorker;
+    ASSERT_EQ(netWorkerInit(&stWorker, 0, &stTemplate, 4, workerOpenSession, nullptr), 0);
+    EXPECT_EQ(stWorker.stCoreCtx.pstCmdTable, &stTemplate.stCmdTable);
+    ASSERT_EQ(netWorkerStart(&stWorker), 0);
+
+    int aiSock[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, aiSock), 0);
+    ASSERT_EQ(netWorkerHandoff(&stWorker, aiSock[1]), 0);
+
+    /* 상관 ID가 있는 요청 → 워커 스레드가 응답 */
+    MSG_ID stMsgId = { 0x02, 0x01 };
+    REQ_KEEP_ALIVE stReq = { 0x01 };
+    FRAME_IOV stFrame = { CMD_KEEP_ALIVE, 0, &stReq, sizeof(stReq), 7, 0, 0, 0 };
+    evbuffer* pstOut = evbuffer_new();
+    ASSERT_EQ(encodeFrameBatch(pstOut, CRC_MODE_XOR8, &stMsgId, &stFrame, 1), 1);
+    std::vector<unsigned char> vecReq(evbuffer_get_length(pstOut));
+    evbuffer_remove(pstOut, vecReq.data(), vecReq.size());
+    evbuffer_free(pstOut);
+    ASSERT_EQ(write(aiSock[0], vecReq.data(), vecReq.size()), (ssize_t)vecReq.size());
+
+    pollfd stPoll = { aiSock[0], POLLIN, 0 };
+    ASSERT_EQ(poll(&stPoll, 1, 2000), 1);
+    unsigned char auchRes[64];
+    ASSERT_GE(read(aiSock[0], auchRes, sizeof(auchRes)), (ssize_t)(sizeof(FRAME_HEADER) + sizeof(FRAME_HEADER_EXT)));
+    FRAME_HEADER_EXT stExt;
+    memcpy(&stExt, auchRes + sizeof(FRAME_HEADER), sizeof(stExt));
+    EXPECT_TRUE(stExt.uchFlags & FRAME_FLAG_RESPONSE);
+    EXPECT_EQ(ntohl(stExt.uiSeq), 7u);
+    EXPECT_EQ(netWorkerLoad(&stWorker), 1);
+
+    netWorkerFree(&stWorker);
+    close(aiSock[0]);
+    sessionFreeCore(&stTemplate);
+    event_base_free(pstEventBase);
+}
+
+/* 워커가 파이프를 비우지 못해도 넘기는 쪽은 막히지 않고 -1 을 받는다 */
+TEST(NetWorkerTest, HandoffFailsWithoutBlockingWhenPipeIsFull) {
+    event_base* pstEventBase = event_base_new();
+    CORE_CTX stTemplate;
+    sessionInitCore(&stTemplate, pstEventBase);
+
+    NET_WORKER stWorker;
+    ASSERT_EQ(netWorkerInit(&stWorker, 0, &stTemplate, 0, workerOpenSession, nullptr), 0);
+
+    /* 스레드를 시작하지 않아 아무도 읽지 않는다. 해제 때 close 해도 무해한 범위 밖 fd 값을 쓴다 */
+    const int iBogusFd = 1 << 24;
+    int iQueued = 0;
+    while (netWorkerHandoff(&stWorker, iBogusFd) == 0)
+        ASSERT_LT(++iQueued, 1 << 20);
+    EXPECT_GT(iQueued, 0);
+    EXPECT_EQ(netWorkerLoad(&stWorker), iQueued);
+
+    netWorkerFree(&stWorker);
+    sessionFreeCore(&stTemplate);
+    event_base_free(pstEventBase);
+}
+
+TEST(NetWorkerTest, ReusePortListenersShareAPort) {
+    int iFirst = createTcpServerOpt(0, 1);
+    ASSERT_GE(iFirst, 0);
+    sockaddr_in stAddr{};
+    socklen_t len = sizeof(stAddr);
+    ASSERT_EQ(getsockname(iFirst, (sockaddr*)&stAddr, &len), 0);
+    unsigned short unPort = ntohs(stAddr.sin_port);
+
+    int iSecond = createTcpServerOpt(unPort, 1);
+    EXPECT_GE(iSecond, 0);
+    EXPECT_LT(createTcpServerOpt(unPort, 0), 0);    /* SO_REUSEPORT 없으면 bind 실패 */
+
+    close(iFirst);
+    if (iSecond >= 0)
+        close(iSecond);
+}
+
+/* ================================================================
+ * 공용 리스너: 한 번 깨어나 backlog 일괄 수락, fd 부족 시 대기 후 재개
+ * ================================================================ */
+static void listenerCollect(NET_LISTENER*, evutil_socket_t fd, sockaddr*, socklen_t, void* pvUser) {
+    static_cast<std::vector<int>*>(pvUser)->push_back(fd);
+}
+
+static unsigned short boundPort(int iFd) {
+    sockaddr_in stAddr{};
+    socklen_t len = sizeof(stAddr);
+    getsockname(iFd, (sockaddr*)&stAddr, &len);
+    return ntohs(stAddr.sin_port);
+}
+
+TEST(NetListenerTest, DrainsBacklogWithinBudget) {
+    event_base* pstEventBase = event_base_new();
+    std::vector<int> vecAccepted;
+    std::vector<int> vecClient;
+
+    /* TCP: 10개 대기, 예산 4 -> 한 번 깨어날 때 4개 */
+    int iTcpFd = createTcpServer(0);
+    ASSERT_GE(iTcpFd, 0);
+    unsigned short unPort = boundPort(iTcpFd);
+    NET_LISTENER* pstTcp = netListenerNew(pstEventBase, iTcpFd, 4, listenerCollect, &vecAccepted);
+    ASSERT_NE(pstTcp, nullptr);
+    for (int i = 0; i < 10; i++)
+        vecClient.push_back(createTcpClient("127.0.0.1", unPort));
+    usleep(20000);
+    event_base_loop(pstEventBase, EVLOOP_ONCE);
+    EXPECT_EQ(pstTcp->ulWakeCnt, 1u);
+    EXPECT_EQ(vecAccepted.size(), 4u);
+    EXPECT_EQ(pstTcp->ulMaxBatch, 4u);
+    while (vecAccepted.size() < 10 && pstTcp->ulWakeCnt < 10)
+        event_base_loop(pstEventBase, EVLOOP_ONCE);
+    EXPECT_EQ(pstTcp->ulAcceptCnt, 10u);
+    EXPECT_EQ(pstTcp->ulWakeCnt, 3u);
+    for (int fd : vecAccepted)
+        EXPECT_NE(fcntl(fd, F_GETFL) & O_NONBLOCK, 0);
+
+    /* UDS: 기본 예산이면 한 번에 전부 */
+    const char* pchPath = "/tmp/netListenerGtest.sock";
+    int iUdsFd = createUdsServer(pchPath);
+    ASSERT_GE(iUdsFd, 0);
+    vecAccepted.clear();
+    NET_LISTENER* pstUds = netListenerNew(pstEventBase, iUdsFd, 0, listenerCollect, &vecAccepted);
+    ASSERT_NE(pstUds, nullptr);
+    for (int i = 0; i < 8; i++)
+        vecClient.push_back(createUdsClient(pchPath));
+    event_base_loop(pstEventBase, EVLOOP_ONCE);
+    EXPECT_EQ(pstUds->ulWakeCnt, 1u);
+    EXPECT_EQ(pstUds->ulAcceptCnt, 8u);
+    EXPECT_EQ(pstUds->ulMaxBatch, 8u);
+
+    for (int fd : vecClient)
+        close(fd);
+    netListenerFree(pstTcp);
+    netListenerFree(pstUds);
+    unlink(pchPath);
+    event_base_free(pstEventBase);
+}
+
+TEST(NetListenerTest, BacksOffWhenOutOfDescriptors) {
+    event_base* pstEventBase = event_base_new();
+    std::vector<int> vecAccepted;
+    int iListenFd = createTcpServer(0);
+    ASSERT_GE(iListenFd, 0);
+    unsigned short unPort = boundPort(iListenFd);
+    NET_LISTENER* pstListener = netListenerNew(pstEventBase, iListenFd, 0, listenerCollect, &vecAccepted);
+    ASSERT_NE(pstListener, nullptr);
+    int iClient = createTcpClient("127.0.0.1", unPort);
+    ASSERT_GE(iClient, 0);
+    usleep(20000);
+
+    /* 남은 fd 를 모두 채워 accept4 가 EMFILE 을 내게 한다 */
+    rlimit stOld{};
+    getrlimit(RLIMIT_NOFILE, &stOld);
+    rlimit stLow = stOld;
+    stLow.rlim_cur = 256;
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &stLow), 0);
+    std::vector<int> vecFiller;
+    for (int fd; (fd = dup(0)) >= 0; )
+        vecFiller.push_back(fd);
+
+    event_base_loop(pstEventBase, EVLOOP_ONCE);
+    EXPECT_EQ(pstListener->ulBackoffCnt, 1u);
+    EXPECT_EQ(pstListener->ulAcceptCnt, 0u);
+    EXPECT_EQ(pstListener->uiBackoffMs, (unsigned int)NET_LISTENER_BACKOFF_MS);
+    /* 리슨 이벤트가 내려가 있으므로 대기 중에 다시 깨어나지 않는다 */
+    EXPECT_FALSE(event_pending(pstListener->pstEvent, EV_READ, nullptr));
+    EXPECT_TRUE(event_pending(pstListener->pstBackoffEvent, EV_TIMEOUT, nullptr));
+
+    /* 커널은 큐를 보기 전에 fd 를 잡으므로 수락 1개 + 빈 큐 확인용 1개를 비운다 */
+    for (int i = 0; i < 2; i++) {
+        close(vecFiller.back());
+        vecFiller.pop_back();
+    }
+    event_base_loop(pstEventBase, EVLOOP_ONCE);     /* 대기 타이머 -> 재개 후 수락 */
+    EXPECT_EQ(pstListener->ulAcceptCnt, 1u);
+    EXPECT_EQ(pstListener->uiBackoffMs, 0u);
+    EXPECT_TRUE(event_pending(pstListener->pstEvent, EV_READ, nullptr));
+
+    for (int fd : vecFiller)
+        close(fd);
+    setrlimit(RLIMIT_NOFILE, &stOld);
+    for (int fd : vecAccepted)
+        close(fd);
+    close(iClient);
+    netListenerFree(pstListener);
+    event_base_free(pstEventBase);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -31,7 +31,7 @@ protected:
         pstSvrEventBase = event_base_new();
         pstClnEventBase = event_base_new();
         ASSERT_NE(pstSvrEventBase, nullptr);
-        tcpSvrInit(&stTcpSvr, pstSvrEventBase, 0x01, TCP_SERVER);
+        tcpSvrInit(&stTcpSvr, pstSvrEventBase, 0x01, TCP_SERVER, 0);
         tcpClnInit(&stTcpCln, pstClnEventBase, 0x02, TCP_CLIENT);
     }
 
@@ -1,57 +1,519 @@
+/**
+ * @file udpSvrGtest.cc
+ * @brief UDP 데이터그램 전송(recvmmsg/sendmmsg 배치), 상대 세션 테이블, 신뢰 전송 GoogleTest
+ */
+
 #include <gtest/gtest.h>
-#include <thread>
-#include <chrono>
 #include <cstring>
+#include <vector>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <event2/event.h>
 
-
 extern "C" {
 #include "netModule/protocols/netContext.h"
 #include "netModule/protocols/udp.h"
+#include "netModule/protocols/udpPeer.h"
+#include "netModule/protocols/udpReliable.h"
+#include "netModule/core/frame.h"
+#include "netModule/core/icdCommand.h"
+#include "netModule/core/inflight.h"
 }
-   
-
-using namespace std::chrono_literals;
 
 class UdpTest : public ::testing::Test {
 protected:
     event_base* base{};
-    UDP_CTX server{};
+    UDP_CTX server;
+    unsigned short unPort{};
 
     void SetUp() override {
         base = event_base_new();
         ASSERT_NE(base, nullptr);
-        udpInit(&server, base, 0x10, NET_MODE_SERVER);
+        udpInit(&server, base, 0x10, UDP_MODE);
+        ASSERT_EQ(udpServerStart(&server, 0), 0);
+        sockaddr_in stAddr{};
+        socklen_t len = sizeof(stAddr);
+        getsockname(server.stNetBase.iSockFd, (sockaddr*)&stAddr, &len);
+        unPort = ntohs(stAddr.sin_port);
     }
 
     void TearDown() override {
         udpStop(&server);
         if (base) event_base_free(base);
     }
+
+    void runFor(int iMs) {
+        timeval stTv = { 0, iMs * 1000 };
+        event_base_loopexit(base, &stTv);
+        event_base_dispatch(base);
+    }
 };
 
-TEST_F(UdpTest, ServerBindAndSendFromClient) {
-    constexpr unsigned short kPort = 40002;
-    ASSERT_EQ(udpServerStart(&server, kPort), 0);
-    std::thread loop([this] { event_base_dispatch(base); });
-    std::this_thread::sleep_for(100ms);
-
-    int sock = socket(AF_INET, SOCK_DGRAM, 0);
-    ASSERT_GE(sock, 0);
-    sockaddr_in dst{};
-    dst.sin_family = AF_INET;
-    dst.sin_port = htons(kPort);
-    inet_pton(AF_INET, "127.0.0.1", &dst.sin_addr);
-
-    const char* msg = "udp-test";
-    ssize_t n = sendto(sock, msg, strlen(msg), 0, (sockaddr*)&dst, sizeof(dst));
-    EXPECT_GT(n, 0);
-    close(sock);
-
-    event_base_loopexit(base, nullptr);
-    loop.join();
+static void countDone(int iStatus, const FRAME_VIEW*, void* pvUser) {
+    if (iStatus == INFLIGHT_DONE)
+        (*static_cast<int*>(pvUser))++;
+}
+
+TEST_F(UdpTest, PipelinedRequestsAreBatched) {
+    UDP_CTX client;
+    udpInit(&client, base, 0x20, UDP_MODE);
+    ASSERT_EQ(udpClientStart(&client, "127.0.0.1", unPort, 0), 0);
+
+    /* 한 번에 쌓은 요청은 루프 끝에서 sendmmsg 로 나가고, 서버도 배치로 받아 배치로 응답 */
+    const int kCount = 64;
+    int iDone = 0;
+    REQ_KEEP_ALIVE stReq = { 0x01 };
+    for (int i = 0; i < kCount; i++)
+        ASSERT_GT(inflightRequest(&client.stSession.stFrameCtx, CMD_KEEP_ALIVE, 0,
+            &stReq, sizeof(stReq), 1000, countDone, &iDone), 0);
+    EXPECT_EQ(client.ulTxDgramCnt, 0u);      /* 루프가 돌 때까지는 쌓이기만 한다 */
+    runFor(100);
+
+    EXPECT_EQ(iDone, kCount);
+    EXPECT_EQ(client.ulTxDgramCnt, (unsigned long)kCount);
+    EXPECT_LE(client.ulTxBatchCnt, 3u);
+    EXPECT_EQ(server.ulRxDgramCnt, (unsigned long)kCount);
+    EXPECT_LT(server.ulRxBatchCnt, (unsigned long)kCount);
+    EXPECT_GT(server.ulRxMaxBatch, 1u);
+    EXPECT_EQ(server.ulTxDgramCnt, (unsigned long)kCount);
+    EXPECT_LT(server.ulTxBatchCnt, (unsigned long)kCount);
+    EXPECT_EQ(server.stSession.stFrameCtx.ulRxFrameCnt, (unsigned long)kCount);
+
+    udpStop(&client);
+}
+
+TEST_F(UdpTest, OneFramePerDatagramAndBadDatagramsDropped) {
+    int iSock = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(iSock, 0);
+    sockaddr_in stDst{};
+    stDst.sin_family = AF_INET;
+    stDst.sin_port = htons(unPort);
+    inet_pton(AF_INET, "127.0.0.1", &stDst.sin_addr);
+
+    /* 프레임 하나를 두 데이터그램으로 나누면 어느 쪽도 프레임이 아니다 */
+    evbuffer* pstFrame = evbuffer_new();
+    MSG_ID stMsgId = { 0x20, 0x10 };
+    REQ_KEEP_ALIVE stReq = { 0x01 };
+    FRAME_IOV stIov = { CMD_KEEP_ALIVE, 0, &stReq, sizeof(stReq), 7, 0, 0, 0 };
+    ASSERT_EQ(encodeFrameBatch(pstFrame, CRC_MODE_XOR8, &stMsgId, &stIov, 1), 1);
+    std::vector<unsigned char> vecFrame(evbuffer_get_length(pstFrame));
+    evbuffer_remove(pstFrame, vecFrame.data(), vecFrame.size());
+    evbuffer_free(pstFrame);
+
+    size_t ulHalf = vecFrame.size() / 2;
+    sendto(iSock, vecFrame.data(), ulHalf, 0, (sockaddr*)&stDst, sizeof(stDst));
+    sendto(iSock, vecFrame.data() + ulHalf, vecFrame.size() - ulHalf, 0, (sockaddr*)&stDst, sizeof(stDst));
+    std::vector<unsigned char> vecBig(UDP_SLOT_SIZE_DEFAULT + 100, 0xAB);    /* 슬롯보다 큰 데이터그램 */
+    sendto(iSock, vecBig.data(), vecBig.size(), 0, (sockaddr*)&stDst, sizeof(stDst));
+    sendto(iSock, vecFrame.data(), vecFrame.size(), 0, (sockaddr*)&stDst, sizeof(stDst));
+    runFor(50);
+
+    EXPECT_EQ(server.ulRxDgramCnt, 4u);
+    EXPECT_EQ(server.ulRxDropCnt, 3u);
+    EXPECT_EQ(server.stSession.stFrameCtx.ulRxFrameCnt, 1u);
+
+    /* 응답은 보낸 주소로 */
+    unsigned char auchReply[256];
+    ssize_t lRecv = recv(iSock, auchReply, sizeof(auchReply), MSG_DONTWAIT);
+    ASSERT_GT(lRecv, (ssize_t)(sizeof(FRAME_HEADER) + sizeof(FRAME_HEADER_EXT)));
+    FRAME_HEADER_EXT stExt;
+    memcpy(&stExt, auchReply + sizeof(FRAME_HEADER), sizeof(stExt));
+    EXPECT_EQ(ntohl(stExt.uiSeq), 7u);
+    EXPECT_TRUE(stExt.uchFlags & FRAME_FLAG_RESPONSE);
+    EXPECT_LT(recv(iSock, auchReply, sizeof(auchReply), MSG_DONTWAIT), 0);
+    close(iSock);
+}
+
+TEST(UdpOffloadTest, GsoSlotsSplitBackIntoFrames) {
+    event_base* base = event_base_new();
+    UDP_CTX server, client;
+    udpInit(&server, base, 0x10, UDP_MODE);
+    udpInit(&client, base, 0x20, UDP_MODE);
+    udpSetOffload(&server, UDP_OFFLOAD_GRO);
+    udpSetOffload(&client, UDP_OFFLOAD_GSO);
+    ASSERT_EQ(udpServerStart(&server, 0), 0);
+    EXPECT_EQ(udpSetOffload(&server, 0), -1);       /* 시작 후에는 바꿀 수 없다 */
+    sockaddr_in stAddr{};
+    socklen_t len = sizeof(stAddr);
+    getsockname(server.stNetBase.iSockFd, (sockaddr*)&stAddr, &len);
+    ASSERT_EQ(udpClientStart(&client, "127.0.0.1", ntohs(stAddr.sin_port), 0), 0);
+    if (client.uchOffloadActive != UDP_OFFLOAD_GSO || server.uchOffloadActive != UDP_OFFLOAD_GRO) {
+        udpStop(&client);
+        udpStop(&server);
+        event_base_free(base);
+        GTEST_SKIP() << "kernel without UDP_SEGMENT/UDP_GRO";
+    }
+
+    /* 같은 크기 20개 + 짧은 1개는 한 슬롯 (짧은 프레임이 마지막 세그먼트), 그 뒤 1개는 새 슬롯 */
+    std::vector<unsigned char> vecPayload(100, 0x5A);
+    FRAME_IOV stFull = { CMD_KEEP_ALIVE, 0, vecPayload.data(), 100, 0, 0, 0, 0 };
+    FRAME_IOV stShort = { CMD_KEEP_ALIVE, 0, vecPayload.data(), 40, 0, 0, 0, 0 };
+    for (int i = 0; i < 20; i++)
+        ASSERT_EQ(udpSendFrame(&client, NULL, 0, &stFull), 1);
+    ASSERT_EQ(udpSendFrame(&client, NULL, 0, &stShort), 1);
+    ASSERT_EQ(udpSendFrame(&client, NULL, 0, &stFull), 1);
+    EXPECT_EQ(client.stTxRing.uiCount, 2u);
+    timeval stTv = { 0, 50 * 1000 };
+    event_base_loopexit(base, &stTv);
+    event_base_dispatch(base);
+
+    EXPECT_EQ(client.ulTxBatchCnt, 1u);
+    EXPECT_EQ(client.ulTxGsoCnt, 1u);
+    EXPECT_EQ(client.ulTxDgramCnt, 22u);
+    EXPECT_EQ(client.ulTxDropCnt, 0u);
+    EXPECT_EQ(server.ulRxDgramCnt, 22u);
+    EXPECT_EQ(server.ulRxDropCnt, 0u);
+    EXPECT_GE(server.ulRxGroCnt, 1u);
+    EXPECT_EQ(server.stSession.stFrameCtx.ulRxFrameCnt, 22u);
+
+    udpStop(&client);
+    udpStop(&server);
+    event_base_free(base);
+}
+
+static std::vector<unsigned char> encodeKeepAlive(unsigned char uchSrcId, unsigned int uiSeq) {
+    evbuffer* pstFrame = evbuffer_new();
+    MSG_ID stMsgId = { uchSrcId, 0x10 };
+    REQ_KEEP_ALIVE stReq = { 0x01 };
+    FRAME_IOV stIov = { CMD_KEEP_ALIVE, 0, &stReq, sizeof(stReq), uiSeq, 0, 0, 0 };
+    encodeFrameBatch(pstFrame, CRC_MODE_XOR8, &stMsgId, &stIov, 1);
+    std::vector<unsigned char> vecFrame(evbuffer_get_length(pstFrame));
+    evbuffer_remove(pstFrame, vecFrame.data(), vecFrame.size());
+    evbuffer_free(pstFrame);
+    return vecFrame;
+}
+
+TEST_F(UdpTest, PeersAreTrackedBySourceAddress) {
+    sockaddr_in stDst{};
+    stDst.sin_family = AF_INET;
+    stDst.sin_port = htons(unPort);
+    inet_pton(AF_INET, "127.0.0.1", &stDst.sin_addr);
+    int aiSock[2] = { socket(AF_INET, SOCK_DGRAM, 0), socket(AF_INET, SOCK_DGRAM, 0) };
+    ASSERT_GE(aiSock[0], 0);
+    ASSERT_GE(aiSock[1], 0);
+
+    /* 소켓 하나로 받지만 상대마다 ID/카운터가 따로 */
+    std::vector<unsigned char> vecA = encodeKeepAlive(0x31, 1);
+    std::vector<unsigned char> vecB = encodeKeepAlive(0x32, 2);
+    sendto(aiSock[0], vecA.data(), vecA.size(), 0, (sockaddr*)&stDst, sizeof(stDst));
+    sendto(aiSock[1], vecB.data(), vecB.size(), 0, (sockaddr*)&stDst, sizeof(stDst));
+    sendto(aiSock[1], vecB.data(), vecB.size(), 0, (sockaddr*)&stDst, sizeof(stDst));
+    runFor(50);
+
+    ASSERT_EQ(server.stPeerTable.uiCount, 2u);
+    UDP_PEER* pstA = udpPeerFindId(&server.stPeerTable, 0x31);
+    UDP_PEER* pstB = udpPeerFindId(&server.stPeerTable, 0x32);
+    ASSERT_NE(pstA, nullptr);
+    ASSERT_NE(pstB, nullptr);
+    EXPECT_EQ(pstA->ulRxFrameCnt, 1u);
+    EXPECT_EQ(pstB->ulRxFrameCnt, 2u);
+    EXPECT_EQ(pstB->ulTxFrameCnt, 2u);
+    EXPECT_EQ(pstB->ulRxBytes, (unsigned long)vecB.size() * 2);
+
+    /* 응답 MSG_ID 는 보낸 쪽 ID 로 */
+    for (int i = 0; i < 2; i++) {
+        unsigned char auchReply[256];
+        FRAME_HEADER stHeader;
+        ASSERT_GT(recv(aiSock[i], auchReply, sizeof(auchReply), MSG_DONTWAIT), (ssize_t)sizeof(stHeader));
+        memcpy(&stHeader, auchReply, sizeof(stHeader));
+        EXPECT_EQ(stHeader.stMsgId.uchSrcId, 0x10);
+        EXPECT_EQ(stHeader.stMsgId.uchDstId, i == 0 ? 0x31 : 0x32);
+    }
+    while (recv(aiSock[1], vecB.data(), vecB.size(), MSG_DONTWAIT) > 0) {}
+
+    /* ID 로 송신: 학습한 주소로만 간다 */
+    REQ_KEEP_ALIVE stReq = { 0x01 };
+    FRAME_IOV stIov = { CMD_KEEP_ALIVE, 0, &stReq, sizeof(stReq), 0, 0, 0, 0 };
+    EXPECT_EQ(udpSendToPeer(&server, 0x31, &stIov), 1);
+    EXPECT_EQ(udpSendToPeer(&server, 0x33, &stIov), -1);
+    runFor(20);
+    unsigned char auchPush[256];
+    FRAME_HEADER stHeader;
+    ASSERT_GT(recv(aiSock[0], auchPush, sizeof(auchPush), MSG_DONTWAIT), (ssize_t)sizeof(stHeader));
+    memcpy(&stHeader, auchPush, sizeof(stHeader));
+    EXPECT_EQ(stHeader.stMsgId.uchDstId, 0x31);
+    EXPECT_LT(recv(aiSock[1], auchPush, sizeof(auchPush), MSG_DONTWAIT), 0);
+    EXPECT_EQ(pstA->ulTxFrameCnt, 2u);
+    close(aiSock[0]);
+    close(aiSock[1]);
+}
+
+static sockaddr_in peerAddr(unsigned int uiHost, unsigned short unPort) {
+    sockaddr_in stAddr{};
+    stAddr.sin_family = AF_INET;
+    stAddr.sin_port = htons(unPort);
+    stAddr.sin_addr.s_addr = htonl(uiHost);
+    return stAddr;
+}
+
+TEST(UdpPeerTableTest, EvictsLeastRecentAndIdle) {
+    UDP_PEER_TABLE stTable;
+    ASSERT_EQ(udpPeerTableInit(&stTable, nullptr, 0x10, 2, 1000), 0);
+    sockaddr_in stA = peerAddr(0x7F000001, 5000), stB = peerAddr(0x7F000001, 5001), stC = peerAddr(0x7F000002, 5000);
+
+    UDP_PEER* pstA = udpPeerTouch(&stTable, (sockaddr*)&stA, sizeof(stA), 0);
+    udpPeerLearnId(&stTable, pstA, 0x31);
+    UDP_PEER* pstB = udpPeerTouch(&stTable, (sockaddr*)&stB, sizeof(stB), 10);
+    udpPeerLearnId(&stTable, pstB, 0x32);
+    EXPECT_EQ(udpPeerTouch(&stTable, (sockaddr*)&stA, sizeof(stA), 20), pstA);
+
+    /* 가득 찬 상태의 새 상대는 가장 오래 조용한 B 를 밀어낸다 */
+    ASSERT_NE(udpPeerTouch(&stTable, (sockaddr*)&stC, sizeof(stC), 30), nullptr);
+    EXPECT_EQ(stTable.uiCount, 2u);
+    EXPECT_EQ(stTable.ulEvictCnt, 1u);
+    EXPECT_EQ(udpPeerLookup(&stTable, (sockaddr*)&stB, sizeof(stB)), nullptr);
+    EXPECT_EQ(udpPeerFindId(&stTable, 0x32), nullptr);
+    EXPECT_EQ(udpPeerFindId(&stTable, 0x31), pstA);
+
+    /* 유휴 정리: 마지막 수신 + 1000ms 가 지난 상대만 */
+    EXPECT_EQ(udpPeerExpire(&stTable, 1019), 0);
+    EXPECT_EQ(udpPeerExpire(&stTable, 1025), 1);
+    EXPECT_EQ(udpPeerLookup(&stTable, (sockaddr*)&stA, sizeof(stA)), nullptr);
+    EXPECT_EQ(udpPeerFindId(&stTable, 0x31), nullptr);
+    EXPECT_NE(udpPeerLookup(&stTable, (sockaddr*)&stC, sizeof(stC)), nullptr);
+    EXPECT_EQ(stTable.ulIdleCnt, 1u);
+    udpPeerTableFree(&stTable);
+}
+
+TEST(UdpPeerTableTest, LookupSurvivesChurn) {
+    /* 삭제 후 탐사 사슬이 끊기지 않는지: 넣고 빼기를 반복하며 남은 항목을 모두 찾는다 */
+    const unsigned int kPeers = 256;
+    UDP_PEER_TABLE stTable;
+    ASSERT_EQ(udpPeerTableInit(&stTable, nullptr, 0x10, kPeers, 0), 0);
+    std::vector<bool> vecLive(kPeers * 4, false);
+    for (unsigned int uiRound = 0; uiRound < 8; uiRound++) {
+        for (unsigned int i = 0; i < vecLive.size(); i++) {
+            sockaddr_in stAddr = peerAddr(0x0A000000 + i, (unsigned short)(4000 + i % 7));
+            if ((i * 7 + uiRound) % 3 == 0) {
+                udpPeerRemove(&stTable, udpPeerLookup(&stTable, (sockaddr*)&stAddr, sizeof(stAddr)));
+                vecLive[i] = false;
+            } else if (stTable.uiCount < kPeers) {
+                ASSERT_NE(udpPeerTouch(&stTable, (sockaddr*)&stAddr, sizeof(stAddr), uiRound), nullptr);
+                vecLive[i] = true;
+            }
+        }
+        unsigned int uiLive = 0;
+        for (unsigned int i = 0; i < vecLive.size(); i++) {
+            sockaddr_in stAddr = peerAddr(0x0A000000 + i, (unsigned short)(4000 + i % 7));
+            UDP_PEER* pstPeer = udpPeerLookup(&stTable, (sockaddr*)&stAddr, sizeof(stAddr));
+            EXPECT_EQ(pstPeer != nullptr, (bool)vecLive[i]) << "round " << uiRound << " peer " << i;
+            uiLive += vecLive[i];
+        }
+        EXPECT_EQ(stTable.uiCount, uiLive);
+    }
+    udpPeerTableFree(&stTable);
+}
+
+TEST(UdpReliableTest, SackRttAndDedupBookkeeping) {
+    SLAB_POOL stPool;
+    TIMER_WHEEL stWheel;
+    slabPoolInit(&stPool, 64, 8);
+    timerWheelInit(&stWheel, nullptr, UDP_REL_TICK_MS);
+    UDP_REL* pstTx = udpRelNew(nullptr, nullptr);
+    ASSERT_NE(pstTx, nullptr);
+    const uint64_t ulNow = 1000000;
+    for (int i = 0; i < 6; i++)
+        ASSERT_NE(udpRelTrack(pstTx, &stPool, 10, ulNow), nullptr);       /* 순번 1..6 */
+
+    /* 2 만 손실: 누적 1 + SACK 3..6 (비트 i = 1 + 2 + i) */
+    EXPECT_EQ(udpRelOnAck(pstTx, &stPool, pstTx->uiEpoch, 1, 0xF, ulNow + 500), 5);
+    EXPECT_EQ(pstTx->uiSndUna, 2u);
+    EXPECT_EQ(pstTx->uiSrttUs, 500u);
+    EXPECT_EQ(pstTx->uiRtoMs, (unsigned int)UDP_REL_RTO_MIN_MS);
+    EXPECT_TRUE(pstTx->astWindow[2].chFast);
+
+    /* 빠른 재전송은 RTO 를 기다리지 않고, 그 뒤 손실은 RTO 만료로 (RTO 두 배) */
+    UDP_REL_ENTRY* apstDue[UDP_REL_WINDOW];
+    ASSERT_EQ(udpRelDue(pstTx, &stPool, ulNow + 600, apstDue), 1);
+    EXPECT_EQ(apstDue[0]->uiSeq, 2u);
+    EXPECT_EQ(pstTx->ulFastCnt, 1u);
+    uint64_t ulRtoUs = (uint64_t)pstTx->uiRtoMs * 1000;
+    EXPECT_EQ(udpRelDue(pstTx, &stPool, ulNow + 600 + ulRtoUs - 1, apstDue), 0);
+    EXPECT_EQ(udpRelDue(pstTx, &stPool, ulNow + 600 + ulRtoUs, apstDue), 1);
+    EXPECT_EQ(pstTx->uiRtoMs, 2u * UDP_REL_RTO_MIN_MS);
+
+    /* 재전송한 항목의 확인은 RTT 표본이 아니다 (Karn) */
+    EXPECT_EQ(udpRelOnAck(pstTx, &stPool, pstTx->uiEpoch + 1, 6, 0, ulNow + 900000), 0);   /* 다른 세대 */
+    EXPECT_EQ(udpRelOnAck(pstTx, &stPool, pstTx->uiEpoch, 6, 0, ulNow + 900000), 1);
+    EXPECT_EQ(pstTx->uiSrttUs, 500u);
+    EXPECT_EQ(udpRelOutstanding(pstTx), 0u);
+    EXPECT_EQ(stPool.ulInUse, 0u);
+    EXPECT_EQ(udpRelOnAck(pstTx, &stPool, pstTx->uiEpoch, 9, 0, ulNow), 0);             /* 보낸 적 없는 순번 */
+
+    /* 수신: 도착 순서대로 전달, 중복은 버리고 확인은 다시 알린다 */
+    const uint32_t kEpoch = 0x5A5A0001;
+    UDP_REL* pstRx = udpRelNew(nullptr, nullptr);
+    ASSERT_NE(pstRx, nullptr);
+    EXPECT_EQ(udpRelOnData(pstRx, kEpoch, 3, 1), 1);
+    EXPECT_EQ(udpRelOnData(pstRx, kEpoch, 1, 1), 1);
+    EXPECT_EQ(udpRelOnData(pstRx, kEpoch, 3, 1), 0);
+    EXPECT_EQ(udpRelOnData(pstRx, kEpoch, 1, 1), 0);
+    EXPECT_TRUE(pstRx->chAckPending);
+    UDP_REL_HEADER stHeader;
+    udpRelBuildHeader(pstRx, 0, 0, &stHeader);
+    EXPECT_EQ(ntohs(stHeader.unMagic), UDP_REL_MAGIC);
+    EXPECT_EQ(stHeader.uchFlags, UDP_REL_FLAG_ACK);
+    EXPECT_EQ(ntohl(stHeader.uiAckEpoch), kEpoch);
+    EXPECT_EQ(ntohl(stHeader.uiAck), 1u);
+    EXPECT_EQ(ntohl(stHeader.uiSackBits), 1u);
+    EXPECT_FALSE(pstRx->chAckPending);
+    EXPECT_EQ(udpRelOnData(pstRx, kEpoch, 40, 1), -1);                          /* 창 밖 */
+    /* 송신 측이 2, 4 를 포기했으면(una 5) 기다리지 않는다 */
+    EXPECT_EQ(udpRelOnData(pstRx, kEpoch, 5, 5), 1);
+    EXPECT_EQ(pstRx->uiRcvNext, 6u);
+    EXPECT_EQ(pstRx->uiRcvBits, 0u);
+    /* 상대가 상태를 새로 만들면(새 세대) 순번 1 부터 다시 받는다 */
+    EXPECT_EQ(udpRelOnData(pstRx, kEpoch + 1, 1, 1), 1);
+    EXPECT_EQ(udpRelOnData(pstRx, kEpoch + 1, 1, 1), 0);
+    EXPECT_EQ(pstRx->uiRcvNext, 2u);
+
+    udpRelFree(pstTx, &stPool, &stWheel);
+    udpRelFree(pstRx, &stPool, &stWheel);
+    timerWheelFree(&stWheel);
+    slabPoolDestroy(&stPool);
+}
+
+/* 손실 경로: 클라이언트 ↔ 서버 사이에서 양방향 데이터그램을 iDropEvery 개마다 하나씩 버린다 */
+typedef struct {
+    int             iFd;
+    sockaddr_in     stServer;
+    sockaddr_in     stClient;
+    int             iDropEvery;
+    unsigned long   ulSeen;
+    unsigned long   ulDropped;
+} LOSSY_RELAY;
+
+static void lossyRelayCb(evutil_socket_t fd, short, void* pvUser) {
+    LOSSY_RELAY* pstRelay = static_cast<LOSSY_RELAY*>(pvUser);
+    unsigned char auchBuf[UDP_DGRAM_MAX];
+    sockaddr_in stFrom{};
+    socklen_t len = sizeof(stFrom);
+    ssize_t lRecv;
+    while ((lRecv = recvfrom(fd, auchBuf, sizeof(auchBuf), MSG_DONTWAIT, (sockaddr*)&stFrom, &len)) >= 0) {
+        int iFromServer = stFrom.sin_port == pstRelay->stServer.sin_port;
+        if (!iFromServer)
+            pstRelay->stClient = stFrom;
+        if (++pstRelay->ulSeen % pstRelay->iDropEvery == 0)
+            pstRelay->ulDropped++;
+        else
+            sendto(fd, auchBuf, (size_t)lRecv, 0,
+                (sockaddr*)(iFromServer ? &pstRelay->stClient : &pstRelay->stServer), sizeof(sockaddr_in));
+        len = sizeof(stFrom);
+    }
+}
+
+static int countHandler(FRAME_CTX*, const FRAME_VIEW*, void* pvUser) {
+    (*static_cast<int*>(pvUser))++;
+    return 1;
+}
+
+TEST_F(UdpTest, ReliableRequestsSurviveLossWhileTelemetryDoesNot) {
+    /* 서버를 신뢰 모드로 다시 시작 */
+    udpStop(&server);
+    udpInit(&server, base, 0x10, UDP_MODE);
+    ASSERT_EQ(udpSetReliable(&server, 1), 0);
+    ASSERT_EQ(udpServerStart(&server, 0), 0);
+    EXPECT_EQ(udpSetReliable(&server, 0), -1);
+    const unsigned char kTelemetryCmd = 0x41;
+    int iTelemetry = 0;
+    ASSERT_EQ(cmdRegister(&server.stNetBase.stCoreCtx.stCmdTable, kTelemetryCmd, CMD_ANY_SIZE,
+        countHandler, &iTelemetry), 0);
+
+    LOSSY_RELAY stRelay{};
+    stRelay.iDropEvery = 4;
+    stRelay.iFd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(stRelay.iFd, 0);
+    sockaddr_in stBind{};
+    stBind.sin_family = AF_INET;
+    inet_pton(AF_INET, "127.0.0.1", &stBind.sin_addr);
+    ASSERT_EQ(bind(stRelay.iFd, (sockaddr*)&stBind, sizeof(stBind)), 0);
+    socklen_t len = sizeof(stBind);
+    getsockname(stRelay.iFd, (sockaddr*)&stBind, &len);
+    getsockname(server.stNetBase.iSockFd, (sockaddr*)&stRelay.stServer, &len);
+    stRelay.stServer.sin_addr = stBind.sin_addr;
+    event* pstRelayEvent = event_new(base, stRelay.iFd, EV_READ | EV_PERSIST, lossyRelayCb, &stRelay);
+    event_add(pstRelayEvent, nullptr);
+
+    UDP_CTX client;
+    udpInit(&client, base, 0x20, UDP_MODE);
+    ASSERT_EQ(udpSetReliable(&client, 1), 0);
+    ASSERT_EQ(udpClientStart(&client, "127.0.0.1", ntohs(stBind.sin_port), 0), 0);
+
+    /* 상관 ID 가 있는 요청은 신뢰 전송(창을 넘는 만큼은 대기), 단발 텔레메트리는 그대로 */
+    const int kCount = 100;
+    int iDone = 0;
+    REQ_KEEP_ALIVE stReq = { 0x01 };
+    unsigned char auchSample[32] = {};
+    FRAME_IOV stTelemetry = { kTelemetryCmd, 0, auchSample, sizeof(auchSample), 0, 0, 0, 0 };
+    for (int i = 0; i < kCount; i++) {
+        ASSERT_GT(inflightRequest(&client.stSession.stFrameCtx, CMD_KEEP_ALIVE, 0,
+            &stReq, sizeof(stReq), 10000, countDone, &iDone), 0);
+        ASSERT_EQ(udpSendFrame(&client, nullptr, 0, &stTelemetry), 1);
+    }
+    for (int iRound = 0; iRound < 100 && iDone < kCount; iRound++)
+        runFor(50);
+
+    EXPECT_EQ(iDone, kCount);
+    EXPECT_GT(stRelay.ulDropped, 0u);
+    EXPECT_EQ(client.ulRelTxCnt, (unsigned long)kCount);
+    EXPECT_GT(client.ulRelBacklogCnt, 0u);
+    EXPECT_GT(client.ulRelRetxCnt + server.ulRelRetxCnt, 0u);
+    EXPECT_EQ(client.ulRelGiveUpCnt + server.ulRelGiveUpCnt, 0u);
+    /* 핸들러는 요청마다 정확히 한 번 (재전송 중복은 걸러진다) */
+    EXPECT_EQ(server.ulRelRxCnt, (unsigned long)kCount);
+    EXPECT_EQ(client.ulRelRxCnt, (unsigned long)kCount);
+    EXPECT_GT(iTelemetry, 0);
+    EXPECT_LT(iTelemetry, kCount);
+    EXPECT_EQ(udpRelOutstanding(client.pstRel), 0u);
+    ASSERT_EQ(server.stPeerTable.uiCount, 1u);
+    UDP_PEER* pstPeer = udpPeerFindId(&server.stPeerTable, 0x20);
+    ASSERT_NE(pstPeer, nullptr);
+    ASSERT_NE(pstPeer->pstRel, nullptr);
+    EXPECT_GT(pstPeer->pstRel->uiSrttUs, 0u);
+
+    udpStop(&client);
+    event_free(pstRelayEvent);
+    close(stRelay.iFd);
+}
+
+TEST_F(UdpTest, ReliableSessionRecoversWhenStateIsRecreated) {
+    udpStop(&server);
+    udpInit(&server, base, 0x10, UDP_MODE);
+    ASSERT_EQ(udpSetReliable(&server, 1), 0);
+    ASSERT_EQ(udpServerStart(&server, 0), 0);
+    sockaddr_in stAddr{};
+    socklen_t len = sizeof(stAddr);
+    getsockname(server.stNetBase.iSockFd, (sockaddr*)&stAddr, &len);
+    UDP_CTX client;
+    udpInit(&client, base, 0x20, UDP_MODE);
+    ASSERT_EQ(udpSetReliable(&client, 1), 0);
+    ASSERT_EQ(udpClientStart(&client, "127.0.0.1", ntohs(stAddr.sin_port), 0), 0);
+
+    const int kCount = 50;
+    REQ_KEEP_ALIVE stReq = { 0x01 };
+    for (int iRound = 0; iRound < 3; iRound++) {
+        int iDone = 0;
+        for (int i = 0; i < kCount; i++)
+            ASSERT_GT(inflightRequest(&client.stSession.stFrameCtx, CMD_KEEP_ALIVE, 0,
+                &stReq, sizeof(stReq), 2000, countDone, &iDone), 0);
+        for (int i = 0; i < 40 && iDone < kCount; i++)
+            runFor(25);
+        EXPECT_EQ(iDone, kCount) << "round " << iRound;
+
+        /* 1회차 뒤: 서버가 상대를 잃음 (유휴/밀려남과 같은 경로), 2회차 뒤: 클라이언트 상태를 새로 */
+        if (iRound == 0) {
+            UDP_PEER* pstPeer = udpPeerFindId(&server.stPeerTable, 0x20);
+            ASSERT_NE(pstPeer, nullptr);
+            udpPeerRemove(&server.stPeerTable, pstPeer);
+        } else if (iRound == 1) {
+            udpRelFree(client.pstRel, &client.stRelPool, &client.stRelWheel);
+            client.pstRel = udpRelNew(&client, nullptr);
+            ASSERT_NE(client.pstRel, nullptr);
+        }
+    }
+    EXPECT_EQ(client.ulRelGiveUpCnt + server.ulRelGiveUpCnt, 0u);
+    EXPECT_EQ(server.ulRelRxCnt, 3u * kCount);
+    udpStop(&client);
 }
 
 int main(int argc, char** argv) {
@@ -0,0 +1,315 @@
+#include "checksum.h"
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CHECKSUM_X86    1
+#endif
+
+#define CRC16_POLY      0x1021      /* CCITT, MSB-first */
+#define CRC32C_POLY     0x82F63B78  /* Castagnoli, reflected */
+#define XOR8_SIMD_MIN   128         /* 이보다 짧으면 SIMD 준비/접기 비용이 더 크다 */
+
+static uint16_t         s_aunCrc16Table[8][256];
+static uint32_t         s_auiCrc32cTable[8][256];
+static pthread_once_t   s_stInitOnce = PTHREAD_ONCE_INIT;
+
+static uint32_t (*s_pfnXor8)(const void*, size_t);
+static uint32_t (*s_pfnCrc32c)(const void*, size_t);
+
+static inline uint64_t load64(const unsigned char* puchData)
+{
+    uint64_t ulValue;
+    memcpy(&ulValue, puchData, sizeof(ulValue));
+    return ulValue;
+}
+
+static inline uint32_t fold64To8(uint64_t ulValue)
+{
+    ulValue ^= ulValue >> 32;
+    ulValue ^= ulValue >> 16;
+    ulValue ^= ulValue >> 8;
+    return (uint8_t)ulValue;
+}
+
+/* ================================================================
+ * XOR8 커널
+ * ================================================================ */
+static uint32_t xor8Byte(const void* pvData, size_t ulSize)
+{
+    const unsigned char* puchData = (const unsigned char*)pvData;
+    uint8_t uchCrc = 0;
+    for (size_t i = 0; i < ulSize; i++)
+        uchCrc ^= puchData[i];
+    return uchCrc;
+}
+
+/* 스칼라 fallback: 8바이트 단위 XOR 후 접기 */
+static uint32_t xor8Word(const void* pvData, size_t ulSize)
+{
+    const unsigned char* puchData = (const unsigned char*)pvData;
+    uint64_t ulAcc0 = 0, ulAcc1 = 0;
+
+    while (ulSize >= 16) {
+        ulAcc0 ^= load64(puchData);
+        ulAcc1 ^= load64(puchData + 8);
+        puchData += 16;
+        ulSize -= 16;
+    }
+    ulAcc0 ^= ulAcc1;
+    if (ulSize >= 8) {
+        ulAcc0 ^= load64(puchData);
+        puchData += 8;
+        ulSize -= 8;
+    }
+    uint32_t uiCrc = fold64To8(ulAcc0);
+    while (ulSize--)
+        uiCrc ^= *puchData++;
+    return uiCrc;
+}
+
+#ifdef CHECKSUM_X86
+__attribute__((target("sse2")))
+static uint32_t xor8Sse2(const void* pvData, size_t ulSize)
+{
+    const unsigned char* puchData = (const unsigned char*)pvData;
+    __m128i stAcc0 = _mm_setzero_si128(), stAcc1 = _mm_setzero_si128();
+    __m128i stAcc2 = _mm_setzero_si128(), stAcc3 = _mm_setzero_si128();
+
+    while (ulSize >= 64) {
+        stAcc0 = _mm_xor_si128(stAcc0, _mm_loadu_si128((const __m128i*)(puchData)));
+        stAcc1 = _mm_xor_si128(stAcc1, _mm_loadu_si128((const __m128i*)(puchData + 16)));
+        stAcc2 = _mm_xor_si128(stAcc2, _mm_loadu_si128((const __m128i*)(puchData + 32)));
+        stAcc3 = _mm_xor_si128(stAcc3, _mm_loadu_si128((const __m128i*)(puchData + 48)));
+        puchData += 64;
+        ulSize -= 64;
+    }
+    stAcc0 = _mm_xor_si128(_mm_xor_si128(stAcc0, stAcc1), _mm_xor_si128(stAcc2, stAcc3));
+    while (ulSize >= 16) {
+        stAcc0 = _mm_xor_si128(stAcc0, _mm_loadu_si128((const __m128i*)puchData));
+        puchData += 16;
+        ulSize -= 16;
+    }
+
+    uint64_t aulLane[2];
+    _mm_storeu_si128((__m128i*)aulLane, stAcc0);
+    return fold64To8(aulLane[0] ^ aulLane[1]) ^ xor8Word(puchData, ulSize);
+}
+
+__attribute__((target("avx2")))
+static uint32_t xor8Avx2(const void* pvData, size_t ulSize)
+{
+    const unsigned char* puchData = (const unsigned char*)pvData;
+    __m256i stAcc0 = _mm256_setzero_si256(), stAcc1 = _mm256_setzero_si256();
+    __m256i stAcc2 = _mm256_setzero_si256(), stAcc3 = _mm256_setzero_si256();
+
+    while (ulSize >= 128) {
+        stAcc0 = _mm256_xor_si256(stAcc0, _mm256_loadu_si256((const __m256i*)(puchData)));
+        stAcc1 = _mm256_xor_si256(stAcc1, _mm256_loadu_si256((const __m256i*)(puchData + 32)));
+        stAcc2 = _mm256_xor_si256(stAcc2, _mm256_loadu_si256((const __m256i*)(puchData + 64)));
+        stAcc3 = _mm256_xor_si256(stAcc3, _mm256_loadu_si256((const __m256i*)(puchData + 96)));
+        puchData += 128;
+        ulSize -= 128;
+    }
+    stAcc0 = _mm256_xor_si256(_mm256_xor_si256(stAcc0, stAcc1), _mm256_xor_si256(stAcc2, stAcc3));
+    while (ulSize >= 32) {
+        stAcc0 = _mm256_xor_si256(stAcc0, _mm256_loadu_si256((const __m256i*)puchData));
+        puchData += 32;
+        ulSize -= 32;
+    }
+
+    __m128i stHalf = _mm_xor_si128(_mm256_castsi256_si128(stAcc0), _mm256_extracti128_si256(stAcc0, 1));
+    uint64_t aulLane[2];
+    _mm_storeu_si128((__m128i*)aulLane, stHalf);
+    return fold64To8(aulLane[0] ^ aulLane[1]) ^ xor8Word(puchData, ulSize);
+}
+#endif
+
+/* ================================================================
+ * CRC-16/CCITT-FALSE 커널
+ * ================================================================ */
+static uint32_t crc16Byte(const void* pvData, size_t ulSize)
+{
+    const unsigned char* puchData = (const unsigned char*)pvData;
+    uint16_t unCrc = 0xFFFF;
+    while (ulSize--)
+        unCrc = (uint16_t)((unCrc << 8) ^ s_aunCrc16Table[0][((unCrc >> 8) ^ *puchData++) & 0xFF]);
+    return unCrc;
+}
+
+static uint32_t crc16Slice8(const void* pvData, size_t ulSize)
+{
+    const unsigned char* puchData = (const unsigned char*)pvData;
+    uint16_t unCrc = 0xFFFF;
+
+    while (ulSize >= 8) {
+        unCrc ^= (uint16_t)((puchData[0] << 8) | puchData[1]);
+        unCrc = s_aunCrc16Table[7][unCrc >> 8]     ^ s_aunCrc16Table[6][unCrc & 0xFF] ^
+                s_aunCrc16Table[5][puchData[2]]    ^ s_aunCrc16Table[4][puchData[3]]  ^
+                s_aunCrc16Table[3][puchData[4]]    ^ s_aunCrc16Table[2][puchData[5]]  ^
+                s_aunCrc16Table[1][puchData[6]]    ^ s_aunCrc16Table[0][puchData[7]];
+        puchData += 8;
+        ulSize -= 8;
+    }
+    while (ulSize--)
+        unCrc = (uint16_t)((unCrc << 8) ^ s_aunCrc16Table[0][((unCrc >> 8) ^ *puchData++) & 0xFF]);
+    return unCrc;
+}
+
+/* ================================================================
+ * CRC-32C 커널
+ * ================================================================ */
+static uint32_t crc32cByte(const void* pvData, size_t ulSize)
+{
+    const unsigned char* puchData = (const unsigned char*)pvData;
+    uint32_t uiCrc = 0xFFFFFFFF;
+    while (ulSize--)
+        uiCrc = (uiCrc >> 8) ^ s_auiCrc32cTable[0][(uiCrc ^ *puchData++) & 0xFF];
+    return ~uiCrc;
+}
+
+static uint32_t crc32cSlice8(const void* pvData, size_t ulSize)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    const unsigned char* puchData = (const unsigned char*)pvData;
+    uint32_t uiCrc = 0xFFFFFFFF;
+
+    while (ulSize >= 8) {
+        uint64_t ulWord = load64(puchData) ^ uiCrc;
+        uint32_t uiLo = (uint32_t)ulWord, uiHi = (uint32_t)(ulWord >> 32);
+        uiCrc = s_auiCrc32cTable[7][uiLo & 0xFF]         ^ s_auiCrc32cTable[6][(uiLo >> 8) & 0xFF] ^
+                s_auiCrc32cTable[5][(uiLo >> 16) & 0xFF] ^ s_auiCrc32cTable[4][uiLo >> 24]         ^
+                s_auiCrc32cTable[3][uiHi & 0xFF]         ^ s_auiCrc32cTable[2][(uiHi >> 8) & 0xFF] ^
+                s_auiCrc32cTable[1][(uiHi >> 16) & 0xFF] ^ s_auiCrc32cTable[0][uiHi >> 24];
+        puchData += 8;
+        ulSize -= 8;
+    }
+    while (ulSize--)
+        uiCrc = (uiCrc >> 8) ^ s_auiCrc32cTable[0][(uiCrc ^ *puchData++) & 0xFF];
+    return ~uiCrc;
+#else
+    return crc32cByte(pvData, ulSize);
+#endif
+}
+
+#ifdef CHECKSUM_X86
+__attribute__((target("sse4.2")))
+static uint32_t crc32cSse42(const void* pvData, size_t ulSize)
+{
+    const unsigned char* puchData = (const unsigned char*)pvData;
+#if defined(__x86_64__)
+    uint64_t ulCrc = 0xFFFFFFFF;
+    while (ulSize >= 8) {
+        ulCrc = _mm_crc32_u64(ulCrc, load64(puchData));
+        puchData += 8;
+        ulSize -= 8;
+    }
+    uint32_t uiCrc = (uint32_t)ulCrc;
+#else
+    uint32_t uiCrc = 0xFFFFFFFF;
+#endif
+    while (ulSize--)
+        uiCrc = _mm_crc32_u8(uiCrc, *puchData++);
+    return ~uiCrc;
+}
+#endif
+
+/* 개별 커널 목록: iSupported 는 checksumInitOnce 에서 한 번만 채운다 */
+static CHECKSUM_KERNEL s_astKernels[] = {
+    { "xor8-byte",      CRC_MODE_XOR8,   xor8Byte,     1 },
+    { "xor8-word",      CRC_MODE_XOR8,   xor8Word,     1 },
+#ifdef CHECKSUM_X86
+    { "xor8-sse2",      CRC_MODE_XOR8,   xor8Sse2,     0 },
+    { "xor8-avx2",      CRC_MODE_XOR8,   xor8Avx2,     0 },
+#endif
+    { "crc16-byte",     CRC_MODE_CRC16,  crc16Byte,    1 },
+    { "crc16-slice8",   CRC_MODE_CRC16,  crc16Slice8,  1 },
+    { "crc32c-byte",    CRC_MODE_CRC32C, crc32cByte,   1 },
+    { "crc32c-slice8",  CRC_MODE_CRC32C, crc32cSlice8, 1 },
+#ifdef CHECKSUM_X86
+    { "crc32c-sse42",   CRC_MODE_CRC32C, crc32cSse42,  0 },
+#endif
+};
+
+/* ================================================================
+ * 테이블 생성 및 런타임 디스패치
+ * ================================================================ */
+static void checksumInitOnce(void)
+{
+    for (int i = 0; i < 256; i++) {
+        uint16_t unCrc = (uint16_t)(i << 8);
+        uint32_t uiCrc = (uint32_t)i;
+        for (int j = 0; j < 8; j++) {
+            unCrc = (uint16_t)((unCrc & 0x8000) ? (unCrc << 1) ^ CRC16_POLY : (unCrc << 1));
+            uiCrc = (uiCrc & 1) ? (uiCrc >> 1) ^ CRC32C_POLY : (uiCrc >> 1);
+        }
+        s_aunCrc16Table[0][i] = unCrc;
+        s_auiCrc32cTable[0][i] = uiCrc;
+    }
+    for (int k = 1; k < 8; k++) {
+        for (int i = 0; i < 256; i++) {
+            uint16_t unPrev = s_aunCrc16Table[k - 1][i];
+            uint32_t uiPrev = s_auiCrc32cTable[k - 1][i];
+            s_aunCrc16Table[k][i] = (uint16_t)((unPrev << 8) ^ s_aunCrc16Table[0][unPrev >> 8]);
+            s_auiCrc32cTable[k][i] = (uiPrev >> 8) ^ s_auiCrc32cTable[0][uiPrev & 0xFF];
+        }
+    }
+
+    s_pfnXor8   = xor8Word;
+    s_pfnCrc32c = crc32cSlice8;
+#ifdef CHECKSUM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        s_pfnXor8 = xor8Avx2;
+    else if (__builtin_cpu_supports("sse2"))
+        s_pfnXor8 = xor8Sse2;
+    if (__builtin_cpu_supports("sse4.2"))
+        s_pfnCrc32c = crc32cSse42;
+
+    for (size_t i = 0; i < sizeof(s_astKernels) / sizeof(s_astKernels[0]); i++) {
+        if (s_astKernels[i].pfnCalc == xor8Sse2)
+            s_astKernels[i].iSupported = __builtin_cpu_supports("sse2");
+        else if (s_astKernels[i].pfnCalc == xor8Avx2)
+            s_astKernels[i].iSupported = __builtin_cpu_supports("avx2");
+        else if (s_astKernels[i].pfnCalc == crc32cSse42)
+            s_astKernels[i].iSupported = __builtin_cpu_supports("sse4.2");
+    }
+#endif
+}
+
+uint8_t checksumXor8(const void* pvData, size_t ulSize)
+{
+    if (ulSize < XOR8_SIMD_MIN)
+        return (uint8_t)xor8Word(pvData, ulSize);
+    pthread_once(&s_stInitOnce, checksumInitOnce);
+    return (uint8_t)s_pfnXor8(pvData, ulSize);
+}
+
+uint16_t checksumCrc16(const void* pvData, size_t ulSize)
+{
+    pthread_once(&s_stInitOnce, checksumInitOnce);
+    return (uint16_t)crc16Slice8(pvData, ulSize);
+}
+
+uint32_t checksumCrc32c(const void* pvData, size_t ulSize)
+{
+    pthread_once(&s_stInitOnce, checksumInitOnce);
+    return s_pfnCrc32c(pvData, ulSize);
+}
+
+uint32_t checksumCalc(unsigned char uchCrcMode, const void* pvData, size_t ulSize)
+{
+    switch (uchCrcMode) {
+        case CRC_MODE_CRC16:    return checksumCrc16(pvData, ulSize);
+        case CRC_MODE_CRC32C:   return checksumCrc32c(pvData, ulSize);
+        default:                return checksumXor8(pvData, ulSize);
+    }
+}
+
+int checksumGetKernels(const CHECKSUM_KERNEL** ppstKernels)
+{
+    pthread_once(&s_stInitOnce, checksumInitOnce);
+    *ppstKernels = s_astKernels;
+    return (int)(sizeof(s_astKernels) / sizeof(s_astKernels[0]));
+}
@@ -0,0 +1,42 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * 프레임 테일 체크섬
+ *  - CRC_MODE_XOR8   : 1 byte XOR (기존 프로토콜, 기본값)
+ *  - CRC_MODE_CRC16  : CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), slicing-by-8
+ *  - CRC_MODE_CRC32C : CRC-32C (Castagnoli), SSE4.2 명령 또는 slicing-by-8
+ * 테일에는 체크섬이 네트워크 바이트 순서로 checksumSize() 바이트 기록된다.
+ */
+typedef enum {
+    CRC_MODE_XOR8   = 0,
+    CRC_MODE_CRC16  = 1,
+    CRC_MODE_CRC32C = 2,
+    CRC_MODE_MAX
+} CRC_MODE;
+
+static inline size_t checksumSize(unsigned char uchCrcMode)
+{
+    return uchCrcMode == CRC_MODE_CRC32C ? 4 : (uchCrcMode == CRC_MODE_CRC16 ? 2 : 1);
+}
+
+/* 런타임 CPU 기능 검사 후 가장 빠른 커널을 사용 */
+uint8_t  checksumXor8(const void* pvData, size_t ulSize);
+uint16_t checksumCrc16(const void* pvData, size_t ulSize);
+uint32_t checksumCrc32c(const void* pvData, size_t ulSize);
+uint32_t checksumCalc(unsigned char uchCrcMode, const void* pvData, size_t ulSize);
+
+/* 개별 커널 목록 (벤치마크/검증용) */
+typedef struct {
+    const char      *pchName;
+    CRC_MODE        eMode;
+    uint32_t        (*pfnCalc)(const void* pvData, size_t ulSize);
+    int             iSupported;     /* 현재 CPU에서 실행 가능 여부 */
+} CHECKSUM_KERNEL;
+
+int checksumGetKernels(const CHECKSUM_KERNEL** ppstKernels);
+
+#endif /* CHECKSUM_H */
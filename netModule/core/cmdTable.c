@@ -0,0 +1,83 @@
+#include "cmdTable.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void cmdTableInit(CMD_TABLE* pstCmdTable)
+{
+    memset(pstCmdTable, 0, sizeof(*pstCmdTable));
+}
+
+void cmdTableFree(CMD_TABLE* pstCmdTable)
+{
+    for (int i = 0; i < CMD_TABLE_SIZE; i++) {
+        free(pstCmdTable->astEntry[i].pstSubTable);
+        pstCmdTable->astEntry[i].pstSubTable = NULL;
+    }
+}
+
+int cmdRegister(CMD_TABLE* pstCmdTable, unsigned short unCmd, int iExpectSize,
+        CMD_HANDLER pfnHandler, void* pvUser)
+{
+    if (!pstCmdTable || unCmd >= CMD_TABLE_SIZE)
+        return -1;
+
+    CMD_ENTRY* pstEntry = &pstCmdTable->astEntry[unCmd];
+    pstEntry->pfnHandler    = pfnHandler;
+    pstEntry->iExpectSize   = iExpectSize;
+    pstEntry->pvUser        = pvUser;
+    pstEntry->chStream      = 0;
+    return 0;
+}
+
+int cmdRegisterStream(CMD_TABLE* pstCmdTable, unsigned short unCmd,
+        CMD_HANDLER pfnHandler, void* pvUser)
+{
+    if (cmdRegister(pstCmdTable, unCmd, CMD_ANY_SIZE, pfnHandler, pvUser) < 0)
+        return -1;
+    pstCmdTable->astEntry[unCmd].chStream = pfnHandler ? 1 : 0;
+    return 0;
+}
+
+int cmdRegisterSub(CMD_TABLE* pstCmdTable, unsigned short unCmd, unsigned char uchSubModule,
+        int iExpectSize, CMD_HANDLER pfnHandler, void* pvUser)
+{
+    if (!pstCmdTable || unCmd >= CMD_TABLE_SIZE)
+        return -1;
+
+    CMD_ENTRY* pstEntry = &pstCmdTable->astEntry[unCmd];
+    if (!pstEntry->pstSubTable) {
+        if (!pfnHandler)
+            return 0;
+        pstEntry->pstSubTable = calloc(CMD_SUBMODULE_SIZE, sizeof(CMD_ENTRY));
+        if (!pstEntry->pstSubTable)
+            return -1;
+    }
+
+    CMD_ENTRY* pstSubEntry = &pstEntry->pstSubTable[uchSubModule];
+    pstSubEntry->pfnHandler    = pfnHandler;
+    pstSubEntry->iExpectSize   = iExpectSize;
+    pstSubEntry->pvUser        = pvUser;
+    pstSubEntry->chStream      = 0;
+    return 0;
+}
+
+int cmdDispatch(const CMD_TABLE* pstCmdTable, FRAME_CTX* pstFrameCtx, const FRAME_VIEW* pstFrameView)
+{
+    const CMD_ENTRY* pstEntry = pstCmdTable ?
+        cmdLookup(pstCmdTable, pstFrameView->unCmd, pstFrameView->uchSubModule) : NULL;
+    if (!pstEntry) {
+        TRACE_ERROR(TRACE_EV_CMD_UNKNOWN, pstFrameCtx->pvSession, pstFrameView->unCmd,
+            pstFrameView->iDataLength, pstFrameView->uchSubModule);
+        return 0;//CMD_ERR_NOT_REGISTERED
+    }
+
+    if (pstEntry->iExpectSize != CMD_ANY_SIZE && pstEntry->iExpectSize != pstFrameView->iDataLength) {
+        TRACE_ERROR(TRACE_EV_CMD_SIZE, pstFrameCtx->pvSession, pstFrameView->unCmd,
+            pstFrameView->iDataLength, pstFrameView->uchSubModule);
+        return 0;//CMD_ERR_SIZE_NOT_MATCH
+    }
+
+    return pstEntry->pfnHandler(pstFrameCtx, pstFrameView, pstEntry->pvUser);
+}
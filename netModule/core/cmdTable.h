@@ -0,0 +1,66 @@
+#ifndef CMD_TABLE_H
+#define CMD_TABLE_H
+
+#include "frame.h"
+
+/* ===== Constants ===== */
+#define CMD_TABLE_SIZE      256     /* 직접 인덱싱하는 명령 범위 (0 ~ CMD_TABLE_SIZE-1) */
+#define CMD_SUBMODULE_SIZE  256     /* uchSubModule 범위 */
+#define CMD_ANY_SIZE        (-1)    /* 페이로드 크기 검사 안 함 */
+
+/*
+ * 명령 핸들러
+ *  - pstFrameView 의 페이로드는 입력 버퍼를 가리키므로 핸들러 반환 후에는 무효
+ *  - return: 0 이상 정상, 음수 오류 (세션 종료 여부는 호출자 판단)
+ */
+typedef int (*CMD_HANDLER)(FRAME_CTX* pstFrameCtx, const FRAME_VIEW* pstFrameView, void* pvUser);
+
+typedef struct cmd_entry CMD_ENTRY;
+struct cmd_entry {
+    CMD_HANDLER     pfnHandler;
+    int             iExpectSize;    /* 기대 페이로드 크기 (CMD_ANY_SIZE: 검사 안 함) */
+    void            *pvUser;
+    CMD_ENTRY       *pstSubTable;   /* uchSubModule 별 2단계 테이블 (필요 시 할당) */
+    char            chStream;       /* 조각 프레임을 재조립 없이 조각마다 전달 */
+};
+
+/* 명령 번호로 직접 인덱싱하는 디스패치 테이블 */
+struct cmd_table {
+    CMD_ENTRY       astEntry[CMD_TABLE_SIZE];
+};
+
+void cmdTableInit(CMD_TABLE* pstCmdTable);
+void cmdTableFree(CMD_TABLE* pstCmdTable);
+
+/* 등록 (pfnHandler == NULL 이면 해제) */
+int  cmdRegister(CMD_TABLE* pstCmdTable, unsigned short unCmd, int iExpectSize,
+        CMD_HANDLER pfnHandler, void* pvUser);
+int  cmdRegisterSub(CMD_TABLE* pstCmdTable, unsigned short unCmd, unsigned char uchSubModule,
+        int iExpectSize, CMD_HANDLER pfnHandler, void* pvUser);
+
+/* 스트리밍 핸들러 등록
+ *  - 조각 프레임(FRAME_FLAG_FRAG)마다 호출: uiFragOffset 위치의 iDataLength 바이트,
+ *    마지막 조각은 FRAME_FLAG_LAST
+ *  - 조각나지 않은 프레임은 평소처럼 한 번에 전달
+ */
+int  cmdRegisterStream(CMD_TABLE* pstCmdTable, unsigned short unCmd,
+        CMD_HANDLER pfnHandler, void* pvUser);
+
+/* return: 핸들러 반환값, 0 미등록/크기 불일치(프레임 폐기) */
+int  cmdDispatch(const CMD_TABLE* pstCmdTable, FRAME_CTX* pstFrameCtx, const FRAME_VIEW* pstFrameView);
+
+/* === 조회: 명령 인덱스 1회 + (있으면) 서브모듈 인덱스 1회 === */
+static inline const CMD_ENTRY* cmdLookup(const CMD_TABLE* pstCmdTable,
+        unsigned short unCmd, unsigned char uchSubModule)
+{
+    if (unCmd >= CMD_TABLE_SIZE)
+        return NULL;
+
+    const CMD_ENTRY* pstEntry = &pstCmdTable->astEntry[unCmd];
+    if (pstEntry->pstSubTable && pstEntry->pstSubTable[uchSubModule].pfnHandler)
+        return &pstEntry->pstSubTable[uchSubModule];
+
+    return pstEntry->pfnHandler ? pstEntry : NULL;
+}
+
+#endif /* CMD_TABLE_H */
@@ -0,0 +1,223 @@
+#include "compress.h"
+#include <stdint.h>
+#include <string.h>
+
+#define LZ4_MIN_MATCH       4
+#define LZ4_LAST_LITERALS   5       /* 블록 끝 5바이트는 항상 리터럴 */
+#define LZ4_MF_LIMIT        12      /* 마지막 일치는 블록 끝 12바이트 전에 시작 */
+#define LZ4_MAX_OFFSET      65535
+#define LZ4_HASH_LOG_MAX    12
+#define LZ4_HASH_LOG_MIN    8
+
+static inline uint32_t lz4Read32(const unsigned char* puch)
+{
+    uint32_t uiVal;
+    memcpy(&uiVal, puch, sizeof(uiVal));
+    return uiVal;
+}
+
+static inline uint64_t lz4Read64(const unsigned char* puch)
+{
+    uint64_t ulVal;
+    memcpy(&ulVal, puch, sizeof(ulVal));
+    return ulVal;
+}
+
+static inline uint32_t lz4Hash(uint32_t uiSeq, int iHashLog)
+{
+    return (uiSeq * 2654435761u) >> (32 - iHashLog);
+}
+
+/* 길이 255 단위 연장 바이트 기록 */
+static inline unsigned char* lz4WriteLength(unsigned char* puchOut, size_t ulLength)
+{
+    while (ulLength >= 255) {
+        *puchOut++ = 255;
+        ulLength -= 255;
+    }
+    *puchOut++ = (unsigned char)ulLength;
+    return puchOut;
+}
+
+/* 일치 길이 계산: 8바이트씩 비교 후 첫 불일치 바이트 위치 */
+static inline size_t lz4MatchLength(const unsigned char* puchIn, const unsigned char* puchRef,
+        const unsigned char* puchLimit)
+{
+    const unsigned char* puchStart = puchIn;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (puchIn + 8 <= puchLimit) {
+        uint64_t ulDiff = lz4Read64(puchIn) ^ lz4Read64(puchRef);
+        if (ulDiff)
+            return (size_t)(puchIn - puchStart) + ((size_t)__builtin_ctzll(ulDiff) >> 3);
+        puchIn += 8;
+        puchRef += 8;
+    }
+#endif
+    while (puchIn < puchLimit && *puchIn == *puchRef) {
+        puchIn++;
+        puchRef++;
+    }
+    return (size_t)(puchIn - puchStart);
+}
+
+size_t compressLz4(const void* pvSrc, size_t ulSrcSize, void* pvDst, size_t ulDstCap)
+{
+    const unsigned char* puchBase   = (const unsigned char*)pvSrc;
+    const unsigned char* puchIn     = puchBase;
+    const unsigned char* puchAnchor = puchBase;
+    const unsigned char* puchEnd    = puchBase + ulSrcSize;
+    unsigned char* puchOut          = (unsigned char*)pvDst;
+    unsigned char* puchOutEnd       = puchOut + ulDstCap;
+    uint32_t auiHash[1 << LZ4_HASH_LOG_MAX];
+
+    /* 입력이 작으면 해시 테이블도 작게 (초기화 비용이 입력 크기에 비례하도록) */
+    int iHashLog = LZ4_HASH_LOG_MIN;
+    while (iHashLog < LZ4_HASH_LOG_MAX && ((size_t)1 << iHashLog) < ulSrcSize)
+        iHashLog++;
+
+    if (ulSrcSize > UINT32_MAX)
+        return 0;
+
+    if (ulSrcSize >= LZ4_MF_LIMIT + 1) {
+        const unsigned char* puchMfLimit    = puchEnd - LZ4_MF_LIMIT;
+        const unsigned char* puchMatchLimit = puchEnd - LZ4_LAST_LITERALS;
+        memset(auiHash, 0, sizeof(uint32_t) << iHashLog);
+
+        auiHash[lz4Hash(lz4Read32(puchIn), iHashLog)] = 0;
+        puchIn++;
+
+        while (puchIn < puchMfLimit) {
+            uint32_t uiSeq = lz4Read32(puchIn);
+            uint32_t uiHash = lz4Hash(uiSeq, iHashLog);
+            const unsigned char* puchRef = puchBase + auiHash[uiHash];
+            auiHash[uiHash] = (uint32_t)(puchIn - puchBase);
+
+            if (puchRef >= puchIn || puchIn - puchRef > LZ4_MAX_OFFSET || lz4Read32(puchRef) != uiSeq) {
+                /* 일치가 오래 없으면 보폭을 늘려 압축 불가 구간을 빨리 지나간다 */
+                puchIn += 1 + ((size_t)(puchIn - puchAnchor) >> 6);
+                continue;
+            }
+
+            while (puchIn > puchAnchor && puchRef > puchBase && puchIn[-1] == puchRef[-1]) {
+                puchIn--;
+                puchRef--;
+            }
+
+            size_t ulLitLen = (size_t)(puchIn - puchAnchor);
+            size_t ulMatchLen = lz4MatchLength(puchIn + LZ4_MIN_MATCH, puchRef + LZ4_MIN_MATCH,
+                puchMatchLimit);
+
+            /* 토큰 + 리터럴 + 오프셋 + 길이 연장 바이트 */
+            if (puchOut + 1 + ulLitLen / 255 + 1 + ulLitLen + 2 + ulMatchLen / 255 + 1 > puchOutEnd)
+                return 0;
+
+            unsigned char* puchToken = puchOut++;
+            if (ulLitLen >= 15) {
+                *puchToken = 15 << 4;
+                puchOut = lz4WriteLength(puchOut, ulLitLen - 15);
+            } else {
+                *puchToken = (unsigned char)(ulLitLen << 4);
+            }
+            memcpy(puchOut, puchAnchor, ulLitLen);
+            puchOut += ulLitLen;
+
+            size_t ulOffset = (size_t)(puchIn - puchRef);
+            *puchOut++ = (unsigned char)(ulOffset & 0xFF);
+            *puchOut++ = (unsigned char)(ulOffset >> 8);
+
+            if (ulMatchLen >= 15) {
+                *puchToken |= 15;
+                puchOut = lz4WriteLength(puchOut, ulMatchLen - 15);
+            } else {
+                *puchToken |= (unsigned char)ulMatchLen;
+            }
+
+            puchIn += LZ4_MIN_MATCH + ulMatchLen;
+            puchAnchor = puchIn;
+            if (puchIn < puchMfLimit)
+                auiHash[lz4Hash(lz4Read32(puchIn - 2), iHashLog)] = (uint32_t)(puchIn - 2 - puchBase);
+        }
+    }
+
+    /* 마지막 리터럴 */
+    size_t ulLitLen = (size_t)(puchEnd - puchAnchor);
+    if (puchOut + 1 + ulLitLen / 255 + 1 + ulLitLen > puchOutEnd)
+        return 0;
+    if (ulLitLen >= 15) {
+        *puchOut++ = 15 << 4;
+        puchOut = lz4WriteLength(puchOut, ulLitLen - 15);
+    } else {
+        *puchOut++ = (unsigned char)(ulLitLen << 4);
+    }
+    memcpy(puchOut, puchAnchor, ulLitLen);
+    puchOut += ulLitLen;
+    return (size_t)(puchOut - (unsigned char*)pvDst);
+}
+
+/* 길이 연장 바이트 읽기, return: -1 입력 끝 */
+static inline int lz4ReadLength(const unsigned char** ppuchIn, const unsigned char* puchEnd, size_t* pulLength)
+{
+    unsigned char uchByte;
+    do {
+        if (*ppuchIn >= puchEnd)
+            return -1;
+        uchByte = *(*ppuchIn)++;
+        *pulLength += uchByte;
+    } while (uchByte == 255);
+    return 0;
+}
+
+long decompressLz4(const void* pvSrc, size_t ulSrcSize, void* pvDst, size_t ulDstCap)
+{
+    const unsigned char* puchIn     = (const unsigned char*)pvSrc;
+    const unsigned char* puchEnd    = puchIn + ulSrcSize;
+    unsigned char* puchBase         = (unsigned char*)pvDst;
+    unsigned char* puchOut          = puchBase;
+    unsigned char* puchOutEnd       = puchBase + ulDstCap;
+
+    while (puchIn < puchEnd) {
+        unsigned char uchToken = *puchIn++;
+
+        size_t ulLitLen = uchToken >> 4;
+        if (ulLitLen == 15 && lz4ReadLength(&puchIn, puchEnd, &ulLitLen) < 0)
+            return -1;//COMPRESS_ERR_CORRUPT
+        if (ulLitLen > (size_t)(puchEnd - puchIn) || ulLitLen > (size_t)(puchOutEnd - puchOut))
+            return -1;//COMPRESS_ERR_CORRUPT
+        memcpy(puchOut, puchIn, ulLitLen);
+        puchOut += ulLitLen;
+        puchIn += ulLitLen;
+
+        if (puchIn == puchEnd)
+            break;      /* 마지막 시퀀스는 리터럴만 */
+
+        if (puchEnd - puchIn < 2)
+            return -1;//COMPRESS_ERR_CORRUPT
+        size_t ulOffset = (size_t)puchIn[0] | ((size_t)puchIn[1] << 8);
+        puchIn += 2;
+        if (ulOffset == 0 || ulOffset > (size_t)(puchOut - puchBase))
+            return -1;//COMPRESS_ERR_CORRUPT
+
+        size_t ulMatchLen = uchToken & 15;
+        if (ulMatchLen == 15 && lz4ReadLength(&puchIn, puchEnd, &ulMatchLen) < 0)
+            return -1;//COMPRESS_ERR_CORRUPT
+        ulMatchLen += LZ4_MIN_MATCH;
+        if (ulMatchLen > (size_t)(puchOutEnd - puchOut))
+            return -1;//COMPRESS_ERR_CORRUPT
+
+        const unsigned char* puchRef = puchOut - ulOffset;
+        if (ulOffset >= 8 && (size_t)(puchOutEnd - puchOut) >= ulMatchLen + 8) {
+            /* 겹치지 않는 8바이트 단위 복사 (끝의 초과 기록은 다음 시퀀스가 덮어씀) */
+            unsigned char* puchStop = puchOut + ulMatchLen;
+            while (puchOut < puchStop) {
+                memcpy(puchOut, puchRef, 8);
+                puchOut += 8;
+                puchRef += 8;
+            }
+            puchOut = puchStop;
+        } else {
+            for (size_t i = 0; i < ulMatchLen; i++)
+                *puchOut++ = *puchRef++;
+        }
+    }
+    return (long)(puchOut - puchBase);
+}
@@ -0,0 +1,24 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stddef.h>
+
+/*
+ * 프레임 페이로드 압축 (LZ4 블록 포맷 호환, 외부 라이브러리 없음)
+ *  - 해시 테이블 1개로 4바이트 일치를 찾는 단일 패스 압축 (속도 우선)
+ *  - 해제는 입력/출력 경계를 모두 검사 (손상된 입력에도 안전)
+ */
+
+/* 최악의 경우 압축 결과 크기 */
+static inline size_t compressBound(size_t ulSize)
+{
+    return ulSize + ulSize / 255 + 16;
+}
+
+/* return: 압축 크기, 0 출력 공간 부족 (압축 이득 없음으로 취급) */
+size_t compressLz4(const void* pvSrc, size_t ulSrcSize, void* pvDst, size_t ulDstCap);
+
+/* return: 해제 크기, -1 손상된 입력 또는 출력 공간 부족 */
+long decompressLz4(const void* pvSrc, size_t ulSrcSize, void* pvDst, size_t ulDstCap);
+
+#endif /* COMPRESS_H */
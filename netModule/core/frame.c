@@ -1,194 +1,967 @@
 #include "frame.h"
 #include "icdCommand.h"
+#include "cmdTable.h"
+#include "checksum.h"
+#include "trace.h"
+#include "inflight.h"
+#include "compress.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <arpa/inet.h>
 #include <event2/buffer.h>
 
+#ifndef FRAME_SMALL_ENCODE_SIZE
+#define FRAME_SMALL_ENCODE_SIZE     512
+#endif
+
 /* ===== Helpers (inline) ===== */
-static inline uint8_t proto_crc8_xor(const uint8_t* p, size_t n) {
-    uint8_t c = 0; for (size_t i=0;i<n;i++) c ^= p[i]; return c;
+/* 테일 = 체크섬(네트워크 바이트 순서, 1/2/4 bytes) + ETX */
+static inline size_t frameBuildTail(unsigned char* puchTail, unsigned char uchCrcMode, uint32_t uiCrc)
+{
+    size_t ulCrcSize = checksumSize(uchCrcMode);
+    for (size_t i = 0; i < ulCrcSize; i++)
+        puchTail[i] = (unsigned char)(uiCrc >> (8 * (ulCrcSize - 1 - i)));
+    puchTail[ulCrcSize]     = (unsigned char)(ETX_CONST >> 8);
+    puchTail[ulCrcSize + 1] = (unsigned char)(ETX_CONST & 0xFF);
+    return ulCrcSize + sizeof(unsigned short);
 }
 
-/* === 프레임 송신 === */
-int writeFrame(struct bufferevent* pstBufferEvent, unsigned short unCmd,
-                       const MSG_ID* pstMsgId, unsigned char uchSubModule,
-                       const void* pvPayload, int iDataLength)
+static inline uint32_t frameTailCrc(const unsigned char* puchTail, unsigned char uchCrcMode)
+{
+    uint32_t uiCrc = 0;
+    for (size_t i = 0; i < checksumSize(uchCrcMode); i++)
+        uiCrc = (uiCrc << 8) | puchTail[i];
+    return uiCrc;
+}
+
+/* === 예약 공간(iovec) 순차 기록 커서 === */
+typedef struct {
+    struct evbuffer_iovec   *pstVec;
+    int                     iVecCnt;
+    int                     iIdx;
+    size_t                  ulOff;
+} IOV_CURSOR;
+
+static inline void iovCursorWrite(IOV_CURSOR* pstCursor, const void* pvSrc, size_t ulSize)
+{
+    const unsigned char* puchSrc = (const unsigned char*)pvSrc;
+    while (ulSize > 0 && pstCursor->iIdx < pstCursor->iVecCnt) {
+        struct evbuffer_iovec* pstVec = &pstCursor->pstVec[pstCursor->iIdx];
+        size_t ulRoom = pstVec->iov_len - pstCursor->ulOff;
+        size_t ulCopy = ulSize < ulRoom ? ulSize : ulRoom;
+        memcpy((unsigned char*)pstVec->iov_base + pstCursor->ulOff, puchSrc, ulCopy);
+        puchSrc += ulCopy;
+        ulSize -= ulCopy;
+        pstCursor->ulOff += ulCopy;
+        if (pstCursor->ulOff == pstVec->iov_len) {
+            pstCursor->iIdx++;
+            pstCursor->ulOff = 0;
+        }
+    }
+}
+
+/* === 헤더 길이 (상관 ID/플래그가 있으면 확장 헤더 포함) === */
+static inline size_t frameExtSize(const FRAME_IOV* pstFrame)
 {
-    FRAME_HEADER stFrameHeader;
-    FRAME_TAIL   stFrameTail;
+    if (!pstFrame->uiSeq && !pstFrame->uchFlags)
+        return 0;
+    return sizeof(FRAME_HEADER_EXT) + ((pstFrame->uchFlags & FRAME_FLAG_FRAG) ? sizeof(FRAME_FRAG_EXT) : 0);
+}
 
-    stFrameHeader.unStx             = htons(STX_CONST);
-    stFrameHeader.iDataLength       = htonl(iDataLength);
+static inline size_t frameHeaderSize(const FRAME_IOV* pstFrame)
+{
+    return sizeof(FRAME_HEADER) + frameExtSize(pstFrame);
+}
+
+/* === 프레임 하나를 커서 위치에 기록 === */
+static inline void frameWriteOne(IOV_CURSOR* pstCursor, unsigned char uchCrcMode,
+        const MSG_ID* pstMsgId, const FRAME_IOV* pstFrame)
+{
+    FRAME_HEADER  stFrameHeader;
+    unsigned char auchTail[FRAME_TAIL_MAX_SIZE];
+
+    size_t ulExtSize = frameExtSize(pstFrame);
+    stFrameHeader.unStx             = htons(ulExtSize ? STX_EXT_CONST : STX_CONST);
+    stFrameHeader.iDataLength       = htonl(pstFrame->iDataLength);
     stFrameHeader.stMsgId.uchSrcId  = pstMsgId->uchSrcId;
     stFrameHeader.stMsgId.uchDstId  = pstMsgId->uchDstId;
-    stFrameHeader.uchSubModule      = uchSubModule;
-    stFrameHeader.unCmd             = htons(unCmd);
+    stFrameHeader.uchSubModule      = pstFrame->uchSubModule;
+    stFrameHeader.unCmd             = htons(pstFrame->unCmd);
 
-    stFrameTail.uchCrc              = proto_crc8_xor((const unsigned char*)pvPayload, (int)iDataLength);
-    stFrameTail.unEtx               = htons(ETX_CONST);
+    size_t ulTailSize = frameBuildTail(auchTail, uchCrcMode,
+        checksumCalc(uchCrcMode, pstFrame->pvPayload, (size_t)pstFrame->iDataLength));
 
-    /* === 전체 프레임 크기 계산 === */
-    int iTotalSize = sizeof(FRAME_HEADER) + iDataLength + sizeof(FRAME_TAIL);
-    unsigned char* puchPacket = (unsigned char*)malloc(iTotalSize);
-    if (!puchPacket) {
-        fprintf(stderr, "malloc() failed in writeFrame\n");
-        return -1;//FRAME_ERR_MEMORY_ALLOC_FAIL
-    }    
-
-    unsigned char* uchPayload = puchPacket;
-    memcpy((void*)uchPayload, &stFrameHeader, sizeof(FRAME_HEADER)); 
-    uchPayload += sizeof(FRAME_HEADER);
-    if (iDataLength > 0 && pvPayload) {
-        memcpy((void*)uchPayload, pvPayload, iDataLength);
-        uchPayload += iDataLength;
-    }
-    memcpy((void*)uchPayload, &stFrameTail, sizeof(FRAME_TAIL));
-    if (bufferevent_write(pstBufferEvent, puchPacket, iTotalSize) < 0) {
-        fprintf(stderr, "bufferevent_write() failed in writeFrame\n");
+    iovCursorWrite(pstCursor, &stFrameHeader, sizeof(FRAME_HEADER));
+    if (ulExtSize) {
+        FRAME_HEADER_EXT stExt;
+        stExt.uchExtLen = (unsigned char)ulExtSize;
+        stExt.uchFlags  = pstFrame->uchFlags;
+        stExt.uiSeq     = htonl(pstFrame->uiSeq);
+        iovCursorWrite(pstCursor, &stExt, sizeof(FRAME_HEADER_EXT));
+        if (pstFrame->uchFlags & FRAME_FLAG_FRAG) {
+            FRAME_FRAG_EXT stFrag;
+            stFrag.uiXferId = htonl(pstFrame->uiXferId);
+            stFrag.uiOffset = htonl(pstFrame->uiFragOffset);
+            iovCursorWrite(pstCursor, &stFrag, sizeof(FRAME_FRAG_EXT));
+        }
+    }
+    if (pstFrame->iDataLength > 0)
+        iovCursorWrite(pstCursor, pstFrame->pvPayload, (size_t)pstFrame->iDataLength);
+    iovCursorWrite(pstCursor, auchTail, ulTailSize);
+}
+
+/* === 프레임 인코딩 (N개) ===
+ * 임시 패킷 malloc 없이 출력 evbuffer에 헤더/페이로드/테일을 기록한다.
+ *  - 작은 프레임 : 스택에서 조립 후 evbuffer_add() 한 번
+ *  - 큰 프레임   : 예약 공간(최대 2개 chain)에 직접 기록, 페이로드는 한 번만 복사
+ * 단일 chain 예약은 기존 chain 내용을 재복사할 수 있으므로 2개 iovec을 사용한다.
+ * 여러 프레임도 한 번의 예약/커밋으로 기록하므로 출력 콜백은 한 번만 호출된다.
+ */
+static int encodeFrames(struct evbuffer* pstEvBuffer, unsigned char uchCrcMode,
+        const MSG_ID* pstMsgId, const FRAME_IOV* pstFrames, int iFrameCnt)
+{
+    struct evbuffer_iovec astVec[2];
+    unsigned char auchPacket[FRAME_SMALL_ENCODE_SIZE];
+    size_t ulTotalSize = 0;
+    int iVecCnt;
+
+    if (!pstEvBuffer || !pstMsgId || !pstFrames || iFrameCnt <= 0)
+        return -1;//FRAME_ERR_INVALID_ARG
+
+    for (int i = 0; i < iFrameCnt; i++) {
+        if (pstFrames[i].iDataLength < 0 || (pstFrames[i].iDataLength > 0 && !pstFrames[i].pvPayload))
+            return -1;//FRAME_ERR_INVALID_ARG
+        ulTotalSize += frameHeaderSize(&pstFrames[i]) + (size_t)pstFrames[i].iDataLength + frameTailSize(uchCrcMode);
+    }
+
+    /* reserve/commit 비용이 memcpy보다 큰 구간 */
+    if (ulTotalSize <= FRAME_SMALL_ENCODE_SIZE) {
+        astVec[0].iov_base = auchPacket;
+        astVec[0].iov_len  = ulTotalSize;
+        iVecCnt = 1;
+    } else {
+        iVecCnt = evbuffer_reserve_space(pstEvBuffer, ulTotalSize, astVec, 2);
+        if (iVecCnt <= 0) {
+            fprintf(stderr, "evbuffer_reserve_space() failed in encodeFrames\n");
+            return -1;//FRAME_ERR_MEMORY_ALLOC_FAIL
+        }
+
+        /* 예약된 공간은 ulTotalSize 이상이 보장되므로 실제 사용 길이로 잘라낸다 */
+        size_t ulRemain = ulTotalSize;
+        for (int i = 0; i < iVecCnt; i++) {
+            if (astVec[i].iov_len > ulRemain)
+                astVec[i].iov_len = ulRemain;
+            ulRemain -= astVec[i].iov_len;
+            if (astVec[i].iov_len == 0) {
+                iVecCnt = i;
+                break;
+            }
+        }
+    }
+
+    IOV_CURSOR stCursor = { astVec, iVecCnt, 0, 0 };
+    for (int i = 0; i < iFrameCnt; i++)
+        frameWriteOne(&stCursor, uchCrcMode, pstMsgId, &pstFrames[i]);
+
+    if (astVec[0].iov_base == auchPacket) {
+        if (evbuffer_add(pstEvBuffer, auchPacket, ulTotalSize) < 0) {
+            fprintf(stderr, "evbuffer_add() failed in encodeFrames\n");
+            return -1;//FRAME_ERR_MEMORY_ALLOC_FAIL
+        }
+    } else if (evbuffer_commit_space(pstEvBuffer, astVec, iVecCnt) < 0) {
+        fprintf(stderr, "evbuffer_commit_space() failed in encodeFrames\n");
         return -1;//FRAME_ERR_MEMORY_ALLOC_FAIL
     }
-    free(puchPacket);
+    return iFrameCnt;
+}
+
+int encodeFrameCrc(struct evbuffer* pstEvBuffer, unsigned char uchCrcMode, unsigned short unCmd,
+                       const MSG_ID* pstMsgId, unsigned char uchSubModule,
+                       const void* pvPayload, int iDataLength)
+{
+    FRAME_IOV stFrame = { unCmd, uchSubModule, pvPayload, iDataLength };
+    return encodeFrames(pstEvBuffer, uchCrcMode, pstMsgId, &stFrame, 1) < 0 ? -1 : 1;
+}
+
+int encodeFrameBatch(struct evbuffer* pstEvBuffer, unsigned char uchCrcMode,
+                       const MSG_ID* pstMsgId, const FRAME_IOV* pstFrames, int iFrameCnt)
+{
+    return encodeFrames(pstEvBuffer, uchCrcMode, pstMsgId, pstFrames, iFrameCnt);
+}
+
+int encodeFrame(struct evbuffer* pstEvBuffer, unsigned short unCmd,
+                       const MSG_ID* pstMsgId, unsigned char uchSubModule,
+                       const void* pvPayload, int iDataLength)
+{
+    return encodeFrameCrc(pstEvBuffer, CRC_MODE_XOR8, unCmd, pstMsgId, uchSubModule,
+        pvPayload, iDataLength);
+}
+
+/* === 프레임 송신 === */
+int writeFrame(struct bufferevent* pstBufferEvent, unsigned short unCmd,
+                       const MSG_ID* pstMsgId, unsigned char uchSubModule,
+                       const void* pvPayload, int iDataLength)
+{
+    if (!pstBufferEvent)
+        return -1;
+
+    /* 출력 버퍼에 직접 기록 → bufferevent가 쓰기 이벤트를 예약한다 */
+    if (encodeFrame(bufferevent_get_output(pstBufferEvent), unCmd, pstMsgId,
+            uchSubModule, pvPayload, iDataLength) < 0) {
+        fprintf(stderr, "encodeFrame() failed in writeFrame\n");
+        return -1;
+    }
     return 1;
 }
 
 
-/* === 프레임 하나 파싱 & 응답 처리 ===
- * return: 1 consumed, 0 need more, -1 fatal
+/* === 여러 프레임 일괄 송신 ===
+ * N개 프레임을 출력 버퍼에 한 번에 인코딩한다. bufferevent는 다음 쓰기 가능
+ * 시점에 출력 버퍼 전체를 writev 한 번으로 커널에 넘기므로, 응답 버스트에서
+ * 프레임당 쓰기 예약/시스템 호출이 줄어든다.
+ * return: 기록한 프레임 수, -1 실패 (실패 시 아무것도 기록하지 않음)
  */
-int responseFrame(struct evbuffer* pstEvBuffer, struct bufferevent  *pstBufferEvent, 
-    MSG_ID* pstMsgId, char chReply) 
+int writeFrameBatch(struct bufferevent* pstBufferEvent, const MSG_ID* pstMsgId,
+                       const FRAME_IOV* pstFrames, int iFrameCnt)
+{
+    if (!pstBufferEvent)
+        return -1;
+
+    int iRet = encodeFrames(bufferevent_get_output(pstBufferEvent), CRC_MODE_XOR8,
+        pstMsgId, pstFrames, iFrameCnt);
+    if (iRet < 0)
+        fprintf(stderr, "encodeFrames() failed in writeFrameBatch\n");
+    return iRet;
+}
+
+int writeFrameBatchCtx(FRAME_CTX* pstFrameCtx, const FRAME_IOV* pstFrames, int iFrameCnt)
 {
-    FRAME_HEADER stFrameHeader;
-    int iLength = evbuffer_get_length(pstEvBuffer);
-    fprintf(stderr,"### %s():%d Recv Data Length is %d[%ld]\n", 
-        __func__, __LINE__, iLength, 
-        sizeof(FRAME_HEADER)+sizeof(FRAME_TAIL)+sizeof(REQ_KEEP_ALIVE));
-    
-    if (iLength < sizeof(FRAME_HEADER)){
-        return 0;//FRAME_ERR_PACKET_TOO_SHORT
+    struct evbuffer* pstOutput = pstFrameCtx ? frameOutput(pstFrameCtx) : NULL;
+    if (!pstOutput)
+        return -1;
+
+    size_t ulBefore = evbuffer_get_length(pstOutput);
+    int iRet = encodeFrames(pstOutput, pstFrameCtx->uchCrcMode, &pstFrameCtx->stMsgId, pstFrames, iFrameCnt);
+    if (iRet < 0) {
+        fprintf(stderr, "encodeFrames() failed in writeFrameBatchCtx\n");
+        return iRet;
     }
+    pstFrameCtx->ulTxFrameCnt   += (unsigned long)iRet;
+    pstFrameCtx->ulTxBytes      += evbuffer_get_length(pstOutput) - ulBefore;
+    return iRet;
+}
 
-    if (evbuffer_copyout(pstEvBuffer, &stFrameHeader, sizeof(stFrameHeader)) != sizeof(stFrameHeader)){
-        return 0;//EV_COPYOUT_SIZE_MISMATCH
+
+/* === 입력 버퍼 선두 ulSize 바이트에 대한 연속 포인터 ===
+ * 첫 chain에 모두 들어있으면 복사 없이 그 주소를 돌려주고,
+ * chain 경계를 넘는 경우에만 pullup(선형화)한다.
+ */
+static inline const unsigned char* frameContiguous(struct evbuffer* pstEvBuffer, size_t ulSize)
+{
+    struct evbuffer_iovec stVec;
+    if (evbuffer_peek(pstEvBuffer, -1, NULL, &stVec, 1) >= 1 && stVec.iov_len >= ulSize)
+        return (const unsigned char*)stVec.iov_base;
+    return (const unsigned char*)evbuffer_pullup(pstEvBuffer, (ev_ssize_t)ulSize);
+}
+
+/* === 재사용 버퍼 확보 (부족할 때만 확장) === */
+static inline unsigned char* frameScratch(unsigned char** ppuchBuf, size_t* pulCap, size_t ulNeed)
+{
+    if (ulNeed > *pulCap) {
+        unsigned char* puchNew = realloc(*ppuchBuf, ulNeed);
+        if (!puchNew)
+            return NULL;
+        *ppuchBuf = puchNew;
+        *pulCap = ulNeed;
     }
+    return *ppuchBuf;
+}
 
-    unsigned short  unStx   = ntohs(stFrameHeader.unStx);
-    int iDataLength = ntohl(stFrameHeader.iDataLength);
-    unsigned short  unCmd  = ntohs(stFrameHeader.unCmd);
+/* === 공유 프레임: 한 번 인코딩, 참조로 여러 번 송신 === */
+FRAME_SHARED* frameSharedEncode(unsigned char uchCrcMode, const MSG_ID* pstMsgId, const FRAME_IOV* pstFrame)
+{
+    if (!pstMsgId || !pstFrame || pstFrame->iDataLength < 0 ||
+            (pstFrame->iDataLength > 0 && !pstFrame->pvPayload))
+        return NULL;
 
-    if (unStx != STX_CONST || iDataLength < 0)
-        return -1;////FRAME_ERR_STX_NOT_MATCH
+    size_t ulSize = frameHeaderSize(pstFrame) + (size_t)pstFrame->iDataLength + frameTailSize(uchCrcMode);
+    FRAME_SHARED* pstShared = malloc(sizeof(FRAME_SHARED) + ulSize);
+    if (!pstShared)
+        return NULL;
+    pstShared->iRefCnt  = 1;
+    pstShared->ulSize   = ulSize;
 
-    int iNeedSize = sizeof(FRAME_HEADER) + (size_t)iDataLength + sizeof(FRAME_TAIL);
-    if (iLength < iNeedSize){
-        return 0;//EV_INCOMPETE_PACKET_IN_BUFFER
+    struct evbuffer_iovec stVec = { pstShared->auchData, ulSize };
+    IOV_CURSOR stCursor = { &stVec, 1, 0, 0 };
+    frameWriteOne(&stCursor, uchCrcMode, pstMsgId, pstFrame);
+    return pstShared;
+}
+
+void frameSharedRelease(FRAME_SHARED* pstShared)
+{
+    if (pstShared && __atomic_sub_fetch(&pstShared->iRefCnt, 1, __ATOMIC_ACQ_REL) == 0)
+        free(pstShared);
+}
+
+/* evbuffer 가 참조 chain 을 다 보내거나 버릴 때 호출 */
+static void frameSharedCleanup(const void* pvData, size_t ulSize, void* pvExtra)
+{
+    (void)pvData; (void)ulSize;
+    frameSharedRelease((FRAME_SHARED*)pvExtra);
+}
+
+int frameSharedAttach(FRAME_SHARED* pstShared, struct evbuffer* pstEvBuffer, size_t ulCopyMax)
+{
+    if (!pstShared || !pstEvBuffer)
+        return -1;
+    if (pstShared->ulSize <= ulCopyMax)
+        return evbuffer_add(pstEvBuffer, pstShared->auchData, pstShared->ulSize) < 0 ? -1 : 1;
+
+    __atomic_add_fetch(&pstShared->iRefCnt, 1, __ATOMIC_RELAXED);
+    if (evbuffer_add_reference(pstEvBuffer, pstShared->auchData, pstShared->ulSize,
+            frameSharedCleanup, pstShared) < 0) {
+        frameSharedRelease(pstShared);
+        return -1;
     }
+    return 1;
+}
+
+/* === 세션 설정(체크섬 모드, 응답 ID, 압축)으로 프레임 하나 송신 ===
+ * 압축이 협상됐고 페이로드가 iCompressMin 이상이면 압축해 보낸다.
+ * 압축 결과가 원본보다 작지 않으면 원본을 그대로 보낸다.
+ * 송신 혼잡(chTxShed) 중이면 단발 프레임은 버리고 0을 돌려준다.
+ */
+int writeFrameIovCtx(FRAME_CTX* pstFrameCtx, const FRAME_IOV* pstFrame)
+{
+    if (!pstFrameCtx || !frameOutput(pstFrameCtx) || !pstFrame)
+        return -1;
 
-    evbuffer_drain(pstEvBuffer, sizeof(FRAME_HEADER));
+    if (frameTxShed(pstFrameCtx, pstFrame->uiSeq, pstFrame->uchFlags))
+        return 0;//FRAME_TX_SHED
 
-    unsigned char *uchPayload = NULL;
-    if (iDataLength > 0) {
-        uchPayload = (unsigned char *)malloc((size_t)iDataLength);
-        if (!uchPayload){
-            return -1;//FRAME_ERR_MEMORY_ALLOC_FAIL
-        }
-        if (evbuffer_remove(pstEvBuffer, uchPayload, (size_t)iDataLength) != iDataLength) {
-            free(uchPayload); 
-            return -1;//EV_REMOVE_SIZE_MISMATCH
+    FRAME_IOV stFrame = *pstFrame;
+    if ((pstFrameCtx->uchActiveCaps & FRAME_CAP_COMPRESS) && stFrame.pvPayload &&
+            stFrame.iDataLength >= pstFrameCtx->iCompressMin && stFrame.iDataLength > 8) {
+        unsigned char* puchComp = frameScratch(&pstFrameCtx->puchTxScratch,
+            &pstFrameCtx->ulTxScratchCap, (size_t)stFrame.iDataLength);
+        size_t ulComp = puchComp ? compressLz4(stFrame.pvPayload, (size_t)stFrame.iDataLength,
+            puchComp + 4, (size_t)stFrame.iDataLength - 4 - 1) : 0;
+        if (ulComp > 0) {
+            uint32_t uiRawLen = htonl((uint32_t)stFrame.iDataLength);
+            memcpy(puchComp, &uiRawLen, sizeof(uiRawLen));
+            stFrame.pvPayload   = puchComp;
+            stFrame.iDataLength = (int)(ulComp + 4);
+            stFrame.uchFlags    |= FRAME_FLAG_COMPRESSED;
         }
     }
 
-    FRAME_TAIL stFrameTail;
-    if (evbuffer_remove(pstEvBuffer, &stFrameTail, sizeof(stFrameTail)) != (int)sizeof(stFrameTail)) {
-        free(uchPayload);
-        return -1;//EV_REMOVE_SIZE_MISMATCH
+    struct evbuffer* pstOutput = frameOutput(pstFrameCtx);
+    size_t ulBefore = evbuffer_get_length(pstOutput);
+    if (encodeFrames(pstOutput, pstFrameCtx->uchCrcMode, &pstFrameCtx->stMsgId, &stFrame, 1) < 0) {
+        fprintf(stderr, "encodeFrames() failed in writeFrameIovCtx\n");
+        return -1;
     }
+    pstFrameCtx->ulTxRawBytes   += (unsigned long)pstFrame->iDataLength;
+    pstFrameCtx->ulTxWireBytes  += (unsigned long)stFrame.iDataLength;
+    pstFrameCtx->ulTxFrameCnt++;
+    pstFrameCtx->ulTxBytes      += evbuffer_get_length(pstOutput) - ulBefore;
+    return 1;
+}
+
+/* === 세션 설정으로 프레임 송신 ===
+ * 상관 ID가 있는 요청을 처리하는 중이면 응답에 같은 ID를 싣는다.
+ */
+int writeFrameCtx(FRAME_CTX* pstFrameCtx, unsigned short unCmd, unsigned char uchSubModule,
+                       const void* pvPayload, int iDataLength)
+{
+    if (!pstFrameCtx)
+        return -1;
+
+    FRAME_IOV stFrame = { unCmd, uchSubModule, pvPayload, iDataLength,
+        pstFrameCtx->uiReplySeq, pstFrameCtx->uiReplySeq ? FRAME_FLAG_RESPONSE : 0, 0, 0 };
+    return writeFrameIovCtx(pstFrameCtx, &stFrame);
+}
+
+/* === 기본 ICD 명령 핸들러 ===
+ *  - 기본 가정: 요청 CMD와 응답 CMD가 동일
+ *  - 상관 ID가 있는 요청(inflightRequest)은 chReply 와 관계없이 응답한다
+ *  - 요청/응답 페이로드 크기가 명령마다 다르므로 크기 검사는 하지 않는다
+ */
+static int cmdReqIdHandler(FRAME_CTX* pstFrameCtx, const FRAME_VIEW* pstFrameView, void* pvUser)
+{
+    (void)pvUser;
+    RES_ID_CAPS stResId;
+    int iResSize = sizeof(RES_ID);
+    stResId.chResult = pstFrameCtx->stMsgId.uchSrcId;
+    stResId.uchCaps  = 0;
 
-    if (proto_crc8_xor(uchPayload, (size_t)iDataLength) != (unsigned char)stFrameTail.uchCrc) {
-        free(uchPayload); 
-        return -1;//FRAME_ERR_CRC_NOT_MATCH
+    if (pstFrameCtx->pfnPeerId && !(pstFrameView->uchFlags & FRAME_FLAG_RESPONSE))
+        pstFrameCtx->pfnPeerId(pstFrameCtx, pstFrameView->stMsgId.uchSrcId);
+
+    /* 기능 협상 요청: 양쪽이 허용하는 기능만 켜고 응답으로 알려준다 */
+    if (pstFrameView->iDataLength >= (int)sizeof(REQ_ID_CAPS)) {
+        const REQ_ID_CAPS* pstReq = (const REQ_ID_CAPS*)pstFrameView->puchPayload;
+        stResId.uchCaps = pstReq->uchCaps & pstFrameCtx->uchLocalCaps;
+        iResSize = sizeof(RES_ID_CAPS);
     }
 
-    if (ntohs(stFrameTail.unEtx) != ETX_CONST) {
-        free(uchPayload); 
-        return -1;//FRAME_ERR_ETX_NOT_MATCH
+    TRACE_INFO(TRACE_EV_RES_ID, pstFrameCtx->pvSession, pstFrameView->unCmd,
+        pstFrameView->iDataLength, stResId.chResult);
+    if (!pstFrameCtx->chReply && !pstFrameCtx->uiReplySeq)
+        return 1;
+    /* 협상 결과를 담은 응답을 실제로 보냈을 때만, 그 응답은 압축하지 않고 보낸 뒤 적용 */
+    if (writeFrameCtx(pstFrameCtx, CMD_REQ_ID, 0, &stResId, iResSize) == 1 &&
+            iResSize == (int)sizeof(RES_ID_CAPS))
+        pstFrameCtx->uchActiveCaps = stResId.uchCaps;
+    return 1;
+}
+
+static void frameNegotiateDone(int iStatus, const FRAME_VIEW* pstFrameView, void* pvUser)
+{
+    FRAME_CTX* pstFrameCtx = (FRAME_CTX*)pvUser;
+    if (iStatus == INFLIGHT_DONE && pstFrameView->iDataLength >= (int)sizeof(RES_ID_CAPS)) {
+        const RES_ID_CAPS* pstRes = (const RES_ID_CAPS*)pstFrameView->puchPayload;
+        pstFrameCtx->uchActiveCaps = pstRes->uchCaps & pstFrameCtx->uchLocalCaps;
     }
+}
 
-    fprintf(stderr,"### %s():%d CMD is %02x###\n",__func__,__LINE__, unCmd);
-    /* === 응답 처리 ===
-       - 기본 가정: 요청 CMD와 응답 CMD가 동일
-    */
-    switch (unCmd) {
-        case CMD_REQ_ID: {
-            RES_ID stResId;
-            stResId.chResult = pstMsgId->uchSrcId;
-            fprintf(stderr, "RES_ID : result=%d, len:%d\n", stResId.chResult, iDataLength);
-            if(chReply)
-                writeFrame(pstBufferEvent, CMD_REQ_ID, pstMsgId, 0, &stResId, sizeof(RES_ID));
+long frameNegotiate(FRAME_CTX* pstFrameCtx, unsigned char uchCaps, unsigned int uiTimeoutMs)
+{
+    REQ_ID_CAPS stReq;
+    stReq.chTmp   = 0x01;
+    stReq.uchCaps = uchCaps & pstFrameCtx->uchLocalCaps;
+    return inflightRequest(pstFrameCtx, CMD_REQ_ID, 0, &stReq, sizeof(stReq), uiTimeoutMs,
+        frameNegotiateDone, pstFrameCtx);
+}
 
+static int cmdKeepAliveHandler(FRAME_CTX* pstFrameCtx, const FRAME_VIEW* pstFrameView, void* pvUser)
+{
+    (void)pvUser;
+    RES_KEEP_ALIVE stResKeepAlive;
+    stResKeepAlive.chResult = 0x01;
+    TRACE_INFO(TRACE_EV_RES_KEEP_ALIVE, pstFrameCtx->pvSession, pstFrameView->unCmd,
+        pstFrameView->iDataLength, stResKeepAlive.chResult);
+    if (pstFrameCtx->chReply || pstFrameCtx->uiReplySeq)
+        writeFrameCtx(pstFrameCtx, CMD_KEEP_ALIVE, 0, &stResKeepAlive, sizeof(RES_KEEP_ALIVE));
+    return 1;
+}
+
+static int cmdIbitHandler(FRAME_CTX* pstFrameCtx, const FRAME_VIEW* pstFrameView, void* pvUser)
+{
+    (void)pvUser;
+    RES_IBIT stResIbit;
+    stResIbit.chBitTotResult = 0x01;
+    stResIbit.chPositionResult = 0x01;
+    TRACE_INFO(TRACE_EV_RES_IBIT, pstFrameCtx->pvSession, pstFrameView->unCmd,
+        pstFrameView->iDataLength, stResIbit.chBitTotResult);
+    if (pstFrameCtx->chReply || pstFrameCtx->uiReplySeq)
+        writeFrameCtx(pstFrameCtx, CMD_IBIT, 0, &stResIbit, sizeof(RES_IBIT));
+    return 1;
+}
+
+void frameRegisterDefaultCmds(CMD_TABLE* pstCmdTable)
+{
+    cmdRegister(pstCmdTable, CMD_REQ_ID,     CMD_ANY_SIZE, cmdReqIdHandler,     NULL);
+    cmdRegister(pstCmdTable, CMD_KEEP_ALIVE, CMD_ANY_SIZE, cmdKeepAliveHandler, NULL);
+    cmdRegister(pstCmdTable, CMD_IBIT,       CMD_ANY_SIZE, cmdIbitHandler,      NULL);
+}
+
+void frameCtxInit(FRAME_CTX* pstFrameCtx, struct bufferevent* pstBufferEvent,
+        const CMD_TABLE* pstCmdTable, void* pvSession)
+{
+    memset(pstFrameCtx, 0, sizeof(*pstFrameCtx));
+    pstFrameCtx->pstBufferEvent = pstBufferEvent;
+    pstFrameCtx->pstCmdTable    = pstCmdTable;
+    pstFrameCtx->pvSession      = pvSession;
+    pstFrameCtx->uiErrorBudget  = FRAME_ERROR_BUDGET_DEFAULT;
+    pstFrameCtx->ulReasmLimit   = FRAME_REASM_LIMIT_DEFAULT;
+    pstFrameCtx->uchLocalCaps   = FRAME_CAP_COMPRESS;
+    pstFrameCtx->iCompressMin   = FRAME_COMPRESS_MIN_DEFAULT;
+}
+
+void frameCtxFree(FRAME_CTX* pstFrameCtx)
+{
+    free(pstFrameCtx->puchReasm);
+    pstFrameCtx->puchReasm      = NULL;
+    pstFrameCtx->ulReasmSize    = 0;
+    pstFrameCtx->ulReasmCap     = 0;
+    pstFrameCtx->chReasmActive  = 0;
+    free(pstFrameCtx->puchTxScratch);
+    free(pstFrameCtx->puchRxScratch);
+    pstFrameCtx->puchTxScratch  = NULL;
+    pstFrameCtx->puchRxScratch  = NULL;
+    pstFrameCtx->ulTxScratchCap = 0;
+    pstFrameCtx->ulRxScratchCap = 0;
+}
+
+/* === 조각 송신 === */
+void frameStreamBegin(FRAME_CTX* pstFrameCtx, FRAME_STREAM* pstStream,
+        unsigned short unCmd, unsigned char uchSubModule)
+{
+    memset(pstStream, 0, sizeof(*pstStream));
+    pstStream->unCmd        = unCmd;
+    pstStream->uchSubModule = uchSubModule;
+    pstStream->uiSeq        = pstFrameCtx->uiReplySeq;     /* 상관 요청 처리 중이면 응답으로 */
+    pstStream->uiXferId     = ++pstFrameCtx->uiNextXferId;
+}
+
+int frameStreamWrite(FRAME_CTX* pstFrameCtx, FRAME_STREAM* pstStream,
+        const void* pvChunk, int iChunkLength, int iLast)
+{
+    if (!pstFrameCtx || !pstStream || iChunkLength < 0)
+        return -1;//FRAME_ERR_INVALID_ARG
+
+    unsigned char uchFlags = FRAME_FLAG_FRAG | (iLast ? FRAME_FLAG_LAST : 0) |
+        (pstStream->uiSeq ? FRAME_FLAG_RESPONSE : 0);
+    FRAME_IOV stFrame = { pstStream->unCmd, pstStream->uchSubModule, pvChunk, iChunkLength,
+        pstStream->uiSeq, uchFlags, pstStream->uiXferId, pstStream->uiOffset };
+    if (writeFrameIovCtx(pstFrameCtx, &stFrame) < 0)
+        return -1;
+    pstStream->uiOffset += (unsigned int)iChunkLength;
+    return 1;
+}
+
+int writeFrameFragmented(FRAME_CTX* pstFrameCtx, unsigned short unCmd, unsigned char uchSubModule,
+        const void* pvPayload, size_t ulLength, size_t ulFragSize)
+{
+    const unsigned char* puchPayload = (const unsigned char*)pvPayload;
+    FRAME_STREAM stStream;
+    int iFragCnt = 0;
+
+    if (!pstFrameCtx || (ulLength > 0 && !pvPayload) || ulLength > UINT32_MAX)
+        return -1;//FRAME_ERR_INVALID_ARG
+    if (ulFragSize == 0 || ulFragSize > FRAME_MAX_DATA_LENGTH)
+        ulFragSize = FRAME_FRAG_SIZE_DEFAULT;
+
+    frameStreamBegin(pstFrameCtx, &stStream, unCmd, uchSubModule);
+    size_t ulOffset = 0;
+    do {
+        size_t ulChunk = ulLength - ulOffset < ulFragSize ? ulLength - ulOffset : ulFragSize;
+        if (frameStreamWrite(pstFrameCtx, &stStream, puchPayload + ulOffset, (int)ulChunk,
+                ulOffset + ulChunk == ulLength) < 0)
+            return -1;
+        ulOffset += ulChunk;
+        iFragCnt++;
+    } while (ulOffset < ulLength);
+    return iFragCnt;
+}
+
+/* === 오류 1회 기록: 허용 횟수를 넘으면 -1 === */
+static inline int frameCountError(FRAME_CTX* pstFrameCtx)
+{
+    pstFrameCtx->chHeaderValid = 0;
+    pstFrameCtx->uiErrorCnt++;
+    return pstFrameCtx->uiErrorCnt > pstFrameCtx->uiErrorBudget ? -1 : 1;
+}
+
+/* === STX 재동기화 ===
+ * 선두에서 STX(0xAA 0x55) 또는 확장 STX(0xAA 0x56)를 찾아 그 앞의 쓰레기 바이트를 버린다.
+ * evbuffer_search()는 chain 단위 memchr로 0xAA를 찾는다.
+ * return: 1 선두가 STX, 0 STX 없음(데이터 대기), -1 오류 허용 횟수 초과
+ */
+static int frameSyncStx(struct evbuffer* pstEvBuffer, FRAME_CTX* pstFrameCtx)
+{
+    static const char chStx0 = (char)(STX_CONST >> 8);
+    size_t ulLength = evbuffer_get_length(pstEvBuffer);
+    size_t ulDiscard = ulLength;
+    struct evbuffer_ptr stPos = evbuffer_search(pstEvBuffer, &chStx0, 1, NULL);
+    int iFound = 0;
+
+    while (stPos.pos >= 0) {
+        struct evbuffer_ptr stNext = stPos;
+        unsigned char uchNext;
+        if (evbuffer_ptr_set(pstEvBuffer, &stNext, 1, EVBUFFER_PTR_ADD) < 0 ||
+                evbuffer_copyout_from(pstEvBuffer, &stNext, &uchNext, 1) != 1) {
+            /* 마지막 바이트가 STX 앞부분: 남겨두고 다음 데이터를 기다린다 */
+            ulDiscard = (size_t)stPos.pos;
             break;
         }
-        case CMD_KEEP_ALIVE: {
-            RES_KEEP_ALIVE stResKeepAlive;
-            stResKeepAlive.chResult = 0x01;
-            fprintf(stderr, "RES_KEEP_ALIVE : result=%d, len:%d\n", stResKeepAlive.chResult, iDataLength);
-            if(chReply){
-                fprintf(stderr,"SEND Keep alive response\n");
-                writeFrame(pstBufferEvent, CMD_KEEP_ALIVE, pstMsgId, 0, &stResKeepAlive, sizeof(RES_KEEP_ALIVE));
-            }
+        if (uchNext == (STX_CONST & 0xFF) || uchNext == (STX_EXT_CONST & 0xFF)) {
+            ulDiscard = (size_t)stPos.pos;
+            iFound = 1;
             break;
         }
-        case CMD_IBIT: {
-            RES_IBIT stResIbit;
-            stResIbit.chBitTotResult = 0x01;
-            stResIbit.chPositionResult = 0x01;
-            fprintf(stderr, "IBIT : total=%d position=%d\n", stResIbit.chBitTotResult, stResIbit.chPositionResult);
-            if(chReply)
-                writeFrame(pstBufferEvent, CMD_IBIT, pstMsgId, 0, &stResIbit, sizeof(RES_IBIT));
-            break;
+        stPos = evbuffer_search(pstEvBuffer, &chStx0, 1, &stNext);
+    }
+
+    if (ulDiscard > 0) {
+        evbuffer_drain(pstEvBuffer, ulDiscard);
+        TRACE_INFO(TRACE_EV_RESYNC, pstFrameCtx->pvSession, 0, ulDiscard, 0);
+        pstFrameCtx->ulDiscardBytes += ulDiscard;
+        /* 동기를 잃은 시점에 한 번만 오류로 센다 */
+        if (!pstFrameCtx->chSyncLost) {
+            pstFrameCtx->chSyncLost = 1;
+            pstFrameCtx->uiResyncCnt++;
+            if (frameCountError(pstFrameCtx) < 0)
+                return -1;
         }
-        default:
-            fprintf(stderr, "RES cmd=%d len=%d\n", unCmd, iDataLength);
-            break;
     }
-    free(uchPayload);
-    iLength = evbuffer_get_length(pstEvBuffer);
-    fprintf(stderr,"### %s():%d Recv Data Length is %d\n", __func__, __LINE__, iLength);
+    return iFound;
+}
+
+/* === 핸들러 처리 시간 측정용 (vDSO, 시스템 호출 없음) === */
+static inline uint64_t frameNowNs(void)
+{
+    struct timespec stTs;
+    clock_gettime(CLOCK_MONOTONIC, &stTs);
+    return (uint64_t)stTs.tv_sec * 1000000000ull + (uint64_t)stTs.tv_nsec;
+}
+
+/* === 잘못된 STX 후보를 1바이트 건너뛰고 재동기화 === */
+static inline int frameSkipCandidate(struct evbuffer* pstEvBuffer, FRAME_CTX* pstFrameCtx)
+{
+    evbuffer_drain(pstEvBuffer, 1);
+    pstFrameCtx->ulDiscardBytes++;
+    pstFrameCtx->chSyncLost = 1;
+    pstFrameCtx->uiResyncCnt++;
+    return frameCountError(pstFrameCtx);
+}
+
+/* === 조각 재조립 ===
+ * 세션당 한 번에 하나의 전송만 모은다. 순서가 어긋나거나 ulReasmLimit 를
+ * 넘으면 그 전송을 버린다. 버퍼는 다음 전송에 재사용한다.
+ * return: 1 완료(pstFrameView 가 재조립 버퍼를 가리킴), 0 진행 중/폐기
+ */
+static int frameReassemble(FRAME_CTX* pstFrameCtx, FRAME_VIEW* pstFrameView)
+{
+    if (pstFrameView->uiFragOffset == 0) {
+        pstFrameCtx->chReasmActive  = 1;
+        pstFrameCtx->uiReasmXferId  = pstFrameView->uiXferId;
+        pstFrameCtx->ulReasmSize    = 0;
+    } else if (!pstFrameCtx->chReasmActive || pstFrameCtx->uiReasmXferId != pstFrameView->uiXferId ||
+            pstFrameView->uiFragOffset != pstFrameCtx->ulReasmSize) {
+        TRACE_ERROR(TRACE_EV_FRAG_ERR, pstFrameCtx->pvSession, pstFrameView->unCmd,
+            pstFrameView->uiFragOffset, 0);
+        pstFrameCtx->chReasmActive = 0;
+        return 0;//FRAME_ERR_FRAG_ORDER
+    }
+
+    size_t ulNeed = pstFrameCtx->ulReasmSize + (size_t)pstFrameView->iDataLength;
+    if (ulNeed > pstFrameCtx->ulReasmLimit) {
+        TRACE_ERROR(TRACE_EV_FRAG_ERR, pstFrameCtx->pvSession, pstFrameView->unCmd, ulNeed, 1);
+        pstFrameCtx->chReasmActive = 0;
+        return 0;//FRAME_ERR_FRAG_TOO_LARGE
+    }
+    if (ulNeed > pstFrameCtx->ulReasmCap) {
+        size_t ulCap = pstFrameCtx->ulReasmCap ? pstFrameCtx->ulReasmCap * 2 : 4096;
+        while (ulCap < ulNeed)
+            ulCap *= 2;
+        if (ulCap > pstFrameCtx->ulReasmLimit)
+            ulCap = pstFrameCtx->ulReasmLimit;
+        unsigned char* puchNew = realloc(pstFrameCtx->puchReasm, ulCap);
+        if (!puchNew) {
+            pstFrameCtx->chReasmActive = 0;
+            return 0;//FRAME_ERR_MEMORY_ALLOC_FAIL
+        }
+        pstFrameCtx->puchReasm  = puchNew;
+        pstFrameCtx->ulReasmCap = ulCap;
+    }
+
+    if (pstFrameView->iDataLength > 0)
+        memcpy(pstFrameCtx->puchReasm + pstFrameCtx->ulReasmSize, pstFrameView->puchPayload,
+            (size_t)pstFrameView->iDataLength);
+    pstFrameCtx->ulReasmSize = ulNeed;
+    if (!(pstFrameView->uchFlags & FRAME_FLAG_LAST))
+        return 0;
+
+    pstFrameCtx->chReasmActive  = 0;
+    pstFrameView->puchPayload   = pstFrameCtx->ulReasmSize ? pstFrameCtx->puchReasm : NULL;
+    pstFrameView->iDataLength   = (int)pstFrameCtx->ulReasmSize;
+    pstFrameView->uchFlags      &= (unsigned char)~(FRAME_FLAG_FRAG | FRAME_FLAG_LAST);
+    pstFrameView->uiFragOffset  = 0;
+    return 1;
+}
+
+/* === 압축 페이로드 해제 (세션 재사용 버퍼로) ===
+ * return: 1 성공(pstFrameView 가 해제 버퍼를 가리킴), -1 손상
+ */
+static int frameDecompress(FRAME_CTX* pstFrameCtx, FRAME_VIEW* pstFrameView)
+{
+    uint32_t uiRawLen;
+    if (pstFrameView->iDataLength < (int)sizeof(uiRawLen))
+        return -1;//FRAME_ERR_COMPRESS_CORRUPT
+    memcpy(&uiRawLen, pstFrameView->puchPayload, sizeof(uiRawLen));
+    uiRawLen = ntohl(uiRawLen);
+    if (uiRawLen > FRAME_MAX_DATA_LENGTH)
+        return -1;//FRAME_ERR_COMPRESS_CORRUPT
+
+    unsigned char* puchRaw = frameScratch(&pstFrameCtx->puchRxScratch, &pstFrameCtx->ulRxScratchCap,
+        uiRawLen ? uiRawLen : 1);
+    if (!puchRaw)
+        return -1;//FRAME_ERR_MEMORY_ALLOC_FAIL
+    long lRaw = decompressLz4(pstFrameView->puchPayload + sizeof(uiRawLen),
+        (size_t)pstFrameView->iDataLength - sizeof(uiRawLen), puchRaw, uiRawLen);
+    if (lRaw != (long)uiRawLen)
+        return -1;//FRAME_ERR_COMPRESS_CORRUPT
+
+    pstFrameView->puchPayload   = puchRaw;
+    pstFrameView->iDataLength   = (int)uiRawLen;
+    pstFrameView->uchFlags      &= (unsigned char)~FRAME_FLAG_COMPRESSED;
+    return 1;
+}
+
+/* === 허브 전달: 프레임을 해석하지 않고 입력 → 대상 출력으로 옮긴다 ===
+ * 체크섬은 최종 수신 측이 검증하고, 여기서는 재동기화를 위해 ETX 만 확인한다.
+ * evbuffer_remove_buffer()는 온전한 chain 을 복사 없이 넘긴다.
+ */
+static int frameForward(struct evbuffer* pstEvBuffer, FRAME_CTX* pstFrameCtx,
+        FRAME_CTX* pstRouteCtx, size_t ulNeedSize)
+{
+    struct evbuffer_ptr stEtx;
+    unsigned char auchEtx[2];
+    if (evbuffer_ptr_set(pstEvBuffer, &stEtx, ulNeedSize - sizeof(auchEtx), EVBUFFER_PTR_SET) < 0 ||
+            evbuffer_copyout_from(pstEvBuffer, &stEtx, auchEtx, sizeof(auchEtx)) != (ev_ssize_t)sizeof(auchEtx))
+        return -1;//FRAME_ERR_EVBUFFER
+    if (((auchEtx[0] << 8) | auchEtx[1]) != ETX_CONST) {
+        TRACE_ERROR(TRACE_EV_ETX_ERR, pstFrameCtx->pvSession,
+            ntohs(pstFrameCtx->stPendHeader.unCmd), ntohl(pstFrameCtx->stPendHeader.iDataLength), 0);
+        return frameSkipCandidate(pstEvBuffer, pstFrameCtx);//FRAME_ERR_ETX_NOT_MATCH
+    }
+
+    pstFrameCtx->chHeaderValid  = 0;
+    pstFrameCtx->chSyncLost     = 0;
+    pstFrameCtx->uiErrorCnt     = 0;
+    pstFrameCtx->ulRxFrameCnt++;
+    pstFrameCtx->ulRxBytes      += ulNeedSize;
+    if (frameTxShed(pstRouteCtx, pstFrameCtx->stPendExt.uiSeq, pstFrameCtx->stPendExt.uchFlags)) {
+        evbuffer_drain(pstEvBuffer, ulNeedSize);
+        return 1;//FRAME_TX_SHED
+    }
+    TRACE_DEBUG(TRACE_EV_ROUTE, pstFrameCtx->pvSession, ntohs(pstFrameCtx->stPendHeader.unCmd),
+        (uint32_t)ulNeedSize, pstFrameCtx->stPendHeader.stMsgId.uchDstId);
+    if (evbuffer_remove_buffer(pstEvBuffer, frameOutput(pstRouteCtx),
+            ulNeedSize) != (int)ulNeedSize)
+        return -1;//FRAME_ERR_EVBUFFER
+    pstFrameCtx->ulRoutedCnt++;
+    pstRouteCtx->ulTxFrameCnt++;
+    pstRouteCtx->ulTxBytes      += ulNeedSize;
+    return 1;//FRAME_ROUTED
+}
+
+/* === 프레임 하나 파싱 & 응답 처리 (증분 스트림 파서) ===
+ * 헤더/페이로드/테일을 입력 버퍼 내부에서 그대로 읽고(zero-copy),
+ * 처리가 끝나면 프레임 전체를 한 번에 drain 한다.
+ *  - STX 앞의 쓰레기는 버리고, 손상된 프레임은 1바이트 건너뛰어 재동기화
+ *  - 연속 오류가 uiErrorBudget 을 넘을 때만 -1 (세션 종료)
+ *  - 검증된 헤더는 페이로드가 모두 도착할 때까지 FRAME_CTX 에 보관
+ * return: 1 진행(프레임 소비/재동기화), 0 need more, -1 fatal
+ */
+int responseFrame(struct evbuffer* pstEvBuffer, FRAME_CTX* pstFrameCtx) 
+{
+    FRAME_VIEW   stFrameView;
+    size_t ulLength = evbuffer_get_length(pstEvBuffer);
+    TRACE_DEBUG(TRACE_EV_RX_BYTES, pstFrameCtx->pvSession, 0, ulLength, 0);
+
+    if (!pstFrameCtx->chHeaderValid) {
+        int iSync = frameSyncStx(pstEvBuffer, pstFrameCtx);
+        if (iSync <= 0)
+            return iSync;//FRAME_ERR_STX_NOT_FOUND
+
+        ulLength = evbuffer_get_length(pstEvBuffer);
+        if (ulLength < sizeof(FRAME_HEADER)){
+            return 0;//FRAME_ERR_PACKET_TOO_SHORT
+        }
+
+        /* 헤더는 정렬되지 않은 위치일 수 있으므로 스택으로 복사 (10 bytes + 확장 헤더) */
+        unsigned char auchHeader[sizeof(FRAME_HEADER) + sizeof(FRAME_HEADER_EXT) + sizeof(FRAME_FRAG_EXT)];
+        ev_ssize_t lCopied = evbuffer_copyout(pstEvBuffer, auchHeader, sizeof(auchHeader));
+        if (lCopied < (ev_ssize_t)sizeof(FRAME_HEADER)){
+            return 0;//EV_COPYOUT_SIZE_MISMATCH
+        }
+        memcpy(&pstFrameCtx->stPendHeader, auchHeader, sizeof(FRAME_HEADER));
+        memset(&pstFrameCtx->stPendExt, 0, sizeof(FRAME_HEADER_EXT));
+
+        if (ntohs(pstFrameCtx->stPendHeader.unStx) == STX_EXT_CONST) {
+            if (lCopied < (ev_ssize_t)(sizeof(FRAME_HEADER) + sizeof(FRAME_HEADER_EXT)))
+                return 0;//FRAME_ERR_PACKET_TOO_SHORT
+            memcpy(&pstFrameCtx->stPendExt, auchHeader + sizeof(FRAME_HEADER), sizeof(FRAME_HEADER_EXT));
+
+            size_t ulExtNeed = sizeof(FRAME_HEADER_EXT) +
+                ((pstFrameCtx->stPendExt.uchFlags & FRAME_FLAG_FRAG) ? sizeof(FRAME_FRAG_EXT) : 0);
+            if (pstFrameCtx->stPendExt.uchFlags & FRAME_FLAG_FRAG) {
+                if (lCopied < (ev_ssize_t)(sizeof(FRAME_HEADER) + ulExtNeed))
+                    return 0;//FRAME_ERR_PACKET_TOO_SHORT
+                memcpy(&pstFrameCtx->stPendFrag, auchHeader + sizeof(FRAME_HEADER) + sizeof(FRAME_HEADER_EXT),
+                    sizeof(FRAME_FRAG_EXT));
+            }
+            if (pstFrameCtx->stPendExt.uchExtLen < ulExtNeed) {
+                TRACE_ERROR(TRACE_EV_LENGTH_ERR, pstFrameCtx->pvSession,
+                    ntohs(pstFrameCtx->stPendHeader.unCmd), pstFrameCtx->stPendExt.uchExtLen, 0);
+                return frameSkipCandidate(pstEvBuffer, pstFrameCtx);//FRAME_ERR_EXT_INVALID
+            }
+        }
+
+        int iPendLength = ntohl(pstFrameCtx->stPendHeader.iDataLength);
+        if (iPendLength < 0 || iPendLength > FRAME_MAX_DATA_LENGTH) {
+            TRACE_ERROR(TRACE_EV_LENGTH_ERR, pstFrameCtx->pvSession,
+                ntohs(pstFrameCtx->stPendHeader.unCmd), (uint32_t)iPendLength, 0);
+            return frameSkipCandidate(pstEvBuffer, pstFrameCtx);//FRAME_ERR_LENGTH_INVALID
+        }
+
+        pstFrameCtx->chHeaderValid = 1;
+    }
+
+    const FRAME_HEADER* pstFrameHeader = &pstFrameCtx->stPendHeader;
+    int iDataLength = ntohl(pstFrameHeader->iDataLength);
+
+    size_t ulHeaderSize = sizeof(FRAME_HEADER) + pstFrameCtx->stPendExt.uchExtLen;
+    size_t ulTailSize = frameTailSize(pstFrameCtx->uchCrcMode);
+    size_t ulNeedSize = ulHeaderSize + (size_t)iDataLength + ulTailSize;
+    if (ulLength < ulNeedSize){
+        return 0;//EV_INCOMPETE_PACKET_IN_BUFFER
+    }
+
+    /* 허브: 다른 노드로 가는 프레임 (체크섬 모드가 같으면 해석 없이 전달) */
+    FRAME_CTX* pstRouteCtx = pstFrameCtx->pfnRoute ?
+        pstFrameCtx->pfnRoute(pstFrameCtx, &pstFrameHeader->stMsgId) : NULL;
+    if (pstRouteCtx && pstRouteCtx->uchCrcMode == pstFrameCtx->uchCrcMode)
+        return frameForward(pstEvBuffer, pstFrameCtx, pstRouteCtx, ulNeedSize);
+
+    const unsigned char* puchFrame = frameContiguous(pstEvBuffer, ulNeedSize);
+    if (!puchFrame)
+        return -1;//FRAME_ERR_MEMORY_ALLOC_FAIL
+
+    const unsigned char* puchPayload = puchFrame + ulHeaderSize;
+    const unsigned char* puchTail = puchPayload + iDataLength;
+
+    if (checksumCalc(pstFrameCtx->uchCrcMode, puchPayload, (size_t)iDataLength) !=
+            frameTailCrc(puchTail, pstFrameCtx->uchCrcMode)) {
+        pstFrameCtx->uiCrcErrCnt++;
+        TRACE_ERROR(TRACE_EV_CRC_ERR, pstFrameCtx->pvSession,
+            ntohs(pstFrameHeader->unCmd), iDataLength, 0);
+        return frameSkipCandidate(pstEvBuffer, pstFrameCtx);//FRAME_ERR_CRC_NOT_MATCH
+    }
+
+    const unsigned char* puchEtx = puchTail + ulTailSize - sizeof(unsigned short);
+    if (((puchEtx[0] << 8) | puchEtx[1]) != ETX_CONST) {
+        TRACE_ERROR(TRACE_EV_ETX_ERR, pstFrameCtx->pvSession,
+            ntohs(pstFrameHeader->unCmd), iDataLength, 0);
+        return frameSkipCandidate(pstEvBuffer, pstFrameCtx);//FRAME_ERR_ETX_NOT_MATCH
+    }
+
+    /* 정상 프레임: 동기 회복 */
+    pstFrameCtx->chHeaderValid  = 0;
+    pstFrameCtx->chSyncLost     = 0;
+    pstFrameCtx->uiErrorCnt     = 0;
+    pstFrameCtx->ulRxFrameCnt++;
+    pstFrameCtx->ulRxBytes      += ulNeedSize;
+
+    stFrameView.unCmd           = ntohs(pstFrameHeader->unCmd);
+    stFrameView.uchSubModule    = pstFrameHeader->uchSubModule;
+    stFrameView.stMsgId         = pstFrameHeader->stMsgId;
+    stFrameView.iDataLength     = iDataLength;
+    stFrameView.puchPayload     = iDataLength > 0 ? puchPayload : NULL;
+    stFrameView.uchFlags        = pstFrameCtx->stPendExt.uchFlags;
+    stFrameView.uiSeq           = ntohl(pstFrameCtx->stPendExt.uiSeq);
+    stFrameView.uiXferId        = 0;
+    stFrameView.uiFragOffset    = 0;
+    if (stFrameView.uchFlags & FRAME_FLAG_FRAG) {
+        stFrameView.uiXferId        = ntohl(pstFrameCtx->stPendFrag.uiXferId);
+        stFrameView.uiFragOffset    = ntohl(pstFrameCtx->stPendFrag.uiOffset);
+    }
+
+    TRACE_INFO(TRACE_EV_RX_FRAME, pstFrameCtx->pvSession, stFrameView.unCmd,
+        iDataLength, stFrameView.uchSubModule);
+
+    if (pstRouteCtx) {
+        /* 체크섬 모드가 다른 세션으로 전달: 검증한 프레임을 대상 모드로 다시 인코딩 (압축/조각 정보 유지) */
+        FRAME_IOV stRoute = { stFrameView.unCmd, stFrameView.uchSubModule, stFrameView.puchPayload,
+            iDataLength, stFrameView.uiSeq, stFrameView.uchFlags, stFrameView.uiXferId, stFrameView.uiFragOffset };
+        struct evbuffer* pstRouteOut = frameOutput(pstRouteCtx);
+        size_t ulBefore = evbuffer_get_length(pstRouteOut);
+        if (!frameTxShed(pstRouteCtx, stRoute.uiSeq, stRoute.uchFlags) &&
+                encodeFrames(pstRouteOut, pstRouteCtx->uchCrcMode, &stFrameView.stMsgId, &stRoute, 1) > 0) {
+            pstFrameCtx->ulRoutedCnt++;
+            pstRouteCtx->ulTxFrameCnt++;
+            pstRouteCtx->ulTxBytes  += evbuffer_get_length(pstRouteOut) - ulBefore;
+        }
+        TRACE_DEBUG(TRACE_EV_ROUTE, pstFrameCtx->pvSession, stFrameView.unCmd,
+            (uint32_t)ulNeedSize, stFrameView.stMsgId.uchDstId);
+        evbuffer_drain(pstEvBuffer, ulNeedSize);
+        return 1;//FRAME_ROUTED
+    }
+    /* === 응답 처리 ===
+       - 명령 테이블 인덱싱으로 핸들러 호출
+       - 핸들러는 입력 버퍼를 가리키는 stFrameView만 참조 (drain 전까지 유효)
+    */
+    if ((stFrameView.uchFlags & FRAME_FLAG_COMPRESSED) && frameDecompress(pstFrameCtx, &stFrameView) < 0) {
+        TRACE_ERROR(TRACE_EV_DECOMPRESS_ERR, pstFrameCtx->pvSession, stFrameView.unCmd, iDataLength, 0);
+        evbuffer_drain(pstEvBuffer, ulNeedSize);
+        return 1;//FRAME_ERR_COMPRESS_CORRUPT (프레임만 폐기)
+    }
+
+    int iIsResponse = (stFrameView.uchFlags & FRAME_FLAG_RESPONSE) && pstFrameCtx->pstInflight;
+    if (stFrameView.uchFlags & FRAME_FLAG_FRAG) {
+        /* 스트리밍 핸들러는 조각마다 호출, 그 외에는 마지막 조각까지 모아서 전달 */
+        const CMD_ENTRY* pstEntry = pstFrameCtx->pstCmdTable ?
+            cmdLookup(pstFrameCtx->pstCmdTable, stFrameView.unCmd, stFrameView.uchSubModule) : NULL;
+        if ((iIsResponse || !pstEntry || !pstEntry->chStream) &&
+                frameReassemble(pstFrameCtx, &stFrameView) <= 0) {
+            evbuffer_drain(pstEvBuffer, ulNeedSize);
+            return 1;//FRAME_FRAG_PENDING
+        }
+    }
+
+    uint64_t ulStartNs = frameNowNs();
+    if (iIsResponse) {
+        /* 대기 중인 요청의 응답: 완료 콜백으로 전달 (시간 초과 후 도착하면 버림) */
+        inflightComplete(pstFrameCtx->pstInflight, &stFrameView);
+    } else {
+        /* 대기 테이블 없이 받은 응답(유휴 확인 응답 등)에는 다시 응답하지 않는다 */
+        pstFrameCtx->uiReplySeq = (stFrameView.uchFlags & FRAME_FLAG_RESPONSE) ? 0 : stFrameView.uiSeq;
+        cmdDispatch(pstFrameCtx->pstCmdTable, pstFrameCtx, &stFrameView);
+        pstFrameCtx->uiReplySeq = 0;
+    }
+    uint64_t ulHandlerNs = frameNowNs() - ulStartNs;
+    pstFrameCtx->ulHandlerNs += ulHandlerNs;
+    if (ulHandlerNs > pstFrameCtx->ulHandlerMaxNs)
+        pstFrameCtx->ulHandlerMaxNs = ulHandlerNs;
+
+    /* 프레임 전체를 한 번에 소비 */
+    evbuffer_drain(pstEvBuffer, ulNeedSize);
     return 1;//FRAME_SUCCESS;
 }
 
 
-/* === 프레임 하나 파싱 & 응답 처리 ===
- * return: 1 consumed, 0 need more, -1 fatal
+/* === 요청 송신: 세션 체크섬 모드를 따르고, ID 는 호출자가 지정 === */
+static int writeRequestCtx(FRAME_CTX* pstFrameCtx, unsigned short unCmd, const MSG_ID* pstMsgId,
+                       const void* pvPayload, int iDataLength)
+{
+    if (!pstFrameCtx || !pstFrameCtx->pstBufferEvent)
+        return -1;
+    return encodeFrameCrc(bufferevent_get_output(pstFrameCtx->pstBufferEvent), pstFrameCtx->uchCrcMode,
+        unCmd, pstMsgId, 0, pvPayload, iDataLength);
+}
+
+/* === 기본 요청 프레임 송신 ===
+ * return: 1 성공
  */
-int requestFrame(struct bufferevent  *pstBufferEvent, MSG_ID* pstMsgId, unsigned short unCmd) {
+int requestFrame(FRAME_CTX* pstFrameCtx, const MSG_ID* pstMsgId, unsigned short unCmd) {
     switch (unCmd) {
         case CMD_REQ_ID: {
             REQ_ID stReqId;
             stReqId.chTmp = 0x01;
-            fprintf(stderr, "REQ_ID\n");
-            writeFrame(pstBufferEvent, CMD_REQ_ID, pstMsgId, 0, &stReqId, sizeof(REQ_ID));
+            writeRequestCtx(pstFrameCtx, CMD_REQ_ID, pstMsgId, &stReqId, sizeof(REQ_ID));
             break;
         }
         case CMD_KEEP_ALIVE: {
             REQ_KEEP_ALIVE stReqKeepAlive;
             stReqKeepAlive.chTmp = 0x01;
-            fprintf(stderr, "REQ_KEEP_ALIVE\n");
-            writeFrame(pstBufferEvent, CMD_KEEP_ALIVE, pstMsgId, 0, &stReqKeepAlive, sizeof(REQ_KEEP_ALIVE));
+            writeRequestCtx(pstFrameCtx, CMD_KEEP_ALIVE, pstMsgId, &stReqKeepAlive, sizeof(REQ_KEEP_ALIVE));
             break;
         }
         case CMD_IBIT: {
             REQ_IBIT stReqIbit;
             stReqIbit.chIbit = 0x01;
-            fprintf(stderr, "REQ_IBIT\n");
-            writeFrame(pstBufferEvent, CMD_IBIT, pstMsgId, 0, &stReqIbit, sizeof(RES_IBIT));
+            writeRequestCtx(pstFrameCtx, CMD_IBIT, pstMsgId, &stReqIbit, sizeof(REQ_IBIT));
             break;
         }
         default:
-            fprintf(stderr, "REQ CMD=%d\n", unCmd);
-            break;
+            TRACE_ERROR(TRACE_EV_CMD_UNKNOWN, pstFrameCtx->pvSession, unCmd, 0, 0);
+            return 1;//FRAME_SUCCESS;
     }
+    TRACE_INFO(TRACE_EV_TX_FRAME, pstFrameCtx->pvSession, unCmd, 0, 0);
     return 1;//FRAME_SUCCESS;
 }
\ No newline at end of file
@@ -3,10 +3,22 @@
 
 #include <event2/event.h>
 #include <event2/bufferevent.h>
+#include <event2/buffer.h>
+#include "checksum.h"
 
 /* ===== Constants ===== */
 #define STX_CONST 0xAA55
+#define STX_EXT_CONST 0xAA56    /* FRAME_HEADER 뒤에 FRAME_HEADER_EXT 가 오는 프레임 */
 #define ETX_CONST 0x55AA
+#define FRAME_TAIL_MAX_SIZE     (4 + sizeof(unsigned short))    /* CRC32C + ETX */
+#define FRAME_MAX_DATA_LENGTH   (16 * 1024 * 1024)  /* 이보다 큰 길이는 잘못된 헤더로 간주 */
+#define FRAME_ERROR_BUDGET_DEFAULT  8               /* 연속 파싱 오류 허용 횟수 */
+#define FRAME_FRAG_SIZE_DEFAULT     (64 * 1024)     /* 조각 하나의 페이로드 크기 */
+#define FRAME_REASM_LIMIT_DEFAULT   (1024 * 1024)   /* 세션당 재조립 버퍼 상한 */
+#define FRAME_COMPRESS_MIN_DEFAULT  256             /* 이보다 작은 페이로드는 압축하지 않음 */
+
+/* 세션 기능 (CMD_REQ_ID 로 협상) */
+#define FRAME_CAP_COMPRESS      0x01    /* LZ4 블록 페이로드 압축 */
 
 
 /* ===== Message types ===== */
@@ -23,15 +35,208 @@ typedef struct __attribute__((__packed__)) {
     unsigned short  unCmd;
 } FRAME_HEADER;
 
+/* 확장 헤더 (STX_EXT_CONST 프레임에만 존재)
+ *  - uchExtLen 은 이 구조체를 포함한 확장 헤더 길이. 수신 측은 모르는 뒤쪽 필드를 건너뛴다
+ *  - 체크섬은 기존과 같이 페이로드만 계산
+ */
+#define FRAME_FLAG_RESPONSE     0x01    /* uiSeq 요청에 대한 응답 */
+#define FRAME_FLAG_FRAG         0x02    /* 조각 프레임: FRAME_FRAG_EXT 가 뒤따름 */
+#define FRAME_FLAG_LAST         0x04    /* 전송의 마지막 조각 */
+#define FRAME_FLAG_COMPRESSED   0x08    /* 페이로드 = 원래 길이(4 bytes, BE) + LZ4 블록 */
+
+typedef struct __attribute__((__packed__)) {
+    unsigned char   uchExtLen;
+    unsigned char   uchFlags;           /* FRAME_FLAG_* */
+    unsigned int    uiSeq;              /* 상관 ID (네트워크 바이트 순서, 0: 없음) */
+} FRAME_HEADER_EXT;
+
+/* 조각 정보 (FRAME_FLAG_FRAG, 네트워크 바이트 순서) */
+typedef struct __attribute__((__packed__)) {
+    unsigned int    uiXferId;           /* 전송 ID (세션 내 송신자 기준) */
+    unsigned int    uiOffset;           /* 전체 페이로드 내 이 조각의 위치 */
+} FRAME_FRAG_EXT;
+
 typedef struct __attribute__((__packed__)) {
     unsigned char   uchCrc;
     unsigned short  unEtx;
-} FRAME_TAIL;
+} FRAME_TAIL;     /* CRC_MODE_XOR8 테일 */
+
+static inline size_t frameTailSize(unsigned char uchCrcMode)
+{
+    return checksumSize(uchCrcMode) + sizeof(unsigned short);
+}
+
+/* 수신 프레임 뷰: 페이로드는 입력 evbuffer 내부를 가리킨다 (복사 없음) */
+typedef struct {
+    unsigned short          unCmd;
+    unsigned char           uchSubModule;
+    MSG_ID                  stMsgId;
+    int                     iDataLength;
+    const unsigned char     *puchPayload;
+    unsigned char           uchFlags;           /* 확장 헤더 플래그 (없으면 0) */
+    unsigned int            uiSeq;              /* 상관 ID (없으면 0) */
+    unsigned int            uiXferId;           /* 조각 프레임의 전송 ID */
+    unsigned int            uiFragOffset;       /* 조각 프레임의 위치 */
+} FRAME_VIEW;
+
+/* 일괄 송신용 프레임 기술자 (iovec 형태) */
+typedef struct {
+    unsigned short          unCmd;
+    unsigned char           uchSubModule;
+    const void              *pvPayload;
+    int                     iDataLength;
+    unsigned int            uiSeq;              /* 0이 아니면 확장 헤더로 기록 */
+    unsigned char           uchFlags;
+    unsigned int            uiXferId;           /* FRAME_FLAG_FRAG 일 때만 사용 */
+    unsigned int            uiFragOffset;
+} FRAME_IOV;
+
+/* 조각 송신 상태 (frameStreamBegin → frameStreamWrite 반복) */
+typedef struct {
+    unsigned short          unCmd;
+    unsigned char           uchSubModule;
+    unsigned int            uiSeq;
+    unsigned int            uiXferId;
+    unsigned int            uiOffset;           /* 다음 조각 위치 */
+} FRAME_STREAM;
+
+typedef struct cmd_table        CMD_TABLE;
+typedef struct frame_ctx        FRAME_CTX;
+typedef struct inflight_table   INFLIGHT_TABLE;
+
+/* CMD_REQ_ID 요청으로 상대 ID를 알게 됐을 때 호출 (세션 레지스트리 갱신용) */
+typedef void (*FRAME_PEER_CB)(FRAME_CTX* pstFrameCtx, unsigned char uchPeerId);
+
+/* 허브 라우팅: 수신 프레임의 MSG_ID 로 전달할 세션의 FRAME_CTX 를 고른다 (NULL: 직접 처리) */
+typedef FRAME_CTX* (*FRAME_ROUTE_CB)(FRAME_CTX* pstFrameCtx, const MSG_ID* pstMsgId);
+
+/* 연결 하나의 프레임 처리 컨텍스트 (세션에 포함) */
+struct frame_ctx {
+    struct bufferevent      *pstBufferEvent;    /* 응답 송신 대상 */
+    struct evbuffer         *pstOutput;         /* 송신 버퍼 직접 지정 (데이터그램 전송, NULL: pstBufferEvent 출력) */
+    const CMD_TABLE         *pstCmdTable;       /* 명령 디스패치 테이블 */
+    void                    *pvSession;         /* 상위 세션 (SESSION_CTX 등) */
+    MSG_ID                  stMsgId;            /* 응답 시 사용할 ID */
+    char                    chReply;            /* 응답 송신 여부 (상관 ID가 있는 요청에는 항상 응답) */
+    unsigned char           uchCrcMode;         /* CRC_MODE_* (양단 동일 설정 필요) */
+    unsigned int            uiReplySeq;         /* 처리 중인 요청의 상관 ID (응답에 그대로 실음) */
+    INFLIGHT_TABLE          *pstInflight;       /* 응답 대기 테이블 (NULL: 사용 안 함) */
+    FRAME_PEER_CB           pfnPeerId;          /* 상대 ID 통지 (NULL: 사용 안 함) */
+    FRAME_ROUTE_CB          pfnRoute;           /* 목적지 전달 (NULL: 모든 프레임 직접 처리) */
+    unsigned long           ulRoutedCnt;        /* 다른 세션으로 전달한 프레임 수 */
+    char                    chTxShed;           /* 송신 혼잡: 저우선(확장 헤더 없는 단발) 프레임은 버린다 */
+    unsigned long           ulTxDropCnt;        /* 혼잡으로 버린 송신 프레임 누계 */
 
+    /* 증분 스트림 파서 상태 */
+    FRAME_HEADER            stPendHeader;       /* 검증된 헤더 (페이로드 대기 중) */
+    FRAME_HEADER_EXT        stPendExt;          /* 검증된 확장 헤더 (uchExtLen 0: 없음) */
+    FRAME_FRAG_EXT          stPendFrag;
 
+    /* 조각 재조립 (스트리밍 핸들러가 아닌 명령) */
+    unsigned char           *puchReasm;
+    size_t                  ulReasmSize;
+    size_t                  ulReasmCap;
+    size_t                  ulReasmLimit;       /* 초과 시 전송 폐기 */
+    unsigned int            uiReasmXferId;
+    char                    chReasmActive;
+    unsigned int            uiNextXferId;       /* 송신 전송 ID */
+
+    /* 페이로드 압축 */
+    unsigned char           uchLocalCaps;       /* 허용하는 기능 (FRAME_CAP_*) */
+    unsigned char           uchActiveCaps;      /* 협상된 기능: 송신에 적용 */
+    int                     iCompressMin;       /* 압축 임계 크기 */
+    unsigned char           *puchTxScratch;     /* 압축 결과 (재사용) */
+    size_t                  ulTxScratchCap;
+    unsigned char           *puchRxScratch;     /* 해제 결과 (재사용) */
+    size_t                  ulRxScratchCap;
+    unsigned long           ulTxRawBytes;       /* 압축 전 페이로드 누계 */
+    unsigned long           ulTxWireBytes;      /* 실제 송신 페이로드 누계 */
+    char                    chHeaderValid;
+    char                    chSyncLost;         /* STX 동기 상실 중 */
+    unsigned int            uiErrorBudget;      /* 연속 오류 허용 횟수 (초과 시 세션 종료) */
+    unsigned int            uiErrorCnt;         /* 현재 연속 오류 수 */
+    unsigned int            uiResyncCnt;        /* 재동기화 횟수 누계 */
+    unsigned int            uiCrcErrCnt;        /* CRC 오류 누계 */
+    unsigned long           ulDiscardBytes;     /* 버린 바이트 누계 */
+
+    /* 통계 (이 연결을 처리하는 스레드에서만 갱신) */
+    unsigned long           ulRxFrameCnt;       /* 정상 수신 프레임 (전달 포함) */
+    unsigned long           ulRxBytes;          /* 정상 수신 프레임 바이트 (헤더/테일 포함) */
+    unsigned long           ulTxFrameCnt;       /* 세션 경로로 송신한 프레임 */
+    unsigned long           ulTxBytes;          /* 송신 프레임 바이트 (헤더/테일 포함) */
+    unsigned long           ulHandlerNs;        /* 핸들러/응답 콜백 처리 시간 누계 */
+    unsigned long           ulHandlerMaxNs;
+};
+
+/* 프레임을 기록할 출력 버퍼 (NULL: 송신 대상 없음) */
+static inline struct evbuffer* frameOutput(const FRAME_CTX* pstFrameCtx)
+{
+    if (pstFrameCtx->pstOutput)
+        return pstFrameCtx->pstOutput;
+    return pstFrameCtx->pstBufferEvent ? bufferevent_get_output(pstFrameCtx->pstBufferEvent) : NULL;
+}
+
+/* 송신 혼잡 시 버릴 프레임인지 (상관 ID/플래그 없는 단발 프레임, 응답/요청/조각은 유지) */
+static inline int frameTxShed(FRAME_CTX* pstFrameCtx, unsigned int uiSeq, unsigned char uchFlags)
+{
+    if (!pstFrameCtx->chTxShed || uiSeq || uchFlags)
+        return 0;
+    pstFrameCtx->ulTxDropCnt++;
+    return 1;
+}
+
+int encodeFrame(struct evbuffer* pstEvBuffer, unsigned short unCmd,
+                       const MSG_ID* pstMsgId, unsigned char uchSubModule,
+                       const void* pvPayload, int iDataLength);
+int encodeFrameCrc(struct evbuffer* pstEvBuffer, unsigned char uchCrcMode, unsigned short unCmd,
+                       const MSG_ID* pstMsgId, unsigned char uchSubModule,
+                       const void* pvPayload, int iDataLength);
+int encodeFrameBatch(struct evbuffer* pstEvBuffer, unsigned char uchCrcMode,
+                       const MSG_ID* pstMsgId, const FRAME_IOV* pstFrames, int iFrameCnt);
 int writeFrame(struct bufferevent* pstBufferEvent, unsigned short unCmd,
                        const MSG_ID* pstMsgId, unsigned char uchSubModule,
                        const void* pvPayload, int iDataLength);
-int responseFrame(struct evbuffer* pstEvBuffer, struct bufferevent  *pstBufferEvent, MSG_ID* pstMsgId, char chReply);
-int requestFrame(struct bufferevent  *pstBufferEvent, MSG_ID* pstMsgId, unsigned short unCmd);
+int writeFrameCtx(FRAME_CTX* pstFrameCtx, unsigned short unCmd, unsigned char uchSubModule,
+                       const void* pvPayload, int iDataLength);
+int writeFrameBatch(struct bufferevent* pstBufferEvent, const MSG_ID* pstMsgId,
+                       const FRAME_IOV* pstFrames, int iFrameCnt);
+int writeFrameBatchCtx(FRAME_CTX* pstFrameCtx, const FRAME_IOV* pstFrames, int iFrameCnt);
+int writeFrameIovCtx(FRAME_CTX* pstFrameCtx, const FRAME_IOV* pstFrame);
+/* CMD_REQ_ID 로 기능 협상 (응답이 오면 uchActiveCaps 갱신), return: 상관 ID, -1 실패 */
+long frameNegotiate(FRAME_CTX* pstFrameCtx, unsigned char uchCaps, unsigned int uiTimeoutMs);
+void frameCtxInit(FRAME_CTX* pstFrameCtx, struct bufferevent* pstBufferEvent,
+        const CMD_TABLE* pstCmdTable, void* pvSession);
+void frameCtxFree(FRAME_CTX* pstFrameCtx);
+
+/* === 공유 프레임 (브로드캐스트) ===
+ * 한 번 인코딩한 불변 버퍼를 여러 출력 evbuffer 에 참조로 붙인다 (페이로드 복사 없음).
+ * 참조 카운트는 원자 연산이므로 다른 스레드의 출력 버퍼에 붙여도 된다.
+ * 만든 쪽은 붙이기가 끝나면 frameSharedRelease()로 자기 참조를 놓는다.
+ */
+typedef struct {
+    int                     iRefCnt;
+    size_t                  ulSize;             /* 인코딩된 프레임 길이 */
+    unsigned char           auchData[];
+} FRAME_SHARED;
+
+FRAME_SHARED* frameSharedEncode(unsigned char uchCrcMode, const MSG_ID* pstMsgId, const FRAME_IOV* pstFrame);
+/* ulCopyMax 이하 프레임은 참조 대신 복사 (참조 chain 비용이 memcpy 보다 큰 구간), return: 1 성공, -1 실패 */
+int  frameSharedAttach(FRAME_SHARED* pstShared, struct evbuffer* pstEvBuffer, size_t ulCopyMax);
+void frameSharedRelease(FRAME_SHARED* pstShared);
+
+/* === 큰 페이로드 조각 송신 ===
+ * 호출마다 조각 프레임 하나를 출력 버퍼에 기록하므로, 조각 사이에
+ * 다른 제어 프레임을 끼워 보낼 수 있다. iLast 가 참이면 마지막 조각.
+ */
+void frameStreamBegin(FRAME_CTX* pstFrameCtx, FRAME_STREAM* pstStream,
+        unsigned short unCmd, unsigned char uchSubModule);
+int  frameStreamWrite(FRAME_CTX* pstFrameCtx, FRAME_STREAM* pstStream,
+        const void* pvChunk, int iChunkLength, int iLast);
+/* 전체 페이로드를 ulFragSize 단위 조각으로 한 번에 기록 (return: 조각 수, -1 실패) */
+int  writeFrameFragmented(FRAME_CTX* pstFrameCtx, unsigned short unCmd, unsigned char uchSubModule,
+        const void* pvPayload, size_t ulLength, size_t ulFragSize);
+void frameRegisterDefaultCmds(CMD_TABLE* pstCmdTable);
+int responseFrame(struct evbuffer* pstEvBuffer, FRAME_CTX* pstFrameCtx);
+/* 기본 요청(REQ_ID/KEEP_ALIVE/IBIT) 송신: pstFrameCtx 의 체크섬 모드로 인코딩 */
+int requestFrame(FRAME_CTX* pstFrameCtx, const MSG_ID* pstMsgId, unsigned short unCmd);
 #endif
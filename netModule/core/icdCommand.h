@@ -9,7 +9,8 @@
 enum {
     CMD_REQ_ID      = 1,
     CMD_KEEP_ALIVE  = 2,
-    CMD_IBIT        = 3
+    CMD_IBIT        = 3,
+    CMD_STATS       = 4
 };
 
 /* ===== Packing portability ===== */
@@ -18,6 +19,9 @@ enum {
 /* REQ_ID */
 typedef struct PACKED { char chTmp;     } REQ_ID;
 typedef struct PACKED { char chResult;  } RES_ID;
+/* 기능 협상을 포함한 REQ_ID/RES_ID (uchCaps: FRAME_CAP_*) */
+typedef struct PACKED { char chTmp;     unsigned char uchCaps; } REQ_ID_CAPS;
+typedef struct PACKED { char chResult;  unsigned char uchCaps; } RES_ID_CAPS;
 
 /* KEEP_ALIVE */
 typedef struct PACKED { char chTmp;     } REQ_KEEP_ALIVE;
@@ -27,5 +31,29 @@ typedef struct PACKED { char chResult;  } RES_KEEP_ALIVE;
 typedef struct PACKED { char chIbit;            } REQ_IBIT;
 typedef struct PACKED { char chBitTotResult; char chPositionResult; } RES_IBIT;
 
+/* STATS (카운터 스냅샷, 정수 필드는 network byte order) */
+#define STATS_VERSION   1
+typedef struct PACKED { char chTmp;     } REQ_STATS;
+typedef struct PACKED {
+    uint64_t        ulRxFrames;
+    uint64_t        ulTxFrames;
+    uint64_t        ulRxBytes;
+    uint64_t        ulTxBytes;
+    uint64_t        ulCrcErr;
+    uint64_t        ulResync;
+    uint64_t        ulDiscardBytes;
+    uint64_t        ulHandlerNs;        /* 핸들러 처리 시간 누계 */
+    uint64_t        ulHandlerMaxNs;
+    uint64_t        ulOutQueued;        /* 출력 버퍼 대기 바이트 */
+    uint32_t        uiInflight;         /* 응답 대기 요청 수 */
+} STATS_COUNTERS;
+typedef struct PACKED {
+    char            chResult;
+    unsigned char   uchVersion;         /* STATS_VERSION */
+    uint32_t        uiSessions;         /* 코어에 등록된 세션 수 */
+    STATS_COUNTERS  stSession;          /* 요청을 받은 연결 */
+    STATS_COUNTERS  stCore;             /* 같은 코어(워커)의 모든 연결 + 종료된 연결 누계 */
+} RES_STATS;
+
 
 #endif /* ICD_COMMAND_H */
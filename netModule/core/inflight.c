@@ -0,0 +1,216 @@
+#include "inflight.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static inline uint64_t inflightNowMs(void)
+{
+    struct timespec stTs;
+    clock_gettime(CLOCK_MONOTONIC, &stTs);
+    return (uint64_t)stTs.tv_sec * 1000ull + (uint64_t)stTs.tv_nsec / 1000000ull;
+}
+
+/* ================================================================
+ * 마감 시각 최소 힙 (슬롯 번호를 담고, 항목은 자기 위치를 uiHeapPos 에 기억)
+ * ================================================================ */
+static inline uint64_t inflightHeapKey(const INFLIGHT_TABLE* pstTable, unsigned int uiPos)
+{
+    return pstTable->pastEntry[pstTable->pauiHeap[uiPos]].ulDeadlineMs;
+}
+
+static inline void inflightHeapSet(INFLIGHT_TABLE* pstTable, unsigned int uiPos, unsigned int uiSlot)
+{
+    pstTable->pauiHeap[uiPos] = uiSlot;
+    pstTable->pastEntry[uiSlot].uiHeapPos = uiPos;
+}
+
+static void inflightHeapUp(INFLIGHT_TABLE* pstTable, unsigned int uiPos)
+{
+    unsigned int uiSlot = pstTable->pauiHeap[uiPos];
+    uint64_t ulKey = pstTable->pastEntry[uiSlot].ulDeadlineMs;
+    while (uiPos > 0) {
+        unsigned int uiParent = (uiPos - 1) / 2;
+        if (inflightHeapKey(pstTable, uiParent) <= ulKey)
+            break;
+        inflightHeapSet(pstTable, uiPos, pstTable->pauiHeap[uiParent]);
+        uiPos = uiParent;
+    }
+    inflightHeapSet(pstTable, uiPos, uiSlot);
+}
+
+static void inflightHeapDown(INFLIGHT_TABLE* pstTable, unsigned int uiPos)
+{
+    unsigned int uiSlot = pstTable->pauiHeap[uiPos];
+    uint64_t ulKey = pstTable->pastEntry[uiSlot].ulDeadlineMs;
+    for (;;) {
+        unsigned int uiChild = uiPos * 2 + 1;
+        if (uiChild >= pstTable->uiCount)
+            break;
+        if (uiChild + 1 < pstTable->uiCount &&
+                inflightHeapKey(pstTable, uiChild + 1) < inflightHeapKey(pstTable, uiChild))
+            uiChild++;
+        if (ulKey <= inflightHeapKey(pstTable, uiChild))
+            break;
+        inflightHeapSet(pstTable, uiPos, pstTable->pauiHeap[uiChild]);
+        uiPos = uiChild;
+    }
+    inflightHeapSet(pstTable, uiPos, uiSlot);
+}
+
+/* uiCount 는 호출자가 늘린 뒤 호출 */
+static inline void inflightHeapPush(INFLIGHT_TABLE* pstTable, unsigned int uiSlot)
+{
+    unsigned int uiPos = pstTable->uiCount - 1;
+    pstTable->pauiHeap[uiPos] = uiSlot;
+    inflightHeapUp(pstTable, uiPos);
+}
+
+/* 슬롯을 비우고 힙에서 뺀다 (uiCount 감소) */
+static void inflightRemove(INFLIGHT_TABLE* pstTable, INFLIGHT_ENTRY* pstEntry)
+{
+    unsigned int uiPos = pstEntry->uiHeapPos;
+    unsigned int uiLast = --pstTable->uiCount;
+    pstEntry->uiSeq = 0;
+    if (uiPos == uiLast)
+        return;
+    inflightHeapSet(pstTable, uiPos, pstTable->pauiHeap[uiLast]);
+    if (uiPos > 0 && inflightHeapKey(pstTable, uiPos) < inflightHeapKey(pstTable, (uiPos - 1) / 2))
+        inflightHeapUp(pstTable, uiPos);
+    else
+        inflightHeapDown(pstTable, uiPos);
+}
+
+/* === 마감 시각에 타이머 예약 (이미 더 이른 시각에 예약돼 있으면 유지) === */
+static void inflightArm(INFLIGHT_TABLE* pstTable, uint64_t ulDeadlineMs, uint64_t ulNowMs)
+{
+    if (pstTable->ulArmedMs && pstTable->ulArmedMs <= ulDeadlineMs)
+        return;
+
+    uint64_t ulWaitMs = ulDeadlineMs > ulNowMs ? ulDeadlineMs - ulNowMs : 0;
+    struct timeval stTv = { (time_t)(ulWaitMs / 1000), (suseconds_t)((ulWaitMs % 1000) * 1000) };
+    evtimer_add(pstTable->pstTimerEvent, &stTv);
+    pstTable->ulArmedMs = ulDeadlineMs;
+}
+
+/* === 시간 초과 처리: 힙 꼭대기에서 만료 항목만 꺼내 콜백 후 다음 마감으로 재예약 === */
+static void inflightTimerCb(evutil_socket_t fd, short nEvents, void* pvData)
+{
+    (void)fd; (void)nEvents;
+    INFLIGHT_TABLE* pstTable = (INFLIGHT_TABLE*)pvData;
+    uint64_t ulNowMs = inflightNowMs();
+
+    pstTable->ulArmedMs = 0;
+    while (pstTable->uiCount > 0 && inflightHeapKey(pstTable, 0) <= ulNowMs) {
+        /* 콜백에서 새 요청을 보낼 수 있으므로 슬롯을 먼저 비운다 */
+        INFLIGHT_ENTRY* pstEntry = &pstTable->pastEntry[pstTable->pauiHeap[0]];
+        INFLIGHT_ENTRY stExpired = *pstEntry;
+        inflightRemove(pstTable, pstEntry);
+        pstTable->ulTimeoutCnt++;
+        TRACE_INFO(TRACE_EV_INFLIGHT_TIMEOUT, pstTable, stExpired.unCmd, stExpired.uiSeq, 0);
+        if (stExpired.pfnCallback)
+            stExpired.pfnCallback(INFLIGHT_TIMEOUT, NULL, stExpired.pvUser);
+    }
+
+    if (pstTable->uiCount > 0)
+        inflightArm(pstTable, inflightHeapKey(pstTable, 0), ulNowMs);
+}
+
+int inflightInit(INFLIGHT_TABLE* pstTable, struct event_base* pstEventBase, unsigned int uiCapacity)
+{
+    memset(pstTable, 0, sizeof(*pstTable));
+    if (!pstEventBase || uiCapacity == 0 || (uiCapacity & (uiCapacity - 1)) != 0)
+        return -1;//INFLIGHT_ERR_INVALID_ARG
+
+    pstTable->pastEntry = calloc(uiCapacity, sizeof(INFLIGHT_ENTRY));
+    pstTable->pauiHeap  = calloc(uiCapacity, sizeof(unsigned int));
+    pstTable->pstTimerEvent = evtimer_new(pstEventBase, inflightTimerCb, pstTable);
+    if (!pstTable->pastEntry || !pstTable->pauiHeap || !pstTable->pstTimerEvent) {
+        inflightFree(pstTable);
+        return -1;//INFLIGHT_ERR_MEMORY_ALLOC_FAIL
+    }
+    pstTable->uiMask    = uiCapacity - 1;
+    pstTable->uiNextSeq = 1;
+    return 0;
+}
+
+/* === 대기 중인 요청을 모두 취소(INFLIGHT_CANCELLED)하고 해제 === */
+void inflightFree(INFLIGHT_TABLE* pstTable)
+{
+    INFLIGHT_ENTRY* pastEntry = pstTable->pastEntry;
+    unsigned int* pauiHeap = pstTable->pauiHeap;
+    unsigned int uiCount = pastEntry && pauiHeap ? pstTable->uiCount : 0;
+
+    if (pstTable->pstTimerEvent)
+        event_free(pstTable->pstTimerEvent);
+    pstTable->pstTimerEvent = NULL;
+    pstTable->pastEntry = NULL;
+    pstTable->pauiHeap = NULL;
+    pstTable->uiCount = 0;
+
+    /* 대기 항목만 힙에서 차례로 (용량 전체를 훑지 않는다) */
+    for (unsigned int i = 0; i < uiCount; i++) {
+        INFLIGHT_ENTRY* pstEntry = &pastEntry[pauiHeap[i]];
+        if (pstEntry->pfnCallback)
+            pstEntry->pfnCallback(INFLIGHT_CANCELLED, NULL, pstEntry->pvUser);
+    }
+    free(pauiHeap);
+    free(pastEntry);
+}
+
+long inflightRequest(FRAME_CTX* pstFrameCtx, unsigned short unCmd, unsigned char uchSubModule,
+        const void* pvPayload, int iDataLength, unsigned int uiTimeoutMs,
+        INFLIGHT_CB pfnCallback, void* pvUser)
+{
+    if (!pstFrameCtx || !frameOutput(pstFrameCtx) || !pstFrameCtx->pstInflight)
+        return -1;//INFLIGHT_ERR_INVALID_ARG
+
+    INFLIGHT_TABLE* pstTable = pstFrameCtx->pstInflight;
+    if (!pstTable->pastEntry || pstTable->uiCount > pstTable->uiMask)
+        return -1;//INFLIGHT_ERR_TABLE_FULL
+
+    /* 오래 대기 중인 항목이 차지한 슬롯은 건너뛴다 (상관 ID 0은 사용하지 않음) */
+    INFLIGHT_ENTRY* pstEntry;
+    unsigned int uiSeq;
+    do {
+        uiSeq = pstTable->uiNextSeq++;
+        if (uiSeq == 0)
+            uiSeq = pstTable->uiNextSeq++;
+        pstEntry = &pstTable->pastEntry[uiSeq & pstTable->uiMask];
+    } while (pstEntry->uiSeq);
+
+    FRAME_IOV stFrame = { unCmd, uchSubModule, pvPayload, iDataLength, uiSeq, 0, 0, 0 };
+    if (writeFrameIovCtx(pstFrameCtx, &stFrame) < 0)
+        return -1;//INFLIGHT_ERR_SEND_FAIL
+
+    uint64_t ulNowMs = inflightNowMs();
+    pstEntry->uiSeq         = uiSeq;
+    pstEntry->unCmd         = unCmd;
+    pstEntry->pfnCallback   = pfnCallback;
+    pstEntry->pvUser        = pvUser;
+    pstEntry->ulDeadlineMs  = ulNowMs + (uiTimeoutMs ? uiTimeoutMs : INFLIGHT_DEFAULT_TIMEOUT_MS);
+    pstTable->uiCount++;
+    inflightHeapPush(pstTable, (unsigned int)(pstEntry - pstTable->pastEntry));
+    inflightArm(pstTable, pstEntry->ulDeadlineMs, ulNowMs);
+    return (long)uiSeq;
+}
+
+int inflightComplete(INFLIGHT_TABLE* pstTable, const FRAME_VIEW* pstFrameView)
+{
+    if (!pstTable->pastEntry || !pstFrameView->uiSeq)
+        return 0;
+
+    INFLIGHT_ENTRY* pstEntry = &pstTable->pastEntry[pstFrameView->uiSeq & pstTable->uiMask];
+    if (pstEntry->uiSeq != pstFrameView->uiSeq) {
+        pstTable->ulLateCnt++;
+        TRACE_INFO(TRACE_EV_INFLIGHT_LATE, pstTable, pstFrameView->unCmd, pstFrameView->uiSeq, 0);
+        return 0;//INFLIGHT_ERR_NOT_FOUND
+    }
+
+    INFLIGHT_ENTRY stDone = *pstEntry;
+    inflightRemove(pstTable, pstEntry);
+    if (stDone.pfnCallback)
+        stDone.pfnCallback(INFLIGHT_DONE, pstFrameView, stDone.pvUser);
+    return 1;
+}
@@ -0,0 +1,64 @@
+#ifndef INFLIGHT_H
+#define INFLIGHT_H
+
+#include <stdint.h>
+#include <event2/event.h>
+#include "frame.h"
+
+/*
+ * 요청/응답 상관 테이블 (세션당 하나)
+ *  - inflightRequest()가 상관 ID를 붙여 요청을 보내고 완료 콜백을 등록
+ *  - 응답(FRAME_FLAG_RESPONSE)이 오면 responseFrame()이 inflightComplete()로 콜백 호출
+ *  - 시간 초과는 가장 이른 마감 시각에 맞춘 타이머 하나로 처리
+ *    (대기 항목은 마감 시각 최소 힙에 두어, 타이머는 만료된 항목만 꺼낸다)
+ * 슬롯은 uiSeq & 마스크 로 바로 찾으므로 응답 매칭이 O(1) 이다.
+ */
+#define INFLIGHT_DEFAULT_CAPACITY   1024    /* 세션당 동시 요청 수 (2의 거듭제곱) */
+#define INFLIGHT_DEFAULT_TIMEOUT_MS 3000
+
+/* 완료 상태 */
+#define INFLIGHT_DONE       1
+#define INFLIGHT_TIMEOUT    0
+#define INFLIGHT_CANCELLED  -1
+
+/* pstFrameView 는 INFLIGHT_DONE 일 때만 유효 (콜백 안에서만 참조) */
+typedef void (*INFLIGHT_CB)(int iStatus, const FRAME_VIEW* pstFrameView, void* pvUser);
+
+typedef struct {
+    unsigned int        uiSeq;          /* 0: 빈 슬롯 */
+    unsigned short      unCmd;
+    INFLIGHT_CB         pfnCallback;
+    void                *pvUser;
+    uint64_t            ulDeadlineMs;
+    unsigned int        uiHeapPos;      /* pauiHeap 안의 위치 (대기 중일 때만 유효) */
+} INFLIGHT_ENTRY;
+
+struct inflight_table {
+    INFLIGHT_ENTRY      *pastEntry;
+    unsigned int        uiMask;
+    unsigned int        uiCount;
+    unsigned int        uiNextSeq;
+    unsigned int        *pauiHeap;      /* 대기 항목 슬롯 번호, ulDeadlineMs 최소 힙 (uiCount 개) */
+    struct event        *pstTimerEvent;
+    uint64_t            ulArmedMs;      /* 타이머가 예약된 마감 시각 (0: 없음) */
+    unsigned long       ulTimeoutCnt;
+    unsigned long       ulLateCnt;      /* 대기 항목 없이 도착한 응답 */
+};
+
+int  inflightInit(INFLIGHT_TABLE* pstTable, struct event_base* pstEventBase, unsigned int uiCapacity);
+void inflightFree(INFLIGHT_TABLE* pstTable);
+
+/* return: 상관 ID (>0), -1 테이블 가득 참/송신 실패 */
+long inflightRequest(FRAME_CTX* pstFrameCtx, unsigned short unCmd, unsigned char uchSubModule,
+        const void* pvPayload, int iDataLength, unsigned int uiTimeoutMs,
+        INFLIGHT_CB pfnCallback, void* pvUser);
+
+/* return: 1 대기 항목 완료, 0 일치 항목 없음 */
+int  inflightComplete(INFLIGHT_TABLE* pstTable, const FRAME_VIEW* pstFrameView);
+
+static inline unsigned int inflightPending(const INFLIGHT_TABLE* pstTable)
+{
+    return pstTable->uiCount;
+}
+
+#endif /* INFLIGHT_H */
@@ -22,6 +22,11 @@ int setReuseaddr(int iFd)
 
 /* TCP SERVER */
 int createTcpServer(unsigned short unPort)
+{
+    return createTcpServerOpt(unPort, 0);
+}
+
+int createTcpServerOpt(unsigned short unPort, int iReusePort)
 {
     int iFd = socket(AF_INET, SOCK_STREAM, 0);
     if (iFd < 0)
@@ -29,6 +34,13 @@ int createTcpServer(unsigned short unPort)
 
     setReuseaddr(iFd);
     makeNonblockClosexec(iFd);
+    if (iReusePort) {
+        int iYes = 1;
+        if (setsockopt(iFd, SOL_SOCKET, SO_REUSEPORT, &iYes, sizeof(iYes)) < 0) {
+            close(iFd);
+            return -1;
+        }
+    }
 
     struct sockaddr_in stSockAddr;
     memset(&stSockAddr, 0, sizeof(stSockAddr));
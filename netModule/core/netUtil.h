@@ -20,6 +20,8 @@ int  setReuseaddr(int fd);
 
 /* TCP/UDP 서버/클라 소켓 */
 int  createTcpServer(unsigned short port);
+/* iReusePort: SO_REUSEPORT 로 같은 포트에 여러 리스너 (커널이 연결 분산) */
+int  createTcpServerOpt(unsigned short port, int iReusePort);
 int  createUdpServer(unsigned short port);
 int  createTcpClient(const char* ip, unsigned short port);
 int  createUdpClient(const char* srv_ip, unsigned short srv_port,
@@ -0,0 +1,90 @@
+#include "slabPool.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* 슬랩 머리 (한 캐시 라인 차지, 객체는 그 뒤부터) */
+struct slab_hdr {
+    SLAB_HDR        *pstNext;
+    unsigned int    uiObjCnt;
+};
+
+_Static_assert(sizeof(SLAB_HDR) <= SLAB_CACHE_LINE, "SLAB_HDR must fit in one cache line");
+
+void slabPoolInit(SLAB_POOL* pstPool, size_t ulObjSize, unsigned int uiSlabObjs)
+{
+    memset(pstPool, 0, sizeof(*pstPool));
+    if (ulObjSize < sizeof(void*))
+        ulObjSize = sizeof(void*);
+    pstPool->ulObjSize  = (ulObjSize + SLAB_CACHE_LINE - 1) & ~(size_t)(SLAB_CACHE_LINE - 1);
+    pstPool->uiSlabObjs = uiSlabObjs ? uiSlabObjs : SLAB_OBJS_DEFAULT;
+}
+
+/* === 슬랩 하나 할당 후 객체를 free list 에 연결 === */
+static int slabPoolGrow(SLAB_POOL* pstPool, unsigned int uiObjCnt)
+{
+    SLAB_HDR* pstSlab = aligned_alloc(SLAB_CACHE_LINE, SLAB_CACHE_LINE + (size_t)uiObjCnt * pstPool->ulObjSize);
+    if (!pstSlab)
+        return -1;//SLAB_ERR_MEMORY_ALLOC_FAIL
+
+    pstSlab->pstNext    = pstPool->pstSlabHead;
+    pstSlab->uiObjCnt   = uiObjCnt;
+    pstPool->pstSlabHead = pstSlab;
+
+    /* 뒤에서부터 연결해 앞쪽 객체가 먼저 나가도록 */
+    unsigned char* puchObjs = (unsigned char*)pstSlab + SLAB_CACHE_LINE;
+    for (unsigned int i = uiObjCnt; i-- > 0; ) {
+        void* pvObj = puchObjs + (size_t)i * pstPool->ulObjSize;
+        *(void**)pvObj = pstPool->pvFreeHead;
+        pstPool->pvFreeHead = pvObj;
+    }
+    pstPool->ulCapacity += uiObjCnt;
+    return 0;
+}
+
+int slabPoolReserve(SLAB_POOL* pstPool, unsigned long ulCount)
+{
+    unsigned long ulFree = pstPool->ulCapacity - pstPool->ulInUse;
+    if (ulCount <= ulFree)
+        return 0;
+    return slabPoolGrow(pstPool, (unsigned int)(ulCount - ulFree));
+}
+
+void* slabPoolAlloc(SLAB_POOL* pstPool)
+{
+    if (pstPool->pvFreeHead) {
+        pstPool->ulHitCnt++;
+    } else {
+        pstPool->ulMissCnt++;
+        if (slabPoolGrow(pstPool, pstPool->uiSlabObjs) < 0)
+            return NULL;
+    }
+
+    void* pvObj = pstPool->pvFreeHead;
+    pstPool->pvFreeHead = *(void**)pvObj;
+    pstPool->ulInUse++;
+    memset(pvObj, 0, pstPool->ulObjSize);
+    return pvObj;
+}
+
+void slabPoolFree(SLAB_POOL* pstPool, void* pvObj)
+{
+    if (!pvObj)
+        return;
+    *(void**)pvObj = pstPool->pvFreeHead;
+    pstPool->pvFreeHead = pvObj;
+    pstPool->ulInUse--;
+}
+
+void slabPoolDestroy(SLAB_POOL* pstPool)
+{
+    SLAB_HDR* pstSlab = pstPool->pstSlabHead;
+    while (pstSlab) {
+        SLAB_HDR* pstNext = pstSlab->pstNext;
+        free(pstSlab);
+        pstSlab = pstNext;
+    }
+    pstPool->pstSlabHead = NULL;
+    pstPool->pvFreeHead  = NULL;
+    pstPool->ulCapacity  = 0;
+    pstPool->ulInUse     = 0;
+}
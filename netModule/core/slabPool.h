@@ -0,0 +1,36 @@
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include <stddef.h>
+
+/*
+ * 고정 크기 객체 슬랩 풀 (단일 스레드: 소유 event_base 스레드에서만 사용)
+ *  - 객체는 캐시 라인(64 bytes) 경계에 정렬, 크기도 캐시 라인 배수로 올림
+ *  - 해제된 객체는 free list 로 재사용, 슬랩 메모리는 slabPoolDestroy() 전까지 유지
+ *  - free list 가 비면 슬랩 하나(uiSlabObjs 개)를 새로 할당 (miss)
+ */
+#define SLAB_CACHE_LINE         64
+#define SLAB_OBJS_DEFAULT       64      /* 확장 시 슬랩당 객체 수 */
+
+typedef struct slab_hdr     SLAB_HDR;
+
+typedef struct {
+    size_t          ulObjSize;          /* 정렬된 객체 크기 */
+    unsigned int    uiSlabObjs;
+    SLAB_HDR        *pstSlabHead;       /* 할당한 슬랩 목록 */
+    void            *pvFreeHead;        /* 사용 가능 객체 (객체 앞부분에 링크 저장) */
+    unsigned long   ulHitCnt;           /* free list 에서 바로 할당 */
+    unsigned long   ulMissCnt;          /* 슬랩 확장이 필요했던 할당 */
+    unsigned long   ulInUse;
+    unsigned long   ulCapacity;         /* 전체 객체 수 */
+} SLAB_POOL;
+
+void  slabPoolInit(SLAB_POOL* pstPool, size_t ulObjSize, unsigned int uiSlabObjs);
+/* 최소 uiCount 개를 사용할 수 있도록 미리 확보, return: 0 성공, -1 메모리 부족 */
+int   slabPoolReserve(SLAB_POOL* pstPool, unsigned long ulCount);
+/* 0으로 초기화된 객체, return: NULL 메모리 부족 */
+void* slabPoolAlloc(SLAB_POOL* pstPool);
+void  slabPoolFree(SLAB_POOL* pstPool, void* pvObj);
+void  slabPoolDestroy(SLAB_POOL* pstPool);
+
+#endif /* SLAB_POOL_H */
@@ -0,0 +1,149 @@
+#include "timerWheel.h"
+#include <string.h>
+#include <time.h>
+
+#define TW_SLOT_MASK    (TW_SLOTS - 1)
+#define TW_MAX_DELTA    ((1ull << (TW_SLOT_BITS * TW_LEVELS)) - 1)
+
+static inline uint64_t timerNowMs(void)
+{
+    struct timespec stTs;
+    clock_gettime(CLOCK_MONOTONIC, &stTs);
+    return (uint64_t)stTs.tv_sec * 1000ull + (uint64_t)stTs.tv_nsec / 1000000ull;
+}
+
+static inline void timerUnlink(TIMER_NODE* pstNode)
+{
+    pstNode->pstPrev->pstNext = pstNode->pstNext;
+    pstNode->pstNext->pstPrev = pstNode->pstPrev;
+    pstNode->pstNext = NULL;
+    pstNode->pstPrev = NULL;
+}
+
+/* === 만료 틱까지 남은 거리로 단/슬롯 결정 === */
+static void timerInsert(TIMER_WHEEL* pstWheel, TIMER_NODE* pstNode)
+{
+    if (pstNode->ulExpireTick < pstWheel->ulCurTick)
+        pstNode->ulExpireTick = pstWheel->ulCurTick;
+    if (pstNode->ulExpireTick - pstWheel->ulCurTick > TW_MAX_DELTA)
+        pstNode->ulExpireTick = pstWheel->ulCurTick + TW_MAX_DELTA;
+
+    uint64_t ulDelta = pstNode->ulExpireTick - pstWheel->ulCurTick;
+    int iLevel = 0;
+    while (iLevel < TW_LEVELS - 1 && ulDelta >= (1ull << (TW_SLOT_BITS * (iLevel + 1))))
+        iLevel++;
+
+    TIMER_NODE* pstHead = &pstWheel->astSlot[iLevel]
+        [(pstNode->ulExpireTick >> (TW_SLOT_BITS * iLevel)) & TW_SLOT_MASK];
+    pstNode->pstNext = pstHead;
+    pstNode->pstPrev = pstHead->pstPrev;
+    pstHead->pstPrev->pstNext = pstNode;
+    pstHead->pstPrev = pstNode;
+}
+
+/* === 상위 단 슬롯의 타이머를 아래 단으로 재배치 === */
+static void timerCascade(TIMER_WHEEL* pstWheel, int iLevel)
+{
+    TIMER_NODE* pstHead = &pstWheel->astSlot[iLevel]
+        [(pstWheel->ulCurTick >> (TW_SLOT_BITS * iLevel)) & TW_SLOT_MASK];
+    while (pstHead->pstNext != pstHead) {
+        TIMER_NODE* pstNode = pstHead->pstNext;
+        timerUnlink(pstNode);
+        timerInsert(pstWheel, pstNode);
+    }
+}
+
+static void timerTickCb(evutil_socket_t fd, short nEvents, void* pvData)
+{
+    (void)fd; (void)nEvents;
+    TIMER_WHEEL* pstWheel = (TIMER_WHEEL*)pvData;
+    uint64_t ulTarget = (timerNowMs() - pstWheel->ulStartMs) / pstWheel->uiTickMs;
+    if (ulTarget > pstWheel->ulCurTick)
+        timerWheelAdvance(pstWheel, ulTarget - pstWheel->ulCurTick);
+}
+
+int timerWheelInit(TIMER_WHEEL* pstWheel, struct event_base* pstEventBase, unsigned int uiTickMs)
+{
+    memset(pstWheel, 0, sizeof(*pstWheel));
+    for (int i = 0; i < TW_LEVELS; i++)
+        for (int j = 0; j < TW_SLOTS; j++)
+            pstWheel->astSlot[i][j].pstNext = pstWheel->astSlot[i][j].pstPrev = &pstWheel->astSlot[i][j];
+    pstWheel->uiTickMs  = uiTickMs ? uiTickMs : 1;
+    pstWheel->ulStartMs = timerNowMs();
+    if (!pstEventBase)
+        return 0;
+
+    struct timeval stTv = { (time_t)(pstWheel->uiTickMs / 1000), (suseconds_t)((pstWheel->uiTickMs % 1000) * 1000) };
+    pstWheel->pstTickEvent = event_new(pstEventBase, -1, EV_PERSIST, timerTickCb, pstWheel);
+    if (!pstWheel->pstTickEvent || event_add(pstWheel->pstTickEvent, &stTv) < 0) {
+        timerWheelFree(pstWheel);
+        return -1;//TIMER_ERR_EVENT
+    }
+    return 0;
+}
+
+/* === 예약된 타이머는 콜백 없이 모두 해제 === */
+void timerWheelFree(TIMER_WHEEL* pstWheel)
+{
+    if (pstWheel->pstTickEvent)
+        event_free(pstWheel->pstTickEvent);
+    pstWheel->pstTickEvent = NULL;
+
+    for (int i = 0; i < TW_LEVELS; i++) {
+        for (int j = 0; j < TW_SLOTS; j++) {
+            TIMER_NODE* pstHead = &pstWheel->astSlot[i][j];
+            while (pstHead->pstNext && pstHead->pstNext != pstHead)
+                timerUnlink(pstHead->pstNext);
+        }
+    }
+    pstWheel->ulCount = 0;
+}
+
+void timerWheelAdd(TIMER_WHEEL* pstWheel, TIMER_NODE* pstNode, unsigned int uiTimeoutMs,
+        TIMER_CB pfnCallback, void* pvUser)
+{
+    if (timerPending(pstNode))
+        timerUnlink(pstNode);
+    else
+        pstWheel->ulCount++;
+
+    uint64_t ulTicks = (uiTimeoutMs + pstWheel->uiTickMs - 1) / pstWheel->uiTickMs;
+    pstNode->ulExpireTick   = pstWheel->ulCurTick + (ulTicks ? ulTicks : 1);
+    pstNode->pfnCallback    = pfnCallback;
+    pstNode->pvUser         = pvUser;
+    timerInsert(pstWheel, pstNode);
+}
+
+void timerWheelCancel(TIMER_WHEEL* pstWheel, TIMER_NODE* pstNode)
+{
+    if (!timerPending(pstNode))
+        return;
+    timerUnlink(pstNode);
+    pstWheel->ulCount--;
+}
+
+void timerWheelAdvance(TIMER_WHEEL* pstWheel, uint64_t ulTicks)
+{
+    while (ulTicks-- > 0) {
+        uint64_t ulTick = ++pstWheel->ulCurTick;
+
+        /* 구간 경계: 상위 단부터 아래로 내린다 */
+        if ((ulTick & TW_SLOT_MASK) == 0) {
+            int iTop = 1;
+            while (iTop < TW_LEVELS - 1 && ((ulTick >> (TW_SLOT_BITS * iTop)) & TW_SLOT_MASK) == 0)
+                iTop++;
+            for (int iLevel = iTop; iLevel >= 1; iLevel--)
+                timerCascade(pstWheel, iLevel);
+        }
+
+        /* 콜백이 다른 타이머를 취소/예약할 수 있으므로 머리에서 하나씩 꺼낸다 */
+        TIMER_NODE* pstHead = &pstWheel->astSlot[0][ulTick & TW_SLOT_MASK];
+        while (pstHead->pstNext != pstHead) {
+            TIMER_NODE* pstNode = pstHead->pstNext;
+            timerUnlink(pstNode);
+            pstWheel->ulCount--;
+            if (pstNode->pfnCallback)
+                pstNode->pfnCallback(pstNode, pstNode->pvUser);
+        }
+    }
+}
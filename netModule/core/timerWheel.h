@@ -0,0 +1,55 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <event2/event.h>
+
+/*
+ * 계층 타이머 휠 (4단 x 64슬롯)
+ *  - 주기 이벤트 하나(uiTickMs)로 수천 개 타이머를 구동, 추가/취소 O(1)
+ *  - 0단은 64틱, 상위 단은 64배씩 범위가 넓고 해당 구간이 오면 아래 단으로 내려온다
+ *  - 범위(64^4 틱)를 넘는 타이머는 최대 범위에서 만료 (콜백에서 다시 예약)
+ *  - 단일 스레드: event_base 스레드에서만 사용
+ */
+#define TW_LEVELS       4
+#define TW_SLOT_BITS    6
+#define TW_SLOTS        (1 << TW_SLOT_BITS)
+
+typedef struct timer_node TIMER_NODE;
+typedef void (*TIMER_CB)(TIMER_NODE* pstNode, void* pvUser);
+
+/* 사용자 구조체에 포함해서 쓰는 타이머 (초기값 0) */
+struct timer_node {
+    TIMER_NODE      *pstNext;           /* NULL: 예약 안 됨 */
+    TIMER_NODE      *pstPrev;
+    uint64_t        ulExpireTick;
+    TIMER_CB        pfnCallback;
+    void            *pvUser;
+};
+
+typedef struct {
+    TIMER_NODE      astSlot[TW_LEVELS][TW_SLOTS];  /* 원형 리스트 머리 */
+    uint64_t        ulCurTick;          /* 마지막으로 처리한 틱 */
+    uint64_t        ulStartMs;
+    unsigned int    uiTickMs;
+    unsigned long   ulCount;            /* 예약된 타이머 수 */
+    struct event    *pstTickEvent;      /* NULL: 수동 구동 (timerWheelAdvance) */
+} TIMER_WHEEL;
+
+/* pstEventBase 가 NULL 이면 주기 이벤트 없이 timerWheelAdvance()로 구동 */
+int  timerWheelInit(TIMER_WHEEL* pstWheel, struct event_base* pstEventBase, unsigned int uiTickMs);
+void timerWheelFree(TIMER_WHEEL* pstWheel);
+
+/* (재)예약: 이미 예약돼 있으면 옮긴다 */
+void timerWheelAdd(TIMER_WHEEL* pstWheel, TIMER_NODE* pstNode, unsigned int uiTimeoutMs,
+        TIMER_CB pfnCallback, void* pvUser);
+void timerWheelCancel(TIMER_WHEEL* pstWheel, TIMER_NODE* pstNode);
+/* 틱 ulTicks 개 진행 (만료 콜백 호출) */
+void timerWheelAdvance(TIMER_WHEEL* pstWheel, uint64_t ulTicks);
+
+static inline int timerPending(const TIMER_NODE* pstNode)
+{
+    return pstNode->pstNext != NULL;
+}
+
+#endif /* TIMER_WHEEL_H */
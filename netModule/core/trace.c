@@ -0,0 +1,141 @@
+#include "trace.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#define TRACE_RING_MASK     (TRACE_RING_SIZE - 1)
+
+_Static_assert((TRACE_RING_SIZE & TRACE_RING_MASK) == 0, "TRACE_RING_SIZE must be a power of two");
+
+typedef struct trace_ring TRACE_RING;
+struct trace_ring {
+    _Atomic uint64_t    ulHead;         /* 다음에 쓸 레코드 번호 (소유 스레드만 증가) */
+    uint32_t            uiThreadId;
+    TRACE_RING          *pstNext;       /* 전역 등록 리스트 (추가만 함) */
+    TRACE_RECORD        astRecord[TRACE_RING_SIZE];
+};
+
+/* 링은 스레드 종료 후에도 덤프할 수 있도록 해제하지 않는다 */
+static _Atomic(TRACE_RING*) g_pstRingHead = NULL;
+static __thread TRACE_RING* t_pstRing = NULL;
+
+static const char* s_apchEventName[TRACE_EV_MAX] = {
+    [TRACE_EV_NONE]             = "NONE",
+    [TRACE_EV_RX_BYTES]         = "RX_BYTES",
+    [TRACE_EV_RX_FRAME]         = "RX_FRAME",
+    [TRACE_EV_TX_FRAME]         = "TX_FRAME",
+    [TRACE_EV_RES_ID]           = "RES_ID",
+    [TRACE_EV_RES_KEEP_ALIVE]   = "RES_KEEP_ALIVE",
+    [TRACE_EV_RES_IBIT]         = "RES_IBIT",
+    [TRACE_EV_CMD_UNKNOWN]      = "CMD_UNKNOWN",
+    [TRACE_EV_CMD_SIZE]         = "CMD_SIZE",
+    [TRACE_EV_RESYNC]           = "RESYNC",
+    [TRACE_EV_CRC_ERR]          = "CRC_ERR",
+    [TRACE_EV_ETX_ERR]          = "ETX_ERR",
+    [TRACE_EV_LENGTH_ERR]       = "LENGTH_ERR",
+    [TRACE_EV_INFLIGHT_TIMEOUT] = "INFLIGHT_TIMEOUT",
+    [TRACE_EV_INFLIGHT_LATE]    = "INFLIGHT_LATE",
+    [TRACE_EV_DECOMPRESS_ERR]   = "DECOMPRESS_ERR",
+    [TRACE_EV_FRAG_ERR]         = "FRAG_ERR",
+    [TRACE_EV_ROUTE]            = "ROUTE",
+};
+
+const char* traceEventName(uint8_t uchEvent)
+{
+    return uchEvent < TRACE_EV_MAX && s_apchEventName[uchEvent] ? s_apchEventName[uchEvent] : "?";
+}
+
+/* === 현재 스레드의 링 (첫 호출 시 할당 후 전역 리스트에 CAS로 등록) === */
+static TRACE_RING* traceThreadRing(void)
+{
+    TRACE_RING* pstRing = calloc(1, sizeof(*pstRing));
+    if (!pstRing)
+        return NULL;
+    pstRing->uiThreadId = (uint32_t)syscall(SYS_gettid);
+
+    TRACE_RING* pstHead = atomic_load_explicit(&g_pstRingHead, memory_order_relaxed);
+    do {
+        pstRing->pstNext = pstHead;
+    } while (!atomic_compare_exchange_weak_explicit(&g_pstRingHead, &pstHead, pstRing,
+                memory_order_release, memory_order_relaxed));
+
+    t_pstRing = pstRing;
+    return pstRing;
+}
+
+void traceRecord(uint8_t uchEvent, const void* pvSession, uint16_t unCmd,
+        uint32_t uiLength, uint8_t uchArg)
+{
+    TRACE_RING* pstRing = t_pstRing;
+    if (!pstRing && !(pstRing = traceThreadRing()))
+        return;
+
+    struct timespec stTs;
+    clock_gettime(CLOCK_MONOTONIC, &stTs);
+
+    uint64_t ulHead = atomic_load_explicit(&pstRing->ulHead, memory_order_relaxed);
+    TRACE_RECORD* pstRecord = &pstRing->astRecord[ulHead & TRACE_RING_MASK];
+    pstRecord->ulTimestampNs    = (uint64_t)stTs.tv_sec * 1000000000ull + (uint64_t)stTs.tv_nsec;
+    pstRecord->ulSession        = (uint64_t)(uintptr_t)pvSession;
+    pstRecord->uiLength         = uiLength;
+    pstRecord->unCmd            = unCmd;
+    pstRecord->uchEvent         = uchEvent;
+    pstRecord->uchArg           = uchArg;
+
+    /* 레코드 내용을 먼저 쓰고 head 를 공개 */
+    atomic_store_explicit(&pstRing->ulHead, ulHead + 1, memory_order_release);
+}
+
+/* === 링 순회 ===
+ * 복사 후 head 를 다시 읽어, 그 사이 덮어쓰였을 수 있는 레코드
+ * (쓰기 중인 슬롯 포함)는 버린다.
+ */
+long traceCollect(TRACE_VISIT pfnVisit, void* pvUser)
+{
+    TRACE_RECORD* pastCopy = malloc(sizeof(TRACE_RECORD) * TRACE_RING_SIZE);
+    long lTotal = 0;
+    if (!pastCopy)
+        return -1;
+
+    for (TRACE_RING* pstRing = atomic_load_explicit(&g_pstRingHead, memory_order_acquire);
+            pstRing; pstRing = pstRing->pstNext) {
+        uint64_t ulHead = atomic_load_explicit(&pstRing->ulHead, memory_order_acquire);
+        uint64_t ulStart = ulHead > TRACE_RING_SIZE ? ulHead - TRACE_RING_SIZE : 0;
+
+        for (uint64_t ul = ulStart; ul < ulHead; ul++)
+            pastCopy[ul & TRACE_RING_MASK] = pstRing->astRecord[ul & TRACE_RING_MASK];
+
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t ulHeadAfter = atomic_load_explicit(&pstRing->ulHead, memory_order_relaxed);
+        if (ulHeadAfter + 1 > ulStart + TRACE_RING_SIZE)
+            ulStart = ulHeadAfter + 1 - TRACE_RING_SIZE;
+
+        for (uint64_t ul = ulStart; ul < ulHead; ul++) {
+            pfnVisit(pstRing->uiThreadId, &pastCopy[ul & TRACE_RING_MASK], pvUser);
+            lTotal++;
+        }
+    }
+
+    free(pastCopy);
+    return lTotal;
+}
+
+static void traceDumpVisit(uint32_t uiThreadId, const TRACE_RECORD* pstRecord, void* pvUser)
+{
+    fprintf((FILE*)pvUser, "%llu.%09llu tid=%u sess=%#llx %-14s cmd=%#04x len=%u arg=%u\n",
+        (unsigned long long)(pstRecord->ulTimestampNs / 1000000000ull),
+        (unsigned long long)(pstRecord->ulTimestampNs % 1000000000ull),
+        uiThreadId, (unsigned long long)pstRecord->ulSession,
+        traceEventName(pstRecord->uchEvent), pstRecord->unCmd,
+        pstRecord->uiLength, pstRecord->uchArg);
+}
+
+long traceDump(FILE* pstFile)
+{
+    long lTotal = traceCollect(traceDumpVisit, pstFile);
+    fflush(pstFile);
+    return lTotal;
+}
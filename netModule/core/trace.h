@@ -0,0 +1,80 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * 바이너리 트레이스 링
+ *  - 스레드마다 고정 크기 레코드 링 하나 (쓰기는 소유 스레드만, lock-free)
+ *  - 링이 차면 가장 오래된 레코드를 덮어쓴다 (flight recorder)
+ *  - traceDump()가 필요할 때 모든 스레드의 링을 텍스트로 디코딩
+ *  - TRACE_LEVEL 보다 상세한 호출 지점은 컴파일 시 제거된다
+ *      make CFLAGS+="-DTRACE_LEVEL=0"  → 트레이스 전부 제거
+ */
+#define TRACE_LEVEL_NONE    0
+#define TRACE_LEVEL_ERROR   1
+#define TRACE_LEVEL_INFO    2
+#define TRACE_LEVEL_DEBUG   3
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL         TRACE_LEVEL_INFO
+#endif
+
+#define TRACE_RING_SIZE     4096    /* 스레드당 레코드 수 (2의 거듭제곱) */
+
+typedef enum {
+    TRACE_EV_NONE = 0,
+    TRACE_EV_RX_BYTES,          /* 읽기 콜백 진입 (uiLength: 입력 버퍼 크기) */
+    TRACE_EV_RX_FRAME,          /* 프레임 수신 (uchArg: submodule) */
+    TRACE_EV_TX_FRAME,          /* 요청 프레임 송신 */
+    TRACE_EV_RES_ID,            /* uchArg: 결과 */
+    TRACE_EV_RES_KEEP_ALIVE,    /* uchArg: 결과 */
+    TRACE_EV_RES_IBIT,          /* uchArg: 종합 결과 */
+    TRACE_EV_CMD_UNKNOWN,       /* 등록되지 않은 명령 */
+    TRACE_EV_CMD_SIZE,          /* 기대 크기 불일치 */
+    TRACE_EV_RESYNC,            /* STX 재동기화 (uiLength: 버린 바이트) */
+    TRACE_EV_CRC_ERR,
+    TRACE_EV_ETX_ERR,
+    TRACE_EV_LENGTH_ERR,
+    TRACE_EV_INFLIGHT_TIMEOUT,  /* 응답 시간 초과 (uiLength: 상관 ID) */
+    TRACE_EV_INFLIGHT_LATE,     /* 대기 항목 없는 응답 (uiLength: 상관 ID) */
+    TRACE_EV_DECOMPRESS_ERR,    /* 압축 페이로드 손상 (프레임 폐기) */
+    TRACE_EV_FRAG_ERR,          /* 조각 순서 오류(uchArg 0)/재조립 상한 초과(uchArg 1) */
+    TRACE_EV_ROUTE,             /* 허브 전달 (uchArg: 목적지 ID) */
+    TRACE_EV_MAX
+} TRACE_EVENT;
+
+/* 고정 크기 레코드 (24 bytes) */
+typedef struct {
+    uint64_t    ulTimestampNs;      /* CLOCK_MONOTONIC */
+    uint64_t    ulSession;          /* 세션 포인터 값 (식별용) */
+    uint32_t    uiLength;
+    uint16_t    unCmd;
+    uint8_t     uchEvent;           /* TRACE_EV_* */
+    uint8_t     uchArg;             /* 이벤트별 부가 값 */
+} TRACE_RECORD;
+
+void traceRecord(uint8_t uchEvent, const void* pvSession, uint16_t unCmd,
+        uint32_t uiLength, uint8_t uchArg);
+
+/* 레벨 게이트: 조건이 상수이므로 비활성 지점은 코드가 남지 않는다 */
+#define TRACE(level, ev, sess, cmd, len, arg)                                   \
+    do {                                                                        \
+        if ((level) <= TRACE_LEVEL)                                             \
+            traceRecord((ev), (sess), (uint16_t)(cmd), (uint32_t)(len), (uint8_t)(arg)); \
+    } while (0)
+
+#define TRACE_ERROR(ev, sess, cmd, len, arg)    TRACE(TRACE_LEVEL_ERROR, ev, sess, cmd, len, arg)
+#define TRACE_INFO(ev, sess, cmd, len, arg)     TRACE(TRACE_LEVEL_INFO, ev, sess, cmd, len, arg)
+#define TRACE_DEBUG(ev, sess, cmd, len, arg)    TRACE(TRACE_LEVEL_DEBUG, ev, sess, cmd, len, arg)
+
+/* 모든 스레드의 링을 스레드별 시간순으로 순회 (덮어쓰기 중인 레코드는 건너뜀)
+ * return: 전달한 레코드 수 */
+typedef void (*TRACE_VISIT)(uint32_t uiThreadId, const TRACE_RECORD* pstRecord, void* pvUser);
+long traceCollect(TRACE_VISIT pfnVisit, void* pvUser);
+
+long traceDump(FILE* pstFile);
+const char* traceEventName(uint8_t uchEvent);
+
+#endif /* TRACE_H */
@@ -1,16 +1,651 @@
 #include "commonSession.h"
 #include "../core/frame.h"
+#include "../core/icdCommand.h"
+#include "../core/checksum.h"
+#include <arpa/inet.h>
+#include <endian.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
+#include <string.h>
+
+/* === 상대 ID 버킷에서 분리 === */
+static void sessionUnbindPeer(SESSION_CTX* pstSessionCtx)
+{
+    if (!pstSessionCtx->chPeerKnown)
+        return;
+
+    if (pstSessionCtx->pstPeerPrev)
+        pstSessionCtx->pstPeerPrev->pstPeerNext = pstSessionCtx->pstPeerNext;
+    else
+        pstSessionCtx->pstCoreCtx->apstPeerIndex[pstSessionCtx->uchPeerId] = pstSessionCtx->pstPeerNext;
+    if (pstSessionCtx->pstPeerNext)
+        pstSessionCtx->pstPeerNext->pstPeerPrev = pstSessionCtx->pstPeerPrev;
+
+    pstSessionCtx->pstPeerNext = NULL;
+    pstSessionCtx->pstPeerPrev = NULL;
+    pstSessionCtx->chPeerKnown = 0;
+}
+
+/* === 상대 ID 등록 (같은 ID의 재접속은 새 세션이 조회 우선) === */
+void sessionBindPeer(SESSION_CTX* pstSessionCtx, unsigned char uchPeerId)
+{
+    if (!pstSessionCtx || !pstSessionCtx->pstCoreCtx)
+        return;
+    if (pstSessionCtx->chPeerKnown && pstSessionCtx->uchPeerId == uchPeerId)
+        return;
+
+    sessionUnbindPeer(pstSessionCtx);
+    SESSION_CTX** ppstBucket = &pstSessionCtx->pstCoreCtx->apstPeerIndex[uchPeerId];
+    pstSessionCtx->uchPeerId    = uchPeerId;
+    pstSessionCtx->chPeerKnown  = 1;
+    pstSessionCtx->pstPeerPrev  = NULL;
+    pstSessionCtx->pstPeerNext  = *ppstBucket;
+    if (*ppstBucket)
+        (*ppstBucket)->pstPeerPrev = pstSessionCtx;
+    *ppstBucket = pstSessionCtx;
+}
+
+SESSION_CTX* sessionFindByPeer(const CORE_CTX* pstCoreCtx, unsigned char uchPeerId)
+{
+    return pstCoreCtx->apstPeerIndex[uchPeerId];
+}
+
+static void sessionPeerIdCallback(FRAME_CTX* pstFrameCtx, unsigned char uchPeerId)
+{
+    sessionBindPeer((SESSION_CTX*)pstFrameCtx->pvSession, uchPeerId);
+}
+
+/* === 허브: 같은 허브의 모든 코어에서 목적지 ID 조회 (코어 수 만큼 O(1)) === */
+SESSION_CTX* sessionRouteLookup(const CORE_CTX* pstCoreCtx, unsigned char uchDstId)
+{
+    const CORE_CTX* pstIt = pstCoreCtx;
+    do {
+        if (pstIt->apstPeerIndex[uchDstId])
+            return pstIt->apstPeerIndex[uchDstId];
+        pstIt = pstIt->pstHubNext;
+    } while (pstIt && pstIt != pstCoreCtx);
+    return NULL;
+}
+
+static FRAME_CTX* sessionRouteCallback(FRAME_CTX* pstFrameCtx, const MSG_ID* pstMsgId)
+{
+    SESSION_CTX* pstSessionCtx = (SESSION_CTX*)pstFrameCtx->pvSession;
+    if (pstMsgId->uchDstId == pstSessionCtx->pstCoreCtx->uchHubId)
+        return NULL;
+
+    SESSION_CTX* pstTarget = sessionRouteLookup(pstSessionCtx->pstCoreCtx, pstMsgId->uchDstId);
+    if (!pstTarget || pstTarget == pstSessionCtx || !pstTarget->pstBufferEvent)
+        return NULL;
+    return &pstTarget->stFrameCtx;
+}
+
+int sessionEnableHub(CORE_CTX* pstCoreCtx, unsigned char uchHubId, CORE_CTX* pstJoin)
+{
+    if (pstJoin && (!pstJoin->chHubMode || pstJoin->pstEventBase != pstCoreCtx->pstEventBase))
+        return -1;//SESSION_ERR_HUB_JOIN
+    if (pstCoreCtx->chHubMode)
+        return pstCoreCtx->uchHubId == uchHubId && !pstJoin ? 0 : -1;//SESSION_ERR_HUB_ACTIVE
+
+    pstCoreCtx->chHubMode   = 1;
+    pstCoreCtx->uchHubId    = uchHubId;
+    if (pstJoin) {
+        /* 원형 리스트에 끼워 넣기 (단독 허브는 pstHubNext 가 NULL) */
+        pstCoreCtx->pstHubNext  = pstJoin->pstHubNext ? pstJoin->pstHubNext : pstJoin;
+        pstJoin->pstHubNext     = pstCoreCtx;
+    }
+    for (SESSION_CTX* pstSessionCtx = pstCoreCtx->pstSockCtxHead; pstSessionCtx;
+            pstSessionCtx = pstSessionCtx->pstSockCtxNext)
+        pstSessionCtx->stFrameCtx.pfnRoute = sessionRouteCallback;
+    return 0;
+}
+
+/* === 브로드캐스트: 인코딩 1회, 세션마다 참조 추가 === */
+int sessionBroadcast(CORE_CTX* pstCoreCtx, const MSG_ID* pstMsgId, const FRAME_IOV* pstFrame,
+        SESSION_FILTER pfnFilter, void* pvUser)
+{
+    FRAME_SHARED* apstShared[CRC_MODE_MAX] = { NULL };
+    int iSent = 0;
+    int iRet = 0;
+
+    for (SESSION_CTX* pstSessionCtx = pstCoreCtx->pstSockCtxHead; pstSessionCtx;
+            pstSessionCtx = pstSessionCtx->pstSockCtxNext) {
+        unsigned char uchCrcMode = pstSessionCtx->stFrameCtx.uchCrcMode;
+        if (!pstSessionCtx->pstBufferEvent || uchCrcMode >= CRC_MODE_MAX)
+            continue;
+        if (pfnFilter && !pfnFilter(pstSessionCtx, pstFrame, pvUser))
+            continue;
+        if (frameTxShed(&pstSessionCtx->stFrameCtx, pstFrame->uiSeq, pstFrame->uchFlags))
+            continue;
+
+        if (!apstShared[uchCrcMode]) {
+            apstShared[uchCrcMode] = frameSharedEncode(uchCrcMode, pstMsgId, pstFrame);
+            if (!apstShared[uchCrcMode]) {
+                iRet = -1;//SESSION_ERR_ENCODE
+                break;
+            }
+        }
+        if (frameSharedAttach(apstShared[uchCrcMode],
+                bufferevent_get_output(pstSessionCtx->pstBufferEvent), SESSION_BROADCAST_COPY_MAX) < 0)
+            continue;
+        pstSessionCtx->stFrameCtx.ulTxRawBytes  += (unsigned long)pstFrame->iDataLength;
+        pstSessionCtx->stFrameCtx.ulTxWireBytes += (unsigned long)pstFrame->iDataLength;
+        pstSessionCtx->stFrameCtx.ulTxFrameCnt++;
+        pstSessionCtx->stFrameCtx.ulTxBytes     += apstShared[uchCrcMode]->ulSize;
+        iSent++;
+    }
+
+    /* 남은 참조는 각 출력 버퍼가 보낸 뒤 놓는다 */
+    for (int i = 0; i < CRC_MODE_MAX; i++)
+        frameSharedRelease(apstShared[i]);
+    return iRet < 0 ? iRet : iSent;
+}
+
+int sessionFilterPeer(const SESSION_CTX* pstSessionCtx, const FRAME_IOV* pstFrame, void* pvUser)
+{
+    (void)pstFrame;
+    return pstSessionCtx->chPeerKnown && pstSessionCtx->uchPeerId == *(const unsigned char*)pvUser;
+}
+
+/* === 카운터 ===
+ * 프레임 카운터는 세션의 FRAME_CTX 가 갖고, 코어는 레지스트리에서 빠진 세션 몫만 누계로 둔다.
+ * 코어 스냅샷은 요청 시 세션을 순회해서 만든다 (수신 경로에 추가 비용 없음).
+ */
+static void sessionStatsAdd(SESSION_STATS* pstSum, const SESSION_STATS* pstStats)
+{
+    pstSum->ulRxFrames      += pstStats->ulRxFrames;
+    pstSum->ulTxFrames      += pstStats->ulTxFrames;
+    pstSum->ulRxBytes       += pstStats->ulRxBytes;
+    pstSum->ulTxBytes       += pstStats->ulTxBytes;
+    pstSum->ulCrcErr        += pstStats->ulCrcErr;
+    pstSum->ulResync        += pstStats->ulResync;
+    pstSum->ulDiscardBytes  += pstStats->ulDiscardBytes;
+    pstSum->ulHandlerNs     += pstStats->ulHandlerNs;
+    if (pstStats->ulHandlerMaxNs > pstSum->ulHandlerMaxNs)
+        pstSum->ulHandlerMaxNs = pstStats->ulHandlerMaxNs;
+    pstSum->ulOutQueued     += pstStats->ulOutQueued;
+    pstSum->uiInflight      += pstStats->uiInflight;
+}
+
+void sessionStats(const SESSION_CTX* pstSessionCtx, SESSION_STATS* pstStats)
+{
+    const FRAME_CTX* pstFrameCtx = &pstSessionCtx->stFrameCtx;
+    pstStats->ulRxFrames        = pstFrameCtx->ulRxFrameCnt;
+    pstStats->ulTxFrames        = pstFrameCtx->ulTxFrameCnt;
+    pstStats->ulRxBytes         = pstFrameCtx->ulRxBytes;
+    pstStats->ulTxBytes         = pstFrameCtx->ulTxBytes;
+    pstStats->ulCrcErr          = pstFrameCtx->uiCrcErrCnt;
+    pstStats->ulResync          = pstFrameCtx->uiResyncCnt;
+    pstStats->ulDiscardBytes    = pstFrameCtx->ulDiscardBytes;
+    pstStats->ulHandlerNs       = pstFrameCtx->ulHandlerNs;
+    pstStats->ulHandlerMaxNs    = pstFrameCtx->ulHandlerMaxNs;
+    pstStats->ulOutQueued       = pstSessionCtx->pstBufferEvent ?
+        evbuffer_get_length(bufferevent_get_output(pstSessionCtx->pstBufferEvent)) : 0;
+    pstStats->uiInflight        = pstFrameCtx->pstInflight ? inflightPending(pstFrameCtx->pstInflight) : 0;
+}
+
+int sessionCoreStats(const CORE_CTX* pstCoreCtx, SESSION_STATS* pstStats)
+{
+    int iSessions = 0;
+    *pstStats = pstCoreCtx->stClosedStats;
+    for (const SESSION_CTX* pstSessionCtx = pstCoreCtx->pstSockCtxHead; pstSessionCtx;
+            pstSessionCtx = pstSessionCtx->pstSockCtxNext) {
+        SESSION_STATS stStats;
+        sessionStats(pstSessionCtx, &stStats);
+        sessionStatsAdd(pstStats, &stStats);
+        iSessions++;
+    }
+    return iSessions;
+}
+
+static void sessionStatsPack(STATS_COUNTERS* pstOut, const SESSION_STATS* pstStats)
+{
+    pstOut->ulRxFrames      = htobe64(pstStats->ulRxFrames);
+    pstOut->ulTxFrames      = htobe64(pstStats->ulTxFrames);
+    pstOut->ulRxBytes       = htobe64(pstStats->ulRxBytes);
+    pstOut->ulTxBytes       = htobe64(pstStats->ulTxBytes);
+    pstOut->ulCrcErr        = htobe64(pstStats->ulCrcErr);
+    pstOut->ulResync        = htobe64(pstStats->ulResync);
+    pstOut->ulDiscardBytes  = htobe64(pstStats->ulDiscardBytes);
+    pstOut->ulHandlerNs     = htobe64(pstStats->ulHandlerNs);
+    pstOut->ulHandlerMaxNs  = htobe64(pstStats->ulHandlerMaxNs);
+    pstOut->ulOutQueued     = htobe64(pstStats->ulOutQueued);
+    pstOut->uiInflight      = htonl(pstStats->uiInflight);
+}
+
+/* CMD_STATS: 요청을 받은 세션과 그 코어(워커)의 스냅샷 (응답 직전 시점) */
+static int sessionStatsHandler(FRAME_CTX* pstFrameCtx, const FRAME_VIEW* pstFrameView, void* pvUser)
+{
+    (void)pstFrameView;
+    (void)pvUser;
+    const SESSION_CTX* pstSessionCtx = (const SESSION_CTX*)pstFrameCtx->pvSession;
+    SESSION_STATS stStats;
+    RES_STATS stRes;
+
+    memset(&stRes, 0, sizeof(stRes));
+    stRes.chResult      = 0x01;
+    stRes.uchVersion    = STATS_VERSION;
+    sessionStats(pstSessionCtx, &stStats);
+    sessionStatsPack(&stRes.stSession, &stStats);
+    stRes.uiSessions    = htonl((uint32_t)sessionCoreStats(pstSessionCtx->pstCoreCtx, &stStats));
+    sessionStatsPack(&stRes.stCore, &stStats);
+    if (pstFrameCtx->chReply || pstFrameCtx->uiReplySeq)
+        writeFrameCtx(pstFrameCtx, CMD_STATS, 0, &stRes, sizeof(stRes));
+    return 1;
+}
+
+/* === 유휴 타이머 ===
+ * 수신마다 휠을 건드리지 않도록 읽기 콜백은 ulLastRxTick 만 기록하고,
+ * 만료 시 실제 유휴 시간을 계산해 확인/종료하거나 남은 시간으로 다시 예약한다.
+ */
+static int sessionIdleTimerOn(const CORE_CTX* pstCoreCtx)
+{
+    return pstCoreCtx->uiKeepAliveMs || pstCoreCtx->uiIdleTimeoutMs;
+}
+
+static void sessionSendKeepAlive(SESSION_CTX* pstSessionCtx)
+{
+    REQ_KEEP_ALIVE stReq;
+    stReq.chTmp = 0x01;
+
+    /* 상관 ID가 있는 요청은 상대가 항상 응답한다 */
+    if (pstSessionCtx->stFrameCtx.pstInflight) {
+        inflightRequest(&pstSessionCtx->stFrameCtx, CMD_KEEP_ALIVE, 0, &stReq, sizeof(stReq),
+            pstSessionCtx->pstCoreCtx->uiKeepAliveMs, NULL, NULL);
+    } else {
+        FRAME_IOV stFrame = { CMD_KEEP_ALIVE, 0, &stReq, sizeof(stReq), SESSION_KEEPALIVE_SEQ, 0, 0, 0 };
+        writeFrameIovCtx(&pstSessionCtx->stFrameCtx, &stFrame);
+    }
+    pstSessionCtx->pstCoreCtx->ulKeepAliveCnt++;
+}
+
+static void sessionIdleTimerCb(TIMER_NODE* pstNode, void* pvUser)
+{
+    (void)pstNode;
+    SESSION_CTX* pstSessionCtx = (SESSION_CTX*)pvUser;
+    CORE_CTX* pstCoreCtx = pstSessionCtx->pstCoreCtx;
+    TIMER_WHEEL* pstWheel = &pstCoreCtx->stTimerWheel;
+    uint64_t ulIdleMs = (pstWheel->ulCurTick - pstSessionCtx->ulLastRxTick) * pstWheel->uiTickMs;
+
+    if (pstCoreCtx->uiIdleTimeoutMs && ulIdleMs >= pstCoreCtx->uiIdleTimeoutMs) {
+        pstCoreCtx->ulIdleReapCnt++;
+        sessionCloseAndFree(pstSessionCtx);
+        return;
+    }
+    if (pstCoreCtx->uiKeepAliveMs && !pstSessionCtx->chKeepAliveSent &&
+            ulIdleMs >= pstCoreCtx->uiKeepAliveMs) {
+        sessionSendKeepAlive(pstSessionCtx);
+        pstSessionCtx->chKeepAliveSent = 1;
+    }
+
+    /* 다음 확인 시점: 확인 시각(보냈으면 한 주기 뒤, 그 사이 수신을 반영)과 종료 시각 중 가까운 쪽 */
+    uint64_t ulNextMs = UINT64_MAX;
+    if (pstCoreCtx->uiKeepAliveMs) {
+        ulNextMs = pstSessionCtx->chKeepAliveSent ?
+            pstCoreCtx->uiKeepAliveMs : pstCoreCtx->uiKeepAliveMs - ulIdleMs;
+        if (!pstCoreCtx->uiIdleTimeoutMs)
+            pstSessionCtx->chKeepAliveSent = 0;     /* 종료 없이 확인만: 조용한 동안 주기마다 확인 */
+    }
+    if (pstCoreCtx->uiIdleTimeoutMs && pstCoreCtx->uiIdleTimeoutMs - ulIdleMs < ulNextMs)
+        ulNextMs = pstCoreCtx->uiIdleTimeoutMs - ulIdleMs;
+    timerWheelAdd(pstWheel, &pstSessionCtx->stIdleTimer, (unsigned int)ulNextMs,
+        sessionIdleTimerCb, pstSessionCtx);
+}
+
+static void sessionArmIdleTimer(SESSION_CTX* pstSessionCtx)
+{
+    CORE_CTX* pstCoreCtx = pstSessionCtx->pstCoreCtx;
+    unsigned int uiFirstMs = pstCoreCtx->uiKeepAliveMs;
+    if (!uiFirstMs || (pstCoreCtx->uiIdleTimeoutMs && pstCoreCtx->uiIdleTimeoutMs < uiFirstMs))
+        uiFirstMs = pstCoreCtx->uiIdleTimeoutMs;
+
+    pstSessionCtx->ulLastRxTick     = pstCoreCtx->stTimerWheel.ulCurTick;
+    pstSessionCtx->chKeepAliveSent  = 0;
+    timerWheelAdd(&pstCoreCtx->stTimerWheel, &pstSessionCtx->stIdleTimer, uiFirstMs,
+        sessionIdleTimerCb, pstSessionCtx);
+}
+
+/* === 코어 타이머 휠: 처음 쓰일 때 시작 === */
+static int sessionStartTimers(CORE_CTX* pstCoreCtx)
+{
+    if (pstCoreCtx->stTimerWheel.uiTickMs)
+        return 0;
+    return timerWheelInit(&pstCoreCtx->stTimerWheel, pstCoreCtx->pstEventBase, SESSION_TIMER_TICK_MS);
+}
+
+void sessionStopTimers(CORE_CTX* pstCoreCtx)
+{
+    if (!pstCoreCtx->stTimerWheel.uiTickMs)
+        return;
+    timerWheelFree(&pstCoreCtx->stTimerWheel);
+    memset(&pstCoreCtx->stTimerWheel, 0, sizeof(pstCoreCtx->stTimerWheel));
+    pstCoreCtx->uiKeepAliveMs   = 0;
+    pstCoreCtx->uiIdleTimeoutMs = 0;
+}
+
+int sessionEnableIdleTimer(CORE_CTX* pstCoreCtx, unsigned int uiKeepAliveMs, unsigned int uiIdleTimeoutMs)
+{
+    sessionDisableIdleTimer(pstCoreCtx);
+    if (!uiKeepAliveMs && !uiIdleTimeoutMs)
+        return 0;
+    if (sessionStartTimers(pstCoreCtx) < 0)
+        return -1;//SESSION_ERR_TIMER
+
+    pstCoreCtx->uiKeepAliveMs   = uiKeepAliveMs;
+    pstCoreCtx->uiIdleTimeoutMs = uiIdleTimeoutMs;
+    for (SESSION_CTX* pstSessionCtx = pstCoreCtx->pstSockCtxHead; pstSessionCtx;
+            pstSessionCtx = pstSessionCtx->pstSockCtxNext)
+        sessionArmIdleTimer(pstSessionCtx);
+    return 0;
+}
+
+void sessionDisableIdleTimer(CORE_CTX* pstCoreCtx)
+{
+    if (!sessionIdleTimerOn(pstCoreCtx))
+        return;
+    for (SESSION_CTX* pstSessionCtx = pstCoreCtx->pstSockCtxHead; pstSessionCtx;
+            pstSessionCtx = pstSessionCtx->pstSockCtxNext)
+        timerWheelCancel(&pstCoreCtx->stTimerWheel, &pstSessionCtx->stIdleTimer);
+    pstCoreCtx->uiKeepAliveMs   = 0;
+    pstCoreCtx->uiIdleTimeoutMs = 0;
+}
+
+/* === 읽기 중지/재개 ===
+ * 느린 상대와 프레임 속도 제한이 같은 EV_READ 를 끄므로 사유별로 표시하고,
+ * 모든 사유가 풀렸을 때만 다시 켠다.
+ */
+static void sessionPauseRead(SESSION_CTX* pstSessionCtx, unsigned char uchReason)
+{
+    if (!pstSessionCtx->uchReadPause && pstSessionCtx->pstBufferEvent)
+        bufferevent_disable(pstSessionCtx->pstBufferEvent, EV_READ);
+    pstSessionCtx->uchReadPause |= uchReason;
+}
+
+static void sessionResumeRead(SESSION_CTX* pstSessionCtx, unsigned char uchReason)
+{
+    if (!(pstSessionCtx->uchReadPause & uchReason))
+        return;
+    pstSessionCtx->uchReadPause &= (unsigned char)~uchReason;
+    if (pstSessionCtx->uchReadPause || !pstSessionCtx->pstBufferEvent)
+        return;
+    bufferevent_enable(pstSessionCtx->pstBufferEvent, EV_READ);
+    /* 멈춘 동안 남은 입력은 새 수신 없이 처리 (다른 콜백 안에서 불릴 수 있으므로 지연 호출) */
+    if (evbuffer_get_length(bufferevent_get_input(pstSessionCtx->pstBufferEvent)))
+        bufferevent_trigger(pstSessionCtx->pstBufferEvent, EV_READ, BEV_TRIG_DEFER_CALLBACKS);
+}
+
+/* === 느린 상대 ===
+ * 출력 evbuffer 콜백에서 길이를 보고 상한 도달/하한 복귀를 판단한다.
+ * 콜백은 다른 세션 처리 중(브로드캐스트, 허브 전달)에도 불리므로 여기서 세션을 닫지 않고,
+ * 종료는 유예 타이머에서만 한다.
+ */
+static void sessionSlowTimerCb(TIMER_NODE* pstNode, void* pvUser)
+{
+    (void)pstNode;
+    SESSION_CTX* pstSessionCtx = (SESSION_CTX*)pvUser;
+    pstSessionCtx->pstCoreCtx->ulSlowDisconnectCnt++;
+    sessionCloseAndFree(pstSessionCtx);
+}
+
+static void sessionSlowEnter(SESSION_CTX* pstSessionCtx)
+{
+    CORE_CTX* pstCoreCtx = pstSessionCtx->pstCoreCtx;
+    pstSessionCtx->chSlow = 1;
+    switch (pstCoreCtx->eSlowPolicy) {
+    case SESSION_SLOW_PAUSE_READ:
+        sessionPauseRead(pstSessionCtx, SESSION_PAUSE_SLOW);
+        pstCoreCtx->ulSlowPauseCnt++;
+        break;
+    case SESSION_SLOW_DROP_LOW:
+        pstSessionCtx->ulSlowDropBase   = pstSessionCtx->stFrameCtx.ulTxDropCnt;
+        pstSessionCtx->stFrameCtx.chTxShed = 1;
+        break;
+    case SESSION_SLOW_DISCONNECT:
+        timerWheelAdd(&pstCoreCtx->stTimerWheel, &pstSessionCtx->stSlowTimer, pstCoreCtx->uiSlowGraceMs,
+            sessionSlowTimerCb, pstSessionCtx);
+        break;
+    }
+}
+
+/* iResume: 읽기 재개 (세션 종료 중에는 0) */
+static void sessionSlowLeave(SESSION_SLOW_POLICY ePolicy, SESSION_CTX* pstSessionCtx, int iResume)
+{
+    CORE_CTX* pstCoreCtx = pstSessionCtx->pstCoreCtx;
+    if (!pstSessionCtx->chSlow)
+        return;
+    pstSessionCtx->chSlow = 0;
+    switch (ePolicy) {
+    case SESSION_SLOW_PAUSE_READ:
+        if (iResume)
+            sessionResumeRead(pstSessionCtx, SESSION_PAUSE_SLOW);
+        else
+            pstSessionCtx->uchReadPause &= (unsigned char)~SESSION_PAUSE_SLOW;
+        break;
+    case SESSION_SLOW_DROP_LOW:
+        pstSessionCtx->stFrameCtx.chTxShed = 0;
+        pstCoreCtx->ulSlowDropCnt += pstSessionCtx->stFrameCtx.ulTxDropCnt - pstSessionCtx->ulSlowDropBase;
+        break;
+    case SESSION_SLOW_DISCONNECT:
+        if (pstCoreCtx->stTimerWheel.uiTickMs)
+            timerWheelCancel(&pstCoreCtx->stTimerWheel, &pstSessionCtx->stSlowTimer);
+        break;
+    }
+}
+
+static void sessionOutputCallback(struct evbuffer* pstEvBuffer, const struct evbuffer_cb_info* pstInfo, void* pvData)
+{
+    (void)pstEvBuffer;
+    SESSION_CTX* pstSessionCtx = (SESSION_CTX*)pvData;
+    CORE_CTX* pstCoreCtx = pstSessionCtx->pstCoreCtx;
+    size_t ulLength = pstInfo->orig_size + pstInfo->n_added - pstInfo->n_deleted;
+
+    if (!pstSessionCtx->chSlow) {
+        if (pstInfo->n_added && pstCoreCtx->ulWriteHighMark && ulLength >= pstCoreCtx->ulWriteHighMark)
+            sessionSlowEnter(pstSessionCtx);
+    } else if (pstInfo->n_deleted && ulLength <= pstCoreCtx->ulWriteLowMark) {
+        sessionSlowLeave(pstCoreCtx->eSlowPolicy, pstSessionCtx, 1);
+    }
+}
+
+static void sessionWatchOutput(SESSION_CTX* pstSessionCtx)
+{
+    if (!pstSessionCtx->pstBufferEvent || pstSessionCtx->chEmbedded || pstSessionCtx->chOutputWatched)
+        return;
+    if (evbuffer_add_cb(bufferevent_get_output(pstSessionCtx->pstBufferEvent),
+            sessionOutputCallback, pstSessionCtx))
+        pstSessionCtx->chOutputWatched = 1;
+}
+
+int sessionSetWriteLimit(CORE_CTX* pstCoreCtx, size_t ulHighMark, size_t ulLowMark,
+        SESSION_SLOW_POLICY ePolicy, unsigned int uiGraceMs)
+{
+    if (ulHighMark && (ulLowMark >= ulHighMark || ePolicy > SESSION_SLOW_DISCONNECT))
+        return -1;//SESSION_ERR_INVALID_ARG
+    if (ulHighMark && ePolicy == SESSION_SLOW_DISCONNECT && sessionStartTimers(pstCoreCtx) < 0)
+        return -1;//SESSION_ERR_TIMER
+
+    /* 정책이 바뀌므로 혼잡 중인 세션은 이전 정책으로 먼저 해제 */
+    for (SESSION_CTX* pstSessionCtx = pstCoreCtx->pstSockCtxHead; pstSessionCtx;
+            pstSessionCtx = pstSessionCtx->pstSockCtxNext)
+        sessionSlowLeave(pstCoreCtx->eSlowPolicy, pstSessionCtx, 1);
+
+    pstCoreCtx->ulWriteHighMark = ulHighMark;
+    pstCoreCtx->ulWriteLowMark  = ulLowMark;
+    pstCoreCtx->eSlowPolicy     = ePolicy;
+    pstCoreCtx->uiSlowGraceMs   = uiGraceMs;
+    if (ulHighMark) {
+        for (SESSION_CTX* pstSessionCtx = pstCoreCtx->pstSockCtxHead; pstSessionCtx;
+                pstSessionCtx = pstSessionCtx->pstSockCtxNext)
+            sessionWatchOutput(pstSessionCtx);
+    }
+    return 0;
+}
+
+/* === 속도 제한 ===
+ * 바이트 제한은 libevent token bucket 에 맡기고 (그룹/연결 bucket 이 스스로 읽기/쓰기를 멈춤),
+ * 프레임 제한은 읽기 콜백에서 프레임마다 토큰을 확인한다.
+ * 토큰은 타이머 휠 틱 기준으로 보충하고, 모자라면 읽기를 멈춘 뒤 한 프레임 분량이 차면 재개한다.
+ */
+#define SESSION_FRAME_TOKEN     1000    /* 프레임 하나의 토큰 (ms 단위 보충을 정수로 계산) */
+
+static struct ev_token_bucket_cfg* sessionRateCfgNew(size_t ulReadRate, size_t ulReadBurst,
+        size_t ulWriteRate, size_t ulWriteBurst)
+{
+    if (!ulReadRate)
+        ulReadRate = ulReadBurst = EV_RATE_LIMIT_MAX;
+    if (!ulWriteRate)
+        ulWriteRate = ulWriteBurst = EV_RATE_LIMIT_MAX;
+    if (ulReadBurst < ulReadRate)
+        ulReadBurst = ulReadRate;
+    if (ulWriteBurst < ulWriteRate)
+        ulWriteBurst = ulWriteRate;
+    return ev_token_bucket_cfg_new(ulReadRate, ulReadBurst, ulWriteRate, ulWriteBurst, NULL);
+}
+
+static int sessionRateLimited(const SESSION_CTX* pstSessionCtx)
+{
+    const CORE_CTX* pstCoreCtx = pstSessionCtx->pstCoreCtx;
+    return pstSessionCtx->pstBufferEvent && !pstSessionCtx->chEmbedded &&
+        (pstCoreCtx->pstRateGroup || pstCoreCtx->pstConnRateCfg || pstCoreCtx->stRateLimit.uiFrameRate);
+}
+
+static void sessionApplyRateLimit(SESSION_CTX* pstSessionCtx)
+{
+    CORE_CTX* pstCoreCtx = pstSessionCtx->pstCoreCtx;
+    bufferevent_set_rate_limit(pstSessionCtx->pstBufferEvent, pstCoreCtx->pstConnRateCfg);
+    if (pstCoreCtx->pstRateGroup)
+        bufferevent_add_to_rate_limit_group(pstSessionCtx->pstBufferEvent, pstCoreCtx->pstRateGroup);
+    else
+        bufferevent_remove_from_rate_limit_group(pstSessionCtx->pstBufferEvent);
+    pstSessionCtx->ulFrameTokens        = (uint64_t)pstCoreCtx->stRateLimit.uiFrameBurst * SESSION_FRAME_TOKEN;
+    pstSessionCtx->ulFrameRefillTick    = pstCoreCtx->stTimerWheel.ulCurTick;
+}
+
+/* 세션 해제 전: bufferevent 해제(finalize)는 지연되므로 그룹 탈퇴는 바로 한다 */
+static void sessionDetachRateLimit(SESSION_CTX* pstSessionCtx)
+{
+    if (!sessionRateLimited(pstSessionCtx))
+        return;
+    if (pstSessionCtx->pstCoreCtx->pstRateGroup)
+        bufferevent_remove_from_rate_limit_group(pstSessionCtx->pstBufferEvent);
+    if (pstSessionCtx->pstCoreCtx->pstConnRateCfg)
+        bufferevent_set_rate_limit(pstSessionCtx->pstBufferEvent, NULL);
+}
+
+static void sessionRateTimerCb(TIMER_NODE* pstNode, void* pvUser)
+{
+    (void)pstNode;
+    sessionResumeRead((SESSION_CTX*)pvUser, SESSION_PAUSE_RATE);
+}
+
+/* return: 1 프레임 처리 가능, 0 토큰 부족 (읽기 중지, 보충 후 재개 예약) */
+static int sessionFrameAdmit(SESSION_CTX* pstSessionCtx)
+{
+    CORE_CTX* pstCoreCtx = pstSessionCtx->pstCoreCtx;
+    uint64_t ulRate = pstCoreCtx->stRateLimit.uiFrameRate;
+    if (!ulRate || pstSessionCtx->chEmbedded)
+        return 1;
+
+    /* 초당 ulRate 프레임 = ms 당 ulRate 토큰 */
+    uint64_t ulNow = pstCoreCtx->stTimerWheel.ulCurTick;
+    uint64_t ulMax = (uint64_t)pstCoreCtx->stRateLimit.uiFrameBurst * SESSION_FRAME_TOKEN;
+    pstSessionCtx->ulFrameTokens += (ulNow - pstSessionCtx->ulFrameRefillTick) *
+        pstCoreCtx->stTimerWheel.uiTickMs * ulRate;
+    if (pstSessionCtx->ulFrameTokens > ulMax)
+        pstSessionCtx->ulFrameTokens = ulMax;
+    pstSessionCtx->ulFrameRefillTick = ulNow;
+    if (pstSessionCtx->ulFrameTokens >= SESSION_FRAME_TOKEN)
+        return 1;
+
+    uint64_t ulWaitMs = (SESSION_FRAME_TOKEN - pstSessionCtx->ulFrameTokens + ulRate - 1) / ulRate;
+    sessionPauseRead(pstSessionCtx, SESSION_PAUSE_RATE);
+    pstCoreCtx->ulRateLimitedCnt++;
+    timerWheelAdd(&pstCoreCtx->stTimerWheel, &pstSessionCtx->stRateTimer, (unsigned int)ulWaitMs,
+        sessionRateTimerCb, pstSessionCtx);
+    return 0;
+}
+
+/* 세션이 모두 해제된 뒤 호출 (그룹 구성원이 남아 있으면 안 됨) */
+static void sessionFreeRateLimit(CORE_CTX* pstCoreCtx)
+{
+    if (pstCoreCtx->pstRateGroup)
+        bufferevent_rate_limit_group_free(pstCoreCtx->pstRateGroup);
+    if (pstCoreCtx->pstConnRateCfg)
+        ev_token_bucket_cfg_free(pstCoreCtx->pstConnRateCfg);
+    pstCoreCtx->pstRateGroup    = NULL;
+    pstCoreCtx->pstConnRateCfg  = NULL;
+    memset(&pstCoreCtx->stRateLimit, 0, sizeof(pstCoreCtx->stRateLimit));
+}
+
+int sessionSetRateLimit(CORE_CTX* pstCoreCtx, const SESSION_RATE_LIMIT* pstLimit)
+{
+    SESSION_RATE_LIMIT stLimit;
+    struct bufferevent_rate_limit_group* pstGroup = NULL;
+    struct ev_token_bucket_cfg* pstConnCfg = NULL;
+
+    memset(&stLimit, 0, sizeof(stLimit));
+    if (pstLimit)
+        stLimit = *pstLimit;
+    if (!stLimit.uiFrameBurst)
+        stLimit.uiFrameBurst = stLimit.uiFrameRate;
+    if (stLimit.uiFrameRate && sessionStartTimers(pstCoreCtx) < 0)
+        return -1;//SESSION_ERR_TIMER
+
+    if (stLimit.ulReadRate || stLimit.ulWriteRate) {
+        struct ev_token_bucket_cfg* pstCfg = sessionRateCfgNew(stLimit.ulReadRate, stLimit.ulReadBurst,
+            stLimit.ulWriteRate, stLimit.ulWriteBurst);
+        if (pstCfg) {
+            pstGroup = bufferevent_rate_limit_group_new(pstCoreCtx->pstEventBase, pstCfg);
+            ev_token_bucket_cfg_free(pstCfg);       /* 그룹은 설정을 복사해 둔다 */
+        }
+        if (!pstGroup)
+            return -1;//SESSION_ERR_RATE_LIMIT
+    }
+    if (stLimit.ulConnReadRate || stLimit.ulConnWriteRate) {
+        pstConnCfg = sessionRateCfgNew(stLimit.ulConnReadRate, 0, stLimit.ulConnWriteRate, 0);
+        if (!pstConnCfg) {
+            if (pstGroup)
+                bufferevent_rate_limit_group_free(pstGroup);
+            return -1;//SESSION_ERR_RATE_LIMIT
+        }
+    }
+
+    /* 기존 세션을 새 그룹/설정으로 옮긴 뒤 이전 것을 해제 */
+    struct bufferevent_rate_limit_group* pstOldGroup = pstCoreCtx->pstRateGroup;
+    struct ev_token_bucket_cfg* pstOldCfg = pstCoreCtx->pstConnRateCfg;
+    pstCoreCtx->stRateLimit     = stLimit;
+    pstCoreCtx->pstRateGroup    = pstGroup;
+    pstCoreCtx->pstConnRateCfg  = pstConnCfg;
+    for (SESSION_CTX* pstSessionCtx = pstCoreCtx->pstSockCtxHead; pstSessionCtx;
+            pstSessionCtx = pstSessionCtx->pstSockCtxNext) {
+        if (pstSessionCtx->uchReadPause & SESSION_PAUSE_RATE) {
+            timerWheelCancel(&pstCoreCtx->stTimerWheel, &pstSessionCtx->stRateTimer);
+            sessionResumeRead(pstSessionCtx, SESSION_PAUSE_RATE);
+        }
+        if (pstSessionCtx->pstBufferEvent && !pstSessionCtx->chEmbedded)
+            sessionApplyRateLimit(pstSessionCtx);
+    }
+    if (pstOldGroup)
+        bufferevent_rate_limit_group_free(pstOldGroup);
+    if (pstOldCfg)
+        ev_token_bucket_cfg_free(pstOldCfg);
+    return 0;
+}
 
 void sessionAdd(SESSION_CTX *pstSessionCtx, CORE_CTX *pstCoreCtx)
 {
     if (!pstSessionCtx || !pstSessionCtx->pstCoreCtx)
         return;
-    pstSessionCtx->pstSockCtxNext               = pstSessionCtx->pstCoreCtx->pstSockCtxHead;
-    pstSessionCtx->pstCoreCtx->pstSockCtxHead   = pstSessionCtx;
-    pstSessionCtx->pstCoreCtx->iClientCount++;
+
+    pstCoreCtx = pstSessionCtx->pstCoreCtx;     /* 세션이 속한 코어 기준 */
+    pstSessionCtx->pstSockCtxPrev   = NULL;
+    pstSessionCtx->pstSockCtxNext   = pstCoreCtx->pstSockCtxHead;
+    if (pstCoreCtx->pstSockCtxHead)
+        pstCoreCtx->pstSockCtxHead->pstSockCtxPrev = pstSessionCtx;
+    pstCoreCtx->pstSockCtxHead      = pstSessionCtx;
+    __atomic_add_fetch(&pstCoreCtx->iClientCount, 1, __ATOMIC_RELAXED);    /* 워커 분배 시 다른 스레드가 읽음 */
+    if (sessionIdleTimerOn(pstCoreCtx))
+        sessionArmIdleTimer(pstSessionCtx);
 }
 
 void sessionRemove(SESSION_CTX* pstSessionCtx)
@@ -19,15 +654,64 @@ void sessionRemove(SESSION_CTX* pstSessionCtx)
         return;
 
     CORE_CTX* pstCoreCtx = pstSessionCtx->pstCoreCtx;
-    SESSION_CTX** ppSessionCtx = &pstCoreCtx->pstSockCtxHead;
-    while (*ppSessionCtx) {
-        if (*ppSessionCtx == pstSessionCtx) {
-            *ppSessionCtx = pstSessionCtx->pstSockCtxNext;
-            pstCoreCtx->iClientCount--;
-            return;
+    sessionUnbindPeer(pstSessionCtx);
+    sessionSlowLeave(pstCoreCtx->eSlowPolicy, pstSessionCtx, 0);
+    sessionDetachRateLimit(pstSessionCtx);
+    if (pstCoreCtx->stTimerWheel.uiTickMs) {
+        timerWheelCancel(&pstCoreCtx->stTimerWheel, &pstSessionCtx->stIdleTimer);
+        timerWheelCancel(&pstCoreCtx->stTimerWheel, &pstSessionCtx->stRateTimer);
+    }
+
+    /* 리스트에 없는 세션 (클라이언트 세션, 이미 제거됨) */
+    if (!pstSessionCtx->pstSockCtxPrev && pstCoreCtx->pstSockCtxHead != pstSessionCtx)
+        return;
+
+    /* 종료된 세션 카운터는 코어 누계로 (대기 중 값은 더 이상 의미 없음) */
+    SESSION_STATS stStats;
+    sessionStats(pstSessionCtx, &stStats);
+    stStats.ulOutQueued = 0;
+    stStats.uiInflight  = 0;
+    sessionStatsAdd(&pstCoreCtx->stClosedStats, &stStats);
+
+    if (pstSessionCtx->pstSockCtxPrev)
+        pstSessionCtx->pstSockCtxPrev->pstSockCtxNext = pstSessionCtx->pstSockCtxNext;
+    else
+        pstCoreCtx->pstSockCtxHead = pstSessionCtx->pstSockCtxNext;
+    if (pstSessionCtx->pstSockCtxNext)
+        pstSessionCtx->pstSockCtxNext->pstSockCtxPrev = pstSessionCtx->pstSockCtxPrev;
+
+    pstSessionCtx->pstSockCtxNext = NULL;
+    pstSessionCtx->pstSockCtxPrev = NULL;
+    __atomic_sub_fetch(&pstCoreCtx->iClientCount, 1, __ATOMIC_RELAXED);
+}
+
+/* === 레지스트리 초기화 (서버 종료 시 세션을 일괄 해제한 뒤 호출) === */
+void sessionClearRegistry(CORE_CTX* pstCoreCtx)
+{
+    pstCoreCtx->pstSockCtxHead = NULL;
+    pstCoreCtx->iClientCount = 0;
+    memset(pstCoreCtx->apstPeerIndex, 0, sizeof(pstCoreCtx->apstPeerIndex));
+}
+
+/* === 코어의 모든 세션 종료 (서버 종료 시, 코어 타이머/속도 제한도 해제) === */
+void sessionCloseAll(CORE_CTX* pstCoreCtx)
+{
+    sessionStopTimers(pstCoreCtx);          /* 세션 해제 전에 휠에서 분리 */
+    SESSION_CTX* pstSessionCtx = pstCoreCtx->pstSockCtxHead;
+    while (pstSessionCtx) {
+        SESSION_CTX* pstNextSessionCtx = pstSessionCtx->pstSockCtxNext;
+        if (pstSessionCtx->pstBufferEvent) {
+            sessionDetachRateLimit(pstSessionCtx);
+            bufferevent_disable(pstSessionCtx->pstBufferEvent, EV_READ | EV_WRITE);
+            bufferevent_free(pstSessionCtx->pstBufferEvent); // fd 자동 close
+            pstSessionCtx->pstBufferEvent = NULL;
         }
-        ppSessionCtx = &(*ppSessionCtx)->pstSockCtxNext;
+        sessionFreeState(pstSessionCtx);
+        sessionRelease(pstSessionCtx);
+        pstSessionCtx = pstNextSessionCtx;
     }
+    sessionClearRegistry(pstCoreCtx);
+    sessionFreeRateLimit(pstCoreCtx);
 }
 
 void sessionInitCore(CORE_CTX* pstCoreCtx, struct event_base* pstEventBase)
@@ -38,6 +722,82 @@ void sessionInitCore(CORE_CTX* pstCoreCtx, struct event_base* pstEventBase)
     pstCoreCtx->iClientSock = -1;
     pstCoreCtx->pstSignalEvent = NULL;
     pstCoreCtx->pstSockCtxHead = NULL;
+    memset(pstCoreCtx->apstPeerIndex, 0, sizeof(pstCoreCtx->apstPeerIndex));
+    pstCoreCtx->uiFrameErrorBudget = FRAME_ERROR_BUDGET_DEFAULT;
+    pstCoreCtx->uchFrameCaps = FRAME_CAP_COMPRESS;
+    memset(&pstCoreCtx->stTimerWheel, 0, sizeof(pstCoreCtx->stTimerWheel));
+    pstCoreCtx->uiKeepAliveMs = 0;
+    pstCoreCtx->uiIdleTimeoutMs = 0;
+    pstCoreCtx->ulKeepAliveCnt = 0;
+    pstCoreCtx->ulIdleReapCnt = 0;
+    pstCoreCtx->chHubMode = 0;
+    pstCoreCtx->uchHubId = 0;
+    pstCoreCtx->pstHubNext = NULL;
+    pstCoreCtx->ulWriteHighMark = 0;
+    pstCoreCtx->ulWriteLowMark = 0;
+    pstCoreCtx->eSlowPolicy = SESSION_SLOW_PAUSE_READ;
+    pstCoreCtx->uiSlowGraceMs = 0;
+    pstCoreCtx->ulSlowPauseCnt = 0;
+    pstCoreCtx->ulSlowDropCnt = 0;
+    pstCoreCtx->ulSlowDisconnectCnt = 0;
+    memset(&pstCoreCtx->stRateLimit, 0, sizeof(pstCoreCtx->stRateLimit));
+    pstCoreCtx->pstRateGroup = NULL;
+    pstCoreCtx->pstConnRateCfg = NULL;
+    pstCoreCtx->ulRateLimitedCnt = 0;
+    memset(&pstCoreCtx->stClosedStats, 0, sizeof(pstCoreCtx->stClosedStats));
+    slabPoolInit(&pstCoreCtx->stSessionPool, sizeof(SESSION_CTX), SLAB_OBJS_DEFAULT);
+    cmdTableInit(&pstCoreCtx->stCmdTable);
+    frameRegisterDefaultCmds(&pstCoreCtx->stCmdTable);
+    cmdRegister(&pstCoreCtx->stCmdTable, CMD_STATS, CMD_ANY_SIZE, sessionStatsHandler, NULL);
+    pstCoreCtx->pstCmdTable = &pstCoreCtx->stCmdTable;
+}
+
+void sessionFreeCore(CORE_CTX* pstCoreCtx)
+{
+    /* 허브 원형 리스트에서 분리 */
+    if (pstCoreCtx->pstHubNext) {
+        CORE_CTX* pstPrev = pstCoreCtx->pstHubNext;
+        while (pstPrev->pstHubNext != pstCoreCtx)
+            pstPrev = pstPrev->pstHubNext;
+        pstPrev->pstHubNext = (pstCoreCtx->pstHubNext == pstPrev) ? NULL : pstCoreCtx->pstHubNext;
+        pstCoreCtx->pstHubNext = NULL;
+    }
+    pstCoreCtx->ulWriteHighMark = 0;
+    pstCoreCtx->ulWriteLowMark = 0;
+    pstCoreCtx->eSlowPolicy = SESSION_SLOW_PAUSE_READ;
+    pstCoreCtx->uiSlowGraceMs = 0;
+    pstCoreCtx->ulSlowPauseCnt = 0;
+    pstCoreCtx->ulSlowDropCnt = 0;
+    pstCoreCtx->ulSlowDisconnectCnt = 0;
+    cmdTableFree(&pstCoreCtx->stCmdTable);
+    slabPoolDestroy(&pstCoreCtx->stSessionPool);
+}
+
+/* === 세션 객체 할당/반납 (코어 풀, 0으로 초기화된 객체) === */
+SESSION_CTX* sessionAlloc(CORE_CTX* pstCoreCtx)
+{
+    SESSION_CTX* pstSessionCtx = slabPoolAlloc(&pstCoreCtx->stSessionPool);
+    if (pstSessionCtx)
+        pstSessionCtx->pstCoreCtx = pstCoreCtx;
+    return pstSessionCtx;
+}
+
+void sessionRelease(SESSION_CTX* pstSessionCtx)
+{
+    slabPoolFree(&pstSessionCtx->pstCoreCtx->stSessionPool, pstSessionCtx);
+}
+
+/* === 접속 폭주 대비 세션 객체 미리 확보 === */
+int sessionPoolReserve(CORE_CTX* pstCoreCtx, unsigned int uiPrealloc)
+{
+    return slabPoolReserve(&pstCoreCtx->stSessionPool, uiPrealloc);
+}
+
+/* === 세션 내부 상태 해제 (대기 요청 취소, 재조립 버퍼) === */
+void sessionFreeState(SESSION_CTX* pstSessionCtx)
+{
+    inflightFree(&pstSessionCtx->stInflight);
+    frameCtxFree(&pstSessionCtx->stFrameCtx);
 }
 
 void sessionCloseAndFree(void* pvData)
@@ -47,28 +807,89 @@ void sessionCloseAndFree(void* pvData)
         return;
 
     sessionRemove(pSessionCtx);
+    sessionFreeState(pSessionCtx);
+
+    /* 클라이언트 컨텍스트 소유 세션: 소켓은 각 Stop 함수에서 해제 */
+    if (pSessionCtx->chEmbedded) {
+        if (pSessionCtx->pstBufferEvent)
+            bufferevent_disable(pSessionCtx->pstBufferEvent, EV_READ | EV_WRITE);
+        return;
+    }
+
     if (pSessionCtx->pstBufferEvent) 
         bufferevent_free(pSessionCtx->pstBufferEvent);
 
-    free(pSessionCtx);
+    sessionRelease(pSessionCtx);
+}
+
+/* === 요청/응답 상관 테이블 사용 === */
+int sessionEnableInflight(SESSION_CTX* pstSessionCtx, unsigned int uiCapacity)
+{
+    if (inflightInit(&pstSessionCtx->stInflight, pstSessionCtx->pstCoreCtx->pstEventBase, uiCapacity) < 0)
+        return -1;
+    pstSessionCtx->stFrameCtx.pstInflight = &pstSessionCtx->stInflight;
+    return 0;
+}
+
+/* === 세션 프레임 컨텍스트 구성 (코어 설정 적용, 상대 ID 등록 연결) === */
+void sessionSetupFrame(SESSION_CTX* pstSessionCtx)
+{
+    CORE_CTX* pstCoreCtx = pstSessionCtx->pstCoreCtx;
+    frameCtxInit(&pstSessionCtx->stFrameCtx, pstSessionCtx->pstBufferEvent,
+        pstCoreCtx->pstCmdTable, pstSessionCtx);
+    pstSessionCtx->stFrameCtx.uiErrorBudget = pstCoreCtx->uiFrameErrorBudget;
+    pstSessionCtx->stFrameCtx.uchLocalCaps  = pstCoreCtx->uchFrameCaps;
+    pstSessionCtx->stFrameCtx.pfnPeerId     = sessionPeerIdCallback;
+    if (pstCoreCtx->chHubMode)
+        pstSessionCtx->stFrameCtx.pfnRoute  = sessionRouteCallback;
+    if (pstCoreCtx->ulWriteHighMark)
+        sessionWatchOutput(pstSessionCtx);
+    if (sessionRateLimited(pstSessionCtx))
+        sessionApplyRateLimit(pstSessionCtx);
+}
+
+/* === 클라이언트 연결을 세션으로 구성 ===
+ * 클라이언트도 서버와 같은 읽기 콜백/명령 테이블로 응답을 처리하고,
+ * inflightRequest()로 여러 요청을 동시에 보낼 수 있다.
+ */
+int sessionAttachClient(SESSION_CTX* pstSessionCtx, CORE_CTX* pstCoreCtx,
+        struct bufferevent* pstBufferEvent, unsigned char uchMyId, unsigned char uchDstId)
+{
+    memset(pstSessionCtx, 0, sizeof(*pstSessionCtx));
+    pstSessionCtx->pstCoreCtx       = pstCoreCtx;
+    pstSessionCtx->pstBufferEvent   = pstBufferEvent;
+    pstSessionCtx->chEmbedded       = 1;
+
+    sessionSetupFrame(pstSessionCtx);
+    pstSessionCtx->stFrameCtx.stMsgId.uchSrcId  = uchMyId;
+    pstSessionCtx->stFrameCtx.stMsgId.uchDstId  = uchDstId;
+    bufferevent_setcb(pstBufferEvent, sessionReadCallback, NULL, sessionEventCallback, pstSessionCtx);
+    return sessionEnableInflight(pstSessionCtx, INFLIGHT_DEFAULT_CAPACITY);
 }
 
 void sessionReadCallback(struct bufferevent* pstBufferEvent, void* pvData)
 {
     SESSION_CTX* pSessionCtx = (SESSION_CTX*)pvData;
     struct evbuffer* pstEventBuffer = bufferevent_get_input(pstBufferEvent);
-    MSG_ID id; 
-    id.uchSrcId = pSessionCtx->uchSrcId; 
-    id.uchDstId = pSessionCtx->uchDstId;
+
+    /* 유휴 타이머 갱신: 휠은 만료 시에만 다시 예약 */
+    pSessionCtx->ulLastRxTick = pSessionCtx->pstCoreCtx->stTimerWheel.ulCurTick;
+    pSessionCtx->chKeepAliveSent = 0;
 
     for (;;) {
-        int r = responseFrame(pstEventBuffer, pstBufferEvent, &id, 
-            pSessionCtx->uchIsResponse);
-        if (r == 1) 
-            break;     /* 더 읽을 게 없음 */
+        /* 프레임 토큰이 없으면 남은 입력은 두고 읽기 중지 (재개 시 이어서 처리) */
+        if (evbuffer_get_length(pstEventBuffer) && !sessionFrameAdmit(pSessionCtx))
+            return;
+
+        int r = responseFrame(pstEventBuffer, &pSessionCtx->stFrameCtx);
+        if (r == 1) {
+            if (pSessionCtx->ulFrameTokens >= SESSION_FRAME_TOKEN)
+                pSessionCtx->ulFrameTokens -= SESSION_FRAME_TOKEN;
+            continue;  /* 한 프레임 처리 완료, 남은 프레임 계속 처리 */
+        }
 
         if (r == 0) 
-            break;     /* 한 프레임 처리 완료 */
+            break;     /* 더 읽을 게 없음 */
             
         if (r < 0) {           /* 에러: 연결 종료 */
             sessionCloseAndFree(pvData);
@@ -5,6 +5,56 @@
 #include <event2/event.h>
 #include <event2/buffer.h>
 #include <stdint.h>
+#include "../core/cmdTable.h"
+#include "../core/inflight.h"
+#include "../core/slabPool.h"
+#include "../core/timerWheel.h"
+
+#define SESSION_PEER_BUCKETS    256     /* MSG_ID 가 1바이트이므로 ID 하나당 버킷 하나 */
+#define SESSION_TIMER_TICK_MS   100     /* 유휴 타이머 휠 해상도 */
+#define SESSION_KEEPALIVE_SEQ   0xFFFFFFFFu /* 유휴 확인 요청의 상관 ID (상대가 항상 응답하도록) */
+#define SESSION_BROADCAST_COPY_MAX  128 /* 이 크기 이하 브로드캐스트 프레임은 참조 대신 복사 */
+
+/* 출력 버퍼가 상한(ulWriteHighMark)에 닿은 세션 처리 (하한 이하로 빠지면 해제) */
+typedef enum {
+    SESSION_SLOW_PAUSE_READ = 0,    /* 상대 읽기 중지 (요청이 더 쌓이지 않게) */
+    SESSION_SLOW_DROP_LOW,          /* 저우선(상관 ID 없는 단발) 프레임 폐기 */
+    SESSION_SLOW_DISCONNECT,        /* 유예 시간 안에 하한까지 빠지지 않으면 종료 */
+} SESSION_SLOW_POLICY;
+
+/* 읽기 중지 사유 (모든 사유가 풀려야 EV_READ 재개) */
+#define SESSION_PAUSE_SLOW      0x01    /* 느린 상대 (SESSION_SLOW_PAUSE_READ) */
+#define SESSION_PAUSE_RATE      0x02    /* 수신 프레임 속도 초과 */
+
+/* 코어 단위 속도 제한 (0 인 항목은 제한 없음, 버스트 0 은 초당 값과 같게)
+ *  - 바이트 제한: libevent rate-limit group(코어 전체 합계) / 연결별 token bucket
+ *  - 프레임 제한: 연결별 token bucket, 초과하면 토큰이 찰 때까지 읽기 중지
+ */
+typedef struct {
+    size_t          ulReadRate;         /* 코어 전체 수신 바이트/초 */
+    size_t          ulReadBurst;
+    size_t          ulWriteRate;        /* 코어 전체 송신 바이트/초 */
+    size_t          ulWriteBurst;
+    size_t          ulConnReadRate;     /* 연결별 수신 바이트/초 */
+    size_t          ulConnWriteRate;    /* 연결별 송신 바이트/초 */
+    unsigned int    uiFrameRate;        /* 연결별 수신 프레임/초 */
+    unsigned int    uiFrameBurst;
+} SESSION_RATE_LIMIT;
+
+/* 연결/코어 카운터 (코어 스레드에서만 갱신하므로 atomic 없음) */
+typedef struct {
+    unsigned long   ulRxFrames;
+    unsigned long   ulTxFrames;
+    unsigned long   ulRxBytes;
+    unsigned long   ulTxBytes;
+    unsigned long   ulCrcErr;
+    unsigned long   ulResync;
+    unsigned long   ulDiscardBytes;
+    unsigned long   ulHandlerNs;
+    unsigned long   ulHandlerMaxNs;
+    size_t          ulOutQueued;        /* 출력 버퍼 대기 바이트 (스냅샷 시점) */
+    unsigned int    uiInflight;         /* 응답 대기 요청 수 (스냅샷 시점) */
+} SESSION_STATS;
 
 /* 연결별 컨텍스트 */
 typedef struct session_ctx  SESSION_CTX;
@@ -16,7 +66,33 @@ struct core_ctx {
     struct event        *pstSignalEvent;
     int                 iClientCount;
     int                 iClientSock;
-    SESSION_CTX         *pstSockCtxHead;
+    SESSION_CTX         *pstSockCtxHead;    /* 전체 세션 (이중 연결 리스트) */
+    SESSION_CTX         *apstPeerIndex[SESSION_PEER_BUCKETS];  /* 상대 ID → 세션 (최근 등록 우선) */
+    CMD_TABLE           stCmdTable;         /* 명령 디스패치 테이블 */
+    const CMD_TABLE     *pstCmdTable;       /* 세션이 사용할 테이블 (워커는 리스너 코어의 테이블 공유) */
+    unsigned int        uiFrameErrorBudget; /* 세션별 연속 파싱 오류 허용 횟수 (0: 첫 오류에 종료) */
+    unsigned char       uchFrameCaps;       /* 세션이 허용하는 기능 (FRAME_CAP_*, 0: 협상 거절) */
+    SLAB_POOL           stSessionPool;      /* SESSION_CTX 할당 풀 (accept 마다 malloc 하지 않음) */
+    TIMER_WHEEL         stTimerWheel;       /* 세션 유휴 타이머 (sessionEnableIdleTimer 후 사용) */
+    unsigned int        uiKeepAliveMs;      /* 이 시간 수신이 없으면 KEEP_ALIVE 확인 (0: 안 보냄) */
+    unsigned int        uiIdleTimeoutMs;    /* 이 시간 수신이 없으면 세션 종료 (0: 종료 안 함) */
+    unsigned long       ulKeepAliveCnt;     /* 보낸 유휴 확인 수 */
+    unsigned long       ulIdleReapCnt;      /* 유휴로 종료한 세션 수 */
+    char                chHubMode;          /* 다른 ID 로 가는 프레임을 등록된 세션으로 전달 */
+    unsigned char       uchHubId;           /* 허브 자신의 ID (이 ID 로 온 프레임은 직접 처리) */
+    CORE_CTX            *pstHubNext;        /* 같은 허브를 이루는 코어 (원형, 같은 스레드) */
+    size_t              ulWriteHighMark;    /* 세션 출력 버퍼 상한 (0: 제한 없음) */
+    size_t              ulWriteLowMark;
+    SESSION_SLOW_POLICY eSlowPolicy;
+    unsigned int        uiSlowGraceMs;      /* SESSION_SLOW_DISCONNECT 유예 시간 */
+    unsigned long       ulSlowPauseCnt;     /* 읽기 중지 횟수 */
+    unsigned long       ulSlowDropCnt;      /* 버린 저우선 프레임 수 (혼잡 해소/세션 종료 시 합산) */
+    unsigned long       ulSlowDisconnectCnt;/* 느린 상대 종료 수 */
+    SESSION_RATE_LIMIT  stRateLimit;        /* 적용 중인 속도 제한 */
+    struct bufferevent_rate_limit_group *pstRateGroup;  /* 코어 전체 바이트 제한 (NULL: 없음) */
+    struct ev_token_bucket_cfg *pstConnRateCfg;         /* 연결별 바이트 제한 (세션이 참조) */
+    unsigned long       ulRateLimitedCnt;   /* 프레임 속도 초과로 읽기를 멈춘 횟수 */
+    SESSION_STATS       stClosedStats;      /* 레지스트리에서 빠진 세션의 카운터 누계 */
 };
 
 struct session_ctx {
@@ -24,19 +100,94 @@ struct session_ctx {
     CORE_CTX            *pstCoreCtx;
     unsigned short      unCmd;
     int                 iDataLength;
-    unsigned char       uchSrcId;
-    unsigned char       uchDstId;
-    unsigned char       uchIsResponse;    
+    FRAME_CTX           stFrameCtx;         /* 응답 ID/응답 여부/디스패치 테이블 */
+    INFLIGHT_TABLE      stInflight;         /* 응답 대기 요청 (sessionEnableInflight 후 사용) */
+    char                chEmbedded;         /* 클라이언트 컨텍스트에 포함된 세션 (free 하지 않음) */
     SESSION_CTX         *pstSockCtxNext;
+    SESSION_CTX         *pstSockCtxPrev;
+    SESSION_CTX         *pstPeerNext;       /* 같은 상대 ID 버킷 */
+    SESSION_CTX         *pstPeerPrev;
+    unsigned char       uchPeerId;
+    char                chPeerKnown;        /* CMD_REQ_ID 로 상대 ID를 알게 됨 */
+    TIMER_NODE          stIdleTimer;
+    uint64_t            ulLastRxTick;       /* 마지막 수신 시각 (타이머 휠 틱) */
+    char                chKeepAliveSent;    /* 마지막 수신 이후 유휴 확인을 보냄 */
+    char                chSlow;             /* 출력 버퍼 상한 도달 (하한까지 빠지면 해제) */
+    char                chOutputWatched;    /* 출력 버퍼 콜백 등록됨 */
+    TIMER_NODE          stSlowTimer;        /* 느린 상대 종료 유예 */
+    unsigned long       ulSlowDropBase;     /* 혼잡 시작 시점의 stFrameCtx.ulTxDropCnt */
+    unsigned char       uchReadPause;       /* SESSION_PAUSE_* */
+    uint64_t            ulFrameTokens;      /* 수신 프레임 토큰 (1/1000 프레임 단위) */
+    uint64_t            ulFrameRefillTick;  /* 마지막 토큰 보충 틱 */
+    TIMER_NODE          stRateTimer;        /* 프레임 토큰 보충 후 읽기 재개 */
 };
 
+/* 브로드캐스트 대상 선택 (1: 보냄, 0: 건너뜀) */
+typedef int (*SESSION_FILTER)(const SESSION_CTX* pstSessionCtx, const FRAME_IOV* pstFrame, void* pvUser);
+
 void sessionInitCore(CORE_CTX* pstCoreCtx, struct event_base* pstEventBase);
+void sessionFreeCore(CORE_CTX* pstCoreCtx);
 void sessionReadCallback(struct bufferevent* pstBufferEvent, void* pvData);
 void sessionEventCallback(struct bufferevent* pstBufferEvent, short nEvents, void* pvData);
 void sessionCloseAndFree(void* pvData);
+void sessionFreeState(SESSION_CTX* pstSessionCtx);
+SESSION_CTX* sessionAlloc(CORE_CTX* pstCoreCtx);
+void sessionRelease(SESSION_CTX* pstSessionCtx);
+int  sessionPoolReserve(CORE_CTX* pstCoreCtx, unsigned int uiPrealloc);
+int  sessionEnableInflight(SESSION_CTX* pstSessionCtx, unsigned int uiCapacity);
+void sessionSetupFrame(SESSION_CTX* pstSessionCtx);
+int  sessionAttachClient(SESSION_CTX* pstSessionCtx, CORE_CTX* pstCoreCtx,
+        struct bufferevent* pstBufferEvent, unsigned char uchMyId, unsigned char uchDstId);
 
-/* 연결 리스트 관리 */
+/* 세션 레지스트리 (추가/삭제 O(1), 상대 ID 조회 O(1)) */
 void sessionAdd(SESSION_CTX *pstSessionCtx, CORE_CTX *pstCoreCtx);
 void sessionRemove(SESSION_CTX *pstSessionCtx);
+void sessionClearRegistry(CORE_CTX* pstCoreCtx);
+void sessionCloseAll(CORE_CTX* pstCoreCtx);
+void sessionBindPeer(SESSION_CTX* pstSessionCtx, unsigned char uchPeerId);
+SESSION_CTX* sessionFindByPeer(const CORE_CTX* pstCoreCtx, unsigned char uchPeerId);
+
+/* 코어의 모든 세션(pfnFilter 가 고른 세션)에 같은 프레임 송신
+ *  - 체크섬 모드별로 한 번만 인코딩하고 각 출력 버퍼에는 참조로 붙인다
+ *  - 압축하지 않고 보낸다 (압축 협상 여부와 관계없이 모든 상대가 받을 수 있음)
+ *  - 코어(워커) 스레드에서 호출, return: 보낸 세션 수, -1 인코딩 실패
+ */
+int  sessionBroadcast(CORE_CTX* pstCoreCtx, const MSG_ID* pstMsgId, const FRAME_IOV* pstFrame,
+        SESSION_FILTER pfnFilter, void* pvUser);
+/* pvUser: const unsigned char* 상대 ID */
+int  sessionFilterPeer(const SESSION_CTX* pstSessionCtx, const FRAME_IOV* pstFrame, void* pvUser);
+
+/* 허브 모드 (목적지 ID 라우팅)
+ *  - 수신 프레임의 uchDstId 가 허브 ID 가 아니고 그 ID 로 등록된(CMD_REQ_ID) 세션이 있으면
+ *    페이로드를 해석하지 않고 그 세션으로 옮긴다. 등록된 세션이 없으면 기존처럼 직접 처리
+ *  - pstJoin: 이미 허브인 다른 코어(TCP/UDS 등)와 ID 공간을 합친다.
+ *    같은 event_base(스레드)의 코어끼리만 가능. 워커 사이 전달은 하지 않는다
+ */
+int  sessionEnableHub(CORE_CTX* pstCoreCtx, unsigned char uchHubId, CORE_CTX* pstJoin);
+SESSION_CTX* sessionRouteLookup(const CORE_CTX* pstCoreCtx, unsigned char uchDstId);
+
+/* 유휴 세션 관리 (sessionAdd 로 등록된 세션 대상)
+ *  - 수신 시에는 마지막 수신 틱만 갱신하고, 타이머 만료 시 남은 시간으로 다시 예약한다
+ *  - uiKeepAliveMs 동안 조용하면 KEEP_ALIVE 확인, uiIdleTimeoutMs 동안 조용하면 종료
+ */
+int  sessionEnableIdleTimer(CORE_CTX* pstCoreCtx, unsigned int uiKeepAliveMs, unsigned int uiIdleTimeoutMs);
+void sessionDisableIdleTimer(CORE_CTX* pstCoreCtx);
+
+/* 느린 상대 대응 (출력 버퍼 상한/하한, 상한 도달 시 정책), ulHighMark 0: 해제
+ * 이후 구성되는 세션과 이미 등록된 세션 모두에 적용 */
+int  sessionSetWriteLimit(CORE_CTX* pstCoreCtx, size_t ulHighMark, size_t ulLowMark,
+        SESSION_SLOW_POLICY ePolicy, unsigned int uiGraceMs);
+/* 속도 제한 (pstLimit NULL 또는 전부 0: 해제)
+ * 이후 구성되는 세션과 이미 등록된 세션 모두에 적용, 코어(워커) 스레드에서 호출
+ * 그룹은 코어 event_base 에 묶이므로 sessionCloseAll 이 event_base 해제 전에 정리한다 */
+int  sessionSetRateLimit(CORE_CTX* pstCoreCtx, const SESSION_RATE_LIMIT* pstLimit);
+/* 카운터 스냅샷 (코어 스레드에서 호출)
+ *  - sessionCoreStats: 등록된 세션 합계 + 종료된 세션 누계, return: 등록된 세션 수
+ *  - 상대는 CMD_STATS 요청으로 같은 스냅샷을 RES_STATS 로 받는다
+ */
+void sessionStats(const SESSION_CTX* pstSessionCtx, SESSION_STATS* pstStats);
+int  sessionCoreStats(const CORE_CTX* pstCoreCtx, SESSION_STATS* pstStats);
+/* 코어 타이머 휠(유휴/유예 타이머) 중지: event_base 해제 전에 호출 (sessionCloseAll 이 호출) */
+void sessionStopTimers(CORE_CTX* pstCoreCtx);
 
 #endif
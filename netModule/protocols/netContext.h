@@ -3,7 +3,10 @@
 
 
 #include "commonSession.h"
-#include <event2/listener.h>
+#include "netWorker.h"
+#include "udpPeer.h"
+#include "udpReliable.h"
+#include <sys/socket.h>
 #include <string.h>
 
 typedef enum {
@@ -22,29 +25,104 @@ typedef struct {
     unsigned char   uchDstId;
 } NET_BASE;
 
+/* 멀티 스레드 서버: 수락한 연결을 워커에 배정하는 방식 */
+typedef enum {
+    TCP_DISPATCH_ROUND_ROBIN,
+    TCP_DISPATCH_LEAST_SESSIONS,
+    TCP_DISPATCH_REUSEPORT,         /* 워커마다 SO_REUSEPORT 리스너, 커널이 분산 (리스너 스레드 없음) */
+} TCP_DISPATCH;
+
 typedef struct {
     NET_BASE                stNetBase;
-    struct evconnlistener   *pstListener;
+    NET_LISTENER            *pstListener;       /* 리슨 fd 소유 */
+    unsigned int            uiSessionPrealloc;
+    NET_WORKER              *pastWorker;        /* NULL: 단일 event_base 에서 모든 세션 처리 */
+    int                     iWorkerCnt;
+    TCP_DISPATCH            eDispatch;
+    unsigned int            uiNextWorker;       /* round-robin 위치 */
+    int                     *paiWorkerCpu;      /* 워커 i 는 paiWorkerCpu[i % iWorkerCpuCnt] 에 고정 */
+    int                     iWorkerCpuCnt;
+    SESSION_RATE_LIMIT      stRateLimit;        /* 시작 시 적용, 코어 전체 바이트 제한은 워커 수로 나눈다 */
+    unsigned long           ulHandoffDropCnt;   /* 모든 워커 파이프가 가득 차 닫은 연결 */
 } TCP_SERVER_CTX;
 
 typedef struct {
     NET_BASE            stNetBase;
     struct bufferevent  *pstBufferEvent;
+    SESSION_CTX         stSession;          /* 응답 처리/요청 상관 테이블 */
 } TCP_CLIENT_CTX;
 
+/* 데이터그램 슬롯 링 (recvmmsg/sendmmsg 용, 시작 시 한 번 할당)
+ *  - 수신: 매번 슬롯 전체를 recvmmsg 에 넘긴다
+ *  - 송신: uiHead 부터 uiCount 개가 대기 중 (FIFO)
+ *  - GSO/GRO: 슬롯 하나에 같은 크기 세그먼트 여러 개, 크기는 제어 메시지(puchCtrl)로 주고받는다
+ */
 typedef struct {
-    NET_BASE            stNetBase;
-    struct bufferevent  *pstBufferEvent;
+    struct mmsghdr          *pastMsg;
+    struct iovec            *pastIov;
+    struct sockaddr_storage *pastAddr;
+    unsigned char           *puchBuf;           /* uiSlotCnt * uiSlotSize */
+    unsigned char           *puchCtrl;          /* 슬롯별 제어 메시지 공간 (UDP_SEGMENT/UDP_GRO) */
+    unsigned short          *punSegSize;        /* 송신: 슬롯의 세그먼트 크기 (첫 프레임 크기) */
+    unsigned int            uiSlotCnt;
+    unsigned int            uiSlotSize;
+    unsigned int            uiHead;
+    unsigned int            uiCount;
+} UDP_RING;
+
+typedef struct {
+    NET_BASE                stNetBase;
+    struct event            *pstReadEvent;
+    struct event            *pstFlushEvent;     /* 루프 한 바퀴의 송신분을 모아 sendmmsg */
+    struct event            *pstWriteEvent;     /* 송신 버퍼가 찼을 때 쓰기 가능 대기 */
+    unsigned int            uiBatch;            /* 시스템 호출 한 번에 주고받을 데이터그램 수 */
+    unsigned int            uiSlotSize;         /* 데이터그램 최대 크기 (프레임 하나가 들어가야 함) */
+    unsigned char           uchOffload;         /* 요청한 UDP_OFFLOAD_* */
+    unsigned char           uchOffloadActive;   /* 커널이 받아들인 UDP_OFFLOAD_* (실패 시 비트를 내린다) */
+    UDP_RING                stRxRing;
+    UDP_RING                stTxRing;
+    struct evbuffer         *pstRxBuffer;       /* 데이터그램 하나를 파서에 넘기는 참조 버퍼 */
+    struct evbuffer         *pstTxBuffer;       /* 인코딩된 송신 프레임 (데이터그램으로 나눠 링에 옮긴다) */
+    SESSION_CTX             stSession;          /* 공용 프레임 처리/요청 상관 테이블 */
+    char                    chConnected;        /* 클라이언트: connect 된 소켓 (목적지 생략) */
+    struct sockaddr_storage stPeerAddr;         /* 마지막 수신 상대 (응답/기본 목적지) */
+    socklen_t               iPeerAddrLen;
+    UDP_PEER_TABLE          stPeerTable;        /* 서버: 수신 주소별 세션 (connect 된 소켓은 사용 안 함) */
+    uint32_t                uiMaxPeers;
+    unsigned int            uiPeerIdleMs;
+    unsigned long           ulRxDgramCnt;       /* GRO 로 합쳐 받은 것도 데이터그램 단위로 센다 */
+    unsigned long           ulRxBatchCnt;       /* 데이터그램을 받은 recvmmsg 호출 수 */
+    unsigned long           ulRxMaxBatch;
+    unsigned long           ulRxDropCnt;        /* 잘리거나 프레임이 아닌 데이터그램 */
+    unsigned long           ulTxDgramCnt;       /* GSO 슬롯은 세그먼트 수만큼 */
+    unsigned long           ulTxBatchCnt;       /* sendmmsg 호출 수 */
+    unsigned long           ulTxDropCnt;        /* 슬롯보다 크거나 링이 넘친 송신 프레임 */
+    unsigned long           ulTxGsoCnt;         /* 세그먼트 여러 개를 한 번에 넘긴 슬롯 */
+    unsigned long           ulRxGroCnt;         /* 커널이 여러 데이터그램을 합쳐 넘긴 슬롯 */
+    char                    chReliable;         /* 확장 헤더 프레임을 신뢰 전송 (udpReliable.h) */
+    UDP_REL                 *pstRel;            /* 클라이언트: connect 된 상대 (서버는 UDP_PEER 마다) */
+    SLAB_POOL               stRelPool;          /* 확인 대기 프레임 사본 (슬롯 크기) */
+    TIMER_WHEEL             stRelWheel;         /* 재전송 타이머 */
+    unsigned long           ulRelTxCnt;         /* 신뢰 프레임 첫 송신 */
+    unsigned long           ulRelRetxCnt;       /* 재전송 (빠른 재전송 포함) */
+    unsigned long           ulRelFastCnt;
+    unsigned long           ulRelGiveUpCnt;     /* 재시도 초과로 버린 프레임 */
+    unsigned long           ulRelBacklogCnt;    /* 창이 차서 대기한 프레임 */
+    unsigned long           ulRelRxCnt;         /* 전달한 신뢰 프레임 */
+    unsigned long           ulRelDupCnt;        /* 중복으로 버린 신뢰 프레임 */
+    unsigned long           ulRelAckCnt;        /* 얹을 곳이 없어 따로 보낸 확인 */
 } UDP_CTX;
 
 typedef struct {
     NET_BASE            stNetBase;
-    struct event        *pstClnConnectEvent;
+    NET_LISTENER        *pstListener;       /* 리슨 fd 소유 */
+    SESSION_RATE_LIMIT  stRateLimit;        /* 시작 시 적용 */
 } UDS_SERVER_CTX;
 
 typedef struct {
     NET_BASE            stNetBase;
     struct bufferevent  *pstBufferEvent;
+    SESSION_CTX         stSession;          /* 응답 처리/요청 상관 테이블 */
 } UDS_CLIENT_CTX;
 
 /* ============================================================
@@ -0,0 +1,108 @@
+#define _GNU_SOURCE
+#include "netListener.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void netListenerAcceptCb(evutil_socket_t fd, short nEvents, void* pvData);
+
+/* === fd 부족: 리슨 이벤트를 내리고 대기 후 다시 켠다 === */
+static void netListenerBackoff(NET_LISTENER* pstListener, int iErr)
+{
+    if (pstListener->uiBackoffMs == 0)
+        pstListener->uiBackoffMs = NET_LISTENER_BACKOFF_MS;
+    else if (pstListener->uiBackoffMs < NET_LISTENER_BACKOFF_MAX_MS)
+        pstListener->uiBackoffMs *= 2;
+    if (pstListener->uiBackoffMs > NET_LISTENER_BACKOFF_MAX_MS)
+        pstListener->uiBackoffMs = NET_LISTENER_BACKOFF_MAX_MS;
+    pstListener->ulBackoffCnt++;
+
+    struct timeval stTv = { (time_t)(pstListener->uiBackoffMs / 1000),
+                            (suseconds_t)((pstListener->uiBackoffMs % 1000) * 1000) };
+    event_del(pstListener->pstEvent);
+    event_add(pstListener->pstBackoffEvent, &stTv);
+    fprintf(stderr, "[LISTENER] accept fd=%d: %s, pause %ums\n",
+        (int)pstListener->iFd, strerror(iErr), pstListener->uiBackoffMs);
+}
+
+static void netListenerResumeCb(evutil_socket_t fd, short nEvents, void* pvData)
+{
+    (void)fd; (void)nEvents;
+    NET_LISTENER* pstListener = (NET_LISTENER*)pvData;
+    event_add(pstListener->pstEvent, NULL);
+    /* 대기 중 쌓인 연결은 읽기 준비로 다시 알려지지만, 바로 한 번 비워 본다 */
+    netListenerAcceptCb(pstListener->iFd, EV_READ, pstListener);
+}
+
+/* === 읽기 준비 한 번에 예산만큼 backlog 비우기 === */
+static void netListenerAcceptCb(evutil_socket_t fd, short nEvents, void* pvData)
+{
+    (void)nEvents;
+    NET_LISTENER* pstListener = (NET_LISTENER*)pvData;
+    unsigned long ulBatch = 0;
+    pstListener->ulWakeCnt++;
+
+    while (ulBatch < pstListener->uiBudget) {
+        struct sockaddr_storage stAddr;
+        socklen_t iAddrLen = sizeof(stAddr);
+        evutil_socket_t iClnFd = accept4(fd, (struct sockaddr*)&stAddr, &iAddrLen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (iClnFd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO)
+                continue;
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                netListenerBackoff(pstListener, errno);
+                break;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                fprintf(stderr, "[LISTENER] accept fd=%d: %s\n", (int)fd, strerror(errno));
+            break;
+        }
+        ulBatch++;
+        pstListener->uiBackoffMs = 0;
+        pstListener->ulAcceptCnt++;
+        if (ulBatch > pstListener->ulMaxBatch)
+            pstListener->ulMaxBatch = ulBatch;
+        pstListener->pfnAccept(pstListener, iClnFd, (struct sockaddr*)&stAddr, iAddrLen, pstListener->pvUser);
+    }
+}
+
+NET_LISTENER* netListenerNew(struct event_base* pstEventBase, evutil_socket_t iFd, unsigned int uiBudget,
+        NET_LISTENER_CB pfnAccept, void* pvUser)
+{
+    if (!pstEventBase || iFd < 0 || !pfnAccept)
+        return NULL;//LISTENER_ERR_PARAM
+    if (evutil_make_socket_nonblocking(iFd) < 0)
+        return NULL;//LISTENER_ERR_SOCKET
+
+    NET_LISTENER* pstListener = (NET_LISTENER*)calloc(1, sizeof(NET_LISTENER));
+    if (!pstListener)
+        return NULL;//LISTENER_ERR_ALLOC
+    pstListener->iFd        = iFd;
+    pstListener->uiBudget   = uiBudget ? uiBudget : NET_LISTENER_BUDGET_DEFAULT;
+    pstListener->pfnAccept  = pfnAccept;
+    pstListener->pvUser     = pvUser;
+
+    pstListener->pstEvent = event_new(pstEventBase, iFd, EV_READ | EV_PERSIST, netListenerAcceptCb, pstListener);
+    pstListener->pstBackoffEvent = evtimer_new(pstEventBase, netListenerResumeCb, pstListener);
+    if (!pstListener->pstEvent || !pstListener->pstBackoffEvent || event_add(pstListener->pstEvent, NULL) < 0) {
+        if (pstListener->pstEvent)
+            event_free(pstListener->pstEvent);
+        if (pstListener->pstBackoffEvent)
+            event_free(pstListener->pstBackoffEvent);
+        free(pstListener);
+        return NULL;//LISTENER_ERR_EVENT
+    }
+    return pstListener;
+}
+
+void netListenerFree(NET_LISTENER* pstListener)
+{
+    if (!pstListener)
+        return;
+    event_free(pstListener->pstEvent);
+    event_free(pstListener->pstBackoffEvent);
+    close(pstListener->iFd);
+    free(pstListener);
+}
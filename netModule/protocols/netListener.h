@@ -0,0 +1,42 @@
+#ifndef NET_LISTENER_H
+#define NET_LISTENER_H
+
+#include <sys/socket.h>
+#include <event2/event.h>
+
+/*
+ * 리슨 소켓 공용 수락기 (TCP/UDS)
+ *  - 읽기 준비 한 번에 accept4(SOCK_NONBLOCK|SOCK_CLOEXEC)를 uiBudget 회까지 반복해 backlog 를 비운다
+ *  - fd 가 모자라면(EMFILE/ENFILE 등) 리슨 이벤트를 내리고 잠시 뒤 다시 켠다 (준비 상태로 헛돌지 않음)
+ *  - 단일 스레드: 리스너를 만든 event_base 스레드에서만 사용
+ */
+#define NET_LISTENER_BUDGET_DEFAULT     64      /* 깨어날 때마다 최대 수락 수 */
+#define NET_LISTENER_BACKOFF_MS         50      /* fd 부족 시 첫 대기, 연속 실패마다 두 배 */
+#define NET_LISTENER_BACKOFF_MAX_MS     1000
+
+typedef struct net_listener NET_LISTENER;
+
+/* 수락한 fd (넌블로킹/close-on-exec) 전달, 소유권은 콜백으로 넘어간다 */
+typedef void (*NET_LISTENER_CB)(NET_LISTENER* pstListener, evutil_socket_t fd,
+        struct sockaddr* pstAddr, socklen_t iAddrLen, void* pvUser);
+
+struct net_listener {
+    struct event        *pstEvent;          /* 리슨 fd 읽기 */
+    struct event        *pstBackoffEvent;   /* fd 부족 후 재개 */
+    evutil_socket_t     iFd;
+    unsigned int        uiBudget;
+    unsigned int        uiBackoffMs;        /* 현재 대기 시간 (0: 정상) */
+    NET_LISTENER_CB     pfnAccept;
+    void                *pvUser;
+    unsigned long       ulWakeCnt;          /* 읽기 준비로 깨어난 횟수 */
+    unsigned long       ulAcceptCnt;        /* 수락한 연결 수 */
+    unsigned long       ulMaxBatch;         /* 한 번에 수락한 최대 수 */
+    unsigned long       ulBackoffCnt;       /* fd 부족으로 멈춘 횟수 */
+};
+
+/* iFd: 리슨 중인 소켓 (AF_INET/AF_UNIX), 해제 시 닫는다. uiBudget 0: 기본값 */
+NET_LISTENER* netListenerNew(struct event_base* pstEventBase, evutil_socket_t iFd, unsigned int uiBudget,
+        NET_LISTENER_CB pfnAccept, void* pvUser);
+void netListenerFree(NET_LISTENER* pstListener);
+
+#endif /* NET_LISTENER_H */
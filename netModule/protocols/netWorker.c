@@ -0,0 +1,171 @@
+#define _GNU_SOURCE     /* pthread_attr_setaffinity_np */
+#include "netWorker.h"
+#include "../core/netUtil.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NET_WORKER_STOP     (-1)    /* 파이프로 보내는 종료 요청 */
+
+/* === 파이프에 쌓인 fd 를 모두 꺼내 세션으로 구성 === */
+static void netWorkerWakeCb(evutil_socket_t iPipeFd, short nEvents, void* pvData)
+{
+    (void)nEvents;
+    NET_WORKER* pstWorker = (NET_WORKER*)pvData;
+    int aiFd[64];
+
+    for (;;) {
+        ssize_t lRead = read(iPipeFd, aiFd, sizeof(aiFd));
+        if (lRead <= 0)
+            break;
+        /* fd 4바이트는 PIPE_BUF 이하 쓰기라 잘려서 오지 않는다 */
+        for (ssize_t i = 0; i < lRead / (ssize_t)sizeof(int); i++) {
+            if (aiFd[i] == NET_WORKER_STOP) {
+                event_base_loopbreak(pstWorker->stCoreCtx.pstEventBase);
+                continue;
+            }
+            pstWorker->pfnOnFd(pstWorker, aiFd[i]);
+            __atomic_sub_fetch(&pstWorker->iPending, 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void* netWorkerThread(void* pvData)
+{
+    NET_WORKER* pstWorker = (NET_WORKER*)pvData;
+
+    /* 시그널은 메인 스레드(리스너 event_base)에서만 처리 */
+    sigset_t stMask;
+    sigfillset(&stMask);
+    pthread_sigmask(SIG_BLOCK, &stMask, NULL);
+
+    event_base_dispatch(pstWorker->stCoreCtx.pstEventBase);
+    return NULL;
+}
+
+int netWorkerInit(NET_WORKER* pstWorker, int iIndex, const CORE_CTX* pstTemplate,
+        unsigned int uiSessionPrealloc, NET_WORKER_FD_CB pfnOnFd, void* pvOwner)
+{
+    memset(pstWorker, 0, sizeof(*pstWorker));
+    pstWorker->iIndex = iIndex;
+    pstWorker->pfnOnFd = pfnOnFd;
+    pstWorker->pvOwner = pvOwner;
+    pstWorker->aiWakePipe[0] = pstWorker->aiWakePipe[1] = -1;
+    pstWorker->iCpu = -1;
+
+    struct event_base* pstEventBase = event_base_new();
+    if (!pstEventBase)
+        return -1;//NET_WORKER_ERR_EVENT_BASE
+    sessionInitCore(&pstWorker->stCoreCtx, pstEventBase);
+    pstWorker->stCoreCtx.pstCmdTable        = pstTemplate->pstCmdTable;
+    pstWorker->stCoreCtx.uiFrameErrorBudget = pstTemplate->uiFrameErrorBudget;
+    pstWorker->stCoreCtx.uchFrameCaps       = pstTemplate->uchFrameCaps;
+    if (pstTemplate->chHubMode)
+        sessionEnableHub(&pstWorker->stCoreCtx, pstTemplate->uchHubId, NULL);    /* 워커 안에서만 전달 */
+
+    if (sessionPoolReserve(&pstWorker->stCoreCtx, uiSessionPrealloc) < 0 ||
+            sessionEnableIdleTimer(&pstWorker->stCoreCtx, pstTemplate->uiKeepAliveMs,
+                pstTemplate->uiIdleTimeoutMs) < 0 ||
+            sessionSetWriteLimit(&pstWorker->stCoreCtx, pstTemplate->ulWriteHighMark,
+                pstTemplate->ulWriteLowMark, pstTemplate->eSlowPolicy, pstTemplate->uiSlowGraceMs) < 0 ||
+            pipe(pstWorker->aiWakePipe) < 0) {
+        netWorkerFree(pstWorker);
+        return -1;//NET_WORKER_ERR_RESOURCE
+    }
+    /* 쓰기 쪽도 non-blocking: 워커가 밀려 파이프가 차도 넘기는 쪽 루프는 멈추지 않는다 */
+    makeNonblockClosexec(pstWorker->aiWakePipe[0]);
+    makeNonblockClosexec(pstWorker->aiWakePipe[1]);
+
+    pstWorker->pstWakeEvent = event_new(pstEventBase, pstWorker->aiWakePipe[0],
+        EV_READ | EV_PERSIST, netWorkerWakeCb, pstWorker);
+    if (!pstWorker->pstWakeEvent || event_add(pstWorker->pstWakeEvent, NULL) < 0) {
+        netWorkerFree(pstWorker);
+        return -1;//NET_WORKER_ERR_EVENT
+    }
+    return 0;
+}
+
+int netWorkerStart(NET_WORKER* pstWorker)
+{
+    pthread_attr_t stAttr;
+    pthread_attr_init(&stAttr);
+    if (pstWorker->iCpu >= 0) {
+        cpu_set_t stCpuSet;
+        CPU_ZERO(&stCpuSet);
+        CPU_SET(pstWorker->iCpu, &stCpuSet);
+        if (pthread_attr_setaffinity_np(&stAttr, sizeof(stCpuSet), &stCpuSet) != 0)
+            fprintf(stderr, "[NET WORKER] worker %d: CPU %d affinity ignored\n",
+                pstWorker->iIndex, pstWorker->iCpu);
+    }
+
+    int iRet = pthread_create(&pstWorker->stThread, &stAttr, netWorkerThread, pstWorker);
+    pthread_attr_destroy(&stAttr);
+    if (iRet != 0)
+        return -1;//NET_WORKER_ERR_THREAD
+    pstWorker->chStarted = 1;
+    return 0;
+}
+
+int netWorkerHandoff(NET_WORKER* pstWorker, evutil_socket_t fd)
+{
+    int iFd = (int)fd;
+    __atomic_add_fetch(&pstWorker->iPending, 1, __ATOMIC_RELAXED);
+    while (write(pstWorker->aiWakePipe[1], &iFd, sizeof(iFd)) != (ssize_t)sizeof(iFd)) {
+        if (errno == EINTR)
+            continue;
+        __atomic_sub_fetch(&pstWorker->iPending, 1, __ATOMIC_RELAXED);
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return -1;//NET_WORKER_ERR_PIPE_FULL
+        return -1;//NET_WORKER_ERR_PIPE
+    }
+    return 0;
+}
+
+int netWorkerLoad(NET_WORKER* pstWorker)
+{
+    return __atomic_load_n(&pstWorker->stCoreCtx.iClientCount, __ATOMIC_RELAXED) +
+           __atomic_load_n(&pstWorker->iPending, __ATOMIC_RELAXED);
+}
+
+void netWorkerFree(NET_WORKER* pstWorker)
+{
+    if (pstWorker->chStarted) {
+        /* 종료 요청은 잃으면 안 되므로 blocking 으로 되돌려 워커가 파이프를 비울 때까지 기다린다 */
+        int iStop = NET_WORKER_STOP;
+        int iFlags = fcntl(pstWorker->aiWakePipe[1], F_GETFL);
+        if (iFlags >= 0)
+            fcntl(pstWorker->aiWakePipe[1], F_SETFL, iFlags & ~O_NONBLOCK);
+        if (write(pstWorker->aiWakePipe[1], &iStop, sizeof(iStop)) == (ssize_t)sizeof(iStop))
+            pthread_join(pstWorker->stThread, NULL);
+        else
+            perror("[NET WORKER] stop request failed");
+        pstWorker->chStarted = 0;
+    }
+
+    /* 스레드 종료 후: 리스너, 남은 세션과 전달 중이던 fd 정리 */
+    if (pstWorker->pstListener)
+        netListenerFree(pstWorker->pstListener);
+    pstWorker->pstListener = NULL;
+    sessionCloseAll(&pstWorker->stCoreCtx);
+    if (pstWorker->aiWakePipe[0] >= 0) {
+        int iFd;
+        while (read(pstWorker->aiWakePipe[0], &iFd, sizeof(iFd)) == (ssize_t)sizeof(iFd))
+            if (iFd != NET_WORKER_STOP)
+                close(iFd);
+        close(pstWorker->aiWakePipe[0]);
+    }
+    if (pstWorker->aiWakePipe[1] >= 0)
+        close(pstWorker->aiWakePipe[1]);
+    pstWorker->aiWakePipe[0] = pstWorker->aiWakePipe[1] = -1;
+
+    if (pstWorker->pstWakeEvent)
+        event_free(pstWorker->pstWakeEvent);
+    pstWorker->pstWakeEvent = NULL;
+    if (pstWorker->stCoreCtx.pstEventBase)
+        event_base_free(pstWorker->stCoreCtx.pstEventBase);
+    pstWorker->stCoreCtx.pstEventBase = NULL;
+    sessionFreeCore(&pstWorker->stCoreCtx);
+}
@@ -0,0 +1,48 @@
+#ifndef NET_WORKER_H
+#define NET_WORKER_H
+
+#include <pthread.h>
+#include <event2/event.h>
+#include "netListener.h"
+#include "commonSession.h"
+
+/*
+ * 이벤트 루프 워커 스레드
+ *  - 워커마다 event_base / 세션 리스트 / 세션 풀을 따로 가진다 (CORE_CTX)
+ *  - 다른 스레드는 netWorkerHandoff()로 수락한 fd 를 넘긴다 (파이프로 fd 값 전달)
+ *  - 또는 워커가 자기 리스너(SO_REUSEPORT)로 직접 수락한다 (pstListener)
+ *  - 세션은 닫힐 때까지 받은 워커에서만 처리된다
+ */
+typedef struct net_worker NET_WORKER;
+
+/* 워커 스레드에서 호출: 넘겨받은 fd 로 세션 구성 */
+typedef void (*NET_WORKER_FD_CB)(NET_WORKER* pstWorker, evutil_socket_t fd);
+
+struct net_worker {
+    pthread_t           stThread;
+    int                 iIndex;
+    CORE_CTX            stCoreCtx;          /* 워커 전용 event_base/세션 */
+    int                 aiWakePipe[2];      /* [0] 워커 읽기, [1] 넘기는 쪽 쓰기 */
+    struct event        *pstWakeEvent;
+    NET_WORKER_FD_CB    pfnOnFd;
+    void                *pvOwner;           /* 서버 컨텍스트 */
+    int                 iPending;           /* 넘겼지만 아직 세션이 안 된 fd 수 (atomic) */
+    int                 iCpu;               /* 고정할 CPU (-1: 고정 안 함), netWorkerStart 전에 설정 */
+    NET_LISTENER          *pstListener;     /* 워커 전용 리스너 (워커가 소유, NULL: 없음) */
+    char                chStarted;
+};
+
+/* pstTemplate 의 코어 설정(명령 테이블, 오류 허용, 기능, 유휴 타이머, 허브, 출력 상한)을 이어받는다 */
+int  netWorkerInit(NET_WORKER* pstWorker, int iIndex, const CORE_CTX* pstTemplate,
+        unsigned int uiSessionPrealloc, NET_WORKER_FD_CB pfnOnFd, void* pvOwner);
+int  netWorkerStart(NET_WORKER* pstWorker);
+/* 다른 스레드에서 호출, 막히지 않는다
+ *  - return: 0 성공, -1 실패 (파이프가 가득 참 포함, fd 는 호출자가 다른 워커로 넘기거나 닫는다)
+ */
+int  netWorkerHandoff(NET_WORKER* pstWorker, evutil_socket_t fd);
+/* 분배 기준 부하: 세션 수 + 전달 중인 fd 수 (다른 스레드에서 읽는 근사값) */
+int  netWorkerLoad(NET_WORKER* pstWorker);
+/* 루프 종료 → join → 세션/자원 해제 */
+void netWorkerFree(NET_WORKER* pstWorker);
+
+#endif
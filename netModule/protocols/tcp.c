@@ -14,17 +14,197 @@
  */
 
 void tcpSvrInit(TCP_SERVER_CTX* pstTcpCtx, struct event_base* pstEventBase,
-    unsigned char uchMyId, NET_MODE eMode)
+    unsigned char uchMyId, NET_MODE eMode, unsigned int uiSessionPrealloc)
 {
     netBaseInit(&pstTcpCtx->stNetBase, pstEventBase, uchMyId, eMode);
+    if (sessionPoolReserve(&pstTcpCtx->stNetBase.stCoreCtx, uiSessionPrealloc) < 0)
+        fprintf(stderr, "[TCP SERVER] session pool prealloc(%u) failed\n", uiSessionPrealloc);
     pstTcpCtx->pstListener = NULL;
+    pstTcpCtx->uiSessionPrealloc = uiSessionPrealloc;
+    pstTcpCtx->pastWorker = NULL;
+    pstTcpCtx->iWorkerCnt = 0;
+    pstTcpCtx->eDispatch = TCP_DISPATCH_ROUND_ROBIN;
+    pstTcpCtx->uiNextWorker = 0;
+    pstTcpCtx->paiWorkerCpu = NULL;
+    pstTcpCtx->iWorkerCpuCnt = 0;
+    memset(&pstTcpCtx->stRateLimit, 0, sizeof(pstTcpCtx->stRateLimit));
+}
+
+/**
+ * @brief 수락한 fd 로 세션 구성 (pstCoreCtx 의 event_base 에서 처리)
+ */
+static int tcpSessionOpen(CORE_CTX* pstCoreCtx, evutil_socket_t fd)
+{
+    SESSION_CTX* pstSession = sessionAlloc(pstCoreCtx);
+    if (!pstSession) {
+        fprintf(stderr, "[TCP SERVER] session alloc failed\n");
+        close(fd);
+        return -1;
+    }
+    pstSession->pstBufferEvent = bufferevent_socket_new(pstCoreCtx->pstEventBase, fd, BEV_OPT_CLOSE_ON_FREE);
+    if (!pstSession->pstBufferEvent) {
+        fprintf(stderr, "[TCP SERVER] bufferevent_socket_new failed\n");
+        sessionRelease(pstSession);
+        close(fd);
+        return -1;
+    }
+
+    bufferevent_setcb(pstSession->pstBufferEvent,
+            sessionReadCallback, NULL, sessionEventCallback, pstSession);
+    sessionSetupFrame(pstSession);
+    bufferevent_enable(pstSession->pstBufferEvent, EV_READ | EV_WRITE);
+    sessionAdd(pstSession, pstCoreCtx);
+    pstCoreCtx->iClientSock = fd;
+    return 0;
+}
+
+/* ================================================================
+ * 멀티 스레드 모드: 리스너 스레드는 수락만, 세션은 워커가 처리
+ * ================================================================ */
+static void tcpWorkerOnFd(NET_WORKER* pstWorker, evutil_socket_t fd)
+{
+    tcpSessionOpen(&pstWorker->stCoreCtx, fd);
+}
+
+/* SO_REUSEPORT 모드: 워커 스레드에서 직접 수락 */
+static void tcpWorkerAcceptCb(NET_LISTENER* listener, evutil_socket_t fd,
+    struct sockaddr* addr, socklen_t socklen, void* pvData)
+{
+    (void)listener;
+    (void)socklen;
+    NET_WORKER* pstWorker = (NET_WORKER*)pvData;
+    char client_ip[INET_ADDRSTRLEN];
+    struct sockaddr_in* client_addr = (struct sockaddr_in*)addr;
+    inet_ntop(AF_INET, &client_addr->sin_addr, client_ip, sizeof(client_ip));
+
+    if (tcpSessionOpen(&pstWorker->stCoreCtx, fd) < 0)
+        return;
+    printf("[TCP SERVER] Client connected: fd=%d, ip=%s, port=%d (worker=%d, total=%d)\n",
+    fd, client_ip, ntohs(client_addr->sin_port), pstWorker->iIndex, pstWorker->stCoreCtx.iClientCount);
+}
+
+static int tcpWorkerListen(NET_WORKER* pstWorker, unsigned short unPort)
+{
+    int iFd = createTcpServerOpt(unPort, 1);
+    if (iFd < 0)
+        return -1;
+    pstWorker->pstListener = netListenerNew(pstWorker->stCoreCtx.pstEventBase, iFd,
+        NET_LISTENER_BUDGET_DEFAULT, tcpWorkerAcceptCb, pstWorker);
+    if (!pstWorker->pstListener) {
+        close(iFd);
+        return -1;
+    }
+    return 0;
+}
+
+static NET_WORKER* tcpPickWorker(TCP_SERVER_CTX* pstTcpCtx)
+{
+    if (pstTcpCtx->eDispatch == TCP_DISPATCH_LEAST_SESSIONS) {
+        NET_WORKER* pstBest = &pstTcpCtx->pastWorker[0];
+        int iBestLoad = netWorkerLoad(pstBest);
+        for (int i = 1; i < pstTcpCtx->iWorkerCnt; i++) {
+            int iLoad = netWorkerLoad(&pstTcpCtx->pastWorker[i]);
+            if (iLoad < iBestLoad) {
+                iBestLoad = iLoad;
+                pstBest = &pstTcpCtx->pastWorker[i];
+            }
+        }
+        return pstBest;
+    }
+    return &pstTcpCtx->pastWorker[pstTcpCtx->uiNextWorker++ % (unsigned int)pstTcpCtx->iWorkerCnt];
+}
+
+int tcpSvrSetWorkerCpus(TCP_SERVER_CTX* pstTcpCtx, const int* paiCpu, int iCpuCnt)
+{
+    if (pstTcpCtx->pastWorker || iCpuCnt < 0)
+        return -1;//TCP_ERR_ALREADY_STARTED
+    free(pstTcpCtx->paiWorkerCpu);
+    pstTcpCtx->paiWorkerCpu = NULL;
+    pstTcpCtx->iWorkerCpuCnt = 0;
+    if (!paiCpu || iCpuCnt == 0)
+        return 0;
+
+    pstTcpCtx->paiWorkerCpu = malloc(sizeof(int) * (size_t)iCpuCnt);
+    if (!pstTcpCtx->paiWorkerCpu)
+        return -1;//TCP_ERR_MEMORY_ALLOC_FAIL
+    memcpy(pstTcpCtx->paiWorkerCpu, paiCpu, sizeof(int) * (size_t)iCpuCnt);
+    pstTcpCtx->iWorkerCpuCnt = iCpuCnt;
+    return 0;
+}
+
+int tcpSvrSetWorkers(TCP_SERVER_CTX* pstTcpCtx, int iWorkerCnt, TCP_DISPATCH eDispatch)
+{
+    if (pstTcpCtx->pastWorker || iWorkerCnt < 0)
+        return -1;//TCP_ERR_ALREADY_STARTED
+    pstTcpCtx->iWorkerCnt = iWorkerCnt;
+    pstTcpCtx->eDispatch = eDispatch;
+    return 0;
+}
+
+int tcpSvrSetRateLimit(TCP_SERVER_CTX* pstTcpCtx, const SESSION_RATE_LIMIT* pstLimit)
+{
+    if (pstTcpCtx->pastWorker || pstTcpCtx->pstListener)
+        return -1;//TCP_ERR_ALREADY_STARTED
+    if (pstLimit)
+        pstTcpCtx->stRateLimit = *pstLimit;
+    else
+        memset(&pstTcpCtx->stRateLimit, 0, sizeof(pstTcpCtx->stRateLimit));
+    return 0;
+}
+
+/* 워커 하나의 몫: 그룹(코어 전체) 제한만 나누고 연결별 제한은 그대로 */
+static void tcpRateShare(const SESSION_RATE_LIMIT* pstLimit, int iWorkerCnt, SESSION_RATE_LIMIT* pstShare)
+{
+    size_t ulDiv = (size_t)iWorkerCnt;
+    *pstShare = *pstLimit;
+    pstShare->ulReadRate    = (pstLimit->ulReadRate + ulDiv - 1) / ulDiv;
+    pstShare->ulReadBurst   = (pstLimit->ulReadBurst + ulDiv - 1) / ulDiv;
+    pstShare->ulWriteRate   = (pstLimit->ulWriteRate + ulDiv - 1) / ulDiv;
+    pstShare->ulWriteBurst  = (pstLimit->ulWriteBurst + ulDiv - 1) / ulDiv;
+}
+
+static void tcpStopWorkers(TCP_SERVER_CTX* pstTcpCtx)
+{
+    for (int i = 0; pstTcpCtx->pastWorker && i < pstTcpCtx->iWorkerCnt; i++)
+        netWorkerFree(&pstTcpCtx->pastWorker[i]);
+    free(pstTcpCtx->pastWorker);
+    pstTcpCtx->pastWorker = NULL;
+}
+
+static int tcpStartWorkers(TCP_SERVER_CTX* pstTcpCtx, unsigned short unPort)
+{
+    pstTcpCtx->pastWorker = calloc((size_t)pstTcpCtx->iWorkerCnt, sizeof(NET_WORKER));
+    if (!pstTcpCtx->pastWorker)
+        return -1;
+
+    SESSION_RATE_LIMIT stShare;
+    tcpRateShare(&pstTcpCtx->stRateLimit, pstTcpCtx->iWorkerCnt, &stShare);
+
+    for (int i = 0; i < pstTcpCtx->iWorkerCnt; i++) {
+        NET_WORKER* pstWorker = &pstTcpCtx->pastWorker[i];
+        int iInitOk = netWorkerInit(pstWorker, i, &pstTcpCtx->stNetBase.stCoreCtx,
+                pstTcpCtx->uiSessionPrealloc, tcpWorkerOnFd, pstTcpCtx) == 0;
+        /* 스레드 시작 전이므로 여기서 워커 코어를 설정해도 된다 */
+        if (iInitOk && sessionSetRateLimit(&pstWorker->stCoreCtx, &stShare) < 0)
+            fprintf(stderr, "[TCP SERVER] worker %d rate limit ignored\n", i);
+        if (iInitOk && pstTcpCtx->iWorkerCpuCnt > 0)
+            pstWorker->iCpu = pstTcpCtx->paiWorkerCpu[i % pstTcpCtx->iWorkerCpuCnt];
+        if (!iInitOk || (pstTcpCtx->eDispatch == TCP_DISPATCH_REUSEPORT && tcpWorkerListen(pstWorker, unPort) < 0) ||
+                netWorkerStart(pstWorker) < 0) {
+            fprintf(stderr, "[TCP SERVER] worker %d start failed\n", i);
+            pstTcpCtx->iWorkerCnt = iInitOk ? i + 1 : i;   /* 초기화된 워커까지만 정리 */
+            tcpStopWorkers(pstTcpCtx);
+            return -1;
+        }
+    }
+    return 0;
 }
 
  /**
  * @brief 클라이언트 접속 콜백
  */
-static void tcpAcceptCb(struct evconnlistener* listener, evutil_socket_t fd,
-    struct sockaddr* addr, int socklen, void* pvData)
+static void tcpAcceptCb(NET_LISTENER* listener, evutil_socket_t fd,
+    struct sockaddr* addr, socklen_t socklen, void* pvData)
 {
     (void)socklen;
     (void)listener;
@@ -37,18 +217,27 @@ static void tcpAcceptCb(struct evconnlistener* listener, evutil_socket_t fd,
     int iClientPort = ntohs(client_addr->sin_port);
     // ===============================
 
-    SESSION_CTX* pstSession = calloc(1, sizeof(*pstSession));
-    pstSession->pstCoreCtx = &pstTcpCtx->stNetBase.stCoreCtx;
-    pstSession->pstBufferEvent = bufferevent_socket_new(
-            pstTcpCtx->stNetBase.stCoreCtx.pstEventBase, 
-            fd, 
-            BEV_OPT_CLOSE_ON_FREE);
+    if (pstTcpCtx->pastWorker) {
+        /* 고른 워커가 밀려 있으면 다음 워커부터 차례로, 모두 실패하면 닫고 센다 */
+        NET_WORKER* pstWorker = tcpPickWorker(pstTcpCtx);
+        int iTry = 0;
+        while (netWorkerHandoff(pstWorker, fd) < 0) {
+            if (++iTry == pstTcpCtx->iWorkerCnt) {
+                pstTcpCtx->ulHandoffDropCnt++;
+                fprintf(stderr, "[TCP SERVER] handoff failed on all %d workers, fd=%d closed\n",
+                    pstTcpCtx->iWorkerCnt, fd);
+                close(fd);
+                return;
+            }
+            pstWorker = &pstTcpCtx->pastWorker[(pstWorker->iIndex + 1) % pstTcpCtx->iWorkerCnt];
+        }
+        printf("[TCP SERVER] Client connected: fd=%d, ip=%s, port=%d (worker=%d)\n",
+        fd, client_ip, iClientPort, pstWorker->iIndex);
+        return;
+    }
 
-    bufferevent_setcb(pstSession->pstBufferEvent,
-            sessionReadCallback, NULL, sessionEventCallback, pstSession);
-    bufferevent_enable(pstSession->pstBufferEvent, EV_READ | EV_WRITE);
-    sessionAdd(pstSession, &pstTcpCtx->stNetBase.stCoreCtx);
-    pstTcpCtx->stNetBase.stCoreCtx.iClientSock = fd;
+    if (tcpSessionOpen(&pstTcpCtx->stNetBase.stCoreCtx, fd) < 0)
+        return;
 
     printf("[TCP SERVER] Client connected: fd=%d, ip=%s, port=%d (total=%d)\n",
     fd, client_ip, iClientPort, pstTcpCtx->stNetBase.stCoreCtx.iClientCount);
@@ -59,6 +248,20 @@ static void tcpAcceptCb(struct evconnlistener* listener, evutil_socket_t fd,
  */
 int tcpServerStart(TCP_SERVER_CTX *pstTcpCtx, unsigned short unPort)
 {
+    if (pstTcpCtx->iWorkerCnt == 0 &&
+            sessionSetRateLimit(&pstTcpCtx->stNetBase.stCoreCtx, &pstTcpCtx->stRateLimit) < 0) {
+        fprintf(stderr, "[TCP SERVER] rate limit setup failed\n");
+        return -1;
+    }
+
+    /* 워커별 리스너: 메인 event_base 는 시그널 등만 처리 */
+    if (pstTcpCtx->iWorkerCnt > 0 && pstTcpCtx->eDispatch == TCP_DISPATCH_REUSEPORT) {
+        if (tcpStartWorkers(pstTcpCtx, unPort) < 0)
+            return -1;
+        printf("[TCP SERVER] Listening on port %d (workers=%d, SO_REUSEPORT)\n", unPort, pstTcpCtx->iWorkerCnt);
+        return 0;
+    }
+
     pstTcpCtx->stNetBase.iSockFd = createTcpServer(unPort);
     if (pstTcpCtx->stNetBase.iSockFd < 0)
         return -1;
@@ -67,20 +270,26 @@ int tcpServerStart(TCP_SERVER_CTX *pstTcpCtx, unsigned short unPort)
         fprintf(stderr, "11[ERROR] Failed to create event_base: %s\n", strerror(errno));
         return -1;
     }
-    pstTcpCtx->pstListener = evconnlistener_new(
+    /* 깨어날 때마다 backlog 를 예산만큼 accept4 로 비운다 (리슨 fd 는 리스너가 소유) */
+    pstTcpCtx->pstListener = netListenerNew(
         pstTcpCtx->stNetBase.stCoreCtx.pstEventBase,
+        pstTcpCtx->stNetBase.iSockFd,
+        NET_LISTENER_BUDGET_DEFAULT,
         tcpAcceptCb,
-        pstTcpCtx,
-        LEV_OPT_CLOSE_ON_FREE | LEV_OPT_REUSEABLE,
-        -1,
-        pstTcpCtx->stNetBase.iSockFd);
+        pstTcpCtx);
 
     if (!pstTcpCtx->pstListener){
         close(pstTcpCtx->stNetBase.iSockFd);
         return -1;
     }
 
-    printf("[TCP SERVER] Listening on port %d\n", unPort);
+    if (pstTcpCtx->iWorkerCnt > 0 && tcpStartWorkers(pstTcpCtx, unPort) < 0) {
+        netListenerFree(pstTcpCtx->pstListener);
+        pstTcpCtx->pstListener = NULL;
+        return -1;
+    }
+
+    printf("[TCP SERVER] Listening on port %d (workers=%d)\n", unPort, pstTcpCtx->iWorkerCnt);
     return 0;
 }
 
@@ -93,24 +302,14 @@ void tcpSvrStop(TCP_SERVER_CTX* pstTcpCtx)
 {
     CORE_CTX* pstCoreCtx = &pstTcpCtx->stNetBase.stCoreCtx;
 
-    // 연결된 모든 세션 종료
-    SESSION_CTX* pstSessionCtx = pstCoreCtx->pstSockCtxHead;
-    while (pstSessionCtx) {
-        SESSION_CTX *pstNextSessionCtx = pstSessionCtx->pstSockCtxNext;
-        if (pstSessionCtx->pstBufferEvent) {
-            bufferevent_disable(pstSessionCtx->pstBufferEvent, EV_READ | EV_WRITE);
-            bufferevent_free(pstSessionCtx->pstBufferEvent); // fd 자동 close
-            pstSessionCtx->pstBufferEvent = NULL;
-        }
-        free(pstSessionCtx);
-        pstSessionCtx = pstNextSessionCtx;
-    }
-    pstCoreCtx->pstSockCtxHead = NULL;
-    pstCoreCtx->iClientCount = 0;
+    // 워커 스레드 종료 후 연결된 모든 세션 종료
+    tcpStopWorkers(pstTcpCtx);
+    tcpSvrSetWorkerCpus(pstTcpCtx, NULL, 0);
+    sessionCloseAll(pstCoreCtx);
 
     // 리슨 소켓 해제
     if (pstTcpCtx->pstListener) {
-        evconnlistener_free(pstTcpCtx->pstListener);   // 리슨 소켓 close
+        netListenerFree(pstTcpCtx->pstListener);   // 리슨 소켓 close
         pstTcpCtx->pstListener = NULL;
     }
 
@@ -134,6 +333,7 @@ void tcpSvrStop(TCP_SERVER_CTX* pstTcpCtx)
     // 상태 초기화
     pstTcpCtx->stNetBase.iSockFd = -1;
     pstCoreCtx->iClientSock = -1;
+    sessionFreeCore(pstCoreCtx);
 
     printf("[TCP SERVER] Stopped and cleaned up.\n");
 }
@@ -152,6 +352,7 @@ void tcpSvrStop(TCP_SERVER_CTX* pstTcpCtx)
 {
     netBaseInit(&pstTcpCtx->stNetBase, pstEventBase, uchMyId, eMode);
     pstTcpCtx->pstBufferEvent = NULL;
+    memset(&pstTcpCtx->stSession, 0, sizeof(pstTcpCtx->stSession));
 }
 
 int tcpClientConnect(TCP_CLIENT_CTX* pstTcpCtx, const char* pchIp, unsigned short unPort)
@@ -170,8 +371,13 @@ int tcpClientConnect(TCP_CLIENT_CTX* pstTcpCtx, const char* pchIp, unsigned shor
         return -1;
     }
 
-    bufferevent_setcb(pstTcpCtx->pstBufferEvent, 
-        sessionReadCallback, NULL, sessionEventCallback, NULL);
+    if (sessionAttachClient(&pstTcpCtx->stSession, &pstTcpCtx->stNetBase.stCoreCtx,
+            pstTcpCtx->pstBufferEvent, pstTcpCtx->stNetBase.uchMyId, pstTcpCtx->stNetBase.uchDstId) < 0) {
+        fprintf(stderr, "[TCP CLIENT] sessionAttachClient failed\n");
+        bufferevent_free(pstTcpCtx->pstBufferEvent);
+        pstTcpCtx->pstBufferEvent = NULL;
+        return -1;
+    }
     bufferevent_enable(pstTcpCtx->pstBufferEvent, EV_READ | EV_WRITE);
 
     // 실제 연결 확인
@@ -179,6 +385,7 @@ int tcpClientConnect(TCP_CLIENT_CTX* pstTcpCtx, const char* pchIp, unsigned shor
     socklen_t len = sizeof(sa);
     if (getpeername(fd, (struct sockaddr*)&sa, &len) < 0) {
         perror("[TCP CLIENT] getpeername failed");
+        sessionFreeState(&pstTcpCtx->stSession);
         bufferevent_free(pstTcpCtx->pstBufferEvent);
         pstTcpCtx->pstBufferEvent = NULL;
         return -1;
@@ -188,7 +395,8 @@ int tcpClientConnect(TCP_CLIENT_CTX* pstTcpCtx, const char* pchIp, unsigned shor
 
 void tcpClnStop(TCP_CLIENT_CTX* pstTcpCtx)
 {
-    // 1. 클라이언트 bufferevent 해제
+    // 1. 대기 중인 요청 취소 후 클라이언트 bufferevent 해제
+    sessionFreeState(&pstTcpCtx->stSession);
     if (pstTcpCtx->pstBufferEvent) {
         bufferevent_disable(pstTcpCtx->pstBufferEvent, EV_READ | EV_WRITE);
         bufferevent_free(pstTcpCtx->pstBufferEvent);   // fd 자동 close
@@ -203,6 +411,7 @@ void tcpClnStop(TCP_CLIENT_CTX* pstTcpCtx)
     }
 
     pstTcpCtx->stNetBase.iSockFd = -1;
+    sessionFreeCore(&pstTcpCtx->stNetBase.stCoreCtx);
 
     printf("[TCP CLIENT] Stopped and cleaned up.\n");
 }
\ No newline at end of file
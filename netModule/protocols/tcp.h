@@ -4,8 +4,16 @@
 #include "netContext.h"
 #include "commonSession.h"
 
+/* uiSessionPrealloc: 미리 확보할 세션 객체 수 (0: 필요할 때 슬랩 단위로 확장) */
 void tcpSvrInit(TCP_SERVER_CTX* pstTcpCtx, struct event_base* pstEventBase,
-        unsigned char uchMyId, NET_MODE eMode);
+        unsigned char uchMyId, NET_MODE eMode, unsigned int uiSessionPrealloc);
+/* tcpServerStart() 전에 호출: 워커 iWorkerCnt 개로 세션 처리 (0: 단일 스레드) */
+int  tcpSvrSetWorkers(TCP_SERVER_CTX* pstTcpCtx, int iWorkerCnt, TCP_DISPATCH eDispatch);
+/* tcpServerStart() 전에 호출: 워커 CPU 고정 (NULL/0: 고정 안 함) */
+int  tcpSvrSetWorkerCpus(TCP_SERVER_CTX* pstTcpCtx, const int* paiCpu, int iCpuCnt);
+/* tcpServerStart() 전에 호출: 수락한 연결의 속도 제한 (NULL: 해제)
+ * 워커 모드에서는 워커마다 그룹을 두고 코어 전체 바이트 제한을 워커 수로 나눠 준다 */
+int  tcpSvrSetRateLimit(TCP_SERVER_CTX* pstTcpCtx, const SESSION_RATE_LIMIT* pstLimit);
 int  tcpServerStart(TCP_SERVER_CTX* pstTcpCtx, unsigned short unPort);
 void tcpSvrStop(TCP_SERVER_CTX *pstTcpCtx);
 
@@ -1,160 +1,949 @@
+#define _GNU_SOURCE
 #include "udp.h"
 #include "../core/frame.h"
 #include "../core/icdCommand.h"
+#include "../core/inflight.h"
 #include "../core/netUtil.h"
+#include "../core/trace.h"
 
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <signal.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
+#ifndef SOL_UDP
+#define SOL_UDP         17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT     103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO         104
+#endif
+#define UDP_CTRL_SPACE  CMSG_SPACE(sizeof(int))     /* UDP_SEGMENT(u16) / UDP_GRO(int) 하나 */
+
 /* ================================================================
  * 공통 초기화 함수
  * ================================================================ */
 void udpInit(UDP_CTX *pstUdpCtx, struct event_base *pstEventBase,
              unsigned char uchMyId, NET_MODE eMode)
 {
+    memset(pstUdpCtx, 0, sizeof(*pstUdpCtx));
     netBaseInit(&pstUdpCtx->stNetBase, pstEventBase, uchMyId, eMode);
-    pstUdpCtx->pstRecvEvent = NULL;
+    pstUdpCtx->stNetBase.iSockFd = -1;
+    pstUdpCtx->uiBatch      = UDP_BATCH_DEFAULT;
+    pstUdpCtx->uiSlotSize   = UDP_SLOT_SIZE_DEFAULT;
+    pstUdpCtx->uiMaxPeers   = UDP_PEER_MAX_DEFAULT;
+    pstUdpCtx->uiPeerIdleMs = UDP_PEER_IDLE_MS_DEFAULT;
 }
 
+int udpSetBatch(UDP_CTX* pstUdpCtx, unsigned int uiBatch, unsigned int uiSlotSize)
+{
+    if (pstUdpCtx->pstReadEvent)
+        return -1;//UDP_ERR_ALREADY_STARTED
+    if (uiSlotSize > UDP_DGRAM_MAX)
+        return -1;//UDP_ERR_SLOT_SIZE
+    pstUdpCtx->uiBatch      = uiBatch ? uiBatch : UDP_BATCH_DEFAULT;
+    pstUdpCtx->uiSlotSize   = uiSlotSize ? uiSlotSize : UDP_SLOT_SIZE_DEFAULT;
+    return 0;
+}
 
-/* === Libevent callbacks === */
-void readCallback(struct bufferevent *pstBufferEvent, void *pvData)
+int udpSetPeerTable(UDP_CTX* pstUdpCtx, uint32_t uiMaxPeers, unsigned int uiIdleMs)
 {
-    UDP_CTX *pstUdpCtx    = (UDP_CTX *)pvData;
-    struct evbuffer *pstEvBuffer = bufferevent_get_input(pstBufferEvent);
-    MSG_ID stMsgId;
-    stMsgId.uchSrcId = pstUdpCtx->stNetBase.uchMyId;
-    stMsgId.uchDstId = pstUdpCtx->stNetBase.uchDstId;
-    fprintf(stderr,"MY ID : %d, Dest ID : %d\n", 
-        pstUdpCtx->stNetBase.uchMyId, pstUdpCtx->stNetBase.uchDstId);
-    //TODO 접속한 클라이언트의 ID 저장이 필요
-    for (;;) {
-        int iRetVal = responseFrame(pstEvBuffer, 
-            pstUdpCtx->pstBufferEvent, &stMsgId, pstUdpCtx->stNetBase);
-        if(iRetVal == 1){
-            break;
-        }
-        if (iRetVal == 0) 
-            break;
-        if (iRetVal < 0) { 
-            closeAndFree(pvData);
-            return; 
-        }        
+    if (pstUdpCtx->pstReadEvent)
+        return -1;//UDP_ERR_ALREADY_STARTED
+    pstUdpCtx->uiMaxPeers   = uiMaxPeers ? uiMaxPeers : UDP_PEER_MAX_DEFAULT;
+    pstUdpCtx->uiPeerIdleMs = uiIdleMs;
+    return 0;
+}
+
+int udpSetOffload(UDP_CTX* pstUdpCtx, unsigned char uchOffload)
+{
+    if (pstUdpCtx->pstReadEvent)
+        return -1;//UDP_ERR_ALREADY_STARTED
+    pstUdpCtx->uchOffload = uchOffload & (UDP_OFFLOAD_GSO | UDP_OFFLOAD_GRO);
+    return 0;
+}
+
+int udpSetReliable(UDP_CTX* pstUdpCtx, char chOn)
+{
+    if (pstUdpCtx->pstReadEvent)
+        return -1;//UDP_ERR_ALREADY_STARTED
+    pstUdpCtx->chReliable = chOn ? 1 : 0;
+    return 0;
+}
+
+/* === 슬롯 링: 메시지 헤더/iovec/주소/버퍼를 한 번에 할당하고 서로 연결 === */
+static void udpRingFree(UDP_RING* pstRing)
+{
+    free(pstRing->pastMsg);
+    free(pstRing->pastIov);
+    free(pstRing->pastAddr);
+    free(pstRing->puchBuf);
+    free(pstRing->puchCtrl);
+    free(pstRing->punSegSize);
+    memset(pstRing, 0, sizeof(*pstRing));
+}
+
+static int udpRingAlloc(UDP_RING* pstRing, unsigned int uiSlotCnt, unsigned int uiSlotSize)
+{
+    memset(pstRing, 0, sizeof(*pstRing));
+    pstRing->pastMsg    = calloc(uiSlotCnt, sizeof(struct mmsghdr));
+    pstRing->pastIov    = calloc(uiSlotCnt, sizeof(struct iovec));
+    pstRing->pastAddr   = calloc(uiSlotCnt, sizeof(struct sockaddr_storage));
+    pstRing->puchBuf    = malloc((size_t)uiSlotCnt * uiSlotSize);
+    pstRing->puchCtrl   = calloc(uiSlotCnt, UDP_CTRL_SPACE);
+    pstRing->punSegSize = calloc(uiSlotCnt, sizeof(unsigned short));
+    if (!pstRing->pastMsg || !pstRing->pastIov || !pstRing->pastAddr || !pstRing->puchBuf ||
+            !pstRing->puchCtrl || !pstRing->punSegSize) {
+        udpRingFree(pstRing);
+        return -1;//UDP_ERR_MEMORY_ALLOC_FAIL
+    }
+    pstRing->uiSlotCnt  = uiSlotCnt;
+    pstRing->uiSlotSize = uiSlotSize;
+    for (unsigned int i = 0; i < uiSlotCnt; i++) {
+        pstRing->pastIov[i].iov_base            = pstRing->puchBuf + (size_t)i * uiSlotSize;
+        pstRing->pastIov[i].iov_len             = uiSlotSize;
+        pstRing->pastMsg[i].msg_hdr.msg_iov     = &pstRing->pastIov[i];
+        pstRing->pastMsg[i].msg_hdr.msg_iovlen  = 1;
+        pstRing->pastMsg[i].msg_hdr.msg_name    = &pstRing->pastAddr[i];
+        pstRing->pastMsg[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
     }
+    return 0;
 }
 
-void eventCallback(struct bufferevent *pstBufferEvent, short nEvents, void *pvData) 
-{    
-    (void)pvData;
-    (void)pstBufferEvent;
-    if (nEvents & (BEV_EVENT_EOF | BEV_EVENT_ERROR)) {
-        closeAndFree(pvData);
+/* ================================================================
+ * 송신: 인코딩된 프레임 → 데이터그램 슬롯 → sendmmsg
+ * ================================================================ */
+/* 송신 버퍼 선두 프레임의 전체 길이 (0: 헤더 불완전). 직접 인코딩한 프레임이므로 검증은 생략
+ * piExt: 확장 헤더(순번/플래그) 유무 (NULL: 필요 없음) */
+static size_t udpFrameSize(struct evbuffer* pstTxBuffer, unsigned char uchCrcMode, int* piExt)
+{
+    unsigned char auchHeader[sizeof(FRAME_HEADER) + 1];
+    FRAME_HEADER stHeader;
+    ev_ssize_t lCopied = evbuffer_copyout(pstTxBuffer, auchHeader, sizeof(auchHeader));
+    if (lCopied < (ev_ssize_t)sizeof(FRAME_HEADER))
+        return 0;
+    memcpy(&stHeader, auchHeader, sizeof(stHeader));
+
+    size_t ulExtLen = 0;
+    if (ntohs(stHeader.unStx) == STX_EXT_CONST) {
+        if (lCopied < (ev_ssize_t)sizeof(auchHeader))
+            return 0;
+        ulExtLen = auchHeader[sizeof(FRAME_HEADER)];    /* FRAME_HEADER_EXT.uchExtLen */
     }
+    if (piExt)
+        *piExt = ulExtLen > 0;
+    return sizeof(FRAME_HEADER) + ulExtLen + (size_t)ntohl(stHeader.iDataLength) + frameTailSize(uchCrcMode);
 }
 
+/* 슬롯 목적지가 pstAddr 인지 (NULL: connect 된 상대) */
+static int udpSlotAddrEqual(const struct msghdr* pstHdr, const struct sockaddr* pstAddr, socklen_t iAddrLen)
+{
+    if (!pstAddr)
+        return pstHdr->msg_name == NULL;
+    return pstHdr->msg_namelen == iAddrLen && memcmp(pstHdr->msg_name, pstAddr, iAddrLen) == 0;
+}
+
+/* === GSO: 마지막 슬롯에 세그먼트로 붙일 수 있으면 그 슬롯 번호 (-1: 새 슬롯) ===
+ *  - 목적지가 같고, 지금까지 세그먼트가 모두 같은 크기이며, 새 프레임이 그보다 크지 않을 때
+ *  - 더 작은 프레임은 마지막 세그먼트가 되므로 그 뒤로는 붙이지 않는다
+ */
+static int udpGsoSlot(UDP_CTX* pstUdpCtx, size_t ulFrame, const struct sockaddr* pstAddr, socklen_t iAddrLen)
+{
+    UDP_RING* pstRing = &pstUdpCtx->stTxRing;
+    if (!(pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GSO) || pstRing->uiCount == 0)
+        return -1;
+    unsigned int uiSlot = (pstRing->uiHead + pstRing->uiCount - 1) % pstRing->uiSlotCnt;
+    const struct msghdr* pstHdr = &pstRing->pastMsg[uiSlot].msg_hdr;
+    size_t ulUsed = pstRing->pastIov[uiSlot].iov_len;
+    size_t ulSeg = pstRing->punSegSize[uiSlot];
+
+    if (ulFrame > ulSeg || ulUsed % ulSeg != 0 || ulUsed / ulSeg >= UDP_GSO_SEGS_MAX ||
+            ulUsed + ulFrame > pstRing->uiSlotSize)
+        return -1;
+    if (!udpSlotAddrEqual(pstHdr, pstAddr, iAddrLen))
+        return -1;
+    return (int)uiSlot;
+}
+
+/* 슬롯에 두 번째 세그먼트가 붙을 때 세그먼트 크기를 제어 메시지로 단다 */
+static void udpGsoMark(UDP_RING* pstRing, unsigned int uiSlot)
+{
+    struct msghdr* pstHdr = &pstRing->pastMsg[uiSlot].msg_hdr;
+    if (pstHdr->msg_control)
+        return;
+    pstHdr->msg_control     = pstRing->puchCtrl + (size_t)uiSlot * UDP_CTRL_SPACE;
+    pstHdr->msg_controllen  = CMSG_SPACE(sizeof(uint16_t));
+    struct cmsghdr* pstCmsg = CMSG_FIRSTHDR(pstHdr);
+    pstCmsg->cmsg_level     = SOL_UDP;
+    pstCmsg->cmsg_type      = UDP_SEGMENT;
+    pstCmsg->cmsg_len       = CMSG_LEN(sizeof(uint16_t));
+    uint16_t unSeg = pstRing->punSegSize[uiSlot];
+    memcpy(CMSG_DATA(pstCmsg), &unSeg, sizeof(unSeg));
+}
+
+/* === 슬롯 확보: GSO 로 마지막 슬롯에 붙이거나 새 슬롯 (링이 차면 먼저 비운다) ===
+ *  - return: ulSize 바이트를 기록할 위치, NULL: 링이 넘침
+ */
+static unsigned char* udpSlotReserve(UDP_CTX* pstUdpCtx, const struct sockaddr* pstAddr, socklen_t iAddrLen,
+        size_t ulSize)
+{
+    UDP_RING* pstRing = &pstUdpCtx->stTxRing;
+    int iGsoSlot = udpGsoSlot(pstUdpCtx, ulSize, pstAddr, iAddrLen);
+    if (iGsoSlot >= 0) {
+        struct iovec* pstIov = &pstRing->pastIov[iGsoSlot];
+        unsigned char* puchDst = (unsigned char*)pstIov->iov_base + pstIov->iov_len;
+        pstIov->iov_len += ulSize;
+        udpGsoMark(pstRing, (unsigned int)iGsoSlot);
+        return puchDst;
+    }
+
+    if (pstRing->uiCount == pstRing->uiSlotCnt)
+        udpFlush(pstUdpCtx);
+    if (pstRing->uiCount == pstRing->uiSlotCnt)
+        return NULL;
+    unsigned int uiSlot = (pstRing->uiHead + pstRing->uiCount) % pstRing->uiSlotCnt;
+    struct msghdr* pstHdr = &pstRing->pastMsg[uiSlot].msg_hdr;
+    pstRing->pastIov[uiSlot].iov_len = ulSize;
+    pstRing->punSegSize[uiSlot] = (unsigned short)ulSize;
+    pstHdr->msg_control     = NULL;
+    pstHdr->msg_controllen  = 0;
+    if (pstAddr) {
+        memcpy(&pstRing->pastAddr[uiSlot], pstAddr, iAddrLen);
+        pstHdr->msg_name    = &pstRing->pastAddr[uiSlot];
+        pstHdr->msg_namelen = iAddrLen;
+    } else {
+        pstHdr->msg_name    = NULL;
+        pstHdr->msg_namelen = 0;
+    }
+    pstRing->uiCount++;
+    return pstRing->pastIov[uiSlot].iov_base;
+}
 
 /* ================================================================
- * UDP 서버 시작
+ * 신뢰 전송: 상대별 상태는 서버는 UDP_PEER, 클라이언트는 컨텍스트에 둔다
  * ================================================================ */
-int udpServerStart(UDP_CTX *pstUdpCtx, uint16_t unPort)
+static UDP_REL* udpRelOf(UDP_CTX* pstUdpCtx, UDP_PEER* pstPeer)
 {
-    pstUdpCtx->stNetBase.iSockFd = createUdpServer(unPort);
-    if (pstUdpCtx->stNetBase.iSockFd < 0) {
-        perror("[UDP SERVER] createUdpServer failed");
-        return -1;
+    if (pstUdpCtx->chConnected)
+        return pstUdpCtx->pstRel;
+    return pstPeer ? pstPeer->pstRel : NULL;
+}
+
+/* 필요할 때 만든다 (텔레메트리만 주고받는 상대는 상태가 없다). return: NULL 상대 없음/메모리 부족 */
+static UDP_REL* udpRelAttach(UDP_CTX* pstUdpCtx, UDP_PEER* pstPeer)
+{
+    if (pstUdpCtx->chConnected || !pstPeer)
+        return udpRelOf(pstUdpCtx, pstPeer);
+    if (!pstPeer->pstRel)
+        pstPeer->pstRel = udpRelNew(pstUdpCtx, pstPeer);
+    return pstPeer->pstRel;
+}
+
+static void udpRelPeerRemoveCb(UDP_PEER* pstPeer, void* pvUser)
+{
+    UDP_CTX* pstUdpCtx = (UDP_CTX*)pvUser;
+    udpRelFree(pstPeer->pstRel, &pstUdpCtx->stRelPool, &pstUdpCtx->stRelWheel);
+    pstPeer->pstRel = NULL;
+}
+
+static const struct sockaddr* udpRelAddr(const UDP_REL* pstRel, socklen_t* piAddrLen)
+{
+    const UDP_PEER* pstPeer = (const UDP_PEER*)pstRel->pvPeer;
+    *piAddrLen = pstPeer ? pstPeer->iAddrLen : 0;
+    return pstPeer ? (const struct sockaddr*)&pstPeer->stAddr : NULL;
+}
+
+/* 확인 대기 항목을 신뢰 헤더와 함께 슬롯에 (첫 송신/재전송 공용). return: 1 적재, 0 링이 넘침 (RTO 가 다시 시도) */
+static int udpStageEntry(UDP_CTX* pstUdpCtx, UDP_REL* pstRel, const UDP_REL_ENTRY* pstEntry)
+{
+    socklen_t iAddrLen;
+    const struct sockaddr* pstAddr = udpRelAddr(pstRel, &iAddrLen);
+    unsigned char* puchDst = udpSlotReserve(pstUdpCtx, pstAddr, iAddrLen, sizeof(UDP_REL_HEADER) + pstEntry->uiLen);
+    if (!puchDst) {
+        pstUdpCtx->ulTxDropCnt++;
+        return 0;
     }
-    
-    pstUdpCtx->pstBufferEvent = bufferevent_socket_new(
-        pstUdpCtx->stNetBase.stCoreCtx.pstEventBase, 
-        pstUdpCtx->stNetBase.iSockFd, 
-        BEV_OPT_CLOSE_ON_FREE);
-    if (!pstUdpCtx->pstBufferEvent) { 
-        fprintf(stderr, "bufferevent_socket_new failed\n");
-        return 1;
+    UDP_REL_HEADER stHeader;
+    udpRelBuildHeader(pstRel, UDP_REL_FLAG_DATA, pstEntry->uiSeq, &stHeader);
+    memcpy(puchDst, &stHeader, sizeof(stHeader));
+    memcpy(puchDst + sizeof(stHeader), pstEntry->puchData, pstEntry->uiLen);
+    return 1;
+}
+
+/* 확인만 담은 데이터그램. 링 끝이 같은 상대로 가는 확인이면 최신 내용으로 덮어쓴다. return: 새로 적재한 수 */
+static int udpStageAck(UDP_CTX* pstUdpCtx, UDP_REL* pstRel)
+{
+    UDP_RING* pstRing = &pstUdpCtx->stTxRing;
+    socklen_t iAddrLen;
+    const struct sockaddr* pstAddr = udpRelAddr(pstRel, &iAddrLen);
+    UDP_REL_HEADER stHeader;
+    udpRelBuildHeader(pstRel, 0, 0, &stHeader);
+
+    if (pstRing->uiCount > 0) {
+        unsigned int uiSlot = (pstRing->uiHead + pstRing->uiCount - 1) % pstRing->uiSlotCnt;
+        const struct msghdr* pstHdr = &pstRing->pastMsg[uiSlot].msg_hdr;
+        UDP_REL_HEADER stTail;
+        if (pstRing->pastIov[uiSlot].iov_len == sizeof(stTail) && !pstHdr->msg_control &&
+                udpSlotAddrEqual(pstHdr, pstAddr, iAddrLen)) {
+            memcpy(&stTail, pstRing->pastIov[uiSlot].iov_base, sizeof(stTail));
+            if (ntohs(stTail.unMagic) == UDP_REL_MAGIC && !(stTail.uchFlags & UDP_REL_FLAG_DATA)) {
+                memcpy(pstRing->pastIov[uiSlot].iov_base, &stHeader, sizeof(stHeader));
+                return 0;
+            }
+        }
+    }
+    unsigned char* puchDst = udpSlotReserve(pstUdpCtx, pstAddr, iAddrLen, sizeof(stHeader));
+    if (!puchDst) {
+        pstRel->chAckPending = 1;   /* 다음 데이터그램에 얹는다 */
+        return 0;
+    }
+    memcpy(puchDst, &stHeader, sizeof(stHeader));
+    pstUdpCtx->ulRelAckCnt++;
+    return 1;
+}
+
+static void udpRelRtoCb(TIMER_NODE* pstNode, void* pvUser);
+static int  udpStageFrom(UDP_CTX* pstUdpCtx, struct evbuffer* pstSrc, const struct sockaddr* pstAddr,
+        socklen_t iAddrLen, UDP_PEER* pstPeer);
+
+/* === 재전송할 항목을 싣고, 창이 열렸으면 대기 프레임을 이어 보낸 뒤 타이머를 다시 건다 === */
+static void udpRelRetransmit(UDP_CTX* pstUdpCtx, UDP_REL* pstRel, uint64_t ulNowUs)
+{
+    UDP_REL_ENTRY* apstDue[UDP_REL_WINDOW];
+    unsigned long ulFast = pstRel->ulFastCnt, ulGiveUp = pstRel->ulGiveUpCnt;
+    int iDue = udpRelDue(pstRel, &pstUdpCtx->stRelPool, ulNowUs, apstDue);
+    int iQueued = 0;
+    pstUdpCtx->ulRelRetxCnt     += (unsigned long)iDue;
+    pstUdpCtx->ulRelFastCnt     += pstRel->ulFastCnt - ulFast;
+    pstUdpCtx->ulRelGiveUpCnt   += pstRel->ulGiveUpCnt - ulGiveUp;
+    for (int i = 0; i < iDue; i++)
+        iQueued += udpStageEntry(pstUdpCtx, pstRel, apstDue[i]);
+
+    if (evbuffer_get_length(pstRel->pstBacklog) > 0 && !udpRelWindowFull(pstRel)) {
+        socklen_t iAddrLen;
+        const struct sockaddr* pstAddr = udpRelAddr(pstRel, &iAddrLen);
+        iQueued += udpStageFrom(pstUdpCtx, pstRel->pstBacklog, pstAddr, iAddrLen, (UDP_PEER*)pstRel->pvPeer);
+    }
+    udpRelArm(pstRel, &pstUdpCtx->stRelWheel, ulNowUs, udpRelRtoCb);
+    if (iQueued)
+        event_active(pstUdpCtx->pstFlushEvent, EV_WRITE, 0);
+}
+
+static void udpRelRtoCb(TIMER_NODE* pstNode, void* pvUser)
+{
+    (void)pstNode;
+    UDP_REL* pstRel = (UDP_REL*)pvUser;
+    udpRelRetransmit((UDP_CTX*)pstRel->pvOwner, pstRel, udpRelNowUs());
+}
+
+/* 수신 신뢰 헤더 처리. return: 1 프레임 전달, 0 버림 (중복/창 밖)
+ *  - 수신 순번을 먼저 반영해, 확인으로 열린 창에서 나가는 프레임이 최신 확인을 싣게 한다 */
+static int udpRelInput(UDP_CTX* pstUdpCtx, UDP_REL* pstRel, const UDP_REL_HEADER* pstHeader)
+{
+    uint64_t ulNowUs = udpRelNowUs();
+    int iRet = 1;
+    if (pstHeader->uchFlags & UDP_REL_FLAG_DATA) {
+        iRet = udpRelOnData(pstRel, ntohl(pstHeader->uiEpoch), ntohl(pstHeader->uiSeq), ntohl(pstHeader->uiUna));
+        if (iRet > 0)
+            pstUdpCtx->ulRelRxCnt++;
+        else if (iRet == 0)
+            pstUdpCtx->ulRelDupCnt++;
+        else
+            pstUdpCtx->ulRxDropCnt++;
+    }
+    if (pstHeader->uchFlags & UDP_REL_FLAG_ACK) {
+        udpRelOnAck(pstRel, &pstUdpCtx->stRelPool, ntohl(pstHeader->uiAckEpoch), ntohl(pstHeader->uiAck),
+            ntohl(pstHeader->uiSackBits), ulNowUs);
+        udpRelRetransmit(pstUdpCtx, pstRel, ulNowUs);
+    }
+    return iRet > 0;
+}
+
+static int udpRelStart(UDP_CTX* pstUdpCtx, struct event_base* pstEventBase)
+{
+    slabPoolInit(&pstUdpCtx->stRelPool, pstUdpCtx->uiSlotSize, UDP_REL_WINDOW);
+    if (timerWheelInit(&pstUdpCtx->stRelWheel, pstEventBase, UDP_REL_TICK_MS) < 0)
+        return -1;//UDP_ERR_EVENT
+    if (pstUdpCtx->chConnected) {
+        pstUdpCtx->pstRel = udpRelNew(pstUdpCtx, NULL);
+        if (!pstUdpCtx->pstRel)
+            return -1;//UDP_ERR_MEMORY_ALLOC_FAIL
+    } else {
+        pstUdpCtx->stPeerTable.pfnRemove    = udpRelPeerRemoveCb;
+        pstUdpCtx->stPeerTable.pvRemoveUser = pstUdpCtx;
     }
-    bufferevent_setcb(pstUdpCtx->pstBufferEvent, 
-        readCallback, 
-        NULL, 
-        eventCallback, 
-        pstUdpCtx);
-    bufferevent_enable(pstUdpCtx->pstBufferEvent, EV_READ|EV_WRITE);
-    bufferevent_setwatermark(pstUdpCtx->pstBufferEvent, 
-        EV_READ, 
-        sizeof(FRAME_HEADER), 
-        READ_HIGH_WM);  
-
-    printf("[UDP SERVER] Listening on port %d\n", unPort);
     return 0;
 }
 
+/* === 프레임을 하나씩 데이터그램 슬롯으로 (pstAddr NULL: connect 된 상대) ===
+ *  - pstSrc: 송신 버퍼 또는 상대의 신뢰 전송 대기 버퍼
+ *  - pstPeer: 상대 세션 송신 카운터/신뢰 전송 상태 (NULL: 없음)
+ *  - GSO 가 켜져 있으면 같은 크기 프레임 연속은 한 슬롯에 세그먼트로 모은다
+ *  - 신뢰 모드: 확장 헤더 프레임은 순번을 받아 창에 보관 (창이 차면 대기 버퍼로),
+ *    나머지는 알릴 확인이 있을 때만 신뢰 헤더를 붙인다
+ */
+static int udpStageFrom(UDP_CTX* pstUdpCtx, struct evbuffer* pstSrc, const struct sockaddr* pstAddr,
+        socklen_t iAddrLen, UDP_PEER* pstPeer)
+{
+    unsigned char uchCrcMode = pstUdpCtx->stSession.stFrameCtx.uchCrcMode;
+    UDP_REL* pstRel = pstUdpCtx->chReliable ? udpRelOf(pstUdpCtx, pstPeer) : NULL;
+    int iFromBacklog = pstRel && pstSrc == pstRel->pstBacklog;
+    int iQueued = 0, iExt = 0;
+    size_t ulFrame;
+
+    while ((ulFrame = udpFrameSize(pstSrc, uchCrcMode, &iExt)) > 0 && evbuffer_get_length(pstSrc) >= ulFrame) {
+        int iReliable = pstUdpCtx->chReliable && (iExt || iFromBacklog);
+        if (iReliable && !pstRel)
+            pstRel = udpRelAttach(pstUdpCtx, pstPeer);
+        iReliable = iReliable && pstRel;
+        size_t ulShim = (iReliable || (pstRel && pstRel->chAckPending)) ? sizeof(UDP_REL_HEADER) : 0;
+        if (ulFrame + ulShim > pstUdpCtx->uiSlotSize) {
+            evbuffer_drain(pstSrc, ulFrame);
+            pstUdpCtx->ulTxDropCnt++;
+            continue;
+        }
+
+        if (iReliable) {
+            /* 순서를 지키려면 앞서 기다리는 프레임이 있을 때도 뒤에 줄 세운다 */
+            if (!iFromBacklog && (udpRelWindowFull(pstRel) || evbuffer_get_length(pstRel->pstBacklog) > 0)) {
+                evbuffer_remove_buffer(pstSrc, pstRel->pstBacklog, ulFrame);
+                pstUdpCtx->ulRelBacklogCnt++;
+                continue;
+            }
+            uint64_t ulNowUs = udpRelNowUs();
+            UDP_REL_ENTRY* pstEntry = udpRelTrack(pstRel, &pstUdpCtx->stRelPool, (unsigned int)ulFrame, ulNowUs);
+            if (!pstEntry) {
+                if (iFromBacklog)
+                    break;
+                evbuffer_drain(pstSrc, ulFrame);
+                pstUdpCtx->ulTxDropCnt++;
+                continue;
+            }
+            evbuffer_remove(pstSrc, pstEntry->puchData, ulFrame);
+            pstUdpCtx->ulRelTxCnt++;
+            iQueued += udpStageEntry(pstUdpCtx, pstRel, pstEntry);
+            if (!timerPending(&pstRel->stRtoTimer))
+                udpRelArm(pstRel, &pstUdpCtx->stRelWheel, ulNowUs, udpRelRtoCb);
+        } else {
+            unsigned char* puchDst = udpSlotReserve(pstUdpCtx, pstAddr, iAddrLen, ulShim + ulFrame);
+            if (!puchDst) {
+                evbuffer_drain(pstSrc, ulFrame);
+                pstUdpCtx->ulTxDropCnt++;
+                continue;
+            }
+            if (ulShim) {
+                UDP_REL_HEADER stHeader;
+                udpRelBuildHeader(pstRel, 0, 0, &stHeader);
+                memcpy(puchDst, &stHeader, sizeof(stHeader));
+            }
+            evbuffer_remove(pstSrc, puchDst + ulShim, ulFrame);
+            iQueued++;
+        }
+        if (pstPeer) {
+            pstPeer->ulTxFrameCnt++;
+            pstPeer->ulTxBytes += ulFrame;
+        }
+    }
+    /* 이번 루프에서 처리할 콜백이 모두 끝난 뒤 한 번에 송신 */
+    if (iQueued)
+        event_active(pstUdpCtx->pstFlushEvent, EV_WRITE, 0);
+    return iQueued;
+}
+
+static int udpStage(UDP_CTX* pstUdpCtx, const struct sockaddr* pstAddr, socklen_t iAddrLen, UDP_PEER* pstPeer)
+{
+    return udpStageFrom(pstUdpCtx, pstUdpCtx->pstTxBuffer, pstAddr, iAddrLen, pstPeer);
+}
+
+/* 기본 목적지: 클라이언트는 connect 된 서버, 서버는 마지막으로 수신한 상대 */
+static int udpStageDefault(UDP_CTX* pstUdpCtx)
+{
+    if (pstUdpCtx->chConnected)
+        return udpStage(pstUdpCtx, NULL, 0, NULL);
+    if (pstUdpCtx->iPeerAddrLen == 0) {
+        /* 아직 받은 적이 없으면 보낼 곳이 없다 */
+        size_t ulFrame;
+        while ((ulFrame = udpFrameSize(pstUdpCtx->pstTxBuffer, pstUdpCtx->stSession.stFrameCtx.uchCrcMode, NULL)) > 0) {
+            evbuffer_drain(pstUdpCtx->pstTxBuffer, ulFrame);
+            pstUdpCtx->ulTxDropCnt++;
+        }
+        return 0;
+    }
+    const struct sockaddr* pstPeerAddr = (const struct sockaddr*)&pstUdpCtx->stPeerAddr;
+    return udpStage(pstUdpCtx, pstPeerAddr, pstUdpCtx->iPeerAddrLen,
+        udpPeerLookup(&pstUdpCtx->stPeerTable, pstPeerAddr, pstUdpCtx->iPeerAddrLen));
+}
+
+/* 슬롯이 담은 데이터그램 수 (GSO 표시가 없으면 하나) */
+static unsigned int udpSlotSegs(const UDP_RING* pstRing, unsigned int uiSlot)
+{
+    if (!pstRing->pastMsg[uiSlot].msg_hdr.msg_control)
+        return 1;
+    return (unsigned int)((pstRing->pastIov[uiSlot].iov_len + pstRing->punSegSize[uiSlot] - 1) /
+        pstRing->punSegSize[uiSlot]);
+}
+
+/* === GSO 를 받지 않는 경로(장치 체크섬 오프로드 없음, MTU 초과 등) ===
+ *  - 이후로는 GSO 를 끄고, 이 슬롯은 세그먼트마다 따로 보낸다
+ */
+static int udpGsoFallback(UDP_CTX* pstUdpCtx, unsigned int uiSlot, int iErr)
+{
+    UDP_RING* pstRing = &pstUdpCtx->stTxRing;
+    const struct msghdr* pstHdr = &pstRing->pastMsg[uiSlot].msg_hdr;
+    const unsigned char* puchData = pstRing->pastIov[uiSlot].iov_base;
+    size_t ulLen = pstRing->pastIov[uiSlot].iov_len;
+    size_t ulSeg = pstRing->punSegSize[uiSlot];
+    int iSent = 0;
+
+    if (pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GSO)
+        fprintf(stderr, "[UDP] GSO send failed: %s, falling back to one datagram per frame\n", strerror(iErr));
+    pstUdpCtx->uchOffloadActive &= (unsigned char)~UDP_OFFLOAD_GSO;
+    for (size_t ulOff = 0; ulOff < ulLen; ulOff += ulSeg) {
+        size_t ulPart = ulLen - ulOff < ulSeg ? ulLen - ulOff : ulSeg;
+        if (sendto(pstUdpCtx->stNetBase.iSockFd, puchData + ulOff, ulPart, MSG_DONTWAIT,
+                pstHdr->msg_name, pstHdr->msg_namelen) == (ssize_t)ulPart) {
+            pstUdpCtx->ulTxDgramCnt++;
+            iSent++;
+        } else {
+            pstUdpCtx->ulTxDropCnt++;
+        }
+    }
+    return iSent;
+}
+
+int udpFlush(UDP_CTX* pstUdpCtx)
+{
+    UDP_RING* pstRing = &pstUdpCtx->stTxRing;
+    int iSent = 0;
+    if (pstUdpCtx->stNetBase.iSockFd < 0)
+        return -1;//UDP_ERR_NOT_STARTED
+
+    while (pstRing->uiCount > 0) {
+        /* 링 끝에서 끊어지는 구간은 두 번에 나눠 보낸다 */
+        unsigned int uiRun = pstRing->uiSlotCnt - pstRing->uiHead;
+        if (uiRun > pstRing->uiCount)
+            uiRun = pstRing->uiCount;
+        int iRet = sendmmsg(pstUdpCtx->stNetBase.iSockFd, &pstRing->pastMsg[pstRing->uiHead], uiRun, MSG_DONTWAIT);
+        if (iRet < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                event_add(pstUdpCtx->pstWriteEvent, NULL);
+                break;
+            }
+            if (pstRing->pastMsg[pstRing->uiHead].msg_hdr.msg_control &&
+                    (errno == EIO || errno == EINVAL || errno == EMSGSIZE || errno == EOPNOTSUPP || errno == ENOPROTOOPT))
+                iSent += udpGsoFallback(pstUdpCtx, pstRing->uiHead, errno);
+            else
+                pstUdpCtx->ulTxDropCnt++;   /* 상대 없음(ECONNREFUSED) 등: 선두 슬롯만 버리고 계속 */
+            iRet = 1;
+        } else {
+            pstUdpCtx->ulTxBatchCnt++;
+            for (int i = 0; i < iRet; i++) {
+                unsigned int uiSegs = udpSlotSegs(pstRing, pstRing->uiHead + (unsigned int)i);
+                pstUdpCtx->ulTxDgramCnt += uiSegs;
+                pstUdpCtx->ulTxGsoCnt   += uiSegs > 1;
+                iSent += (int)uiSegs;
+            }
+        }
+        pstRing->uiHead     = (pstRing->uiHead + (unsigned int)iRet) % pstRing->uiSlotCnt;
+        pstRing->uiCount    -= (unsigned int)iRet;
+    }
+    if (pstRing->uiCount == 0)
+        pstRing->uiHead = 0;
+    return iSent;
+}
+
+static void udpFlushCb(evutil_socket_t fd, short nEvents, void* pvData)
+{
+    (void)fd;
+    (void)nEvents;
+    UDP_CTX* pstUdpCtx = (UDP_CTX*)pvData;
+    udpStageDefault(pstUdpCtx);
+    udpFlush(pstUdpCtx);
+}
+
+/* 읽기 콜백 밖에서 기록된 프레임(요청, 유휴 확인 등)도 같은 경로로 송신 */
+static void udpTxBufferCb(struct evbuffer* pstEvBuffer, const struct evbuffer_cb_info* pstInfo, void* pvData)
+{
+    (void)pstEvBuffer;
+    UDP_CTX* pstUdpCtx = (UDP_CTX*)pvData;
+    if (pstInfo->n_added && pstUdpCtx->pstFlushEvent)
+        event_active(pstUdpCtx->pstFlushEvent, EV_WRITE, 0);
+}
+
+int udpSendFrame(UDP_CTX* pstUdpCtx, const struct sockaddr* pstAddr, socklen_t iAddrLen, const FRAME_IOV* pstFrame)
+{
+    if (!pstUdpCtx->pstTxBuffer)
+        return -1;//UDP_ERR_NOT_STARTED
+    if (pstAddr && iAddrLen > (socklen_t)sizeof(struct sockaddr_storage))
+        return -1;//UDP_ERR_ADDR
+    /* 앞서 기록된 기본 목적지 프레임이 다른 주소로 섞이지 않게 먼저 옮긴다 */
+    udpStageDefault(pstUdpCtx);
+    if (!pstAddr) {
+        if (writeFrameIovCtx(&pstUdpCtx->stSession.stFrameCtx, pstFrame) < 0)
+            return -1;//UDP_ERR_ENCODE
+        udpStageDefault(pstUdpCtx);
+        return 1;
+    }
+
+    /* 아는 상대면 MSG_ID 도 그 상대로 (기본 목적지의 MSG_ID 는 되돌려 둔다) */
+    FRAME_CTX* pstFrameCtx = &pstUdpCtx->stSession.stFrameCtx;
+    UDP_PEER* pstPeer = udpPeerLookup(&pstUdpCtx->stPeerTable, pstAddr, iAddrLen);
+    /* 신뢰 전송은 상대별 순번이 필요하므로 처음 보내는 주소도 세션을 만든다 */
+    if (!pstPeer && pstUdpCtx->chReliable)
+        pstPeer = udpPeerTouch(&pstUdpCtx->stPeerTable, pstAddr, iAddrLen, udpPeerNowMs());
+    MSG_ID stSaved = pstFrameCtx->stMsgId;
+    if (pstPeer && pstPeer->chIdKnown)
+        pstFrameCtx->stMsgId.uchDstId = pstPeer->stMsgId.uchDstId;
+    int iRet = writeFrameIovCtx(pstFrameCtx, pstFrame);
+    pstFrameCtx->stMsgId = stSaved;
+    if (iRet < 0)
+        return -1;//UDP_ERR_ENCODE
+    udpStage(pstUdpCtx, pstAddr, iAddrLen, pstPeer);
+    return 1;
+}
+
+int udpSendToPeer(UDP_CTX* pstUdpCtx, unsigned char uchPeerId, const FRAME_IOV* pstFrame)
+{
+    UDP_PEER* pstPeer = udpPeerFindId(&pstUdpCtx->stPeerTable, uchPeerId);
+    if (!pstPeer)
+        return -1;//UDP_ERR_UNKNOWN_PEER
+    return udpSendFrame(pstUdpCtx, (const struct sockaddr*)&pstPeer->stAddr, pstPeer->iAddrLen, pstFrame);
+}
+
 /* ================================================================
- * UDP 서버 정리
+ * 수신: recvmmsg → 데이터그램마다 프레임 하나 디스패치
  * ================================================================ */
-void udpServerStop(UDP_CTX *pstUdpCtx)
+static void udpDispatch(UDP_CTX* pstUdpCtx, const struct msghdr* pstHdr, const unsigned char* puchData,
+        unsigned int uiLength, uint64_t ulNowMs)
 {
-    if (pstUdpCtx->pstBufferEvent) {
-        event_free(pstUdpCtx->pstBufferEvent);
-        pstUdpCtx->pstBufferEvent = NULL;
+    if (pstHdr->msg_flags & MSG_TRUNC) {
+        pstUdpCtx->ulRxDropCnt++;
+        return;
     }
+    memcpy(&pstUdpCtx->stPeerAddr, pstHdr->msg_name, pstHdr->msg_namelen);
+    pstUdpCtx->iPeerAddrLen = pstHdr->msg_namelen;
 
-    if (pstUdpCtx->stNetBase.iSockFd >= 0) {
-        close(pstUdpCtx->stNetBase.iSockFd);
-        pstUdpCtx->stNetBase.iSockFd = -1;
+    /* 상대 세션: 응답 MSG_ID 는 보낸 쪽 ID 로 (검증된 프레임이 있을 때만 ID 를 기억) */
+    FRAME_CTX* pstFrameCtx = &pstUdpCtx->stSession.stFrameCtx;
+    UDP_PEER* pstPeer = udpPeerTouch(&pstUdpCtx->stPeerTable, pstHdr->msg_name, pstHdr->msg_namelen, ulNowMs);
+    unsigned long ulRxFrames = pstFrameCtx->ulRxFrameCnt;
+    FRAME_HEADER stPeek;
+    int iPeeked = 0;
+    if (pstPeer) {
+        pstPeer->ulRxDgramCnt++;
+        pstPeer->ulRxBytes += uiLength;
+    }
+
+    /* 신뢰 전송 헤더: 확인을 처리하고 떼어낸다. 이미 받은 순번이면 프레임은 버리고 확인만 다시 보낸다 */
+    UDP_REL* pstRel = NULL;
+    int iDeliver = 1;
+    if (uiLength >= sizeof(UDP_REL_HEADER) && puchData[0] == (UDP_REL_MAGIC >> 8) &&
+            puchData[1] == (UDP_REL_MAGIC & 0xFF)) {
+        UDP_REL_HEADER stRelHeader;
+        memcpy(&stRelHeader, puchData, sizeof(stRelHeader));
+        puchData += sizeof(stRelHeader);
+        uiLength -= sizeof(stRelHeader);
+        if (pstUdpCtx->chReliable && (pstRel = udpRelAttach(pstUdpCtx, pstPeer)) != NULL)
+            iDeliver = udpRelInput(pstUdpCtx, pstRel, &stRelHeader);
     }
 
-    printf("[UDP SERVER] Stopped.\n");
+    if (pstPeer) {
+        pstFrameCtx->stMsgId.uchDstId = pstPeer->chIdKnown ?
+            pstPeer->stMsgId.uchDstId : pstUdpCtx->stNetBase.uchDstId;
+        if (uiLength >= sizeof(stPeek)) {
+            memcpy(&stPeek, puchData, sizeof(stPeek));
+            iPeeked = ntohs(stPeek.unStx) == STX_CONST || ntohs(stPeek.unStx) == STX_EXT_CONST;
+            if (iPeeked)
+                pstFrameCtx->stMsgId.uchDstId = stPeek.stMsgId.uchSrcId;
+        }
+    }
+
+    /* 슬롯을 복사 없이 참조로 붙여 스트림 파서를 그대로 사용 */
+    struct evbuffer* pstRxBuffer = pstUdpCtx->pstRxBuffer;
+    if (iDeliver && uiLength > 0) {
+        evbuffer_add_reference(pstRxBuffer, puchData, uiLength, NULL, NULL);
+        int iRet = 1;
+        while (iRet == 1 && evbuffer_get_length(pstRxBuffer) > 0)
+            iRet = responseFrame(pstRxBuffer, pstFrameCtx);
+        if (pstPeer && pstFrameCtx->ulRxFrameCnt > ulRxFrames) {
+            pstPeer->ulRxFrameCnt += pstFrameCtx->ulRxFrameCnt - ulRxFrames;
+            if (iPeeked && (!pstPeer->chIdKnown || pstPeer->stMsgId.uchDstId != stPeek.stMsgId.uchSrcId))
+                udpPeerLearnId(&pstUdpCtx->stPeerTable, pstPeer, stPeek.stMsgId.uchSrcId);
+        }
+
+        /* 데이터그램 경계를 넘는 프레임은 없다: 남은 조각은 버리고 파서 상태를 되돌린다 */
+        if (evbuffer_get_length(pstRxBuffer) > 0) {
+            pstUdpCtx->ulRxDropCnt++;
+            evbuffer_drain(pstRxBuffer, evbuffer_get_length(pstRxBuffer));
+        }
+        pstFrameCtx->chHeaderValid  = 0;
+        pstFrameCtx->chSyncLost     = 0;
+        pstFrameCtx->uiErrorCnt     = 0;
+    }
+
+    /* 핸들러 응답은 보낸 쪽으로 (확인 정보를 얹는다), 얹을 응답이 없으면 확인만 */
+    if (pstUdpCtx->chConnected)
+        udpStage(pstUdpCtx, NULL, 0, NULL);
+    else
+        udpStage(pstUdpCtx, (const struct sockaddr*)&pstUdpCtx->stPeerAddr, pstUdpCtx->iPeerAddrLen, pstPeer);
+    if (pstRel && pstRel->chAckPending && udpStageAck(pstUdpCtx, pstRel) > 0)
+        event_active(pstUdpCtx->pstFlushEvent, EV_WRITE, 0);
+}
+
+/* === GRO 로 합쳐진 슬롯은 세그먼트 크기대로 나눠 데이터그램마다 디스패치 === */
+static void udpReceive(UDP_CTX* pstUdpCtx, struct msghdr* pstHdr, const unsigned char* puchData,
+        unsigned int uiLength, uint64_t ulNowMs)
+{
+    unsigned int uiSeg = uiLength;
+    if (pstHdr->msg_controllen > 0) {
+        for (struct cmsghdr* pstCmsg = CMSG_FIRSTHDR(pstHdr); pstCmsg; pstCmsg = CMSG_NXTHDR(pstHdr, pstCmsg)) {
+            if (pstCmsg->cmsg_level == SOL_UDP && pstCmsg->cmsg_type == UDP_GRO) {
+                int iGsoSize;
+                memcpy(&iGsoSize, CMSG_DATA(pstCmsg), sizeof(iGsoSize));
+                if (iGsoSize > 0 && (unsigned int)iGsoSize < uiLength) {
+                    uiSeg = (unsigned int)iGsoSize;
+                    pstUdpCtx->ulRxGroCnt++;
+                }
+            }
+        }
+    }
+    if (uiSeg == 0) {
+        pstUdpCtx->ulRxDgramCnt++;
+        udpDispatch(pstUdpCtx, pstHdr, puchData, 0, ulNowMs);
+        return;
+    }
+    for (unsigned int uiOff = 0; uiOff < uiLength; uiOff += uiSeg) {
+        unsigned int uiPart = uiLength - uiOff < uiSeg ? uiLength - uiOff : uiSeg;
+        pstUdpCtx->ulRxDgramCnt++;
+        /* 병합용으로 키운 슬롯에 들어온, 원래 슬롯보다 큰 데이터그램 */
+        if (uiPart > pstUdpCtx->uiSlotSize) {
+            pstUdpCtx->ulRxDropCnt++;
+            continue;
+        }
+        udpDispatch(pstUdpCtx, pstHdr, puchData + uiOff, uiPart, ulNowMs);
+    }
+}
+
+static void udpReadCb(evutil_socket_t fd, short nEvents, void* pvData)
+{
+    (void)nEvents;
+    UDP_CTX* pstUdpCtx = (UDP_CTX*)pvData;
+    UDP_RING* pstRing = &pstUdpCtx->stRxRing;
+    int iGro = (pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GRO) != 0;
+
+    for (int iRound = 0; iRound < UDP_RX_ROUNDS; iRound++) {
+        for (unsigned int i = 0; i < pstRing->uiSlotCnt; i++) {
+            pstRing->pastMsg[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+            if (iGro)
+                pstRing->pastMsg[i].msg_hdr.msg_controllen = UDP_CTRL_SPACE;
+        }
+        int iRecv = recvmmsg(fd, pstRing->pastMsg, pstRing->uiSlotCnt, MSG_DONTWAIT, NULL);
+        if (iRecv <= 0) {
+            /* connect 된 소켓의 ICMP 오류(ECONNREFUSED)는 호출 한 번으로 소멸 */
+            if (iRecv < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNREFUSED)
+                fprintf(stderr, "[UDP] recvmmsg failed: %s\n", strerror(errno));
+            break;
+        }
+        pstUdpCtx->ulRxBatchCnt++;
+        if ((unsigned long)iRecv > pstUdpCtx->ulRxMaxBatch)
+            pstUdpCtx->ulRxMaxBatch = (unsigned long)iRecv;
+        TRACE_DEBUG(TRACE_EV_RX_BYTES, pstUdpCtx, 0, (uint32_t)iRecv, 0);
+
+        uint64_t ulNowMs = pstUdpCtx->stPeerTable.pastPeer ? udpPeerNowMs() : 0;
+        for (int i = 0; i < iRecv; i++)
+            udpReceive(pstUdpCtx, &pstRing->pastMsg[i].msg_hdr, pstRing->pastIov[i].iov_base,
+                pstRing->pastMsg[i].msg_len, ulNowMs);
+        if ((unsigned int)iRecv < pstRing->uiSlotCnt)
+            break;
+    }
 }
 
 /* ================================================================
- * UDP 클라이언트 시작
+ * 시작/종료
  * ================================================================ */
-int udpClientStart(UDP_CTX *pstUdpCtx, uint16_t unBindPort)
+/* 공용 프레임 컨텍스트: 상대별 상태가 없으므로 기능 협상(압축)은 하지 않는다 */
+static void udpSetupSession(UDP_CTX* pstUdpCtx)
 {
-    pstUdpCtx->stNetBase.iSockFd = createUdpClient(unBindPort);
-    if (pstUdpCtx->stNetBase.iSockFd < 0) {
-        perror("[UDP CLIENT] createUdpClient failed");
+    CORE_CTX* pstCoreCtx = &pstUdpCtx->stNetBase.stCoreCtx;
+    SESSION_CTX* pstSession = &pstUdpCtx->stSession;
+    memset(pstSession, 0, sizeof(*pstSession));
+    pstSession->pstCoreCtx = pstCoreCtx;
+    pstSession->chEmbedded = 1;
+
+    frameCtxInit(&pstSession->stFrameCtx, NULL, pstCoreCtx->pstCmdTable, pstSession);
+    pstSession->stFrameCtx.pstOutput        = pstUdpCtx->pstTxBuffer;
+    pstSession->stFrameCtx.uiErrorBudget    = pstCoreCtx->uiFrameErrorBudget;
+    pstSession->stFrameCtx.uchLocalCaps     = 0;
+    pstSession->stFrameCtx.stMsgId.uchSrcId = pstUdpCtx->stNetBase.uchMyId;
+    pstSession->stFrameCtx.stMsgId.uchDstId = pstUdpCtx->stNetBase.uchDstId;
+}
+
+static void udpRelease(UDP_CTX* pstUdpCtx);
+
+/* === 오프로드: 소켓 옵션을 받아들이는 것만 켠다 (구버전 커널은 ENOPROTOOPT) === */
+static void udpOffloadSetup(UDP_CTX* pstUdpCtx, int iFd)
+{
+    pstUdpCtx->uchOffloadActive = 0;
+    if (pstUdpCtx->uchOffload & UDP_OFFLOAD_GSO) {
+        int iSegSize = 0;   /* 소켓 기본값은 두지 않고 슬롯마다 제어 메시지로 지정 */
+        if (setsockopt(iFd, SOL_UDP, UDP_SEGMENT, &iSegSize, sizeof(iSegSize)) == 0)
+            pstUdpCtx->uchOffloadActive |= UDP_OFFLOAD_GSO;
+        else
+            fprintf(stderr, "[UDP] UDP_SEGMENT unsupported (%s), GSO off\n", strerror(errno));
+    }
+    if (pstUdpCtx->uchOffload & UDP_OFFLOAD_GRO) {
+        int iOn = 1;
+        if (setsockopt(iFd, SOL_UDP, UDP_GRO, &iOn, sizeof(iOn)) == 0)
+            pstUdpCtx->uchOffloadActive |= UDP_OFFLOAD_GRO;
+        else
+            fprintf(stderr, "[UDP] UDP_GRO unsupported (%s), GRO off\n", strerror(errno));
+    }
+}
+
+static int udpStart(UDP_CTX* pstUdpCtx, int iFd)
+{
+    struct event_base* pstEventBase = pstUdpCtx->stNetBase.stCoreCtx.pstEventBase;
+    pstUdpCtx->stNetBase.iSockFd = iFd;
+
+    /* 오프로드 슬롯은 세그먼트 여러 개가 들어가도록 데이터그램 최대 크기로 */
+    udpOffloadSetup(pstUdpCtx, iFd);
+    unsigned int uiRxSlot = (pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GRO) ? UDP_GRO_SLOT_SIZE : pstUdpCtx->uiSlotSize;
+    unsigned int uiTxSlot = (pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GSO) ? UDP_DGRAM_MAX : pstUdpCtx->uiSlotSize;
+    if (uiRxSlot < pstUdpCtx->uiSlotSize)
+        uiRxSlot = pstUdpCtx->uiSlotSize;
+    if (uiTxSlot < pstUdpCtx->uiSlotSize)
+        uiTxSlot = pstUdpCtx->uiSlotSize;
+    if (udpRingAlloc(&pstUdpCtx->stRxRing, pstUdpCtx->uiBatch, uiRxSlot) < 0 ||
+            udpRingAlloc(&pstUdpCtx->stTxRing, pstUdpCtx->uiBatch, uiTxSlot) < 0)
+        goto fail;
+    if (pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GRO) {
+        for (unsigned int i = 0; i < pstUdpCtx->stRxRing.uiSlotCnt; i++)
+            pstUdpCtx->stRxRing.pastMsg[i].msg_hdr.msg_control = pstUdpCtx->stRxRing.puchCtrl + (size_t)i * UDP_CTRL_SPACE;
+    }
+    pstUdpCtx->pstRxBuffer = evbuffer_new();
+    pstUdpCtx->pstTxBuffer = evbuffer_new();
+    if (!pstUdpCtx->pstRxBuffer || !pstUdpCtx->pstTxBuffer ||
+            !evbuffer_add_cb(pstUdpCtx->pstTxBuffer, udpTxBufferCb, pstUdpCtx))
+        goto fail;
+    udpSetupSession(pstUdpCtx);
+    if (!pstUdpCtx->chConnected && udpPeerTableInit(&pstUdpCtx->stPeerTable, pstEventBase,
+            pstUdpCtx->stNetBase.uchMyId, pstUdpCtx->uiMaxPeers, pstUdpCtx->uiPeerIdleMs) < 0)
+        goto fail;
+    if (pstUdpCtx->chReliable && udpRelStart(pstUdpCtx, pstEventBase) < 0)
+        goto fail;
+
+    pstUdpCtx->pstReadEvent     = event_new(pstEventBase, iFd, EV_READ | EV_PERSIST, udpReadCb, pstUdpCtx);
+    pstUdpCtx->pstFlushEvent    = event_new(pstEventBase, -1, 0, udpFlushCb, pstUdpCtx);
+    pstUdpCtx->pstWriteEvent    = event_new(pstEventBase, iFd, EV_WRITE, udpFlushCb, pstUdpCtx);
+    if (!pstUdpCtx->pstReadEvent || !pstUdpCtx->pstFlushEvent || !pstUdpCtx->pstWriteEvent ||
+            event_add(pstUdpCtx->pstReadEvent, NULL) < 0)
+        goto fail;
+    return 0;
+
+fail:
+    udpRelease(pstUdpCtx);
+    return -1;//UDP_ERR_START
+}
+
+/* ================================================================
+ * UDP 서버 시작
+ * ================================================================ */
+int udpServerStart(UDP_CTX *pstUdpCtx, unsigned short unPort)
+{
+    int iFd = createUdpServer(unPort);
+    if (iFd < 0) {
+        perror("[UDP SERVER] createUdpServer failed");
         return -1;
     }
+    if (udpStart(pstUdpCtx, iFd) < 0) {
+        fprintf(stderr, "[UDP SERVER] start failed\n");
+        return -1;
+    }
+    printf("[UDP SERVER] Listening on port %d (batch=%u, slot=%u%s%s%s)\n",
+        unPort, pstUdpCtx->uiBatch, pstUdpCtx->uiSlotSize,
+        (pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GSO) ? ", gso" : "",
+        (pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GRO) ? ", gro" : "",
+        pstUdpCtx->chReliable ? ", reliable" : "");
+    return 0;
+}
 
-    pstUdpCtx->pstBufferEvent = bufferevent_socket_new(
-        pstUdpCtx->stNetBase.stCoreCtx.pstEventBase, 
-        pstUdpCtx->stNetBase.iSockFd, 
-        BEV_OPT_CLOSE_ON_FREE);
-    if (!pstUdpCtx->pstBufferEvent) { 
-        fprintf(stderr, "bufferevent_socket_new failed\n");
-        return 1;
+/* ================================================================
+ * UDP 클라이언트 시작 (connect 된 소켓, 응답 대기 테이블 사용)
+ * ================================================================ */
+int udpClientStart(UDP_CTX *pstUdpCtx, const char* pchIpAddr, unsigned short unSvrPort, unsigned short unMyPort)
+{
+    int iFd = createUdpClient(pchIpAddr, unSvrPort, unMyPort);
+    if (iFd < 0) {
+        perror("[UDP CLIENT] createUdpClient failed");
+        return -1;
+    }
+    pstUdpCtx->chConnected = 1;
+    if (udpStart(pstUdpCtx, iFd) < 0 ||
+            sessionEnableInflight(&pstUdpCtx->stSession, INFLIGHT_DEFAULT_CAPACITY) < 0) {
+        fprintf(stderr, "[UDP CLIENT] start failed\n");
+        udpRelease(pstUdpCtx);
+        return -1;
     }
-    bufferevent_setcb(pstUdpCtx->pstBufferEvent, 
-        readCallback, 
-        NULL, 
-        eventCallback, 
-        pstUdpCtx);
-    bufferevent_enable(pstUdpCtx->pstBufferEvent, EV_READ|EV_WRITE);
-    bufferevent_setwatermark(pstUdpCtx->pstBufferEvent, 
-        EV_READ, 
-        sizeof(FRAME_HEADER), 
-        READ_HIGH_WM);  
-    printf("[UDP CLIENT] Started (bind port=%d)\n", unBindPort);
+    printf("[UDP CLIENT] Started (dst=%s:%u, bind port=%u%s%s%s)\n", pchIpAddr, unSvrPort, unMyPort,
+        (pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GSO) ? ", gso" : "",
+        (pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GRO) ? ", gro" : "",
+        pstUdpCtx->chReliable ? ", reliable" : "");
     return 0;
 }
 
 /* ================================================================
- * UDP 클라이언트 종료
+ * UDP 종료 (대기 중인 송신분은 마지막으로 한 번 내보낸다)
  * ================================================================ */
-void udpClientStop(UDP_CTX *pstUdpCtx)
+static void udpRelease(UDP_CTX* pstUdpCtx)
 {
-    if (pstUdpCtx->pstBufferEvent) {
-        event_free(pstUdpCtx->pstBufferEvent);
-        pstUdpCtx->pstBufferEvent = NULL;
+    if (pstUdpCtx->pstTxBuffer && pstUdpCtx->pstFlushEvent) {
+        udpStageDefault(pstUdpCtx);
+        udpFlush(pstUdpCtx);
     }
+    if (pstUdpCtx->pstReadEvent)
+        event_free(pstUdpCtx->pstReadEvent);
+    if (pstUdpCtx->pstFlushEvent)
+        event_free(pstUdpCtx->pstFlushEvent);
+    if (pstUdpCtx->pstWriteEvent)
+        event_free(pstUdpCtx->pstWriteEvent);
+    pstUdpCtx->pstReadEvent     = NULL;
+    pstUdpCtx->pstFlushEvent    = NULL;
+    pstUdpCtx->pstWriteEvent    = NULL;
+
+    sessionFreeState(&pstUdpCtx->stSession);
+    memset(&pstUdpCtx->stSession, 0, sizeof(pstUdpCtx->stSession));
+    if (pstUdpCtx->pstRxBuffer)
+        evbuffer_free(pstUdpCtx->pstRxBuffer);
+    if (pstUdpCtx->pstTxBuffer)
+        evbuffer_free(pstUdpCtx->pstTxBuffer);
+    pstUdpCtx->pstRxBuffer = NULL;
+    pstUdpCtx->pstTxBuffer = NULL;
+    udpRingFree(&pstUdpCtx->stRxRing);
+    udpRingFree(&pstUdpCtx->stTxRing);
+    udpPeerTableFree(&pstUdpCtx->stPeerTable);   /* 상대별 신뢰 전송 상태도 함께 해제 */
+    udpRelFree(pstUdpCtx->pstRel, &pstUdpCtx->stRelPool, &pstUdpCtx->stRelWheel);
+    pstUdpCtx->pstRel = NULL;
+    timerWheelFree(&pstUdpCtx->stRelWheel);
+    slabPoolDestroy(&pstUdpCtx->stRelPool);
 
     if (pstUdpCtx->stNetBase.iSockFd >= 0) {
         close(pstUdpCtx->stNetBase.iSockFd);
         pstUdpCtx->stNetBase.iSockFd = -1;
     }
+    pstUdpCtx->chConnected = 0;
+    pstUdpCtx->iPeerAddrLen = 0;
+    pstUdpCtx->uchOffloadActive = 0;
+}
 
-    printf("[UDP CLIENT] Stopped.\n");
+void udpStop(UDP_CTX *pstUdpCtx)
+{
+    udpRelease(pstUdpCtx);
+    sessionFreeCore(&pstUdpCtx->stNetBase.stCoreCtx);
 }
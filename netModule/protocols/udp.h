@@ -4,9 +4,44 @@
 #include "commonSession.h"
 #include "netContext.h"
 
+/*
+ * 데이터그램 전송
+ *  - 읽기 준비마다 recvmmsg 로 최대 uiBatch 개를 미리 할당한 슬롯에 받는다
+ *  - 데이터그램 하나 = 프레임 하나 (스트림처럼 이어 붙이지 않음, 남는 바이트는 버림)
+ *  - 응답/송신 프레임은 링에 쌓았다가 루프 한 바퀴 끝에 sendmmsg 한 번으로 내보낸다
+ *  - GSO: 같은 목적지로 가는 같은 크기 프레임 연속을 슬롯 하나에 모아 UDP_SEGMENT 로 한 번에 넘긴다
+ *  - GRO: 커널이 합쳐 넘긴 슬롯을 세그먼트 크기대로 나눠 데이터그램마다 디스패치
+ *  - 서버는 수신 주소별 세션(udpPeer.h)에 상대 ID/카운터를 두고, 응답 MSG_ID 를 보낸 쪽으로 맞춘다
+ *  - 신뢰 모드(udpReliable.h): 확장 헤더가 있는 프레임(요청/응답/조각)은 순번/확인/재전송,
+ *    확장 헤더가 없는 단발 프레임(텔레메트리)은 그대로 보내고 확인 정보만 얹는다
+ */
+#define UDP_BATCH_DEFAULT       32
+#define UDP_SLOT_SIZE_DEFAULT   2048        /* 더 큰 프레임은 udpSetBatch 로 늘리거나 조각 송신 */
+#define UDP_DGRAM_MAX           65507
+#define UDP_RX_ROUNDS           8           /* 한 번 깨어날 때 recvmmsg 반복 상한 */
+
+#define UDP_OFFLOAD_GSO         0x01        /* 송신 세그먼트 오프로드 (UDP_SEGMENT) */
+#define UDP_OFFLOAD_GRO         0x02        /* 수신 병합 (UDP_GRO) */
+#define UDP_GSO_SEGS_MAX        64          /* 커널 UDP_MAX_SEGMENTS (구버전 기준) */
+#define UDP_GRO_SLOT_SIZE       65535       /* 병합된 수신 슬롯 최대 크기 */
+
 void udpInit(UDP_CTX* pstUdpCtx, struct event_base* pstEventBase, unsigned char uchMyId, NET_MODE eMode);
+/* 시작 전에만 변경 가능 (0: 기본값) */
+int  udpSetBatch(UDP_CTX* pstUdpCtx, unsigned int uiBatch, unsigned int uiSlotSize);
+/* 서버 상대 세션 테이블 크기/유휴 시간, 시작 전에만 변경 가능 (uiMaxPeers 0: 기본값, uiIdleMs 0: 유휴 정리 안 함) */
+int  udpSetPeerTable(UDP_CTX* pstUdpCtx, uint32_t uiMaxPeers, unsigned int uiIdleMs);
+/* 시작 전에만 변경 가능. 커널/장치가 지원하지 않으면 켜지 않고(uchOffloadActive) 일반 경로로 동작 */
+int  udpSetOffload(UDP_CTX* pstUdpCtx, unsigned char uchOffload);
+/* 시작 전에만 변경 가능. 양쪽 모두 켜야 재전송이 동작 (꺼진 쪽은 신뢰 헤더를 떼어내고 그대로 처리) */
+int  udpSetReliable(UDP_CTX* pstUdpCtx, char chOn);
 int  udpServerStart(UDP_CTX* pstUdpCtx, unsigned short unPort);
 int  udpClientStart(UDP_CTX* pstUdpCtx, const char* pchIpAddr, unsigned short unSvrPort, unsigned short unMyPort);
+/* pstAddr NULL: 기본 목적지 (클라이언트는 서버, 서버는 마지막 수신 상대). return: 1 대기열 추가, -1 실패 */
+int  udpSendFrame(UDP_CTX* pstUdpCtx, const struct sockaddr* pstAddr, socklen_t iAddrLen, const FRAME_IOV* pstFrame);
+/* 상대 ID 로 송신 (수신 프레임에서 학습한 주소). return: 1 대기열 추가, -1 모르는 상대/실패 */
+int  udpSendToPeer(UDP_CTX* pstUdpCtx, unsigned char uchPeerId, const FRAME_IOV* pstFrame);
+/* 대기 중인 데이터그램 즉시 송신. return: 보낸 수, -1 오류 */
+int  udpFlush(UDP_CTX* pstUdpCtx);
 void udpStop(UDP_CTX* pstUdpCtx);
 
 #endif
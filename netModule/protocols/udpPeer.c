@@ -0,0 +1,307 @@
+#include "udpPeer.h"
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+uint64_t udpPeerNowMs(void)
+{
+    struct timespec stTs;
+    clock_gettime(CLOCK_MONOTONIC, &stTs);
+    return (uint64_t)stTs.tv_sec * 1000ull + (uint64_t)stTs.tv_nsec / 1000000ull;
+}
+
+/* ================================================================
+ * 주소 키: 패밀리/포트/주소만 비교 (sockaddr 의 패딩은 보지 않는다)
+ * ================================================================ */
+static inline uint32_t udpPeerFnv(uint32_t uiHash, const void* pvData, size_t ulLen)
+{
+    const unsigned char* puchData = (const unsigned char*)pvData;
+    for (size_t i = 0; i < ulLen; i++) {
+        uiHash ^= puchData[i];
+        uiHash *= 16777619u;
+    }
+    return uiHash;
+}
+
+static uint32_t udpPeerHash(const struct sockaddr* pstAddr, socklen_t iAddrLen)
+{
+    uint32_t uiHash = 2166136261u;
+    uiHash = udpPeerFnv(uiHash, &pstAddr->sa_family, sizeof(pstAddr->sa_family));
+    if (pstAddr->sa_family == AF_INET) {
+        const struct sockaddr_in* pstIn = (const struct sockaddr_in*)pstAddr;
+        uiHash = udpPeerFnv(uiHash, &pstIn->sin_port, sizeof(pstIn->sin_port));
+        uiHash = udpPeerFnv(uiHash, &pstIn->sin_addr, sizeof(pstIn->sin_addr));
+    } else if (pstAddr->sa_family == AF_INET6) {
+        const struct sockaddr_in6* pstIn6 = (const struct sockaddr_in6*)pstAddr;
+        uiHash = udpPeerFnv(uiHash, &pstIn6->sin6_port, sizeof(pstIn6->sin6_port));
+        uiHash = udpPeerFnv(uiHash, &pstIn6->sin6_addr, sizeof(pstIn6->sin6_addr));
+        uiHash = udpPeerFnv(uiHash, &pstIn6->sin6_scope_id, sizeof(pstIn6->sin6_scope_id));
+    } else {
+        uiHash = udpPeerFnv(uiHash, pstAddr, iAddrLen);
+    }
+    return uiHash;
+}
+
+static int udpPeerAddrEqual(const UDP_PEER* pstPeer, const struct sockaddr* pstAddr, socklen_t iAddrLen)
+{
+    const struct sockaddr* pstMine = (const struct sockaddr*)&pstPeer->stAddr;
+    if (pstMine->sa_family != pstAddr->sa_family)
+        return 0;
+    if (pstAddr->sa_family == AF_INET) {
+        const struct sockaddr_in* pstA = (const struct sockaddr_in*)pstMine;
+        const struct sockaddr_in* pstB = (const struct sockaddr_in*)pstAddr;
+        return pstA->sin_port == pstB->sin_port && pstA->sin_addr.s_addr == pstB->sin_addr.s_addr;
+    }
+    if (pstAddr->sa_family == AF_INET6) {
+        const struct sockaddr_in6* pstA = (const struct sockaddr_in6*)pstMine;
+        const struct sockaddr_in6* pstB = (const struct sockaddr_in6*)pstAddr;
+        return pstA->sin6_port == pstB->sin6_port && pstA->sin6_scope_id == pstB->sin6_scope_id &&
+            memcmp(&pstA->sin6_addr, &pstB->sin6_addr, sizeof(pstA->sin6_addr)) == 0;
+    }
+    return pstPeer->iAddrLen == iAddrLen && memcmp(pstMine, pstAddr, iAddrLen) == 0;
+}
+
+/* ================================================================
+ * 최근 수신 순서 (항목 번호로 연결한 이중 연결 리스트)
+ * ================================================================ */
+static void udpPeerLruUnlink(UDP_PEER_TABLE* pstTable, uint32_t uiIdx)
+{
+    UDP_PEER* pstPeer = &pstTable->pastPeer[uiIdx];
+    if (pstPeer->uiLruPrev != UDP_PEER_NONE)
+        pstTable->pastPeer[pstPeer->uiLruPrev].uiLruNext = pstPeer->uiLruNext;
+    else
+        pstTable->uiLruHead = pstPeer->uiLruNext;
+    if (pstPeer->uiLruNext != UDP_PEER_NONE)
+        pstTable->pastPeer[pstPeer->uiLruNext].uiLruPrev = pstPeer->uiLruPrev;
+    else
+        pstTable->uiLruTail = pstPeer->uiLruPrev;
+    pstPeer->uiLruPrev = pstPeer->uiLruNext = UDP_PEER_NONE;
+}
+
+static void udpPeerLruPushHead(UDP_PEER_TABLE* pstTable, uint32_t uiIdx)
+{
+    UDP_PEER* pstPeer = &pstTable->pastPeer[uiIdx];
+    pstPeer->uiLruPrev = UDP_PEER_NONE;
+    pstPeer->uiLruNext = pstTable->uiLruHead;
+    if (pstTable->uiLruHead != UDP_PEER_NONE)
+        pstTable->pastPeer[pstTable->uiLruHead].uiLruPrev = uiIdx;
+    else
+        pstTable->uiLruTail = uiIdx;
+    pstTable->uiLruHead = uiIdx;
+}
+
+/* ================================================================
+ * 해시 슬롯 (선형 탐사)
+ * ================================================================ */
+static uint32_t udpPeerFindSlot(const UDP_PEER_TABLE* pstTable, uint32_t uiHash,
+        const struct sockaddr* pstAddr, socklen_t iAddrLen)
+{
+    uint32_t uiSlot = uiHash & pstTable->uiSlotMask;
+    uint32_t uiIdx;
+    while ((uiIdx = pstTable->puiSlot[uiSlot]) != UDP_PEER_NONE) {
+        const UDP_PEER* pstPeer = &pstTable->pastPeer[uiIdx];
+        if (pstPeer->uiHash == uiHash && udpPeerAddrEqual(pstPeer, pstAddr, iAddrLen))
+            return uiSlot;
+        uiSlot = (uiSlot + 1) & pstTable->uiSlotMask;
+    }
+    return UDP_PEER_NONE;
+}
+
+/* 빈 슬롯은 해시 사슬을 끊으므로, 뒤에서 원래 자리가 이 슬롯 이전인 항목을 당겨 채운다 */
+static void udpPeerSlotDelete(UDP_PEER_TABLE* pstTable, uint32_t uiIdx)
+{
+    uint32_t uiMask = pstTable->uiSlotMask;
+    uint32_t uiHole = pstTable->pastPeer[uiIdx].uiHash & uiMask;
+    while (pstTable->puiSlot[uiHole] != uiIdx)
+        uiHole = (uiHole + 1) & uiMask;
+
+    uint32_t uiNext = uiHole;
+    for (;;) {
+        uiNext = (uiNext + 1) & uiMask;
+        uint32_t uiMoved = pstTable->puiSlot[uiNext];
+        if (uiMoved == UDP_PEER_NONE)
+            break;
+        uint32_t uiHome = pstTable->pastPeer[uiMoved].uiHash & uiMask;
+        /* uiHome 이 (uiHole, uiNext] 구간 안이면 그 자리에 그대로 둔다 */
+        if (((uiNext - uiHome) & uiMask) < ((uiNext - uiHole) & uiMask))
+            continue;
+        pstTable->puiSlot[uiHole] = uiMoved;
+        uiHole = uiNext;
+    }
+    pstTable->puiSlot[uiHole] = UDP_PEER_NONE;
+}
+
+/* ================================================================
+ * 생성/해제
+ * ================================================================ */
+static void udpPeerIdleCb(evutil_socket_t fd, short nEvents, void* pvData)
+{
+    (void)fd;
+    (void)nEvents;
+    udpPeerExpire((UDP_PEER_TABLE*)pvData, udpPeerNowMs());
+}
+
+int udpPeerTableInit(UDP_PEER_TABLE* pstTable, struct event_base* pstEventBase, unsigned char uchMyId,
+        uint32_t uiMaxPeers, unsigned int uiIdleMs)
+{
+    memset(pstTable, 0, sizeof(*pstTable));
+    if (uiMaxPeers == 0)
+        uiMaxPeers = UDP_PEER_MAX_DEFAULT;
+    if (uiMaxPeers > (1u << 24))
+        return -1;//UDP_PEER_ERR_PARAM
+
+    uint32_t uiSlotCnt = 1;
+    while (uiSlotCnt < uiMaxPeers * 2)
+        uiSlotCnt <<= 1;
+    pstTable->pastPeer  = calloc(uiMaxPeers, sizeof(UDP_PEER));
+    pstTable->puiSlot   = malloc((size_t)uiSlotCnt * sizeof(uint32_t));
+    if (!pstTable->pastPeer || !pstTable->puiSlot) {
+        udpPeerTableFree(pstTable);
+        return -1;//UDP_PEER_ERR_MEMORY_ALLOC_FAIL
+    }
+    memset(pstTable->puiSlot, 0xFF, (size_t)uiSlotCnt * sizeof(uint32_t));
+    memset(pstTable->auiIdIndex, 0xFF, sizeof(pstTable->auiIdIndex));
+    pstTable->uiSlotMask    = uiSlotCnt - 1;
+    pstTable->uiMaxPeers    = uiMaxPeers;
+    pstTable->uiLruHead     = UDP_PEER_NONE;
+    pstTable->uiLruTail     = UDP_PEER_NONE;
+    pstTable->uiIdleMs      = uiIdleMs;
+    pstTable->uchMyId       = uchMyId;
+    for (uint32_t i = 0; i < uiMaxPeers; i++)
+        pstTable->pastPeer[i].uiLruNext = i + 1 < uiMaxPeers ? i + 1 : UDP_PEER_NONE;
+    pstTable->uiFreeHead    = 0;
+
+    /* 유휴 판정 오차는 주기(유휴 시간의 1/4) 이내 */
+    if (pstEventBase && uiIdleMs > 0) {
+        unsigned int uiPeriodMs = uiIdleMs / 4 ? uiIdleMs / 4 : 1;
+        struct timeval stTv = { (time_t)(uiPeriodMs / 1000), (suseconds_t)((uiPeriodMs % 1000) * 1000) };
+        pstTable->pstIdleEvent = event_new(pstEventBase, -1, EV_PERSIST, udpPeerIdleCb, pstTable);
+        if (!pstTable->pstIdleEvent || event_add(pstTable->pstIdleEvent, &stTv) < 0) {
+            udpPeerTableFree(pstTable);
+            return -1;//UDP_PEER_ERR_EVENT
+        }
+    }
+    return 0;
+}
+
+void udpPeerTableFree(UDP_PEER_TABLE* pstTable)
+{
+    if (pstTable->pstIdleEvent)
+        event_free(pstTable->pstIdleEvent);
+    if (pstTable->pfnRemove && pstTable->pastPeer) {
+        for (uint32_t i = 0; i < pstTable->uiMaxPeers; i++)
+            if (pstTable->pastPeer[i].chUsed)
+                pstTable->pfnRemove(&pstTable->pastPeer[i], pstTable->pvRemoveUser);
+    }
+    free(pstTable->pastPeer);
+    free(pstTable->puiSlot);
+    memset(pstTable, 0, sizeof(*pstTable));
+}
+
+/* ================================================================
+ * 조회/갱신
+ * ================================================================ */
+UDP_PEER* udpPeerLookup(const UDP_PEER_TABLE* pstTable, const struct sockaddr* pstAddr, socklen_t iAddrLen)
+{
+    if (!pstTable->pastPeer || !pstAddr)
+        return NULL;
+    uint32_t uiSlot = udpPeerFindSlot(pstTable, udpPeerHash(pstAddr, iAddrLen), pstAddr, iAddrLen);
+    return uiSlot == UDP_PEER_NONE ? NULL : &pstTable->pastPeer[pstTable->puiSlot[uiSlot]];
+}
+
+UDP_PEER* udpPeerTouch(UDP_PEER_TABLE* pstTable, const struct sockaddr* pstAddr, socklen_t iAddrLen,
+        uint64_t ulNowMs)
+{
+    if (!pstTable->pastPeer || !pstAddr || iAddrLen > (socklen_t)sizeof(struct sockaddr_storage))
+        return NULL;
+    uint32_t uiHash = udpPeerHash(pstAddr, iAddrLen);
+    uint32_t uiSlot = udpPeerFindSlot(pstTable, uiHash, pstAddr, iAddrLen);
+    uint32_t uiIdx;
+
+    if (uiSlot != UDP_PEER_NONE) {
+        uiIdx = pstTable->puiSlot[uiSlot];
+        if (pstTable->uiLruHead != uiIdx) {
+            udpPeerLruUnlink(pstTable, uiIdx);
+            udpPeerLruPushHead(pstTable, uiIdx);
+        }
+        pstTable->pastPeer[uiIdx].ulLastSeenMs = ulNowMs;
+        return &pstTable->pastPeer[uiIdx];
+    }
+
+    /* 새 상대: 자리가 없으면 가장 오래 조용한 상대를 내보낸다 */
+    if (pstTable->uiCount == pstTable->uiMaxPeers) {
+        udpPeerRemove(pstTable, &pstTable->pastPeer[pstTable->uiLruTail]);
+        pstTable->ulEvictCnt++;
+    }
+    uiIdx = pstTable->uiFreeHead;
+    UDP_PEER* pstPeer = &pstTable->pastPeer[uiIdx];
+    pstTable->uiFreeHead = pstPeer->uiLruNext;
+    memset(pstPeer, 0, sizeof(*pstPeer));
+    memcpy(&pstPeer->stAddr, pstAddr, iAddrLen);
+    pstPeer->iAddrLen           = iAddrLen;
+    pstPeer->uiHash             = uiHash;
+    pstPeer->chUsed             = 1;
+    pstPeer->ulLastSeenMs       = ulNowMs;
+    pstPeer->stMsgId.uchSrcId   = pstTable->uchMyId;
+
+    uiSlot = uiHash & pstTable->uiSlotMask;
+    while (pstTable->puiSlot[uiSlot] != UDP_PEER_NONE)
+        uiSlot = (uiSlot + 1) & pstTable->uiSlotMask;
+    pstTable->puiSlot[uiSlot] = uiIdx;
+    udpPeerLruPushHead(pstTable, uiIdx);
+    pstTable->uiCount++;
+    return pstPeer;
+}
+
+void udpPeerLearnId(UDP_PEER_TABLE* pstTable, UDP_PEER* pstPeer, unsigned char uchPeerId)
+{
+    uint32_t uiIdx = (uint32_t)(pstPeer - pstTable->pastPeer);
+    if (pstPeer->chIdKnown && pstPeer->stMsgId.uchDstId != uchPeerId &&
+            pstTable->auiIdIndex[pstPeer->stMsgId.uchDstId] == uiIdx)
+        pstTable->auiIdIndex[pstPeer->stMsgId.uchDstId] = UDP_PEER_NONE;
+    pstPeer->stMsgId.uchDstId   = uchPeerId;
+    pstPeer->chIdKnown          = 1;
+    pstTable->auiIdIndex[uchPeerId] = uiIdx;
+}
+
+UDP_PEER* udpPeerFindId(const UDP_PEER_TABLE* pstTable, unsigned char uchPeerId)
+{
+    if (!pstTable->pastPeer || pstTable->auiIdIndex[uchPeerId] == UDP_PEER_NONE)
+        return NULL;
+    return &pstTable->pastPeer[pstTable->auiIdIndex[uchPeerId]];
+}
+
+void udpPeerRemove(UDP_PEER_TABLE* pstTable, UDP_PEER* pstPeer)
+{
+    if (!pstPeer || !pstPeer->chUsed)
+        return;
+    if (pstTable->pfnRemove)
+        pstTable->pfnRemove(pstPeer, pstTable->pvRemoveUser);
+    uint32_t uiIdx = (uint32_t)(pstPeer - pstTable->pastPeer);
+    udpPeerSlotDelete(pstTable, uiIdx);
+    udpPeerLruUnlink(pstTable, uiIdx);
+    if (pstPeer->chIdKnown && pstTable->auiIdIndex[pstPeer->stMsgId.uchDstId] == uiIdx)
+        pstTable->auiIdIndex[pstPeer->stMsgId.uchDstId] = UDP_PEER_NONE;
+    pstPeer->chUsed     = 0;
+    pstPeer->uiLruNext  = pstTable->uiFreeHead;
+    pstTable->uiFreeHead = uiIdx;
+    pstTable->uiCount--;
+}
+
+/* LRU 꼬리부터 보므로 유휴가 아닌 상대를 만나면 멈춘다 */
+int udpPeerExpire(UDP_PEER_TABLE* pstTable, uint64_t ulNowMs)
+{
+    int iExpired = 0;
+    if (!pstTable->pastPeer || pstTable->uiIdleMs == 0)
+        return 0;
+    while (pstTable->uiLruTail != UDP_PEER_NONE) {
+        UDP_PEER* pstPeer = &pstTable->pastPeer[pstTable->uiLruTail];
+        if (pstPeer->ulLastSeenMs + pstTable->uiIdleMs > ulNowMs)
+            break;
+        udpPeerRemove(pstTable, pstPeer);
+        iExpired++;
+    }
+    pstTable->ulIdleCnt += (unsigned long)iExpired;
+    return iExpired;
+}
@@ -0,0 +1,77 @@
+#ifndef UDP_PEER_H
+#define UDP_PEER_H
+
+#include <event2/event.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include "../core/frame.h"
+
+/*
+ * UDP 상대별 세션 테이블 (소켓 하나로 여러 상대)
+ *  - 수신 주소(sockaddr) → 가벼운 세션(MSG_ID, 카운터, 마지막 수신 시각)
+ *  - 개방 주소법(선형 탐사) 해시, 삭제는 뒤 항목을 당겨 채운다 (묘비 없음)
+ *  - 가득 차면 가장 오래 조용한 상대(LRU 꼬리)를 밀어내고, 주기 타이머가 유휴 상대를 정리
+ *  - 단일 스레드: 테이블을 만든 event_base 스레드에서만 사용
+ */
+#define UDP_PEER_MAX_DEFAULT        1024
+#define UDP_PEER_IDLE_MS_DEFAULT    60000   /* 이 시간 동안 수신이 없으면 제거 (0: 유휴 정리 안 함) */
+#define UDP_PEER_NONE               0xFFFFFFFFu
+#define UDP_PEER_ID_BUCKETS         256     /* MSG_ID 가 1바이트 */
+
+typedef struct {
+    struct sockaddr_storage stAddr;
+    socklen_t               iAddrLen;
+    uint32_t                uiHash;
+    MSG_ID                  stMsgId;            /* uchSrcId: 나, uchDstId: 상대 (수신 프레임에서 학습) */
+    char                    chUsed;
+    char                    chIdKnown;
+    uint64_t                ulLastSeenMs;
+    uint32_t                uiLruPrev;          /* 최근 수신 순서 (머리: 가장 최근) */
+    uint32_t                uiLruNext;
+    unsigned long           ulRxDgramCnt;
+    unsigned long           ulRxFrameCnt;
+    unsigned long           ulRxBytes;
+    unsigned long           ulTxFrameCnt;
+    unsigned long           ulTxBytes;
+    struct udp_rel          *pstRel;            /* 신뢰 전송 상태 (udpReliable.h, NULL: 없음) */
+} UDP_PEER;
+
+/* 항목이 제거되기 직전 호출 (밀려남/유휴/직접 제거/테이블 해제) */
+typedef void (*UDP_PEER_CB)(UDP_PEER* pstPeer, void* pvUser);
+
+typedef struct {
+    UDP_PEER        *pastPeer;          /* uiMaxPeers 개, 항목 위치는 제거될 때까지 고정 */
+    uint32_t        *puiSlot;           /* 해시 슬롯 → 항목 번호 (UDP_PEER_NONE: 빈 슬롯) */
+    uint32_t        uiSlotMask;         /* 슬롯 수 - 1 (2의 거듭제곱, 항목 수의 두 배 이상) */
+    uint32_t        uiMaxPeers;
+    uint32_t        uiCount;
+    uint32_t        uiFreeHead;         /* 빈 항목 목록 (uiLruNext 로 연결) */
+    uint32_t        uiLruHead;
+    uint32_t        uiLruTail;
+    uint32_t        auiIdIndex[UDP_PEER_ID_BUCKETS];    /* 상대 ID → 가장 최근 학습한 항목 */
+    unsigned int    uiIdleMs;
+    unsigned char   uchMyId;
+    struct event    *pstIdleEvent;
+    UDP_PEER_CB     pfnRemove;          /* NULL: 없음 */
+    void            *pvRemoveUser;
+    unsigned long   ulEvictCnt;         /* 가득 차서 밀려난 상대 */
+    unsigned long   ulIdleCnt;          /* 유휴로 정리된 상대 */
+} UDP_PEER_TABLE;
+
+/* pstEventBase NULL: 유휴 타이머 없이 udpPeerExpire 를 직접 호출. uiMaxPeers 0: 기본값 */
+int  udpPeerTableInit(UDP_PEER_TABLE* pstTable, struct event_base* pstEventBase, unsigned char uchMyId,
+        uint32_t uiMaxPeers, unsigned int uiIdleMs);
+void udpPeerTableFree(UDP_PEER_TABLE* pstTable);
+/* 수신 상대 갱신: 없으면 추가(가득 차면 LRU 꼬리 제거), 최근 순서 머리로. return: 항목, NULL 테이블 없음 */
+UDP_PEER* udpPeerTouch(UDP_PEER_TABLE* pstTable, const struct sockaddr* pstAddr, socklen_t iAddrLen,
+        uint64_t ulNowMs);
+UDP_PEER* udpPeerLookup(const UDP_PEER_TABLE* pstTable, const struct sockaddr* pstAddr, socklen_t iAddrLen);
+/* 수신 프레임의 송신자 ID 학습 (같은 ID 를 다른 주소가 쓰면 나중 주소가 이긴다) */
+void udpPeerLearnId(UDP_PEER_TABLE* pstTable, UDP_PEER* pstPeer, unsigned char uchPeerId);
+UDP_PEER* udpPeerFindId(const UDP_PEER_TABLE* pstTable, unsigned char uchPeerId);
+void udpPeerRemove(UDP_PEER_TABLE* pstTable, UDP_PEER* pstPeer);
+/* ulNowMs - uiIdleMs 이전에 마지막으로 수신한 상대 제거. return: 제거 수 */
+int  udpPeerExpire(UDP_PEER_TABLE* pstTable, uint64_t ulNowMs);
+uint64_t udpPeerNowMs(void);
+
+#endif /* UDP_PEER_H */
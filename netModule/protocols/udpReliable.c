@@ -0,0 +1,266 @@
+#include "udpReliable.h"
+#include <arpa/inet.h>
+#include <event2/buffer.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <time.h>
+
+uint64_t udpRelNowUs(void)
+{
+    struct timespec stTs;
+    clock_gettime(CLOCK_MONOTONIC, &stTs);
+    return (uint64_t)stTs.tv_sec * 1000000ull + (uint64_t)stTs.tv_nsec / 1000ull;
+}
+
+UDP_REL* udpRelNew(void* pvOwner, void* pvPeer)
+{
+    UDP_REL* pstRel = calloc(1, sizeof(UDP_REL));
+    if (!pstRel)
+        return NULL;
+    pstRel->pstBacklog = evbuffer_new();
+    if (!pstRel->pstBacklog) {
+        free(pstRel);
+        return NULL;
+    }
+    pstRel->pvOwner     = pvOwner;
+    pstRel->pvPeer      = pvPeer;
+    /* 세대: 같은 상대와의 이전 상태와 겹치지 않으면 충분 (난수를 못 얻으면 시각과 주소로) */
+    if (getrandom(&pstRel->uiEpoch, sizeof(pstRel->uiEpoch), GRND_NONBLOCK) != (ssize_t)sizeof(pstRel->uiEpoch))
+        pstRel->uiEpoch = (uint32_t)udpRelNowUs() ^ (uint32_t)(uintptr_t)pstRel;
+    if (pstRel->uiEpoch == 0)
+        pstRel->uiEpoch = 1;
+    pstRel->uiNextSeq   = 1;
+    pstRel->uiSndUna    = 1;
+    pstRel->uiRtoMs     = UDP_REL_RTO_INIT_MS;
+    return pstRel;
+}
+
+static void udpRelDrop(UDP_REL_ENTRY* pstEntry, SLAB_POOL* pstPool)
+{
+    slabPoolFree(pstPool, pstEntry->puchData);
+    pstEntry->puchData  = NULL;
+    pstEntry->chFast    = 0;
+}
+
+void udpRelFree(UDP_REL* pstRel, SLAB_POOL* pstPool, TIMER_WHEEL* pstWheel)
+{
+    if (!pstRel)
+        return;
+    timerWheelCancel(pstWheel, &pstRel->stRtoTimer);
+    for (int i = 0; i < UDP_REL_WINDOW; i++)
+        if (pstRel->astWindow[i].puchData)
+            udpRelDrop(&pstRel->astWindow[i], pstPool);
+    evbuffer_free(pstRel->pstBacklog);
+    free(pstRel);
+}
+
+/* 앞쪽의 확인된 칸을 건너뛴다 (SACK 으로 먼저 비워진 칸 포함) */
+static void udpRelAdvanceUna(UDP_REL* pstRel)
+{
+    while (pstRel->uiSndUna != pstRel->uiNextSeq &&
+            !pstRel->astWindow[pstRel->uiSndUna % UDP_REL_WINDOW].puchData)
+        pstRel->uiSndUna++;
+}
+
+/* ================================================================
+ * 송신
+ * ================================================================ */
+void udpRelBuildHeader(UDP_REL* pstRel, unsigned char uchFlags, uint32_t uiSeq, UDP_REL_HEADER* pstHeader)
+{
+    memset(pstHeader, 0, sizeof(*pstHeader));
+    pstHeader->unMagic = htons(UDP_REL_MAGIC);
+    if (uchFlags & UDP_REL_FLAG_DATA) {
+        pstHeader->uiEpoch  = htonl(pstRel->uiEpoch);
+        pstHeader->uiSeq    = htonl(uiSeq);
+        pstHeader->uiUna    = htonl(pstRel->uiSndUna);
+    }
+    if (pstRel->chRcvInit) {
+        uchFlags |= UDP_REL_FLAG_ACK;
+        pstHeader->uiAckEpoch   = htonl(pstRel->uiPeerEpoch);
+        pstHeader->uiAck        = htonl(pstRel->uiRcvNext - 1);
+        pstHeader->uiSackBits   = htonl(pstRel->uiRcvBits);
+        pstRel->chAckPending    = 0;
+    }
+    pstHeader->uchFlags = uchFlags;
+}
+
+UDP_REL_ENTRY* udpRelTrack(UDP_REL* pstRel, SLAB_POOL* pstPool, unsigned int uiLen, uint64_t ulNowUs)
+{
+    if (udpRelWindowFull(pstRel) || uiLen > pstPool->ulObjSize)
+        return NULL;
+    UDP_REL_ENTRY* pstEntry = &pstRel->astWindow[pstRel->uiNextSeq % UDP_REL_WINDOW];
+    pstEntry->puchData = slabPoolAlloc(pstPool);
+    if (!pstEntry->puchData)
+        return NULL;
+    pstEntry->uiLen     = uiLen;
+    pstEntry->uiSeq     = pstRel->uiNextSeq++;
+    pstEntry->ulSentUs  = ulNowUs;
+    pstEntry->uchTxCnt  = 1;
+    pstEntry->chFast    = 0;
+    return pstEntry;
+}
+
+/* === RFC 6298: 재전송한 항목의 확인은 어느 송신에 대한 것인지 모르므로 표본으로 쓰지 않는다 (Karn) === */
+static void udpRelRttSample(UDP_REL* pstRel, uint64_t ulRttUs)
+{
+    uint32_t uiRtt = ulRttUs > 60000000ull ? 60000000u : (uint32_t)ulRttUs;
+    if (pstRel->uiSrttUs == 0) {
+        pstRel->uiSrttUs    = uiRtt ? uiRtt : 1;
+        pstRel->uiRttVarUs  = uiRtt / 2;
+    } else {
+        uint32_t uiDelta = pstRel->uiSrttUs > uiRtt ? pstRel->uiSrttUs - uiRtt : uiRtt - pstRel->uiSrttUs;
+        pstRel->uiRttVarUs  = (3 * pstRel->uiRttVarUs + uiDelta) / 4;
+        pstRel->uiSrttUs    = (7 * pstRel->uiSrttUs + uiRtt) / 8;
+    }
+    uint32_t uiVar = 4 * pstRel->uiRttVarUs;
+    if (uiVar < UDP_REL_TICK_MS * 1000u)
+        uiVar = UDP_REL_TICK_MS * 1000u;
+    unsigned int uiRtoMs = (pstRel->uiSrttUs + uiVar + 999) / 1000;
+    if (uiRtoMs < UDP_REL_RTO_MIN_MS)
+        uiRtoMs = UDP_REL_RTO_MIN_MS;
+    if (uiRtoMs > UDP_REL_RTO_MAX_MS)
+        uiRtoMs = UDP_REL_RTO_MAX_MS;
+    pstRel->uiRtoMs = uiRtoMs;
+}
+
+int udpRelOnAck(UDP_REL* pstRel, SLAB_POOL* pstPool, uint32_t uiAckEpoch, uint32_t uiAck, uint32_t uiSackBits,
+        uint64_t ulNowUs)
+{
+    /* 이전 세대(상태를 잃기 전)의 순번을 가리키는 확인, 보낸 적 없는 순번까지 확인하는 헤더는 무시 */
+    if (uiAckEpoch != pstRel->uiEpoch || (int32_t)(uiAck - (pstRel->uiNextSeq - 1)) > 0)
+        return 0;
+
+    int iAcked = 0;
+    uint64_t ulSampleSentUs = 0;
+    for (uint32_t uiSeq = pstRel->uiSndUna; uiSeq != pstRel->uiNextSeq; uiSeq++) {
+        UDP_REL_ENTRY* pstEntry = &pstRel->astWindow[uiSeq % UDP_REL_WINDOW];
+        if (!pstEntry->puchData)
+            continue;
+        int32_t iDist = (int32_t)(uiSeq - uiAck);
+        if (iDist > 0 && (iDist < 2 || iDist - 2 >= 32 || !((uiSackBits >> (iDist - 2)) & 1)))
+            continue;
+        if (pstEntry->uchTxCnt == 1 && pstEntry->ulSentUs > ulSampleSentUs)
+            ulSampleSentUs = pstEntry->ulSentUs;
+        udpRelDrop(pstEntry, pstPool);
+        iAcked++;
+    }
+    if (ulSampleSentUs && ulNowUs >= ulSampleSentUs)
+        udpRelRttSample(pstRel, ulNowUs - ulSampleSentUs);
+
+    /* 빠른 재전송: 뒤 순번이 UDP_REL_DUP_THRESH 개 이상 먼저 도착했으면 손실로 본다 (한 번만) */
+    if (uiSackBits) {
+        uint32_t uiHigh = uiAck + 2 + (31 - (uint32_t)__builtin_clz(uiSackBits));
+        for (uint32_t uiSeq = pstRel->uiSndUna; (int32_t)(uiHigh - uiSeq) >= UDP_REL_DUP_THRESH; uiSeq++) {
+            UDP_REL_ENTRY* pstEntry = &pstRel->astWindow[uiSeq % UDP_REL_WINDOW];
+            if (pstEntry->puchData && pstEntry->uiSeq == uiSeq && pstEntry->uchTxCnt == 1)
+                pstEntry->chFast = 1;
+        }
+    }
+    udpRelAdvanceUna(pstRel);
+    return iAcked;
+}
+
+int udpRelDue(UDP_REL* pstRel, SLAB_POOL* pstPool, uint64_t ulNowUs, UDP_REL_ENTRY** apstDue)
+{
+    uint64_t ulRtoUs = (uint64_t)pstRel->uiRtoMs * 1000ull;
+    int iDue = 0, iTimeout = 0;
+    for (uint32_t uiSeq = pstRel->uiSndUna; uiSeq != pstRel->uiNextSeq; uiSeq++) {
+        UDP_REL_ENTRY* pstEntry = &pstRel->astWindow[uiSeq % UDP_REL_WINDOW];
+        if (!pstEntry->puchData || pstEntry->uiSeq != uiSeq)
+            continue;
+        if (!pstEntry->chFast && ulNowUs - pstEntry->ulSentUs < ulRtoUs)
+            continue;
+        iTimeout |= !pstEntry->chFast;
+        pstRel->ulFastCnt += pstEntry->chFast && pstEntry->uchTxCnt <= UDP_REL_MAX_RETRY;
+        if (pstEntry->uchTxCnt > UDP_REL_MAX_RETRY) {
+            udpRelDrop(pstEntry, pstPool);
+            pstRel->ulGiveUpCnt++;
+            continue;
+        }
+        pstEntry->chFast    = 0;
+        pstEntry->uchTxCnt++;
+        pstEntry->ulSentUs  = ulNowUs;
+        apstDue[iDue++]     = pstEntry;
+        pstRel->ulRetxCnt++;
+    }
+    /* 만료는 혼잡/경로 변화의 신호: 다음 표본이 올 때까지 RTO 를 두 배로 */
+    if (iTimeout) {
+        pstRel->uiRtoMs *= 2;
+        if (pstRel->uiRtoMs > UDP_REL_RTO_MAX_MS)
+            pstRel->uiRtoMs = UDP_REL_RTO_MAX_MS;
+    }
+    udpRelAdvanceUna(pstRel);
+    return iDue;
+}
+
+void udpRelArm(UDP_REL* pstRel, TIMER_WHEEL* pstWheel, uint64_t ulNowUs, TIMER_CB pfnCallback)
+{
+    uint64_t ulRtoUs = (uint64_t)pstRel->uiRtoMs * 1000ull;
+    uint64_t ulDueUs = UINT64_MAX;
+    for (uint32_t uiSeq = pstRel->uiSndUna; uiSeq != pstRel->uiNextSeq; uiSeq++) {
+        const UDP_REL_ENTRY* pstEntry = &pstRel->astWindow[uiSeq % UDP_REL_WINDOW];
+        if (!pstEntry->puchData || pstEntry->uiSeq != uiSeq)
+            continue;
+        uint64_t ulAt = pstEntry->chFast ? ulNowUs : pstEntry->ulSentUs + ulRtoUs;
+        if (ulAt < ulDueUs)
+            ulDueUs = ulAt;
+    }
+    if (ulDueUs == UINT64_MAX) {
+        timerWheelCancel(pstWheel, &pstRel->stRtoTimer);
+        return;
+    }
+    unsigned int uiMs = ulDueUs > ulNowUs ? (unsigned int)((ulDueUs - ulNowUs + 999) / 1000) : 0;
+    timerWheelAdd(pstWheel, &pstRel->stRtoTimer, uiMs, pfnCallback, pstRel);
+}
+
+/* ================================================================
+ * 수신
+ * ================================================================ */
+/* uiRcvNext 를 받은 것으로 하고 이어서 받아 둔 순번까지 전진 */
+static void udpRelRcvStep(UDP_REL* pstRel)
+{
+    pstRel->uiRcvNext++;
+    while (pstRel->uiRcvBits & 1) {
+        pstRel->uiRcvBits >>= 1;
+        pstRel->uiRcvNext++;
+    }
+    pstRel->uiRcvBits >>= 1;
+}
+
+int udpRelOnData(UDP_REL* pstRel, uint32_t uiEpoch, uint32_t uiSeq, uint32_t uiUna)
+{
+    /* 처음 만난 상대, 또는 상대가 상태를 새로 만들었으면(세대 변경) 송신 측이 보관 중인 가장 오래된 순번부터.
+     * 이쪽이 상태를 잃은 경우는 chRcvInit 0 으로 같은 경로 */
+    if (!pstRel->chRcvInit || uiEpoch != pstRel->uiPeerEpoch) {
+        pstRel->chRcvInit   = 1;
+        pstRel->uiPeerEpoch = uiEpoch;
+        pstRel->uiRcvNext   = uiUna;
+        pstRel->uiRcvBits   = 0;
+    }
+    pstRel->chAckPending = 1;
+
+    /* 송신 측이 포기한 순번은 기다리지 않는다 */
+    int32_t iSkip = (int32_t)(uiUna - pstRel->uiRcvNext);
+    if (iSkip > UDP_REL_WINDOW) {
+        pstRel->uiRcvNext   = uiUna;
+        pstRel->uiRcvBits   = 0;
+    } else {
+        while ((int32_t)(uiUna - pstRel->uiRcvNext) > 0)
+            udpRelRcvStep(pstRel);
+    }
+
+    int32_t iDist = (int32_t)(uiSeq - pstRel->uiRcvNext);
+    if (iDist < 0)
+        return 0;
+    if (iDist == 0) {
+        udpRelRcvStep(pstRel);
+        return 1;
+    }
+    if (iDist - 1 >= 32)
+        return -1;
+    if ((pstRel->uiRcvBits >> (iDist - 1)) & 1)
+        return 0;
+    pstRel->uiRcvBits |= 1u << (iDist - 1);
+    return 1;
+}
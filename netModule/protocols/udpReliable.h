@@ -0,0 +1,107 @@
+#ifndef UDP_RELIABLE_H
+#define UDP_RELIABLE_H
+
+#include <stdint.h>
+#include "../core/slabPool.h"
+#include "../core/timerWheel.h"
+
+/*
+ * UDP 신뢰 전송 계층 (상대별 순번/창/선택 확인/재전송)
+ *  - 데이터그램 앞에 UDP_REL_HEADER 를 붙인다 (프레임 코덱은 그대로)
+ *  - 신뢰 프레임(DATA)은 상대별 순번을 받고 확인될 때까지 사본을 창에 보관
+ *  - 확인(누적 + 32비트 SACK)은 같은 상대로 나가는 모든 데이터그램에 얹고, 얹을 곳이 없으면 확인만 보낸다
+ *  - 수신 측은 도착 순서대로 바로 전달하고 중복만 걸러낸다 (순서 대기 없음: 앞 손실이 뒤를 막지 않음)
+ *  - 재전송: RTO(RFC 6298 SRTT/RTTVAR, Karn) 만료 또는 뒤 순번이 UDP_REL_DUP_THRESH 개 이상 확인되면 즉시
+ *  - 상태마다 임의의 세대(epoch)를 두어, 한쪽이 상태를 잃고 순번 1 부터 다시 시작해도
+ *    상대는 수신 상태를 새로 잡고(DATA) 옛 세대의 확인은 버린다(ACK)
+ *  - 단일 스레드: UDP 컨텍스트의 event_base 스레드에서만 사용
+ */
+#define UDP_REL_MAGIC           0xAA5A  /* 프레임 STX(0xAA55/0xAA56)와 구분 */
+#define UDP_REL_FLAG_DATA       0x01    /* 신뢰 프레임이 뒤따름 (uiSeq 유효) */
+#define UDP_REL_FLAG_ACK        0x02    /* uiAck/uiSackBits 유효 */
+
+#define UDP_REL_WINDOW          32      /* 확인 대기 최대 수 (SACK 비트 수와 같음) */
+#define UDP_REL_TICK_MS         5       /* 재전송 타이머 휠 해상도 */
+#define UDP_REL_RTO_INIT_MS     200
+#define UDP_REL_RTO_MIN_MS      20
+#define UDP_REL_RTO_MAX_MS      2000
+#define UDP_REL_MAX_RETRY       8       /* 초과하면 포기 (요청 쪽은 응답 대기 시간 초과로 알게 된다) */
+#define UDP_REL_DUP_THRESH      3       /* 빠른 재전송: 뒤 순번이 이만큼 먼저 확인되면 */
+
+/* 네트워크 바이트 순서 */
+typedef struct __attribute__((__packed__)) {
+    unsigned short  unMagic;
+    unsigned char   uchFlags;           /* UDP_REL_FLAG_* */
+    unsigned char   uchReserved;
+    unsigned int    uiEpoch;            /* DATA: 송신 측 상태의 세대 */
+    unsigned int    uiSeq;              /* DATA: 이 프레임의 순번 */
+    unsigned int    uiUna;              /* DATA: 송신 측이 아직 보관 중인 가장 오래된 순번 (그 이전은 받지 않아도 된다) */
+    unsigned int    uiAckEpoch;         /* ACK: 확인하는 순번의 세대 (상대의 uiEpoch) */
+    unsigned int    uiAck;              /* ACK: 연속으로 받은 마지막 순번 */
+    unsigned int    uiSackBits;         /* ACK: 비트 i = uiAck + 2 + i 수신 */
+} UDP_REL_HEADER;
+
+typedef struct {
+    unsigned char   *puchData;          /* 프레임 사본 (NULL: 빈 칸) */
+    unsigned int    uiLen;
+    uint32_t        uiSeq;
+    uint64_t        ulSentUs;           /* 마지막 송신 시각 */
+    unsigned char   uchTxCnt;
+    char            chFast;             /* 빠른 재전송 대상 */
+} UDP_REL_ENTRY;
+
+typedef struct udp_rel {
+    void            *pvOwner;           /* UDP_CTX */
+    void            *pvPeer;            /* UDP_PEER (NULL: connect 된 상대) */
+    TIMER_NODE      stRtoTimer;
+
+    /* 송신 */
+    uint32_t        uiEpoch;            /* 0 이 아닌 임의 값 */
+    uint32_t        uiNextSeq;
+    uint32_t        uiSndUna;
+    UDP_REL_ENTRY   astWindow[UDP_REL_WINDOW];      /* 순번 % UDP_REL_WINDOW */
+    struct evbuffer *pstBacklog;        /* 창이 차서 대기 중인 신뢰 프레임 */
+    uint32_t        uiSrttUs;           /* 0: 표본 없음 */
+    uint32_t        uiRttVarUs;
+    unsigned int    uiRtoMs;
+
+    /* 수신 */
+    char            chRcvInit;
+    char            chAckPending;       /* 상대에게 알릴 확인 정보가 바뀜 */
+    uint32_t        uiPeerEpoch;        /* 수신 상태가 따르는 상대 세대 */
+    uint32_t        uiRcvNext;          /* 다음 연속 순번 */
+    uint32_t        uiRcvBits;          /* 비트 i = uiRcvNext + 1 + i 수신 */
+
+    unsigned long   ulRetxCnt;          /* 재전송 (빠른 재전송 포함) */
+    unsigned long   ulFastCnt;          /* 빠른 재전송 */
+    unsigned long   ulGiveUpCnt;        /* 재시도 초과로 버린 프레임 */
+} UDP_REL;
+
+uint64_t udpRelNowUs(void);
+UDP_REL* udpRelNew(void* pvOwner, void* pvPeer);
+void     udpRelFree(UDP_REL* pstRel, SLAB_POOL* pstPool, TIMER_WHEEL* pstWheel);
+
+static inline int udpRelWindowFull(const UDP_REL* pstRel)
+{
+    return pstRel->uiNextSeq - pstRel->uiSndUna >= UDP_REL_WINDOW;
+}
+static inline unsigned int udpRelOutstanding(const UDP_REL* pstRel)
+{
+    return pstRel->uiNextSeq - pstRel->uiSndUna;
+}
+
+/* 송신 헤더 작성 (확인 정보를 실었으면 chAckPending 해제). uchFlags: UDP_REL_FLAG_DATA 또는 0 */
+void udpRelBuildHeader(UDP_REL* pstRel, unsigned char uchFlags, uint32_t uiSeq, UDP_REL_HEADER* pstHeader);
+/* 새 신뢰 프레임 등록: 순번 부여, uiLen 크기 사본 공간 할당 (NULL: 창이 참/메모리 부족) */
+UDP_REL_ENTRY* udpRelTrack(UDP_REL* pstRel, SLAB_POOL* pstPool, unsigned int uiLen, uint64_t ulNowUs);
+/* 확인 처리. return: 새로 확인된 수 (빠른 재전송 대상은 chFast 표시) */
+int  udpRelOnAck(UDP_REL* pstRel, SLAB_POOL* pstPool, uint32_t uiAckEpoch, uint32_t uiAck, uint32_t uiSackBits,
+        uint64_t ulNowUs);
+/* 신뢰 프레임 수신 (세대가 바뀌면 수신 상태를 새로). return: 1 전달, 0 중복, -1 창 밖 (모두 확인 정보는 갱신) */
+int  udpRelOnData(UDP_REL* pstRel, uint32_t uiEpoch, uint32_t uiSeq, uint32_t uiUna);
+/* 지금 다시 보낼 항목 (RTO 만료/빠른 재전송). 재시도 초과 항목은 버린다. return: apstDue 에 채운 수 */
+int  udpRelDue(UDP_REL* pstRel, SLAB_POOL* pstPool, uint64_t ulNowUs, UDP_REL_ENTRY** apstDue);
+/* 가장 이른 재전송 시각에 타이머 예약 (대기 항목이 없으면 취소) */
+void udpRelArm(UDP_REL* pstRel, TIMER_WHEEL* pstWheel, uint64_t ulNowUs, TIMER_CB pfnCallback);
+
+#endif /* UDP_RELIABLE_H */
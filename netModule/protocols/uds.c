@@ -9,37 +9,57 @@
 #include <unistd.h>
 
 void udsSvrInit(UDS_SERVER_CTX* pstUdsSrvCtx, struct event_base* pstEventBase,
-    unsigned char uchMyId, NET_MODE eMode)
+    unsigned char uchMyId, NET_MODE eMode, unsigned int uiSessionPrealloc)
 {
     netBaseInit(&pstUdsSrvCtx->stNetBase, pstEventBase, uchMyId, eMode);
-    pstUdsSrvCtx->pstClnConnectEvent = NULL;
+    if (sessionPoolReserve(&pstUdsSrvCtx->stNetBase.stCoreCtx, uiSessionPrealloc) < 0)
+        fprintf(stderr, "[UDS SERVER] session pool prealloc(%u) failed\n", uiSessionPrealloc);
+    pstUdsSrvCtx->pstListener = NULL;
+    memset(&pstUdsSrvCtx->stRateLimit, 0, sizeof(pstUdsSrvCtx->stRateLimit));
+}
+
+int udsSvrSetRateLimit(UDS_SERVER_CTX* pstUdsSrvCtx, const SESSION_RATE_LIMIT* pstLimit)
+{
+    if (pstUdsSrvCtx->pstListener)
+        return -1;//UDS_ERR_ALREADY_STARTED
+    if (pstLimit)
+        pstUdsSrvCtx->stRateLimit = *pstLimit;
+    else
+        memset(&pstUdsSrvCtx->stRateLimit, 0, sizeof(pstUdsSrvCtx->stRateLimit));
+    return 0;
 }
 
 /* ================================================================
  * 클라이언트 접속 수락 콜백 (accept)
  * ================================================================ */
-static void udsAcceptCb(evutil_socket_t fd, short ev, void* pvData)
+static void udsAcceptCb(NET_LISTENER* pstListener, evutil_socket_t client_fd,
+    struct sockaddr* addr, socklen_t socklen, void* pvData)
 {
-    (void)ev;
+    (void)pstListener;
+    (void)addr;
+    (void)socklen;
     UDS_SERVER_CTX* pstUdsSrvCtx = (UDS_SERVER_CTX*)pvData;
 
-    struct sockaddr_un client_addr;
-    socklen_t len = sizeof(client_addr);
-    int client_fd = accept(fd, (struct sockaddr*)&client_addr, &len);
-    if (client_fd < 0) {
-        perror("[UDS SERVER] accept failed");
+    SESSION_CTX* pstSession = sessionAlloc(&pstUdsSrvCtx->stNetBase.stCoreCtx);
+    if (!pstSession) {
+        fprintf(stderr, "[UDS SERVER] session alloc failed\n");
+        close(client_fd);
         return;
     }
-
-    SESSION_CTX* pstSession = calloc(1, sizeof(*pstSession));
-    pstSession->pstCoreCtx = &pstUdsSrvCtx->stNetBase.stCoreCtx;
     pstSession->pstBufferEvent = bufferevent_socket_new(
         pstUdsSrvCtx->stNetBase.stCoreCtx.pstEventBase, 
         client_fd, 
         BEV_OPT_CLOSE_ON_FREE);
+    if (!pstSession->pstBufferEvent) {
+        fprintf(stderr, "[UDS SERVER] bufferevent_socket_new failed\n");
+        sessionRelease(pstSession);
+        close(client_fd);
+        return;
+    }
 
     bufferevent_setcb(pstSession->pstBufferEvent, 
         sessionReadCallback, NULL, sessionEventCallback, pstSession);
+    sessionSetupFrame(pstSession);
     bufferevent_enable(pstSession->pstBufferEvent, EV_READ | EV_WRITE);
 
     sessionAdd(pstSession, &pstUdsSrvCtx->stNetBase.stCoreCtx);
@@ -54,6 +74,11 @@ static void udsAcceptCb(evutil_socket_t fd, short ev, void* pvData)
  * ================================================================ */
 int udsServerStart(UDS_SERVER_CTX *pstUdsSrvCtx, const char *pchPath)
 {
+    if (sessionSetRateLimit(&pstUdsSrvCtx->stNetBase.stCoreCtx, &pstUdsSrvCtx->stRateLimit) < 0) {
+        fprintf(stderr, "[UDS SERVER] rate limit setup failed\n");
+        return -1;
+    }
+
     unlink(pchPath);
     pstUdsSrvCtx->stNetBase.iSockFd = createUdsServer(pchPath);
     if (pstUdsSrvCtx->stNetBase.iSockFd < 0) {
@@ -61,15 +86,19 @@ int udsServerStart(UDS_SERVER_CTX *pstUdsSrvCtx, const char *pchPath)
         return -1;
     }
 
-    // 클라이언트 접속 대기용 이벤트 등록
-    pstUdsSrvCtx->pstClnConnectEvent = event_new(
+    // 클라이언트 접속 대기: 깨어날 때마다 backlog 를 한꺼번에 수락 (리슨 fd 는 리스너가 소유)
+    pstUdsSrvCtx->pstListener = netListenerNew(
         pstUdsSrvCtx->stNetBase.stCoreCtx.pstEventBase,
         pstUdsSrvCtx->stNetBase.iSockFd,
-        EV_READ | EV_PERSIST,
+        NET_LISTENER_BUDGET_DEFAULT,
         udsAcceptCb,
         pstUdsSrvCtx);
-
-    event_add(pstUdsSrvCtx->pstClnConnectEvent, NULL);
+    if (!pstUdsSrvCtx->pstListener) {
+        fprintf(stderr, "[UDS SERVER] listener setup failed\n");
+        close(pstUdsSrvCtx->stNetBase.iSockFd);
+        pstUdsSrvCtx->stNetBase.iSockFd = -1;
+        return -1;
+    }
 
     printf("[UDS SERVER] Listening on %s\n", pchPath);
     return 0;
@@ -83,29 +112,20 @@ void udsSvrStop(UDS_SERVER_CTX *pstUdsSrvCtx)
     CORE_CTX* pstCoreCtx = &pstUdsSrvCtx->stNetBase.stCoreCtx;
 
     // 세션 정리
-    SESSION_CTX* pstSessionCtx = pstCoreCtx->pstSockCtxHead;
-    while (pstSessionCtx) {
-        SESSION_CTX* pstNextSessionCtx = pstSessionCtx->pstSockCtxNext;
-        if (pstSessionCtx->pstBufferEvent) {
-            bufferevent_free(pstSessionCtx->pstBufferEvent);
-        }
-        free(pstSessionCtx);
-        pstSessionCtx = pstNextSessionCtx;
-    }
+    sessionCloseAll(pstCoreCtx);
 
-    pstCoreCtx->pstSockCtxHead = NULL;
-    pstCoreCtx->iClientCount = 0;
-
-    // 이벤트 해제
-    if (pstUdsSrvCtx->pstClnConnectEvent) {
-        event_free(pstUdsSrvCtx->pstClnConnectEvent);
-        pstUdsSrvCtx->pstClnConnectEvent = NULL;
+    // 리스너 해제 (리슨 소켓 close)
+    if (pstUdsSrvCtx->pstListener) {
+        netListenerFree(pstUdsSrvCtx->pstListener);
+        pstUdsSrvCtx->pstListener = NULL;
+        pstUdsSrvCtx->stNetBase.iSockFd = -1;
     }
 
     if (pstUdsSrvCtx->stNetBase.iSockFd >= 0) {
         close(pstUdsSrvCtx->stNetBase.iSockFd);
         pstUdsSrvCtx->stNetBase.iSockFd = -1;
     }
+    sessionFreeCore(pstCoreCtx);
 
     printf("[UDS SERVER] Stopped and cleaned up.\n");
 }
@@ -117,6 +137,7 @@ void udsClnInit(UDS_CLIENT_CTX *pstUdsClnCtx, struct event_base *pstEventBase,
 {
     netBaseInit(&pstUdsClnCtx->stNetBase, pstEventBase, uchMyId, eMode);
     pstUdsClnCtx->pstBufferEvent = NULL;
+    memset(&pstUdsClnCtx->stSession, 0, sizeof(pstUdsClnCtx->stSession));
 }
 
 int udsClientStart(UDS_CLIENT_CTX *pstUdsClnCtx, const char *pchPath)
@@ -135,8 +156,14 @@ int udsClientStart(UDS_CLIENT_CTX *pstUdsClnCtx, const char *pchPath)
         return -1;
     }
 
-    bufferevent_setcb(pstUdsClnCtx->pstBufferEvent, 
-        sessionReadCallback, NULL, sessionEventCallback, NULL);
+    if (sessionAttachClient(&pstUdsClnCtx->stSession, &pstUdsClnCtx->stNetBase.stCoreCtx,
+            pstUdsClnCtx->pstBufferEvent, pstUdsClnCtx->stNetBase.uchMyId,
+            pstUdsClnCtx->stNetBase.uchDstId) < 0) {
+        fprintf(stderr, "[UDS CLIENT] sessionAttachClient failed\n");
+        bufferevent_free(pstUdsClnCtx->pstBufferEvent);
+        pstUdsClnCtx->pstBufferEvent = NULL;
+        return -1;
+    }
     bufferevent_enable(pstUdsClnCtx->pstBufferEvent, EV_READ | EV_WRITE);
     return 0;
 }
@@ -144,7 +171,8 @@ int udsClientStart(UDS_CLIENT_CTX *pstUdsClnCtx, const char *pchPath)
 
 void udsClnStop(UDS_CLIENT_CTX *pstUdsClnCtx)
 {
-    // 1. 클라이언트 bufferevent 해제
+    // 1. 대기 중인 요청 취소 후 클라이언트 bufferevent 해제
+    sessionFreeState(&pstUdsClnCtx->stSession);
     if (pstUdsClnCtx->pstBufferEvent) {
         bufferevent_disable(pstUdsClnCtx->pstBufferEvent, EV_READ | EV_WRITE);
         bufferevent_free(pstUdsClnCtx->pstBufferEvent);   // fd 자동 close
@@ -159,5 +187,6 @@ void udsClnStop(UDS_CLIENT_CTX *pstUdsClnCtx)
     }
 
     pstUdsClnCtx->stNetBase.iSockFd = -1;
+    sessionFreeCore(&pstUdsClnCtx->stNetBase.stCoreCtx);
     printf("[UDS CLIENT] Stopped and cleaned up.\n");
 }
@@ -4,8 +4,11 @@
 #include "commonSession.h"
 #include "netContext.h"
 
+/* uiSessionPrealloc: 미리 확보할 세션 객체 수 (0: 필요할 때 슬랩 단위로 확장) */
 void udsSvrInit(UDS_SERVER_CTX *pstUdsSrvCtx, struct event_base* pstEventBase, 
-    unsigned char uchMyId, NET_MODE eMode);
+    unsigned char uchMyId, NET_MODE eMode, unsigned int uiSessionPrealloc);
+/* udsServerStart() 전에 호출: 수락한 연결의 속도 제한 (NULL: 해제) */
+int  udsSvrSetRateLimit(UDS_SERVER_CTX *pstUdsSrvCtx, const SESSION_RATE_LIMIT *pstLimit);
 int  udsServerStart(UDS_SERVER_CTX *pstUdsSrvCtx, const char *pchPath);
 void udsSvrStop(UDS_SERVER_CTX *pstUdsSrvCtx);
 
@@ -1,9 +1,11 @@
 #include "netModule/protocols/tcp.h"
+#include "netModule/core/trace.h"
 #include <event2/event.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 static void signalCallBack(evutil_socket_t sig, short ev, void *pvData)
 {
@@ -13,8 +15,82 @@ static void signalCallBack(evutil_socket_t sig, short ev, void *pvData)
     event_base_loopbreak(pstTcpCtx->stNetBase.stCoreCtx.pstEventBase);
 }
 
+/* SIGUSR1: 트레이스 링 덤프 + 세션 풀/유휴/느린 상대/속도 제한/리스너 상태 */
+static void traceDumpCallBack(evutil_socket_t sig, short ev, void *pvData)
+{
+    (void)sig; (void)ev;
+    const SLAB_POOL* pstPool = &((TCP_SERVER_CTX*)pvData)->stNetBase.stCoreCtx.stSessionPool;
+    long lTotal = traceDump(stderr);
+    printf("[TCP SERVER] %ld trace records dumped\n", lTotal);
+    printf("[TCP SERVER] session pool: in-use=%lu capacity=%lu hit=%lu miss=%lu\n",
+        pstPool->ulInUse, pstPool->ulCapacity, pstPool->ulHitCnt, pstPool->ulMissCnt);
+    printf("[TCP SERVER] worker handoff: dropped=%lu\n", ((TCP_SERVER_CTX*)pvData)->ulHandoffDropCnt);
+
+    /* 워커 카운터는 다른 스레드 값이므로 근사치 */
+    TCP_SERVER_CTX *pstTcpCtx = (TCP_SERVER_CTX *)pvData;
+    unsigned long ulKeepAlive = pstTcpCtx->stNetBase.stCoreCtx.ulKeepAliveCnt;
+    unsigned long ulIdleReap  = pstTcpCtx->stNetBase.stCoreCtx.ulIdleReapCnt;
+    for (int i = 0; i < pstTcpCtx->iWorkerCnt; i++) {
+        ulKeepAlive += pstTcpCtx->pastWorker[i].stCoreCtx.ulKeepAliveCnt;
+        ulIdleReap  += pstTcpCtx->pastWorker[i].stCoreCtx.ulIdleReapCnt;
+    }
+    printf("[TCP SERVER] idle: keepalive=%lu reaped=%lu\n", ulKeepAlive, ulIdleReap);
+
+    const CORE_CTX* pstCoreCtx = &pstTcpCtx->stNetBase.stCoreCtx;
+    unsigned long ulPause = pstCoreCtx->ulSlowPauseCnt;
+    unsigned long ulDrop  = pstCoreCtx->ulSlowDropCnt;
+    unsigned long ulKick  = pstCoreCtx->ulSlowDisconnectCnt;
+    for (int i = 0; i < pstTcpCtx->iWorkerCnt; i++) {
+        ulPause += pstTcpCtx->pastWorker[i].stCoreCtx.ulSlowPauseCnt;
+        ulDrop  += pstTcpCtx->pastWorker[i].stCoreCtx.ulSlowDropCnt;
+        ulKick  += pstTcpCtx->pastWorker[i].stCoreCtx.ulSlowDisconnectCnt;
+    }
+    printf("[TCP SERVER] slow consumer: paused=%lu dropped=%lu disconnected=%lu\n", ulPause, ulDrop, ulKick);
+
+    unsigned long ulThrottle = pstCoreCtx->ulRateLimitedCnt;
+    for (int i = 0; i < pstTcpCtx->iWorkerCnt; i++)
+        ulThrottle += pstTcpCtx->pastWorker[i].stCoreCtx.ulRateLimitedCnt;
+    printf("[TCP SERVER] rate limit: throttled=%lu\n", ulThrottle);
+
+    /* 리스너: 메인 하나 또는 SO_REUSEPORT 워커별 */
+    unsigned long ulWake = 0, ulAccept = 0, ulMaxBatch = 0, ulBackoff = 0;
+    for (int i = -1; i < pstTcpCtx->iWorkerCnt; i++) {
+        const NET_LISTENER* pstListener = (i < 0) ? pstTcpCtx->pstListener :
+            (pstTcpCtx->pastWorker ? pstTcpCtx->pastWorker[i].pstListener : NULL);
+        if (!pstListener)
+            continue;
+        ulWake    += pstListener->ulWakeCnt;
+        ulAccept  += pstListener->ulAcceptCnt;
+        ulBackoff += pstListener->ulBackoffCnt;
+        if (pstListener->ulMaxBatch > ulMaxBatch)
+            ulMaxBatch = pstListener->ulMaxBatch;
+    }
+    printf("[TCP SERVER] listener: wakeups=%lu accepted=%lu max-batch=%lu backoff=%lu\n",
+        ulWake, ulAccept, ulMaxBatch, ulBackoff);
+}
+
 int main(int argc, char *argv[])
 {
+    /* 유휴 정리/출력 상한/속도 제한은 옵션으로만 켠다 (기본: 기존 동작 그대로) */
+    unsigned int uiKeepAliveMs = 0, uiIdleTimeoutMs = 0;
+    size_t ulWriteHigh = 0, ulWriteLow = 0;
+    SESSION_RATE_LIMIT stRateLimit = { 0 };
+    int iOpt;
+    while ((iOpt = getopt(argc, argv, "k:w:f:")) != -1) {
+        switch (iOpt) {
+            case 'k': sscanf(optarg, "%u,%u", &uiKeepAliveMs, &uiIdleTimeoutMs); break;
+            case 'w': sscanf(optarg, "%zu,%zu", &ulWriteHigh, &ulWriteLow); break;
+            case 'f': sscanf(optarg, "%u,%u", &stRateLimit.uiFrameRate, &stRateLimit.uiFrameBurst); break;
+            default:
+                fprintf(stderr, "Usage: %s [-k keepalive_ms,idle_ms] [-w high_bytes,low_bytes] [-f frames_per_sec,burst]"
+                    " [port] [workers] [rr|least|reuseport] [cpu,cpu,...]\n", argv[0]);
+                return 1;
+        }
+    }
+    /* 남은 위치 인자는 argv[1] 부터 기존 순서 그대로 */
+    argc -= optind - 1;
+    argv += optind - 1;
+
     unsigned short unPort = (argc > 1) ? atoi(argv[1]) : 9000;
     struct event_base *pstEventBase = event_base_new();
     if (!pstEventBase) {
@@ -22,7 +98,34 @@ int main(int argc, char *argv[])
         return -1;
     }
     TCP_SERVER_CTX stTcpCtx;
-    tcpSvrInit(&stTcpCtx, pstEventBase, 1, TCP_SERVER);
+    tcpSvrInit(&stTcpCtx, pstEventBase, 1, TCP_SERVER, 256);
+    /* tcpSvr [-k ..] [-w ..] [-f ..] <port> [workers] [rr|least|reuseport] [cpu,cpu,...] */
+    if (argc > 2) {
+        TCP_DISPATCH eDispatch = TCP_DISPATCH_ROUND_ROBIN;
+        if (argc > 3 && !strcmp(argv[3], "least"))
+            eDispatch = TCP_DISPATCH_LEAST_SESSIONS;
+        else if (argc > 3 && !strcmp(argv[3], "reuseport"))
+            eDispatch = TCP_DISPATCH_REUSEPORT;
+        tcpSvrSetWorkers(&stTcpCtx, atoi(argv[2]), eDispatch);
+    }
+    if (argc > 4) {
+        int aiCpu[64];
+        int iCpuCnt = 0;
+        for (char* pchTok = strtok(argv[4], ","); pchTok && iCpuCnt < 64; pchTok = strtok(NULL, ","))
+            aiCpu[iCpuCnt++] = atoi(pchTok);
+        tcpSvrSetWorkerCpus(&stTcpCtx, aiCpu, iCpuCnt);
+    }
+    /* -k: 조용하면 KEEP_ALIVE 확인, 더 오래 조용하면 종료 (워커는 시작 시 설정을 이어받는다) */
+    if (uiKeepAliveMs || uiIdleTimeoutMs) {
+        if (sessionEnableIdleTimer(&stTcpCtx.stNetBase.stCoreCtx, uiKeepAliveMs, uiIdleTimeoutMs) < 0)
+            fprintf(stderr, "[TCP SERVER] idle timer disabled\n");
+    }
+    /* -w: 출력 버퍼가 high 에서 읽기 중지, low 까지 빠지면 재개 */
+    if (ulWriteHigh)
+        sessionSetWriteLimit(&stTcpCtx.stNetBase.stCoreCtx, ulWriteHigh, ulWriteLow, SESSION_SLOW_PAUSE_READ, 0);
+    /* -f: 연결 하나가 초당 프레임 수(버스트)를 넘으면 잠시 읽기 중지 */
+    if (stRateLimit.uiFrameRate)
+        tcpSvrSetRateLimit(&stTcpCtx, &stRateLimit);
     fprintf(stderr,"### %s():%d ###\n",__func__,__LINE__);
     if (tcpServerStart(&stTcpCtx, unPort) < 0) {
         fprintf(stderr, "Failed to start TCP server\n");
@@ -43,10 +146,16 @@ int main(int argc, char *argv[])
         tcpSvrStop(&stTcpCtx);
         return 1;
     }   
+    struct event *pstDumpEvent = evsignal_new(pstEventBase, SIGUSR1, traceDumpCallBack, &stTcpCtx);
+    if (pstDumpEvent)
+        event_add(pstDumpEvent, NULL);
 
     printf("[TCP SERVER] Running on port %d\n", unPort);
     event_base_dispatch(pstEventBase);
 
+    if (pstDumpEvent)
+        event_free(pstDumpEvent);
+
     tcpSvrStop(&stTcpCtx);
     return 0;
 }
@@ -0,0 +1,146 @@
+/**
+ * @file udpBench.c
+ * @brief UDP 텔레메트리 버스트 처리량 / 시스템 호출 수 측정 (루프백)
+ *
+ * 사용법:
+ *   ./udpBench [frame_count] [payload_bytes]
+ *
+ * batch   : sendmmsg/recvmmsg 배치만 (데이터그램마다 커널 경로 한 번)
+ * gso     : 송신 UDP_SEGMENT (같은 크기 프레임을 한 슬롯으로), 수신은 데이터그램 단위
+ * gso+gro : 송신 UDP_SEGMENT + 수신 UDP_GRO (합쳐 받은 슬롯을 사용자 공간에서 나눔)
+ */
+#include "netModule/protocols/udp.h"
+#include "netModule/core/frame.h"
+#include <arpa/inet.h>
+#include <event2/event.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_CMD       0x60        /* 응답 없는 텔레메트리 프레임 */
+#define BURST_SIZE      UDP_GSO_SEGS_MAX    /* 루프 한 바퀴에 쌓는 프레임 수 (GSO 슬롯 하나, 수신 버퍼 안쪽) */
+#define IDLE_ROUNDS     2000        /* 수신이 멈춘 것으로 보는 빈 루프 수 */
+
+typedef struct {
+    const char      *pchName;
+    unsigned char   uchClient;
+    unsigned char   uchServer;
+} BENCH_MODE;
+
+typedef struct {
+    double          dFramesPerSec;
+    unsigned long   ulRxFrames;
+    unsigned long   ulTxCalls;
+    unsigned long   ulRxCalls;
+    unsigned char   uchActive;
+} BENCH_RESULT;
+
+static double nowSec(void)
+{
+    struct timespec stTs;
+    clock_gettime(CLOCK_MONOTONIC, &stTs);
+    return (double)stTs.tv_sec + (double)stTs.tv_nsec / 1e9;
+}
+
+static int benchHandler(FRAME_CTX* pstFrameCtx, const FRAME_VIEW* pstFrameView, void* pvUser)
+{
+    (void)pstFrameCtx;
+    (void)pstFrameView;
+    (*(unsigned long*)pvUser)++;
+    return 1;
+}
+
+static int runBench(const BENCH_MODE* pstMode, long lCount, int iDataLength, BENCH_RESULT* pstResult)
+{
+    struct event_base* pstEventBase = event_base_new();
+    UDP_CTX stServer, stClient;
+    unsigned long ulRxFrames = 0;
+    memset(pstResult, 0, sizeof(*pstResult));
+
+    udpInit(&stServer, pstEventBase, 10, UDP_MODE);
+    udpInit(&stClient, pstEventBase, 20, UDP_MODE);
+    udpSetOffload(&stServer, pstMode->uchServer);
+    udpSetOffload(&stClient, pstMode->uchClient);
+    if (udpServerStart(&stServer, 0) < 0) {
+        udpStop(&stServer);
+        event_base_free(pstEventBase);
+        return -1;
+    }
+    struct sockaddr_in stAddr;
+    socklen_t iAddrLen = sizeof(stAddr);
+    getsockname(stServer.stNetBase.iSockFd, (struct sockaddr*)&stAddr, &iAddrLen);
+    if (udpClientStart(&stClient, "127.0.0.1", ntohs(stAddr.sin_port), 0) < 0) {
+        udpStop(&stServer);
+        udpStop(&stClient);
+        event_base_free(pstEventBase);
+        return -1;
+    }
+    cmdRegister(&stServer.stNetBase.stCoreCtx.stCmdTable, BENCH_CMD, CMD_ANY_SIZE, benchHandler, &ulRxFrames);
+
+    unsigned char* puchPayload = malloc((size_t)iDataLength);
+    for (int i = 0; i < iDataLength; i++)
+        puchPayload[i] = (unsigned char)(i * 31);
+    FRAME_IOV stFrame = { BENCH_CMD, 0, puchPayload, iDataLength, 0, 0, 0, 0 };
+
+    /* 버스트마다 수신 측이 따라잡게 해 소켓 버퍼 넘침(손실) 대신 경로 비용을 잰다 */
+    double dStart = nowSec();
+    long lSent = 0;
+    while (lSent < lCount) {
+        for (int i = 0; i < BURST_SIZE && lSent < lCount; i++, lSent++)
+            udpSendFrame(&stClient, NULL, 0, &stFrame);
+        for (int iIdle = 0; ulRxFrames < (unsigned long)lSent && iIdle < IDLE_ROUNDS; iIdle++)
+            event_base_loop(pstEventBase, EVLOOP_NONBLOCK);
+    }
+    double dElapsed = nowSec() - dStart;
+
+    pstResult->dFramesPerSec    = (double)ulRxFrames / dElapsed;
+    pstResult->ulRxFrames       = ulRxFrames;
+    pstResult->ulTxCalls        = stClient.ulTxBatchCnt;
+    pstResult->ulRxCalls        = stServer.ulRxBatchCnt;
+    pstResult->uchActive        = stClient.uchOffloadActive | stServer.uchOffloadActive;
+
+    free(puchPayload);
+    udpStop(&stClient);
+    udpStop(&stServer);
+    event_base_free(pstEventBase);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    long lCount = (argc > 1) ? atol(argv[1]) : 200000;
+    int iDataLength = (argc > 2) ? atoi(argv[2]) : 1200;
+    static const BENCH_MODE astModes[] = {
+        { "batch",   0,               0               },
+        { "gso",     UDP_OFFLOAD_GSO, 0               },
+        { "gso+gro", UDP_OFFLOAD_GSO, UDP_OFFLOAD_GRO },
+    };
+    if (lCount <= 0 || iDataLength <= 0 || iDataLength > UDP_SLOT_SIZE_DEFAULT - 32) {
+        fprintf(stderr, "usage: %s [frame_count] [payload_bytes <= %d]\n", argv[0], UDP_SLOT_SIZE_DEFAULT - 32);
+        return 1;
+    }
+
+    BENCH_RESULT astResult[sizeof(astModes) / sizeof(astModes[0])];
+    for (size_t i = 0; i < sizeof(astModes) / sizeof(astModes[0]); i++) {
+        if (runBench(&astModes[i], lCount, iDataLength, &astResult[i]) < 0) {
+            fprintf(stderr, "[BENCH] %s: start failed\n", astModes[i].pchName);
+            return 1;
+        }
+    }
+
+    printf("\n%d byte payload, %ld frames\n", iDataLength, lCount);
+    printf("%8s %12s %8s %10s %14s %14s  %s\n", "mode", "frames/s", "speedup", "received",
+        "sendmmsg/1k", "recvmmsg/1k", "offload");
+    for (size_t i = 0; i < sizeof(astModes) / sizeof(astModes[0]); i++) {
+        const BENCH_RESULT* pstResult = &astResult[i];
+        double dPerK = pstResult->ulRxFrames ? 1000.0 / (double)pstResult->ulRxFrames : 0.0;
+        printf("%8s %12.0f %7.2fx %10lu %14.2f %14.2f  %s%s%s\n", astModes[i].pchName,
+            pstResult->dFramesPerSec, pstResult->dFramesPerSec / astResult[0].dFramesPerSec,
+            pstResult->ulRxFrames, (double)pstResult->ulTxCalls * dPerK, (double)pstResult->ulRxCalls * dPerK,
+            (pstResult->uchActive & UDP_OFFLOAD_GSO) ? "gso " : "",
+            (pstResult->uchActive & UDP_OFFLOAD_GRO) ? "gro" : "",
+            pstResult->uchActive ? "" : "-");
+    }
+    return 0;
+}
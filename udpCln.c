@@ -3,69 +3,136 @@
  * @brief UDP 클라이언트 테스트 (netModule 기반)
  *
  * 사용법:
- *   ./udpCln <server_ip> <server_port> [my_port]
+ *   ./udpCln <server_ip> <server_port> [my_port] [rel]
  * 예:
  *   ./udpCln 127.0.0.1 9001       # 임의 포트 바인드
  *   ./udpCln 127.0.0.1 9001 5000  # 로컬 5000 포트 바인드
+ *   ./udpCln 127.0.0.1 9001 0 rel # 신뢰 전송 (서버도 rel 로 시작)
  */
 
- #include "netModule/protocols/udp.h"
- #include "netModule/core/netCore.h"
- #include <event2/event.h>
- #include <signal.h>
- #include <stdio.h>
- #include <stdlib.h>
- 
- static void sigint_cb(evutil_socket_t sig, short ev, void *arg)
- {
-     (void)sig; (void)ev;
-     UDP_CTX *ctx = (UDP_CTX *)arg;
-     printf("\n[UDP CLIENT] SIGINT caught. Exiting...\n");
-     udpStop(ctx);
-     event_base_loopbreak(ctx->stCoreCtx.pstEventBase);
- }
- 
- int main(int argc, char *argv[])
- {
-     if (argc < 3) {
-         printf("Usage: %s <server_ip> <server_port> [my_port]\n", argv[0]);
-         return 1;
-     }
- 
-     const char *ip = argv[1];
-     unsigned short svr_port = (unsigned short)atoi(argv[2]);
-     unsigned short my_port  = (argc >= 4) ? (unsigned short)atoi(argv[3]) : 0;  // 0이면 커널이 임의 포트 할당
- 
-     struct event_base *base = event_base_new();
-     if (!base) {
-         fprintf(stderr, "Failed to create event_base\n");
-         return 1;
-     }
- 
-     UDP_CTX udpCtx;
-     udpInit(&udpCtx, base, 20, NET_MODE_CLIENT);
- 
-     // 올바른 호출 (IP, 서버 포트, 내 바인드 포트)
-     if (udpClientStart(&udpCtx, ip, svr_port, my_port) < 0) {
-         fprintf(stderr, "[UDP CLIENT] Failed to start (dst=%s:%u, bind=%u)\n",
-                 ip, svr_port, my_port);
-         event_base_free(base);
-         return 1;
-     }
- 
-     struct event *sig = evsignal_new(base, SIGINT, sigint_cb, &udpCtx);
-     if (sig) event_add(sig, NULL);
- 
-     printf("[UDP CLIENT] dst=%s:%u, bind=%u\n", ip, svr_port, my_port);
-     printf("[UDP CLIENT] Type messages and press Enter.\n");
- 
-     event_base_dispatch(base);
- 
-     if (sig) 
-        event_free(sig);
-        
-     udpStop(&udpCtx);
-     event_base_free(base);
-     return 0;
- }
- 
\ No newline at end of file
+#include "netModule/protocols/udp.h"
+#include "netModule/core/frame.h"
+#include "netModule/core/icdCommand.h"
+#include "netModule/core/inflight.h"
+#include <event2/event.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* === pipeline <n>: 응답을 기다리지 않고 KEEP_ALIVE n개를 연속 송신 === */
+typedef struct {
+    int     iPending;
+    int     iDone;
+    int     iTimeout;
+} PIPELINE_STAT;
+
+static PIPELINE_STAT s_stPipeline;
+
+static void pipelineCallBack(int iStatus, const FRAME_VIEW* pstFrameView, void* pvUser)
+{
+    (void)pstFrameView;
+    PIPELINE_STAT* pstStat = (PIPELINE_STAT*)pvUser;
+    if (iStatus == INFLIGHT_DONE)
+        pstStat->iDone++;
+    else
+        pstStat->iTimeout++;
+    if (--pstStat->iPending == 0)
+        printf("client: pipeline done (ok=%d, timeout/lost=%d)\n", pstStat->iDone, pstStat->iTimeout);
+}
+
+static void stdInCallBack(evutil_socket_t fd, short nEvents, void* pvData)
+{
+    (void)fd;
+    (void)nEvents;
+    UDP_CTX *pstUdpCtx = (UDP_CTX *)pvData;
+    char achStdInData[1024];
+    if (!fgets(achStdInData, sizeof(achStdInData), stdin)) {
+        event_base_loopexit(pstUdpCtx->stNetBase.stCoreCtx.pstEventBase, NULL);
+        return;
+    }
+    achStdInData[strcspn(achStdInData, "\n")] = '\0';
+    if (strcmp(achStdInData, "keepalive") == 0) {
+        REQ_KEEP_ALIVE stReq = { 0x01 };
+        FRAME_IOV stFrame = { CMD_KEEP_ALIVE, 0, &stReq, sizeof(stReq), 0, 0, 0, 0 };
+        udpSendFrame(pstUdpCtx, NULL, 0, &stFrame);
+        printf("client: sent KEEP_ALIVE\n");
+    } else if (strncmp(achStdInData, "pipeline", 8) == 0) {
+        int iCount = atoi(achStdInData + 8);
+        REQ_KEEP_ALIVE stReq = { 0x01 };
+        memset(&s_stPipeline, 0, sizeof(s_stPipeline));
+        for (int i = 0; i < (iCount > 0 ? iCount : 1); i++) {
+            if (inflightRequest(&pstUdpCtx->stSession.stFrameCtx, CMD_KEEP_ALIVE, 0,
+                    &stReq, sizeof(stReq), 1000, pipelineCallBack, &s_stPipeline) < 0)
+                break;
+            s_stPipeline.iPending++;
+        }
+        printf("client: sent %d KEEP_ALIVE (pipelined)\n", s_stPipeline.iPending);
+    } else if (strcmp(achStdInData, "stats") == 0) {
+        printf("client: rx dgrams=%lu recvmmsg=%lu dropped=%lu, tx dgrams=%lu sendmmsg=%lu dropped=%lu\n",
+            pstUdpCtx->ulRxDgramCnt, pstUdpCtx->ulRxBatchCnt, pstUdpCtx->ulRxDropCnt,
+            pstUdpCtx->ulTxDgramCnt, pstUdpCtx->ulTxBatchCnt, pstUdpCtx->ulTxDropCnt);
+        if (pstUdpCtx->pstRel)
+            printf("client: reliable tx=%lu retx=%lu (fast %lu) gave-up=%lu backlog=%lu, rx=%lu dup=%lu acks=%lu,"
+                " srtt=%uus rto=%ums in-flight=%u\n",
+                pstUdpCtx->ulRelTxCnt, pstUdpCtx->ulRelRetxCnt, pstUdpCtx->ulRelFastCnt, pstUdpCtx->ulRelGiveUpCnt,
+                pstUdpCtx->ulRelBacklogCnt, pstUdpCtx->ulRelRxCnt, pstUdpCtx->ulRelDupCnt, pstUdpCtx->ulRelAckCnt,
+                pstUdpCtx->pstRel->uiSrttUs, pstUdpCtx->pstRel->uiRtoMs, udpRelOutstanding(pstUdpCtx->pstRel));
+    } else if (!strcmp(achStdInData, "quit") || !strcmp(achStdInData, "exit")) {
+        event_base_loopexit(pstUdpCtx->stNetBase.stCoreCtx.pstEventBase, NULL);
+    } else {
+        printf("usage:\n  keepalive\n  pipeline <n>\n  stats\n  quit\n");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        printf("Usage: %s <server_ip> <server_port> [my_port] [rel]\n", argv[0]);
+        return 1;
+    }
+
+    const char *pchIp = argv[1];
+    unsigned short unSvrPort = (unsigned short)atoi(argv[2]);
+    unsigned short unMyPort  = (argc >= 4) ? (unsigned short)atoi(argv[3]) : 0;  // 0이면 커널이 임의 포트 할당
+
+    struct event_base *pstEventBase = event_base_new();
+    if (!pstEventBase) {
+        fprintf(stderr, "Failed to create event_base\n");
+        return 1;
+    }
+
+    UDP_CTX stUdpCtx;
+    udpInit(&stUdpCtx, pstEventBase, 20, UDP_MODE);
+    stUdpCtx.stNetBase.uchDstId = 10;
+    if (argc >= 5 && strcmp(argv[4], "rel") == 0)
+        udpSetReliable(&stUdpCtx, 1);
+    if (udpClientStart(&stUdpCtx, pchIp, unSvrPort, unMyPort) < 0) {
+        fprintf(stderr, "[UDP CLIENT] Failed to start (dst=%s:%u, bind=%u)\n", pchIp, unSvrPort, unMyPort);
+        udpStop(&stUdpCtx);
+        event_base_free(pstEventBase);
+        return 1;
+    }
+
+    /* STDIN Event 처리 */
+    signal(SIGPIPE, SIG_IGN);
+    struct event *pstStdInEvent = event_new(pstEventBase, fileno(stdin), EV_READ | EV_PERSIST,
+        stdInCallBack, &stUdpCtx);
+    if (!pstStdInEvent || event_add(pstStdInEvent, NULL) < 0) {
+        fprintf(stderr, "Could not add StdIn event\n");
+        if (pstStdInEvent)
+            event_free(pstStdInEvent);
+        udpStop(&stUdpCtx);
+        event_base_free(pstEventBase);
+        return 1;
+    }
+
+    printf("[UDP CLIENT] Type message and press Enter.\n");
+    event_base_dispatch(pstEventBase);
+
+    event_free(pstStdInEvent);
+    udpStop(&stUdpCtx);
+    event_base_free(pstEventBase);
+    printf("[UDP CLIENT] Stopped.\n");
+    return 0;
+}
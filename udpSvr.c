@@ -1,40 +1,109 @@
 #include "netModule/protocols/udp.h"
-#include "netModule/core/netCore.h"
+#include "netModule/core/trace.h"
 #include <event2/event.h>
+#include <netdb.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-static void sigint_cb(evutil_socket_t sig, short ev, void *arg)
+static void signalCallBack(evutil_socket_t sig, short ev, void *pvData)
 {
     (void)sig; (void)ev;
-    UDP_CTX *ctx = (UDP_CTX *)arg;
+    UDP_CTX *pstUdpCtx = (UDP_CTX *)pvData;
     printf("\n[UDP SERVER] SIGINT caught. Exiting...\n");
-    udpStop(ctx);
-    event_base_loopbreak(ctx->stCoreCtx.pstEventBase);
+    event_base_loopbreak(pstUdpCtx->stNetBase.stCoreCtx.pstEventBase);
+}
+
+/* SIGUSR1: 트레이스 링 덤프 + 데이터그램 배치 상태 */
+static void traceDumpCallBack(evutil_socket_t sig, short ev, void *pvData)
+{
+    (void)sig; (void)ev;
+    const UDP_CTX *pstUdpCtx = (const UDP_CTX *)pvData;
+    long lTotal = traceDump(stderr);
+    printf("[UDP SERVER] %ld trace records dumped\n", lTotal);
+    printf("[UDP SERVER] rx: dgrams=%lu recvmmsg=%lu max-batch=%lu dropped=%lu\n",
+        pstUdpCtx->ulRxDgramCnt, pstUdpCtx->ulRxBatchCnt, pstUdpCtx->ulRxMaxBatch, pstUdpCtx->ulRxDropCnt);
+    printf("[UDP SERVER] tx: dgrams=%lu sendmmsg=%lu dropped=%lu\n",
+        pstUdpCtx->ulTxDgramCnt, pstUdpCtx->ulTxBatchCnt, pstUdpCtx->ulTxDropCnt);
+    printf("[UDP SERVER] offload:%s%s gso-slots=%lu gro-slots=%lu\n",
+        (pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GSO) ? " gso" : "",
+        (pstUdpCtx->uchOffloadActive & UDP_OFFLOAD_GRO) ? " gro" : "",
+        pstUdpCtx->ulTxGsoCnt, pstUdpCtx->ulRxGroCnt);
+    if (pstUdpCtx->chReliable)
+        printf("[UDP SERVER] reliable: tx=%lu retx=%lu (fast %lu) gave-up=%lu backlog=%lu, rx=%lu dup=%lu acks=%lu\n",
+            pstUdpCtx->ulRelTxCnt, pstUdpCtx->ulRelRetxCnt, pstUdpCtx->ulRelFastCnt, pstUdpCtx->ulRelGiveUpCnt,
+            pstUdpCtx->ulRelBacklogCnt, pstUdpCtx->ulRelRxCnt, pstUdpCtx->ulRelDupCnt, pstUdpCtx->ulRelAckCnt);
+
+    /* 상대 세션: 최근 수신 순 */
+    const UDP_PEER_TABLE *pstTable = &pstUdpCtx->stPeerTable;
+    printf("[UDP SERVER] peers=%u/%u evicted=%lu idle=%lu\n",
+        pstTable->uiCount, pstTable->uiMaxPeers, pstTable->ulEvictCnt, pstTable->ulIdleCnt);
+    uint64_t ulNowMs = udpPeerNowMs();
+    for (uint32_t uiIdx = pstTable->uiLruHead; uiIdx != UDP_PEER_NONE; uiIdx = pstTable->pastPeer[uiIdx].uiLruNext) {
+        const UDP_PEER *pstPeer = &pstTable->pastPeer[uiIdx];
+        char achHost[NI_MAXHOST], achServ[NI_MAXSERV];
+        if (getnameinfo((const struct sockaddr *)&pstPeer->stAddr, pstPeer->iAddrLen, achHost, sizeof(achHost),
+                achServ, sizeof(achServ), NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
+            strcpy(achHost, "?");
+            achServ[0] = '\0';
+        }
+        if (pstPeer->chIdKnown)
+            printf("  %s:%s id=%u", achHost, achServ, pstPeer->stMsgId.uchDstId);
+        else
+            printf("  %s:%s id=?", achHost, achServ);
+        printf(" rx=%lu/%lu frames/dgrams tx=%lu frames, %lu/%lu bytes rx/tx, idle %lums\n",
+            pstPeer->ulRxFrameCnt, pstPeer->ulRxDgramCnt, pstPeer->ulTxFrameCnt,
+            pstPeer->ulRxBytes, pstPeer->ulTxBytes, (unsigned long)(ulNowMs - pstPeer->ulLastSeenMs));
+        if (pstPeer->pstRel)
+            printf("    reliable: srtt=%uus rto=%ums in-flight=%u retx=%lu gave-up=%lu\n",
+                pstPeer->pstRel->uiSrttUs, pstPeer->pstRel->uiRtoMs, udpRelOutstanding(pstPeer->pstRel),
+                pstPeer->pstRel->ulRetxCnt, pstPeer->pstRel->ulGiveUpCnt);
+    }
 }
 
 int main(int argc, char *argv[])
 {
-    unsigned short port = (argc > 1) ? atoi(argv[1]) : 9001;
-    struct event_base *base = event_base_new();
+    unsigned short unPort = (argc > 1) ? atoi(argv[1]) : 9001;
+    struct event_base *pstEventBase = event_base_new();
+    if (!pstEventBase) {
+        fprintf(stderr, "[ERROR] Failed to create event_base\n");
+        return 1;
+    }
 
-    UDP_CTX udpCtx;
-    udpInit(&udpCtx, base, 10, NET_MODE_SERVER);
+    UDP_CTX stUdpCtx;
+    udpInit(&stUdpCtx, pstEventBase, 10, UDP_MODE);
+    /* udpSvr <port> [batch] [gso,gro,rel] */
+    if (argc > 2)
+        udpSetBatch(&stUdpCtx, (unsigned int)atoi(argv[2]), 0);
+    if (argc > 3)
+        udpSetOffload(&stUdpCtx, (strstr(argv[3], "gso") ? UDP_OFFLOAD_GSO : 0) |
+                                 (strstr(argv[3], "gro") ? UDP_OFFLOAD_GRO : 0));
+    if (argc > 3 && strstr(argv[3], "rel"))
+        udpSetReliable(&stUdpCtx, 1);
 
-    if (udpServerStart(&udpCtx, port) < 0) {
+    if (udpServerStart(&stUdpCtx, unPort) < 0) {
         fprintf(stderr, "Failed to start UDP server\n");
+        udpStop(&stUdpCtx);
+        event_base_free(pstEventBase);
         return 1;
     }
 
-    struct event *sig = evsignal_new(base, SIGINT, sigint_cb, &udpCtx);
-    event_add(sig, NULL);
+    struct event *pstSigEvent = evsignal_new(pstEventBase, SIGINT, signalCallBack, &stUdpCtx);
+    if (pstSigEvent)
+        event_add(pstSigEvent, NULL);
+    struct event *pstDumpEvent = evsignal_new(pstEventBase, SIGUSR1, traceDumpCallBack, &stUdpCtx);
+    if (pstDumpEvent)
+        event_add(pstDumpEvent, NULL);
 
-    printf("[UDP SERVER] Listening on port %d\n", port);
-    event_base_dispatch(base);
+    event_base_dispatch(pstEventBase);
 
-    event_free(sig);
-    udpStop(&udpCtx);
-    event_base_free(base);
+    if (pstDumpEvent)
+        event_free(pstDumpEvent);
+    if (pstSigEvent)
+        event_free(pstSigEvent);
+    udpStop(&stUdpCtx);
+    event_base_free(pstEventBase);
+    printf("[UDP SERVER] Stopped.\n");
     return 0;
 }
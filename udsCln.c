@@ -1,10 +1,13 @@
 #include "netModule/protocols/uds.h"
 #include "netModule/core/frame.h"
 #include "netModule/core/icdCommand.h"
+#include "netModule/core/inflight.h"
 #include <event2/event.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <endian.h>
 
 #if 0
 static void signalCallBack(evutil_socket_t sig, short ev, void *pvData)
@@ -16,6 +19,55 @@ static void signalCallBack(evutil_socket_t sig, short ev, void *pvData)
 }
 #endif
 
+/* === pipeline <n>: 응답을 기다리지 않고 KEEP_ALIVE n개를 연속 송신 === */
+typedef struct {
+    int     iPending;
+    int     iDone;
+    int     iTimeout;
+} PIPELINE_STAT;
+
+static PIPELINE_STAT s_stPipeline;
+
+static void pipelineCallBack(int iStatus, const FRAME_VIEW* pstFrameView, void* pvUser)
+{
+    (void)pstFrameView;
+    PIPELINE_STAT* pstStat = (PIPELINE_STAT*)pvUser;
+    if (iStatus == INFLIGHT_DONE)
+        pstStat->iDone++;
+    else
+        pstStat->iTimeout++;
+    if (--pstStat->iPending == 0)
+        printf("client: pipeline done (ok=%d, timeout/cancel=%d)\n", pstStat->iDone, pstStat->iTimeout);
+}
+
+/* === stats: 상대 노드의 CMD_STATS 스냅샷 출력 === */
+static void printStatsCounters(const char* pchName, const STATS_COUNTERS* pstStats)
+{
+    uint64_t ulRxFrames = be64toh(pstStats->ulRxFrames);
+    printf("  %-7s rx=%llu/%lluB tx=%llu/%lluB crc=%llu resync=%llu discard=%lluB "
+           "queued=%lluB inflight=%u handler avg=%lluns max=%lluns\n", pchName,
+        (unsigned long long)ulRxFrames, (unsigned long long)be64toh(pstStats->ulRxBytes),
+        (unsigned long long)be64toh(pstStats->ulTxFrames), (unsigned long long)be64toh(pstStats->ulTxBytes),
+        (unsigned long long)be64toh(pstStats->ulCrcErr), (unsigned long long)be64toh(pstStats->ulResync),
+        (unsigned long long)be64toh(pstStats->ulDiscardBytes), (unsigned long long)be64toh(pstStats->ulOutQueued),
+        ntohl(pstStats->uiInflight),
+        (unsigned long long)(ulRxFrames ? be64toh(pstStats->ulHandlerNs) / ulRxFrames : 0),
+        (unsigned long long)be64toh(pstStats->ulHandlerMaxNs));
+}
+
+static void statsCallBack(int iStatus, const FRAME_VIEW* pstFrameView, void* pvUser)
+{
+    (void)pvUser;
+    if (iStatus != INFLIGHT_DONE || pstFrameView->iDataLength < (int)sizeof(RES_STATS)) {
+        printf("client: stats failed\n");
+        return;
+    }
+    const RES_STATS* pstRes = (const RES_STATS*)pstFrameView->puchPayload;
+    printf("client: stats v%u sessions=%u\n", pstRes->uchVersion, ntohl(pstRes->uiSessions));
+    printStatsCounters("session", &pstRes->stSession);
+    printStatsCounters("core", &pstRes->stCore);
+}
+
 static void stdInCallBack(evutil_socket_t sig, short nEvents, void* pvData)
 {
     (void)sig;
@@ -32,14 +84,35 @@ static void stdInCallBack(evutil_socket_t sig, short nEvents, void* pvData)
     achStdInData[strcspn(achStdInData, "\n")] = '\0';
     if (strcmp(achStdInData, "keepalive") == 0) {
         printf("client: sent KEEP_ALIVE\n");       
-        requestFrame(pstUdsClnCtx->pstBufferEvent, &stMsgId, CMD_KEEP_ALIVE);        
+        requestFrame(&pstUdsClnCtx->stSession.stFrameCtx, &stMsgId, CMD_KEEP_ALIVE);        
     } else if (strcmp(achStdInData, "ibit") == 0) {        
         printf("client: sent IBIT\n");
-        requestFrame(pstUdsClnCtx->pstBufferEvent, &stMsgId, CMD_IBIT);        
+        requestFrame(&pstUdsClnCtx->stSession.stFrameCtx, &stMsgId, CMD_IBIT);        
+    } else if (strncmp(achStdInData, "pipeline", 8) == 0) {
+        int iCount = atoi(achStdInData + 8);
+        REQ_KEEP_ALIVE stReqKeepAlive = { 0x01 };
+        memset(&s_stPipeline, 0, sizeof(s_stPipeline));
+        for (int i = 0; i < (iCount > 0 ? iCount : 1); i++) {
+            if (inflightRequest(&pstUdsClnCtx->stSession.stFrameCtx, CMD_KEEP_ALIVE, 0,
+                    &stReqKeepAlive, sizeof(stReqKeepAlive), 0, pipelineCallBack, &s_stPipeline) < 0)
+                break;
+            s_stPipeline.iPending++;
+        }
+        printf("client: sent %d KEEP_ALIVE (pipelined)\n", s_stPipeline.iPending);
+    } else if (strcmp(achStdInData, "compress") == 0) {
+        if (frameNegotiate(&pstUdsClnCtx->stSession.stFrameCtx, FRAME_CAP_COMPRESS, 0) < 0)
+            printf("client: compress negotiation failed\n");
+        else
+            printf("client: sent REQ_ID (compress)\n");
+    } else if (strcmp(achStdInData, "stats") == 0) {
+        REQ_STATS stReqStats = { 0x01 };
+        if (inflightRequest(&pstUdsClnCtx->stSession.stFrameCtx, CMD_STATS, 0,
+                &stReqStats, sizeof(stReqStats), 1000, statsCallBack, NULL) < 0)
+            printf("client: stats request failed\n");
     } else if (!strcmp(achStdInData, "quit") || !strcmp(achStdInData, "exit")) {
         event_base_loopexit(pstUdsClnCtx->stNetBase.stCoreCtx.pstEventBase, NULL);
     } else {
-        printf("usage:\n  echo <text>\n  keepalive\n  ibit <n>\n  quit\n");
+        printf("usage:\n  echo <text>\n  keepalive\n  ibit <n>\n  pipeline <n>\n  compress\n  stats\n  quit\n");
     }
 }
 
@@ -1,8 +1,10 @@
 #include "netModule/protocols/uds.h"
+#include "netModule/core/trace.h"
 #include <event2/event.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 static void signalCallBack(evutil_socket_t sig, short ev, void *pvData)
 {
@@ -12,13 +14,65 @@ static void signalCallBack(evutil_socket_t sig, short ev, void *pvData)
     event_base_loopbreak(pstUdsCtx->stNetBase.stCoreCtx.pstEventBase);
 }
 
+/* SIGUSR1: 트레이스 링 덤프 + 세션 풀/유휴/느린 상대/속도 제한/리스너 상태 */
+static void traceDumpCallBack(evutil_socket_t sig, short ev, void *pvData)
+{
+    (void)sig; (void)ev;
+    const SLAB_POOL* pstPool = &((UDS_SERVER_CTX*)pvData)->stNetBase.stCoreCtx.stSessionPool;
+    long lTotal = traceDump(stderr);
+    printf("[UDS SERVER] %ld trace records dumped\n", lTotal);
+    printf("[UDS SERVER] session pool: in-use=%lu capacity=%lu hit=%lu miss=%lu\n",
+        pstPool->ulInUse, pstPool->ulCapacity, pstPool->ulHitCnt, pstPool->ulMissCnt);
+    printf("[UDS SERVER] idle: keepalive=%lu reaped=%lu\n",
+        ((UDS_SERVER_CTX*)pvData)->stNetBase.stCoreCtx.ulKeepAliveCnt,
+        ((UDS_SERVER_CTX*)pvData)->stNetBase.stCoreCtx.ulIdleReapCnt);
+    printf("[UDS SERVER] slow consumer: paused=%lu dropped=%lu disconnected=%lu\n",
+        ((UDS_SERVER_CTX*)pvData)->stNetBase.stCoreCtx.ulSlowPauseCnt,
+        ((UDS_SERVER_CTX*)pvData)->stNetBase.stCoreCtx.ulSlowDropCnt,
+        ((UDS_SERVER_CTX*)pvData)->stNetBase.stCoreCtx.ulSlowDisconnectCnt);
+    printf("[UDS SERVER] rate limit: throttled=%lu\n",
+        ((UDS_SERVER_CTX*)pvData)->stNetBase.stCoreCtx.ulRateLimitedCnt);
+    const NET_LISTENER* pstListener = ((UDS_SERVER_CTX*)pvData)->pstListener;
+    if (pstListener)
+        printf("[UDS SERVER] listener: wakeups=%lu accepted=%lu max-batch=%lu backoff=%lu\n",
+            pstListener->ulWakeCnt, pstListener->ulAcceptCnt, pstListener->ulMaxBatch, pstListener->ulBackoffCnt);
+}
+
 int main(int argc, char *argv[])
 {
-    const char *pchPath = (argc > 1) ? argv[1] : "/tmp/uds_server.sock";
+    /* 유휴 정리/출력 상한/속도 제한은 옵션으로만 켠다 (기본: 기존 동작 그대로) */
+    unsigned int uiKeepAliveMs = 0, uiIdleTimeoutMs = 0;
+    size_t ulWriteHigh = 0, ulWriteLow = 0;
+    SESSION_RATE_LIMIT stRateLimit = { 0 };
+    int iOpt;
+    while ((iOpt = getopt(argc, argv, "k:w:f:")) != -1) {
+        switch (iOpt) {
+            case 'k': sscanf(optarg, "%u,%u", &uiKeepAliveMs, &uiIdleTimeoutMs); break;
+            case 'w': sscanf(optarg, "%zu,%zu", &ulWriteHigh, &ulWriteLow); break;
+            case 'f': sscanf(optarg, "%u,%u", &stRateLimit.uiFrameRate, &stRateLimit.uiFrameBurst); break;
+            default:
+                fprintf(stderr, "Usage: %s [-k keepalive_ms,idle_ms] [-w high_bytes,low_bytes] [-f frames_per_sec,burst]"
+                    " [path]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    const char *pchPath = (optind < argc) ? argv[optind] : "/tmp/uds_server.sock";
     struct event_base *pstEventBase = event_base_new();
 
     UDS_SERVER_CTX stUdsCtx;
-    udsSvrInit(&stUdsCtx, pstEventBase, 30, UDS_SERVER);
+    udsSvrInit(&stUdsCtx, pstEventBase, 30, UDS_SERVER, 256);
+    /* -k: 조용하면 KEEP_ALIVE 확인, 더 오래 조용하면 종료 */
+    if (uiKeepAliveMs || uiIdleTimeoutMs) {
+        if (sessionEnableIdleTimer(&stUdsCtx.stNetBase.stCoreCtx, uiKeepAliveMs, uiIdleTimeoutMs) < 0)
+            fprintf(stderr, "[UDS SERVER] idle timer disabled\n");
+    }
+    /* -w: 출력 버퍼가 high 에서 읽기 중지, low 까지 빠지면 재개 */
+    if (ulWriteHigh)
+        sessionSetWriteLimit(&stUdsCtx.stNetBase.stCoreCtx, ulWriteHigh, ulWriteLow, SESSION_SLOW_PAUSE_READ, 0);
+    /* -f: 연결 하나가 초당 프레임 수(버스트)를 넘으면 잠시 읽기 중지 */
+    if (stRateLimit.uiFrameRate)
+        udsSvrSetRateLimit(&stUdsCtx, &stRateLimit);
 
     if (udsServerStart(&stUdsCtx, pchPath) < 0) {
         fprintf(stderr, "Failed to start UDS server\n");
@@ -38,10 +92,16 @@ int main(int argc, char *argv[])
         udsSvrStop(&stUdsCtx);
         return 1;
     }   
+    struct event *pstDumpEvent = evsignal_new(pstEventBase, SIGUSR1, traceDumpCallBack, &stUdsCtx);
+    if (pstDumpEvent)
+        event_add(pstDumpEvent, NULL);
 
     printf("[UDS SERVER] Listening on %s\n", pchPath);
     event_base_dispatch(pstEventBase);
 
+    if (pstDumpEvent)
+        event_free(pstDumpEvent);
+
     event_free(stUdsCtx.stNetBase.stCoreCtx.pstSignalEvent);
     udsSvrStop(&stUdsCtx);
     return 0;